@@ -0,0 +1,286 @@
+/**
+ * @file arena.hpp
+ * @brief 单调 arena 分配器 / Monotonic arena allocator
+ *
+ * @details
+ * 1. Arena 从 InterfaceAllocator（默认 GlobalAllocator）整块取 chunk，Small/Medium 层直接命中；chunk 内顺序切分，对象没有块头。
+ * 2. 释放单个对象是空操作；checkpoint / rewind 可嵌套，reset 与析构按 chunk 数 O(chunks) 归还整串 chunk。
+ * 3. ScopedArena 在作用域结束时回卷到进入时的位置；ArenaAllocator 让标准容器使用 arena。
+ *
+ * 1. Arena takes whole chunks from an InterfaceAllocator (GlobalAllocator by default), served by the Small/Medium tiers;
+ *    objects are bumped out of a chunk with no per-object header.
+ * 2. Freeing one object is a no-op; checkpoint / rewind nest, and reset and the destructor return the whole run of chunks
+ *    in O(chunks).
+ * 3. ScopedArena rewinds to where it started when the scope ends; ArenaAllocator lets standard containers use an arena.
+ *
+ * @note Arena 不是线程安全的：每个请求或线程各用一个 / Arena is not thread-safe: use one per request or thread.
+ *
+ * 代码风格说明 / Style Notes
+ * ---------------------------------------------------------------------------
+ * 1. 彻底避免缩写：所有标识符均使用完整单词 (chunk, cursor, checkpoint...)；
+ * 2. 中英文注释并存，支持 Doxygen 文档 / Bilingual comments with Doxygen support.
+ */
+
+#pragma once
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "global_allocator_api.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace os_memory::allocator
+{
+	/// @brief 单调 arena / Monotonic arena
+	class Arena
+	{
+	public:
+		static constexpr std::size_t DEFAULT_CHUNK_BYTES = 64 * 1024;	 //!< 首个 chunk 的大小 / Size of the first chunk
+		static constexpr std::size_t MAX_CHUNK_BYTES = 1 * 1024 * 1024;	 //!< 倍增上限，仍在 Small 层内 / Growth cap, still inside the Small tier
+
+		/// @brief 回卷点 / Rewind point
+		struct Checkpoint
+		{
+			void*		chunk = nullptr;   //!< 当时的当前 chunk / Chunk current at that time
+			std::byte*	cursor = nullptr;  //!< 当时的切分位置 / Bump position at that time
+			std::size_t used_bytes = 0;	   //!< 当时已切出的字节 / Bytes handed out at that time
+		};
+
+		/**
+		 * @param allocator    chunk 的来源 / where chunks come from
+		 * @param chunk_bytes  首个 chunk 的大小，之后倍增到 MAX_CHUNK_BYTES / size of the first chunk, doubled up to MAX_CHUNK_BYTES
+		 */
+		explicit Arena( InterfaceAllocator& allocator = *os_memory::api::GlobalAllocator::get(), std::size_t chunk_bytes = DEFAULT_CHUNK_BYTES )
+			: allocator_( allocator ), next_chunk_bytes_( std::clamp( chunk_bytes, sizeof( ChunkHeader ) + CHUNK_ALIGNMENT, MAX_CHUNK_BYTES ) )
+		{
+		}
+
+		~Arena()
+		{
+			reset();
+		}
+
+		Arena( const Arena& ) = delete;
+		Arena& operator=( const Arena& ) = delete;
+
+		/**
+		 * @brief 切出 bytes 字节 / Bump-allocate bytes bytes
+		 * @param alignment  2 的幂 / a power of two
+		 * @throw std::bad_alloc 取 chunk 失败 / when no chunk can be obtained
+		 */
+		void* allocate( std::size_t bytes, std::size_t alignment = alignof( std::max_align_t ) )
+		{
+			if ( alignment == 0 || ( alignment & ( alignment - 1 ) ) != 0 )
+				throw std::bad_alloc();
+
+			std::byte* user_pointer = align_up( cursor_, alignment );
+			if ( !current_ || user_pointer > limit_ || static_cast<std::size_t>( limit_ - user_pointer ) < bytes )
+			{
+				add_chunk( bytes, alignment );
+				user_pointer = align_up( cursor_, alignment );
+			}
+			cursor_ = user_pointer + bytes;
+			used_bytes_ += bytes;
+			return user_pointer;
+		}
+
+		/// @brief 空操作：内存在 rewind/reset 时整体归还 / No-op: memory comes back as a whole on rewind/reset
+		void deallocate( void*, std::size_t = 0 ) noexcept {}
+
+		/// @brief 记录当前位置 / Record the current position
+		Checkpoint checkpoint() const noexcept
+		{
+			return { current_, cursor_, used_bytes_ };
+		}
+
+		/**
+		 * @brief 回到 checkpoint：之后取得的 chunk 全部归还 / Go back to a checkpoint, returning every chunk taken after it
+		 * @note 回卷点必须来自本 arena 且未被更早的回卷越过 / The checkpoint must come from this arena and not have been passed by an earlier rewind
+		 */
+		void rewind( const Checkpoint& point ) noexcept
+		{
+			while ( current_ && current_ != point.chunk )
+				release_current_chunk();
+			if ( !current_ )
+				return;
+			cursor_ = point.cursor;
+			used_bytes_ = point.used_bytes;
+		}
+
+		/// @brief 归还全部 chunk / Return every chunk
+		void reset() noexcept
+		{
+			rewind( Checkpoint {} );
+			used_bytes_ = 0;
+		}
+
+		/// @brief 已切出的字节（不含对齐填充）/ Bytes handed out, alignment padding excluded
+		std::size_t used_bytes() const noexcept
+		{
+			return used_bytes_;
+		}
+
+		/// @brief 占用的 chunk 总字节 / Total bytes of the chunks held
+		std::size_t reserved_bytes() const noexcept
+		{
+			return reserved_bytes_;
+		}
+
+		std::size_t chunk_count() const noexcept
+		{
+			return chunk_count_;
+		}
+
+	private:
+		static constexpr std::size_t CHUNK_ALIGNMENT = alignof( std::max_align_t );
+
+		/// @brief chunk 起始处的链表头 / List header at the start of a chunk
+		struct alignas( CHUNK_ALIGNMENT ) ChunkHeader
+		{
+			ChunkHeader* previous;	//!< 更早的 chunk / The older chunk
+			std::size_t	 bytes;		//!< 整个 chunk 的字节数，带尺寸释放用 / Whole chunk size, for sized deallocation
+		};
+
+		static std::byte* align_up( std::byte* pointer, std::size_t alignment ) noexcept
+		{
+			const std::uintptr_t address = reinterpret_cast<std::uintptr_t>( pointer );
+			return pointer + ( ( ( address + alignment - 1 ) & ~( static_cast<std::uintptr_t>( alignment ) - 1 ) ) - address );
+		}
+
+		void add_chunk( std::size_t bytes, std::size_t alignment )
+		{
+			const std::size_t padding = alignment > CHUNK_ALIGNMENT ? alignment - CHUNK_ALIGNMENT : 0;
+			if ( bytes > std::numeric_limits<std::size_t>::max() - sizeof( ChunkHeader ) - padding )
+				throw std::bad_alloc();
+
+			// 放不下的大对象单独成块，不打断倍增节奏 / An oversized object gets a chunk of its own without disturbing the growth
+			const std::size_t needed_bytes = sizeof( ChunkHeader ) + padding + bytes;
+			const std::size_t chunk_bytes = std::max( needed_bytes, next_chunk_bytes_ );
+			if ( chunk_bytes == next_chunk_bytes_ )
+				next_chunk_bytes_ = std::min( next_chunk_bytes_ * 2, MAX_CHUNK_BYTES );
+
+			auto* chunk = static_cast<ChunkHeader*>( allocator_.allocate( chunk_bytes, CHUNK_ALIGNMENT ) );
+			chunk->previous = static_cast<ChunkHeader*>( current_ );
+			chunk->bytes = chunk_bytes;
+			current_ = chunk;
+			cursor_ = reinterpret_cast<std::byte*>( chunk + 1 );
+			limit_ = reinterpret_cast<std::byte*>( chunk ) + chunk_bytes;
+			reserved_bytes_ += chunk_bytes;
+			++chunk_count_;
+		}
+
+		void release_current_chunk() noexcept
+		{
+			auto* chunk = static_cast<ChunkHeader*>( current_ );
+			current_ = chunk->previous;
+			reserved_bytes_ -= chunk->bytes;
+			--chunk_count_;
+			allocator_.deallocate( chunk, chunk->bytes, CHUNK_ALIGNMENT );
+
+			if ( auto* previous = static_cast<ChunkHeader*>( current_ ) )
+			{
+				// 前一个 chunk 的切分位置由随后的 rewind 恢复 / The previous chunk's bump position is restored by the rewind that follows
+				cursor_ = limit_ = reinterpret_cast<std::byte*>( previous ) + previous->bytes;
+			}
+			else
+			{
+				cursor_ = limit_ = nullptr;
+				used_bytes_ = 0;
+			}
+		}
+
+		InterfaceAllocator& allocator_;
+		void*				current_ = nullptr;	 //!< 最新的 chunk（ChunkHeader）/ Newest chunk (a ChunkHeader)
+		std::byte*			cursor_ = nullptr;	 //!< 下一个空闲字节 / Next free byte
+		std::byte*			limit_ = nullptr;	 //!< 当前 chunk 末尾 / End of the current chunk
+		std::size_t			next_chunk_bytes_;	 //!< 下一个 chunk 的大小 / Size of the next chunk
+		std::size_t			used_bytes_ = 0;
+		std::size_t			reserved_bytes_ = 0;
+		std::size_t			chunk_count_ = 0;
+	};
+
+	/// @brief 作用域回卷：离开作用域时回到进入时的位置，可嵌套 / Scoped rewind: goes back to the entry position when the scope ends; nests
+	class ScopedArena
+	{
+	public:
+		explicit ScopedArena( Arena& arena ) noexcept : arena_( arena ), entry_( arena.checkpoint() ) {}
+		~ScopedArena()
+		{
+			arena_.rewind( entry_ );
+		}
+
+		ScopedArena( const ScopedArena& ) = delete;
+		ScopedArena& operator=( const ScopedArena& ) = delete;
+
+		Arena& arena() noexcept
+		{
+			return arena_;
+		}
+
+	private:
+		Arena&			  arena_;
+		Arena::Checkpoint entry_;
+	};
+
+	/// @brief 使用 Arena 的 STL 分配器，释放为空操作 / STL allocator over an Arena; deallocation is a no-op
+	/// @tparam Type 要分配的元素类型 / Type of elements to allocate
+	template <typename Type>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = Type;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = ArenaAllocator<U>;
+		};
+
+		/// @brief 容器随赋值与交换带走 arena / Containers carry their arena along on assignment and swap
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		explicit ArenaAllocator( Arena& arena ) noexcept : arena_( &arena ) {}
+		template <typename U>
+		ArenaAllocator( const ArenaAllocator<U>& other ) noexcept : arena_( other.arena_ )
+		{
+		}
+
+		Type* allocate( size_type count )
+		{
+			if ( count > std::numeric_limits<size_type>::max() / sizeof( Type ) )
+				throw std::bad_alloc();
+			return static_cast<Type*>( arena_->allocate( count * sizeof( Type ), alignof( Type ) ) );
+		}
+
+		void deallocate( Type*, size_type ) noexcept {}
+
+		template <typename U>
+		bool operator==( const ArenaAllocator<U>& other ) const noexcept
+		{
+			return arena_ == other.arena_;
+		}
+		template <typename U>
+		bool operator!=( const ArenaAllocator<U>& other ) const noexcept
+		{
+			return arena_ != other.arena_;
+		}
+
+	private:
+		template <typename U>
+		friend class ArenaAllocator;
+
+		Arena* arena_;
+	};
+}  // namespace os_memory::allocator
+
+#endif	// ARENA_HPP
@@ -0,0 +1,939 @@
+/**
+ * @file benchmark.cpp
+ * @brief 分配器基准套件 / Allocator benchmark suite
+ *
+ * @details
+ * 对 malloc、SystemAllocator 与 PoolAllocator 运行同一组负载，报告吞吐、延迟分位数、RSS 与线程扩展曲线：
+ * Runs the same workloads against malloc, SystemAllocator and PoolAllocator and reports throughput, latency
+ * percentiles, RSS and thread-scaling curves:
+ * 1. fixed_churn_N：尺寸 N 的定长分配/释放循环 / fixed-size churn of N-byte blocks;
+ * 2. random_mix：跨 Small/Medium/Large/Huge 四层的随机尺寸 / random sizes across the Small/Medium/Large/Huge tiers;
+ * 3. producer_consumer：生产者分配，消费者在另一线程释放 / producers allocate, consumers free on another thread;
+ * 4. larson：每轮结束把存活块交给另一线程继续替换 / live blocks are handed to another thread after every round (Larson);
+ * 5. xmalloc：成批分配，由任意取到该批的线程释放 / batches are freed by whichever thread picks them up (xmalloc-test);
+ * 6. aligned：随机对齐的定长窗口循环 / churn with random alignments.
+ *
+ * 构建 / Build
+ *   Windows: AllocationMemoryPoolBenchmark.vcxproj（与演示程序同一解决方案 / in the same solution as the demo)
+ *   Linux:   g++ -std=c++20 -O2 -pthread benchmark.cpp memory_pool.cpp -latomic -o allocator_benchmark
+ *
+ * 用法 / Usage
+ *   allocator_benchmark [--threads 1,2,4,8] [--operations N] [--repetitions N] [--seed N]
+ *                       [--allocators malloc,system,pool] [--workloads fixed_churn,random_mix,...]
+ *                       [--churn-sizes 16,64,...|all] [--sample-interval N] [--json FILE]
+ *
+ * 同一 seed 下每个线程的操作序列是确定的；每个组合重复 --repetitions 次并报告吞吐居中的一次，
+ * JSON 输出的键固定，可直接与上一次运行逐项比较。
+ * With the same seed every thread's operation sequence is deterministic; each combination runs --repetitions times
+ * and the run with the median throughput is reported. The JSON keys are fixed, so two runs can be compared item by item.
+ *
+ * @note SystemAllocator 不是线程安全的，基准用一把互斥锁串行化它；它每次分配都映射页，建议减少 --operations 或跳过。
+ *       SystemAllocator is not thread-safe, so the benchmark serialises it behind one mutex; it maps pages on every
+ *       allocation, so lower --operations or leave it out for long sweeps.
+ */
+
+#include "memory_allocators.hpp"
+
+#if defined( _WIN32 )
+#include <psapi.h>
+#elif defined( __linux__ )
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t DEFAULT_ALIGNMENT_BYTES = sizeof( void* );  //!< 与 InterfaceAllocator 默认一致 / Same default as InterfaceAllocator
+	constexpr std::size_t CHURN_WINDOW = 64;						   //!< 定长与对齐循环的存活块数 / Live blocks of the churn loops
+	constexpr std::size_t MIX_SLOTS = 256;							   //!< random_mix 每线程存活块数 / Live blocks per random_mix thread
+	constexpr std::size_t QUEUE_CAPACITY = 1024;					   //!< 生产者/消费者环形队列容量 / Producer/consumer ring capacity
+	constexpr std::size_t LARSON_SLOTS = 1000;						   //!< larson 每线程存活块数 / Live blocks per larson thread
+	constexpr std::size_t LARSON_ROUNDS = 10;						   //!< larson 交接轮数 / larson hand-over rounds
+	constexpr std::size_t XMALLOC_BATCH = 64;						   //!< xmalloc 每批块数 / Blocks per xmalloc batch
+
+	// =========================== 随机数与计时 / Randomness and timing ===========================
+
+	/// @brief xorshift64*：每线程独立、可复现 / xorshift64*: per thread and reproducible
+	struct Random
+	{
+		std::uint64_t state;
+
+		explicit Random( std::uint64_t seed ) : state( seed * 0x9E3779B97F4A7C15ull + 0x2545F4914F6CDD1Dull ) {}
+
+		std::uint64_t next()
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1Dull;
+		}
+
+		/// @brief [0, bound) 内均匀 / Uniform in [0, bound)
+		std::size_t below( std::size_t bound )
+		{
+			return static_cast<std::size_t>( next() % bound );
+		}
+
+		/// @brief [minimum, maximum] 内对数均匀：每个数量级被抽中的概率相同 / Log-uniform in [minimum, maximum]: every order of magnitude is equally likely
+		std::size_t log_uniform( std::size_t minimum, std::size_t maximum )
+		{
+			const int		  low_bits = std::bit_width( minimum ) - 1;
+			const int		  high_bits = std::bit_width( maximum ) - 1;
+			const int		  bits = low_bits + static_cast<int>( below( static_cast<std::size_t>( high_bits - low_bits + 1 ) ) );
+			const std::size_t base = std::size_t( 1 ) << bits;
+			return std::clamp<std::size_t>( base + below( base ), minimum, maximum );
+		}
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	std::uint64_t elapsed_nanoseconds( Clock::time_point start, Clock::time_point end )
+	{
+		return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+	}
+
+	/**
+	 * @brief 对数-线性延迟直方图：每个 2 的幂分 16 格，相对误差不超过 6.25%
+	 *        Log-linear latency histogram: 16 cells per power of two, relative error at most 6.25%
+	 */
+	class LatencyHistogram
+	{
+	public:
+		void record( std::uint64_t nanoseconds )
+		{
+			++counts[ index_of( nanoseconds ) ];
+			++total;
+		}
+
+		void merge( const LatencyHistogram& other )
+		{
+			for ( std::size_t i = 0; i < CELL_COUNT; ++i )
+				counts[ i ] += other.counts[ i ];
+			total += other.total;
+		}
+
+		/// @brief 分位数（格上界）/ Percentile, reported as the cell's upper bound
+		std::uint64_t percentile( double fraction ) const
+		{
+			if ( total == 0 )
+				return 0;
+			const std::uint64_t rank = std::max<std::uint64_t>( 1, static_cast<std::uint64_t>( fraction * static_cast<double>( total ) + 0.5 ) );
+			std::uint64_t		seen = 0;
+			for ( std::size_t i = 0; i < CELL_COUNT; ++i )
+			{
+				seen += counts[ i ];
+				if ( seen >= rank )
+					return upper_bound_of( i );
+			}
+			return upper_bound_of( CELL_COUNT - 1 );
+		}
+
+		std::uint64_t samples() const
+		{
+			return total;
+		}
+
+	private:
+		static constexpr int		 SUB_CELL_BITS = 4;
+		static constexpr std::size_t SUB_CELLS = std::size_t( 1 ) << SUB_CELL_BITS;
+		static constexpr std::size_t CELL_COUNT = 64 * SUB_CELLS;
+
+		static std::size_t index_of( std::uint64_t value )
+		{
+			if ( value < SUB_CELLS )
+				return static_cast<std::size_t>( value );
+			const int shift = std::bit_width( value ) - 1 - SUB_CELL_BITS;
+			return static_cast<std::size_t>( shift + 1 ) * SUB_CELLS + static_cast<std::size_t>( ( value >> shift ) - SUB_CELLS );
+		}
+
+		static std::uint64_t upper_bound_of( std::size_t index )
+		{
+			if ( index < SUB_CELLS )
+				return index;
+			const int shift = static_cast<int>( index / SUB_CELLS ) - 1;
+			return ( ( SUB_CELLS + index % SUB_CELLS + 1 ) << shift ) - 1;
+		}
+
+		std::array<std::uint64_t, CELL_COUNT> counts {};
+		std::uint64_t						  total = 0;
+	};
+
+	/// @brief 进程常驻内存 / Resident set size of the process
+	std::size_t resident_set_bytes()
+	{
+#if defined( _WIN32 )
+		PROCESS_MEMORY_COUNTERS counters {};
+		if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+			return static_cast<std::size_t>( counters.WorkingSetSize );
+		return 0;
+#elif defined( __linux__ )
+		long		  total_pages = 0;
+		long		  resident_pages = 0;
+		std::FILE*	  statm = std::fopen( "/proc/self/statm", "r" );
+		if ( statm )
+		{
+			if ( std::fscanf( statm, "%ld %ld", &total_pages, &resident_pages ) != 2 )
+				resident_pages = 0;
+			std::fclose( statm );
+		}
+		return static_cast<std::size_t>( resident_pages ) * static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+#else
+		return 0;
+#endif
+	}
+
+	// =========================== 被测分配器 / Allocators under test ===========================
+
+	/// @brief 基准使用的最小分配接口 / Minimal allocation interface used by the benchmark
+	class BenchmarkAllocator
+	{
+	public:
+		virtual ~BenchmarkAllocator() = default;
+		virtual const char* name() const = 0;
+		virtual void*		allocate( std::size_t bytes, std::size_t alignment ) = 0;
+		virtual void		deallocate( void* pointer, std::size_t bytes, std::size_t alignment ) = 0;
+	};
+
+	/// @brief C 运行库 malloc；超过基本对齐时走平台的对齐分配 / The C runtime's malloc; alignments above the fundamental one use the platform's aligned allocation
+	class MallocAllocator final : public BenchmarkAllocator
+	{
+	public:
+		const char* name() const override
+		{
+			return "malloc";
+		}
+
+		void* allocate( std::size_t bytes, std::size_t alignment ) override
+		{
+			void* pointer = nullptr;
+			if ( alignment <= alignof( std::max_align_t ) )
+				pointer = std::malloc( bytes );
+			else
+			{
+#if defined( _WIN32 )
+				pointer = _aligned_malloc( bytes, alignment );
+#else
+				if ( posix_memalign( &pointer, alignment, bytes ) != 0 )
+					pointer = nullptr;
+#endif
+			}
+			if ( !pointer )
+				throw std::bad_alloc();
+			return pointer;
+		}
+
+		void deallocate( void* pointer, std::size_t bytes, std::size_t alignment ) override
+		{
+			( void )bytes;
+#if defined( _WIN32 )
+			if ( alignment > alignof( std::max_align_t ) )
+			{
+				_aligned_free( pointer );
+				return;
+			}
+#else
+			( void )alignment;
+#endif
+			std::free( pointer );
+		}
+	};
+
+	/**
+	 * @brief 经 InterfaceAllocator 调用仓库内的分配器 / Drive one of this repository's allocators through InterfaceAllocator
+	 * @note serialise 为 true 时所有调用持同一把锁 / With serialise set, every call holds one lock
+	 */
+	template <typename AllocatorType>
+	class InterfaceBenchmarkAllocator final : public BenchmarkAllocator
+	{
+	public:
+		InterfaceBenchmarkAllocator( const char* display_name, bool serialise ) : display_name_( display_name ), serialise_( serialise ) {}
+
+		const char* name() const override
+		{
+			return display_name_;
+		}
+
+		void* allocate( std::size_t bytes, std::size_t alignment ) override
+		{
+			if ( !serialise_ )
+				return allocator_.allocate( bytes, alignment );
+			std::lock_guard<std::mutex> lock( mutex_ );
+			return allocator_.allocate( bytes, alignment );
+		}
+
+		void deallocate( void* pointer, std::size_t bytes, std::size_t alignment ) override
+		{
+			if ( !serialise_ )
+			{
+				allocator_.deallocate( pointer, bytes, alignment );
+				return;
+			}
+			std::lock_guard<std::mutex> lock( mutex_ );
+			allocator_.deallocate( pointer, bytes, alignment );
+		}
+
+	private:
+		AllocatorType allocator_;
+		const char*	  display_name_;
+		bool		  serialise_;
+		std::mutex	  mutex_;
+	};
+
+	// =========================== 运行与测量 / Running and measuring ===========================
+
+	struct Options
+	{
+		std::vector<std::size_t> thread_counts;
+		std::vector<std::string> allocators { "malloc", "system", "pool" };
+		std::vector<std::string> workloads { "fixed_churn", "random_mix", "producer_consumer", "larson", "xmalloc", "aligned" };
+		std::vector<std::size_t> churn_sizes { 16, 64, 256, 944, 4096, 32768, 262144 };
+		std::size_t				 operations = 100000;  //!< 每线程分配次数 / Allocations per thread
+		std::size_t				 repetitions = 3;
+		std::size_t				 sample_interval = 8;  //!< 每隔多少次操作计时一次 / Time one operation out of this many
+		std::uint64_t			 seed = 1;
+		std::string				 json_path;
+	};
+
+	/**
+	 * @brief 单个线程的分配入口：计数并按间隔采样延迟 / A thread's allocation entry point: counts operations and samples latency at an interval
+	 * @note 每个块写入首字节，避免测到从未触碰的映射 / The first byte of every block is written so untouched mappings are not what gets measured
+	 */
+	struct ThreadContext
+	{
+		BenchmarkAllocator& allocator;
+		Random				random;
+		std::size_t			sample_interval;
+		std::size_t			allocate_countdown;
+		std::size_t			free_countdown;	 //!< 与分配分开计数，交替的负载也能采到两种操作 / Counted apart from allocations so alternating workloads sample both
+		std::uint64_t		operations = 0;
+		LatencyHistogram	allocate_latency;
+		LatencyHistogram	free_latency;
+		Clock::time_point	start_time;
+		Clock::time_point	end_time;
+
+		ThreadContext( BenchmarkAllocator& allocator, std::uint64_t seed, std::size_t sample_interval )
+			: allocator( allocator ), random( seed ), sample_interval( std::max<std::size_t>( 1, sample_interval ) ), allocate_countdown( this->sample_interval ), free_countdown( this->sample_interval )
+		{
+		}
+
+		void* allocate( std::size_t bytes, std::size_t alignment = DEFAULT_ALIGNMENT_BYTES )
+		{
+			++operations;
+			void* pointer;
+			if ( --allocate_countdown != 0 )
+				pointer = allocator.allocate( bytes, alignment );
+			else
+			{
+				allocate_countdown = sample_interval;
+				const Clock::time_point start = Clock::now();
+				pointer = allocator.allocate( bytes, alignment );
+				allocate_latency.record( elapsed_nanoseconds( start, Clock::now() ) );
+			}
+			*static_cast<volatile char*>( pointer ) = 1;
+			return pointer;
+		}
+
+		void deallocate( void* pointer, std::size_t bytes, std::size_t alignment = DEFAULT_ALIGNMENT_BYTES )
+		{
+			++operations;
+			if ( --free_countdown != 0 )
+			{
+				allocator.deallocate( pointer, bytes, alignment );
+				return;
+			}
+			free_countdown = sample_interval;
+			const Clock::time_point start = Clock::now();
+			allocator.deallocate( pointer, bytes, alignment );
+			free_latency.record( elapsed_nanoseconds( start, Clock::now() ) );
+		}
+	};
+
+	struct Measurement
+	{
+		std::string		 workload;
+		std::string		 allocator;
+		std::size_t		 threads = 0;
+		std::size_t		 block_bytes = 0;  //!< 仅 fixed_churn / fixed_churn only
+		double			 seconds = 0.0;
+		std::uint64_t	 operations = 0;
+		LatencyHistogram allocate_latency;
+		LatencyHistogram free_latency;
+		std::size_t		 rss_before_bytes = 0;
+		std::size_t		 rss_peak_bytes = 0;
+		std::size_t		 rss_after_bytes = 0;
+		double			 scaling = 1.0;	 //!< 相对最少线程数的吞吐倍数 / Throughput relative to the smallest thread count
+
+		double operations_per_second() const
+		{
+			return seconds > 0.0 ? static_cast<double>( operations ) / seconds : 0.0;
+		}
+	};
+
+	/**
+	 * @brief 启动 thread_count 个线程同时执行 body，测墙钟时间并旁路采样 RSS
+	 *        Start thread_count threads that run body together, timing the wall clock while a side thread samples RSS
+	 * @note 墙钟取最早开始到最晚结束，由各线程自己打点，主线程被调度走也不影响
+	 *       Wall time spans the earliest start to the latest end as stamped by the workers, so a descheduled main thread does not skew it
+	 * @param body  void(ThreadContext&, std::size_t thread_index)
+	 */
+	template <typename Body>
+	Measurement run_threads( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options, Body&& body )
+	{
+		std::vector<std::unique_ptr<ThreadContext>> contexts;
+		for ( std::size_t i = 0; i < thread_count; ++i )
+			contexts.push_back( std::make_unique<ThreadContext>( allocator, options.seed * 1000003 + i, options.sample_interval ) );
+
+		Measurement measurement;
+		measurement.allocator = allocator.name();
+		measurement.threads = thread_count;
+		measurement.rss_before_bytes = resident_set_bytes();
+
+		std::atomic<bool>		 running { true };
+		std::atomic<std::size_t> peak { measurement.rss_before_bytes };
+		std::thread				 monitor( [ &running, &peak ]() {
+			while ( running.load( std::memory_order_relaxed ) )
+			{
+				peak.store( std::max( peak.load( std::memory_order_relaxed ), resident_set_bytes() ), std::memory_order_relaxed );
+				std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+			}
+		} );
+
+		// 全部线程就绪后同时开始 / Every thread starts together once all are ready
+		std::barrier			 start_line( static_cast<std::ptrdiff_t>( thread_count + 1 ) );
+		std::vector<std::thread> threads;
+		for ( std::size_t i = 0; i < thread_count; ++i )
+			threads.emplace_back( [ &, i ]() {
+				start_line.arrive_and_wait();
+				contexts[ i ]->start_time = Clock::now();
+				body( *contexts[ i ], i );
+				contexts[ i ]->end_time = Clock::now();
+			} );
+		start_line.arrive_and_wait();
+		for ( std::thread& thread : threads )
+			thread.join();
+
+		running.store( false, std::memory_order_relaxed );
+		monitor.join();
+		measurement.rss_peak_bytes = std::max( peak.load( std::memory_order_relaxed ), resident_set_bytes() );
+		measurement.rss_after_bytes = resident_set_bytes();
+
+		Clock::time_point start = contexts.front()->start_time;
+		Clock::time_point end = contexts.front()->end_time;
+		for ( const auto& context : contexts )
+		{
+			start = std::min( start, context->start_time );
+			end = std::max( end, context->end_time );
+			measurement.operations += context->operations;
+			measurement.allocate_latency.merge( context->allocate_latency );
+			measurement.free_latency.merge( context->free_latency );
+		}
+		measurement.seconds = static_cast<double>( elapsed_nanoseconds( start, end ) ) * 1e-9;
+		return measurement;
+	}
+
+	// =========================== 负载 / Workloads ===========================
+
+	/// @brief 新块替换窗口中最旧的块 / Each new block replaces the oldest one in a fixed window
+	Measurement run_fixed_churn( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options, std::size_t block_bytes )
+	{
+		Measurement measurement = run_threads( allocator, thread_count, options, [ & ]( ThreadContext& context, std::size_t ) {
+			std::array<void*, CHURN_WINDOW> window {};
+			for ( std::size_t i = 0; i < options.operations; ++i )
+			{
+				void*& slot = window[ i % CHURN_WINDOW ];
+				if ( slot )
+					context.deallocate( slot, block_bytes );
+				slot = context.allocate( block_bytes );
+			}
+			for ( void* pointer : window )
+				if ( pointer )
+					context.deallocate( pointer, block_bytes );
+		} );
+		measurement.workload = "fixed_churn_" + std::to_string( block_bytes );
+		measurement.block_bytes = block_bytes;
+		return measurement;
+	}
+
+	/**
+	 * @brief 随机替换存活块，尺寸跨四层：97% Small、2.5% Medium、0.4% Large、0.1% Huge
+	 *        Random replacement of live blocks with sizes across the four tiers: 97% Small, 2.5% Medium, 0.4% Large, 0.1% Huge
+	 */
+	Measurement run_random_mix( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options )
+	{
+		auto next_size = []( Random& random ) -> std::size_t {
+			const std::size_t draw = random.below( 1000 );
+			if ( draw < 970 )
+				return random.log_uniform( 8, 1ull << 20 );
+			if ( draw < 995 )
+				return random.log_uniform( ( 1ull << 20 ) + 1, 512ull << 20 );
+			if ( draw < 999 )
+				return random.log_uniform( ( 512ull << 20 ) + 1, 1ull << 30 );
+			return random.log_uniform( ( 1ull << 30 ) + 1, 3ull << 29 );
+		};
+
+		Measurement measurement = run_threads( allocator, thread_count, options, [ & ]( ThreadContext& context, std::size_t ) {
+			std::array<std::pair<void*, std::size_t>, MIX_SLOTS> slots {};
+			for ( std::size_t i = 0; i < options.operations; ++i )
+			{
+				auto& slot = slots[ context.random.below( MIX_SLOTS ) ];
+				if ( slot.first )
+					context.deallocate( slot.first, slot.second );
+				slot.second = next_size( context.random );
+				slot.first = context.allocate( slot.second );
+			}
+			for ( auto& [ pointer, bytes ] : slots )
+				if ( pointer )
+					context.deallocate( pointer, bytes );
+		} );
+		measurement.workload = "random_mix";
+		return measurement;
+	}
+
+	/// @brief 单生产者单消费者环形队列 / Single-producer single-consumer ring
+	struct BlockQueue
+	{
+		std::array<std::pair<void*, std::size_t>, QUEUE_CAPACITY> cells {};
+		alignas( 64 ) std::atomic<std::size_t> head { 0 };
+		alignas( 64 ) std::atomic<std::size_t> tail { 0 };
+
+		bool try_push( void* pointer, std::size_t bytes )
+		{
+			const std::size_t position = tail.load( std::memory_order_relaxed );
+			if ( position - head.load( std::memory_order_acquire ) == QUEUE_CAPACITY )
+				return false;
+			cells[ position % QUEUE_CAPACITY ] = { pointer, bytes };
+			tail.store( position + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool try_pop( std::pair<void*, std::size_t>& block )
+		{
+			const std::size_t position = head.load( std::memory_order_relaxed );
+			if ( position == tail.load( std::memory_order_acquire ) )
+				return false;
+			block = cells[ position % QUEUE_CAPACITY ];
+			head.store( position + 1, std::memory_order_release );
+			return true;
+		}
+	};
+
+	/// @brief 线程两两成对：偶数号分配并入队，奇数号出队释放 / Threads pair up: even ones allocate and enqueue, odd ones dequeue and free
+	Measurement run_producer_consumer( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options )
+	{
+		const std::size_t						 pair_count = std::max<std::size_t>( 1, thread_count / 2 );
+		std::vector<std::unique_ptr<BlockQueue>> queues;
+		for ( std::size_t i = 0; i < pair_count; ++i )
+			queues.push_back( std::make_unique<BlockQueue>() );
+
+		Measurement measurement = run_threads( allocator, pair_count * 2, options, [ & ]( ThreadContext& context, std::size_t thread_index ) {
+			BlockQueue& queue = *queues[ thread_index / 2 ];
+			if ( thread_index % 2 == 0 )
+			{
+				for ( std::size_t i = 0; i < options.operations; ++i )
+				{
+					const std::size_t bytes = context.random.log_uniform( 16, 4096 );
+					void*			  pointer = context.allocate( bytes );
+					while ( !queue.try_push( pointer, bytes ) )
+						std::this_thread::yield();
+				}
+				return;
+			}
+
+			std::pair<void*, std::size_t> block;
+			for ( std::size_t received = 0; received < options.operations; )
+			{
+				if ( !queue.try_pop( block ) )
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				context.deallocate( block.first, block.second );
+				++received;
+			}
+		} );
+		measurement.workload = "producer_consumer";
+		return measurement;
+	}
+
+	/**
+	 * @brief Larson：每轮随机替换本线程持有的块，轮末把整组块交给下一个线程
+	 *        Larson: each round randomly replaces the blocks the thread holds, then the whole set moves to the next thread
+	 */
+	Measurement run_larson( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options )
+	{
+		std::vector<std::vector<std::pair<void*, std::size_t>>> sets( thread_count, std::vector<std::pair<void*, std::size_t>>( LARSON_SLOTS ) );
+		std::barrier											round_end( static_cast<std::ptrdiff_t>( thread_count ) );
+		const std::size_t										operations_per_round = std::max<std::size_t>( 1, options.operations / LARSON_ROUNDS );
+
+		Measurement measurement = run_threads( allocator, thread_count, options, [ & ]( ThreadContext& context, std::size_t thread_index ) {
+			for ( auto& slot : sets[ thread_index ] )
+			{
+				slot.second = context.random.log_uniform( 16, 512 );
+				slot.first = context.allocate( slot.second );
+			}
+			round_end.arrive_and_wait();
+
+			for ( std::size_t round = 0; round < LARSON_ROUNDS; ++round )
+			{
+				// 第 round 轮处理第 (thread_index + round) 个线程留下的块 / Round r works on the set left by thread (index + r)
+				auto& set = sets[ ( thread_index + round ) % thread_count ];
+				for ( std::size_t i = 0; i < operations_per_round; ++i )
+				{
+					auto& slot = set[ context.random.below( LARSON_SLOTS ) ];
+					context.deallocate( slot.first, slot.second );
+					slot.second = context.random.log_uniform( 16, 512 );
+					slot.first = context.allocate( slot.second );
+				}
+				round_end.arrive_and_wait();
+			}
+
+			for ( auto& slot : sets[ ( thread_index + LARSON_ROUNDS ) % thread_count ] )
+				context.deallocate( slot.first, slot.second );
+		} );
+		measurement.workload = "larson";
+		return measurement;
+	}
+
+	/// @brief xmalloc-test：成批分配后入共享栈，任意线程取出整批释放 / xmalloc-test: batches go onto a shared stack and any thread frees a whole batch
+	Measurement run_xmalloc( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options )
+	{
+		struct Batch
+		{
+			std::array<void*, XMALLOC_BATCH>		pointers;
+			std::array<std::uint32_t, XMALLOC_BATCH> sizes;
+		};
+
+		// 批描述符预先建好，共享栈不在测量中分配 / Batch descriptors are built up front so the shared stacks never allocate while measuring
+		std::vector<Batch>	batches( thread_count * 4 );
+		std::vector<Batch*> empty_batches;
+		std::vector<Batch*> full_batches;
+		empty_batches.reserve( batches.size() );
+		full_batches.reserve( batches.size() );
+		for ( Batch& batch : batches )
+			empty_batches.push_back( &batch );
+		std::mutex				 batch_mutex;
+		std::atomic<std::size_t> finished_threads { 0 };
+
+		auto take = [ & ]( std::vector<Batch*>& stack ) -> Batch* {
+			std::lock_guard<std::mutex> lock( batch_mutex );
+			if ( stack.empty() )
+				return nullptr;
+			Batch* batch = stack.back();
+			stack.pop_back();
+			return batch;
+		};
+		auto give = [ & ]( std::vector<Batch*>& stack, Batch* batch ) {
+			std::lock_guard<std::mutex> lock( batch_mutex );
+			stack.push_back( batch );
+		};
+
+		Measurement measurement = run_threads( allocator, thread_count, options, [ & ]( ThreadContext& context, std::size_t ) {
+			auto free_batch = [ & ]( Batch* batch ) {
+				for ( std::size_t i = 0; i < XMALLOC_BATCH; ++i )
+					context.deallocate( batch->pointers[ i ], batch->sizes[ i ] );
+				give( empty_batches, batch );
+			};
+
+			for ( std::size_t allocated = 0; allocated < options.operations; allocated += XMALLOC_BATCH )
+			{
+				Batch* batch = take( empty_batches );
+				while ( !batch )
+				{
+					if ( Batch* full = take( full_batches ) )
+						free_batch( full );
+					batch = take( empty_batches );
+				}
+				for ( std::size_t i = 0; i < XMALLOC_BATCH; ++i )
+				{
+					batch->sizes[ i ] = static_cast<std::uint32_t>( context.random.log_uniform( 8, 512 ) );
+					batch->pointers[ i ] = context.allocate( batch->sizes[ i ] );
+				}
+				give( full_batches, batch );
+
+				if ( Batch* full = take( full_batches ) )
+					free_batch( full );
+			}
+
+			/* 收尾：所有线程都停止入栈后再清空 / Drain: stop only once every thread has stopped pushing */
+			finished_threads.fetch_add( 1, std::memory_order_acq_rel );
+			for ( ;; )
+			{
+				if ( Batch* full = take( full_batches ) )
+					free_batch( full );
+				else if ( finished_threads.load( std::memory_order_acquire ) == thread_count )
+					break;
+				else
+					std::this_thread::yield();
+			}
+		} );
+		measurement.workload = "xmalloc";
+		return measurement;
+	}
+
+	/// @brief 随机对齐（16 B–64 KiB）与尺寸的定长窗口循环 / Churn with random alignments (16 B–64 KiB) and sizes
+	Measurement run_aligned( BenchmarkAllocator& allocator, std::size_t thread_count, const Options& options )
+	{
+		constexpr std::array<std::size_t, 6> ALIGNMENTS = { 16, 32, 64, 256, 4096, 65536 };
+
+		Measurement measurement = run_threads( allocator, thread_count, options, [ & ]( ThreadContext& context, std::size_t ) {
+			struct AlignedBlock
+			{
+				void*		pointer = nullptr;
+				std::size_t bytes = 0;
+				std::size_t alignment = 0;
+			};
+			std::array<AlignedBlock, CHURN_WINDOW> window {};
+			for ( std::size_t i = 0; i < options.operations; ++i )
+			{
+				AlignedBlock& slot = window[ i % CHURN_WINDOW ];
+				if ( slot.pointer )
+					context.deallocate( slot.pointer, slot.bytes, slot.alignment );
+				slot.bytes = context.random.log_uniform( 16, 16384 );
+				slot.alignment = ALIGNMENTS[ context.random.below( ALIGNMENTS.size() ) ];
+				slot.pointer = context.allocate( slot.bytes, slot.alignment );
+				if ( reinterpret_cast<std::uintptr_t>( slot.pointer ) % slot.alignment != 0 )
+				{
+					std::cerr << "[Benchmark] " << context.allocator.name() << " returned a misaligned pointer\n";
+					std::abort();
+				}
+			}
+			for ( const AlignedBlock& slot : window )
+				if ( slot.pointer )
+					context.deallocate( slot.pointer, slot.bytes, slot.alignment );
+		} );
+		measurement.workload = "aligned";
+		return measurement;
+	}
+
+	/// @brief 按吞吐取居中的一次 / Keep the repetition with the median throughput
+	template <typename Run>
+	Measurement run_median( std::size_t repetitions, Run&& run )
+	{
+		std::vector<Measurement> runs;
+		for ( std::size_t i = 0; i < std::max<std::size_t>( 1, repetitions ); ++i )
+			runs.push_back( run() );
+		std::sort( runs.begin(), runs.end(), []( const Measurement& left, const Measurement& right ) { return left.operations_per_second() < right.operations_per_second(); } );
+		return runs[ runs.size() / 2 ];
+	}
+
+	// =========================== 输出 / Output ===========================
+
+	void print_header()
+	{
+		std::printf( "%-22s %-8s %7s %14s %24s %24s %10s %8s\n", "workload", "alloc", "threads", "ops/s", "allocate p50/p99/p99.9", "free p50/p99/p99.9", "peak RSS", "scaling" );
+	}
+
+	void print_row( const Measurement& measurement )
+	{
+		char allocate_column[ 64 ];
+		char free_column[ 64 ];
+		std::snprintf( allocate_column, sizeof( allocate_column ), "%llu/%llu/%llu ns", static_cast<unsigned long long>( measurement.allocate_latency.percentile( 0.50 ) ),
+					   static_cast<unsigned long long>( measurement.allocate_latency.percentile( 0.99 ) ), static_cast<unsigned long long>( measurement.allocate_latency.percentile( 0.999 ) ) );
+		std::snprintf( free_column, sizeof( free_column ), "%llu/%llu/%llu ns", static_cast<unsigned long long>( measurement.free_latency.percentile( 0.50 ) ),
+					   static_cast<unsigned long long>( measurement.free_latency.percentile( 0.99 ) ), static_cast<unsigned long long>( measurement.free_latency.percentile( 0.999 ) ) );
+		std::printf( "%-22s %-8s %7zu %14.0f %24s %24s %7.1f MiB %7.2fx\n", measurement.workload.c_str(), measurement.allocator.c_str(), measurement.threads, measurement.operations_per_second(),
+					 allocate_column, free_column, static_cast<double>( measurement.rss_peak_bytes ) / ( 1 << 20 ), measurement.scaling );
+		std::fflush( stdout );
+	}
+
+	void write_latency_json( std::ostream& output, const LatencyHistogram& histogram )
+	{
+		output << "{\"samples\":" << histogram.samples() << ",\"p50\":" << histogram.percentile( 0.50 ) << ",\"p99\":" << histogram.percentile( 0.99 ) << ",\"p999\":" << histogram.percentile( 0.999 ) << "}";
+	}
+
+	void write_json( std::ostream& output, const Options& options, const std::vector<Measurement>& results )
+	{
+		output << "{\"benchmark\":\"AllocationMemoryPool\",\"seed\":" << options.seed << ",\"operations_per_thread\":" << options.operations << ",\"repetitions\":" << options.repetitions
+			   << ",\"sample_interval\":" << options.sample_interval << ",\"hardware_threads\":" << std::thread::hardware_concurrency() << ",\"results\":[";
+		for ( std::size_t i = 0; i < results.size(); ++i )
+		{
+			const Measurement& measurement = results[ i ];
+			output << ( i ? ",\n" : "\n" ) << "{\"workload\":\"" << measurement.workload << "\",\"allocator\":\"" << measurement.allocator << "\",\"threads\":" << measurement.threads
+				   << ",\"block_bytes\":" << measurement.block_bytes << ",\"operations\":" << measurement.operations << ",\"seconds\":" << measurement.seconds
+				   << ",\"operations_per_second\":" << measurement.operations_per_second() << ",\"scaling\":" << measurement.scaling << ",\"allocate_latency_ns\":";
+			write_latency_json( output, measurement.allocate_latency );
+			output << ",\"free_latency_ns\":";
+			write_latency_json( output, measurement.free_latency );
+			output << ",\"rss_before_bytes\":" << measurement.rss_before_bytes << ",\"rss_peak_bytes\":" << measurement.rss_peak_bytes << ",\"rss_after_bytes\":" << measurement.rss_after_bytes << "}";
+		}
+		output << "\n]}\n";
+	}
+
+	// =========================== 命令行 / Command line ===========================
+
+	std::vector<std::string> split_list( std::string_view text )
+	{
+		std::vector<std::string> items;
+		while ( !text.empty() )
+		{
+			const std::size_t comma = text.find( ',' );
+			if ( comma != 0 )
+				items.emplace_back( text.substr( 0, comma ) );
+			if ( comma == std::string_view::npos )
+				break;
+			text.remove_prefix( comma + 1 );
+		}
+		return items;
+	}
+
+	std::vector<std::size_t> split_numbers( std::string_view text )
+	{
+		std::vector<std::size_t> numbers;
+		for ( const std::string& item : split_list( text ) )
+			numbers.push_back( static_cast<std::size_t>( std::stoull( item ) ) );
+		return numbers;
+	}
+
+	/// @brief 默认线程数：1, 2, 4, ... 直到硬件线程数 / Default thread counts: 1, 2, 4, ... up to the hardware threads
+	std::vector<std::size_t> default_thread_counts()
+	{
+		const std::size_t		 hardware_threads = std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+		std::vector<std::size_t> counts;
+		for ( std::size_t count = 1; count < hardware_threads; count *= 2 )
+			counts.push_back( count );
+		counts.push_back( hardware_threads );
+		return counts;
+	}
+
+	bool parse_options( int argc, char** argv, Options& options )
+	{
+		for ( int i = 1; i < argc; ++i )
+		{
+			const std::string_view argument = argv[ i ];
+			if ( argument == "--help" || i + 1 >= argc )
+			{
+				std::cout << "usage: " << argv[ 0 ]
+						  << " [--threads 1,2,4] [--operations N] [--repetitions N] [--seed N] [--allocators malloc,system,pool]"
+							 " [--workloads fixed_churn,random_mix,producer_consumer,larson,xmalloc,aligned] [--churn-sizes 16,64,...|all]"
+							 " [--sample-interval N] [--json FILE]\n";
+				return false;
+			}
+
+			const std::string_view value = argv[ ++i ];
+			if ( argument == "--threads" )
+				options.thread_counts = split_numbers( value );
+			else if ( argument == "--operations" )
+				options.operations = static_cast<std::size_t>( std::stoull( std::string( value ) ) );
+			else if ( argument == "--repetitions" )
+				options.repetitions = static_cast<std::size_t>( std::stoull( std::string( value ) ) );
+			else if ( argument == "--seed" )
+				options.seed = std::stoull( std::string( value ) );
+			else if ( argument == "--allocators" )
+				options.allocators = split_list( value );
+			else if ( argument == "--workloads" )
+				options.workloads = split_list( value );
+			else if ( argument == "--churn-sizes" )
+				options.churn_sizes = value == "all" ? std::vector<std::size_t>( SmallMemoryManager::BUCKET_SIZES.begin(), SmallMemoryManager::BUCKET_SIZES.end() ) : split_numbers( value );
+			else if ( argument == "--sample-interval" )
+				options.sample_interval = static_cast<std::size_t>( std::stoull( std::string( value ) ) );
+			else if ( argument == "--json" )
+				options.json_path = value;
+			else
+			{
+				std::cerr << "[Benchmark] unknown option " << argument << "\n";
+				return false;
+			}
+		}
+		if ( options.thread_counts.empty() )
+			options.thread_counts = default_thread_counts();
+		return true;
+	}
+
+	std::unique_ptr<BenchmarkAllocator> make_allocator( std::string_view name )
+	{
+		if ( name == "malloc" )
+			return std::make_unique<MallocAllocator>();
+		if ( name == "system" )
+			return std::make_unique<InterfaceBenchmarkAllocator<os_memory::allocator::SystemAllocator>>( "system", true );
+		if ( name == "pool" )
+			return std::make_unique<InterfaceBenchmarkAllocator<os_memory::allocator::PoolAllocator>>( "pool", false );
+		return nullptr;
+	}
+}  // namespace
+
+int main( int argc, char** argv )
+{
+	Options options;
+	if ( !parse_options( argc, argv, options ) )
+		return 1;
+
+	std::vector<std::unique_ptr<BenchmarkAllocator>> allocators;
+	for ( const std::string& name : options.allocators )
+	{
+		if ( auto allocator = make_allocator( name ) )
+			allocators.push_back( std::move( allocator ) );
+		else
+			std::cerr << "[Benchmark] unknown allocator " << name << "\n";
+	}
+
+	std::vector<Measurement> results;
+	print_header();
+	auto run_series = [ & ]( auto&& run_one ) {
+		for ( auto& allocator : allocators )
+		{
+			double baseline = 0.0;
+			for ( std::size_t thread_count : options.thread_counts )
+			{
+				Measurement measurement = run_median( options.repetitions, [ & ]() { return run_one( *allocator, thread_count ); } );
+				if ( baseline == 0.0 )
+					baseline = measurement.operations_per_second();
+				measurement.scaling = baseline > 0.0 ? measurement.operations_per_second() / baseline : 0.0;
+				print_row( measurement );
+				results.push_back( std::move( measurement ) );
+			}
+		}
+	};
+
+	for ( const std::string& workload : options.workloads )
+	{
+		if ( workload == "fixed_churn" )
+		{
+			for ( std::size_t block_bytes : options.churn_sizes )
+				run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_fixed_churn( allocator, threads, options, block_bytes ); } );
+		}
+		else if ( workload == "random_mix" )
+			run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_random_mix( allocator, threads, options ); } );
+		else if ( workload == "producer_consumer" )
+			run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_producer_consumer( allocator, threads, options ); } );
+		else if ( workload == "larson" )
+			run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_larson( allocator, threads, options ); } );
+		else if ( workload == "xmalloc" )
+			run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_xmalloc( allocator, threads, options ); } );
+		else if ( workload == "aligned" )
+			run_series( [ & ]( BenchmarkAllocator& allocator, std::size_t threads ) { return run_aligned( allocator, threads, options ); } );
+		else
+			std::cerr << "[Benchmark] unknown workload " << workload << "\n";
+	}
+
+	if ( !options.json_path.empty() )
+	{
+		std::ofstream json_file( options.json_path );
+		write_json( json_file, options, results );
+		if ( !json_file )
+			std::cerr << "[Benchmark] could not write " << options.json_path << "\n";
+	}
+
+	// 先销毁池再销毁 SystemAllocator：两者的泄漏检查共用进程级映射计数 / Destroy the pool before SystemAllocator: both leak checks read the process-wide mapping counter
+	for ( auto& allocator : allocators )
+		if ( std::string_view( allocator->name() ) == "pool" )
+			allocator.reset();
+	allocators.clear();
+	return 0;
+}
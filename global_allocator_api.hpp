@@ -79,12 +79,123 @@ namespace os_memory::api
 			return get()->current_memory_usage();
 		}
 
+		/**
+		 * @brief 分配并清零 count 个 size 字节的元素，新映射的页不再 memset / Allocate count zero-filled elements of size bytes; fresh pages skip the memset
+		 * @see InterfaceAllocator::allocate_zeroed
+		 */
+		static void* allocate_zeroed( size_t count, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			return get()->allocate_zeroed( count, size, alignment, file, line, nothrow );
+		}
+
+		/**
+		 * @brief 从指定 NUMA 节点分配，用于固定在节点上的缓冲区 / Allocate from a given NUMA node, for buffers pinned to it
+		 * @see InterfaceAllocator::allocate_on_node
+		 */
+		static void* allocate_on_node( size_t numa_node, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			return get()->allocate_on_node( numa_node, size, alignment, file, line, nothrow );
+		}
+
+		/**
+		 * @brief NUMA 节点数 / Number of NUMA nodes
+		 */
+		static size_t numa_node_count()
+		{
+			return os_memory::numa_node_count();
+		}
+
+		/**
+		 * @brief 批量分配同尺寸内存 / Allocate a batch of same-size blocks
+		 * @see InterfaceAllocator::allocate_batch
+		 */
+		static size_t allocate_batch( size_t size, size_t count, void** out_pointers, const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			return get()->allocate_batch( size, count, out_pointers, file, line, nothrow );
+		}
+
+		/**
+		 * @brief 批量释放内存 / Free a batch of blocks
+		 * @see InterfaceAllocator::deallocate_batch
+		 */
+		static void deallocate_batch( void* const* pointers, size_t count )
+		{
+			get()->deallocate_batch( pointers, count );
+		}
+
+		/**
+		 * @brief 把空闲的缓存内存归还操作系统 / Return idle cached memory to the OS
+		 * @return 归还的字节数 / bytes returned
+		 */
+		static size_t trim()
+		{
+			return get()->trim();
+		}
+
+		/**
+		 * @brief 配置后台归还策略 / Configure background purging
+		 * @param idle_period  空闲多久后归还 / how long memory must stay idle before it is returned
+		 * @param interval     扫描间隔，0 表示关闭 / scan interval, 0 disables it
+		 */
+		static void set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval )
+		{
+			get()->set_purge_policy( idle_period, interval );
+		}
+
+		/**
+		 * @brief 设置软/硬内存上限，0 表示不限 / Set the soft and hard memory limits, 0 meaning none
+		 * @see MemoryPool::set_memory_limit
+		 */
+		static void set_memory_limit( size_t soft_limit_bytes, size_t hard_limit_bytes )
+		{
+			get()->set_memory_limit( soft_limit_bytes, hard_limit_bytes );
+		}
+
+		/// @brief 登记压力回调，回调可在任意分配线程上被调用 / Register a pressure callback; it may run on any allocating thread
+		static bool add_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+		{
+			return get()->add_memory_pressure_callback( callback, context );
+		}
+
+		static void remove_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+		{
+			get()->remove_memory_pressure_callback( callback, context );
+		}
+
+		/// @brief 立即执行一轮压力回收 / Run one pressure pass now
+		static size_t relieve_memory_pressure()
+		{
+			return get()->relieve_memory_pressure();
+		}
+
+		/**
+		 * @brief 启动时预热，消除首次分配的映射与缺页延迟 / Pre-warm at startup to take first-allocation mapping and page-fault latency off the hot path
+		 * @see InterfaceAllocator::reserve
+		 */
+		static size_t reserve( const ReserveProfile& profile )
+		{
+			return get()->reserve( profile );
+		}
+
+		/**
+		 * @brief 为 Medium/Large/Huge 层的新映射选择页大小 / Choose the page size of new Medium/Large/Huge mappings
+		 * @note 显式巨页不可用时自动回退 / Explicit huge pages fall back automatically when unavailable
+		 */
+		static void set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy )
+		{
+			get()->set_page_policy( medium_policy, large_policy, huge_policy );
+		}
+
+		/// @see InterfaceAllocator::statistics
+		static MemoryPoolStatistics statistics()
+		{
+			return get()->statistics();
+		}
+
 	private:
-		static InterfaceAllocator* instance_;  //!< 全局分配器实例指针 / pointer to allocator instance
+		static inline InterfaceAllocator* instance_ = nullptr;	//!< 全局分配器实例指针（inline：可被多个翻译单元包含）/ pointer to allocator instance (inline, so several translation units may include this header)
 	};
 
-	InterfaceAllocator* GlobalAllocator::instance_ = nullptr;
-
 	/// @brief 全局分配接口函数：分配内存 / Global allocation function
 	/// @see InterfaceAllocator::allocate
 	inline void* my_allocate( size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, int line = 0, bool nothrow = false )
@@ -92,6 +203,13 @@ namespace os_memory::api
 		return GlobalAllocator::get()->allocate( size, alignment, file, line, nothrow );
 	}
 
+	/// @brief 全局清零分配接口函数 / Global zero-filled allocation function
+	/// @see InterfaceAllocator::allocate_zeroed
+	inline void* my_allocate_zeroed( size_t count, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, int line = 0, bool nothrow = false )
+	{
+		return GlobalAllocator::get()->allocate_zeroed( count, size, alignment, file, line, nothrow );
+	}
+
 	/// @brief 全局释放接口函数：释放内存 / Global deallocation function
 	/// @see InterfaceAllocator::deallocate
 	inline void my_deallocate( void* pointer )
@@ -99,12 +217,42 @@ namespace os_memory::api
 		GlobalAllocator::get()->deallocate( pointer );
 	}
 
+	/// @brief 全局带尺寸释放接口函数：不读块头定位层级 / Global sized deallocation: locates the tier without reading headers
+	/// @see InterfaceAllocator::deallocate
+	inline void my_deallocate( void* pointer, size_t size, size_t alignment = sizeof( void* ) )
+	{
+		GlobalAllocator::get()->deallocate( pointer, size, alignment );
+	}
+
+	/// @brief 全局可用字节数查询 / Global usable-size query
+	/// @see InterfaceAllocator::usable_size
+	inline size_t my_usable_size( void* pointer )
+	{
+		return GlobalAllocator::get()->usable_size( pointer );
+	}
+
+	/// @brief 全局调整大小接口函数：原地扩展或搬迁 / Global reallocation function: grows in place or moves
+	/// @see InterfaceAllocator::reallocate
+	inline void* my_reallocate( void* pointer, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, int line = 0, bool nothrow = false )
+	{
+		return GlobalAllocator::get()->reallocate( pointer, size, alignment, file, line, nothrow );
+	}
+
 	/// @brief 启用内存泄漏跟踪 / Enable memory leak tracking
 	inline void enable_memory_tracking( bool detailed = false )
 	{
 		GlobalAllocator::get()->enable_leak_detection( detailed );
 	}
 
+	/**
+	 * @brief 设置泄漏跟踪的采样间隔 / Set the leak-tracking sampling interval
+	 * @param mean_bytes_between_samples 平均每多少字节记录一次，0 表示全量 / mean bytes between samples, 0 records every allocation
+	 */
+	inline void set_memory_tracking_sampling_rate( size_t mean_bytes_between_samples )
+	{
+		MemoryTracker::instance().set_sampling_rate( mean_bytes_between_samples );
+	}
+
 	/// @brief 禁用内存泄漏跟踪 / Disable memory leak tracking
 	inline void disable_memory_tracking()
 	{
@@ -123,6 +271,56 @@ namespace os_memory::api
 	{
 		return MemoryTracker::instance().current_memory_usage();
 	}
+
+	/**
+	 * @brief 启动采样堆剖析 / Start the sampling heap profiler
+	 * @param mean_bytes_between_samples 平均每多少字节抓一次调用栈 / mean bytes between two captured stacks
+	 */
+	inline void start_heap_profiling( size_t mean_bytes_between_samples = HeapProfiler::DEFAULT_SAMPLING_RATE )
+	{
+		HeapProfiler::instance().start( mean_bytes_between_samples );
+	}
+
+	/// @brief 停止采样堆剖析 / Stop the sampling heap profiler
+	inline void stop_heap_profiling()
+	{
+		HeapProfiler::instance().stop();
+	}
+
+	/// @brief 导出 pprof 堆文件 / Write a pprof heap profile
+	inline void write_heap_profile( std::ostream& output_stream )
+	{
+		HeapProfiler::instance().write_pprof( output_stream );
+	}
+
+	/// @brief 导出折叠栈（火焰图输入）/ Write collapsed stacks (flame graph input)
+	inline void write_heap_profile_collapsed( std::ostream& output_stream, HeapProfiler::View view = HeapProfiler::View::LiveBytes )
+	{
+		HeapProfiler::instance().write_collapsed( output_stream, view );
+	}
+
+	/// @brief 导出分层统计（JSON）/ Write the per-tier statistics as JSON
+	inline void write_memory_statistics_json( std::ostream& output_stream )
+	{
+		GlobalAllocator::statistics().write_json( output_stream );
+	}
+
+	/// @brief 导出分层统计（Prometheus 文本格式）/ Write the per-tier statistics in the Prometheus text format
+	inline void write_memory_statistics_prometheus( std::ostream& output_stream, std::string_view prefix = "memory_pool" )
+	{
+		GlobalAllocator::statistics().write_prometheus( output_stream, prefix );
+	}
+
+	/**
+	 * @brief 由本进程记录的尺寸直方图生成并写出调优的策略头文件 / Generate a tuned policy header from the size histogram recorded in this process
+	 * @note 先调用 SizeHistogramRecorder::instance().start() 并运行代表性负载 / Call SizeHistogramRecorder::instance().start() and run a representative workload first
+	 * @throw std::invalid_argument 见 generate_size_classes / see generate_size_classes
+	 */
+	inline void write_tuned_size_class_policy( std::ostream& output_stream, const os_memory::memory_pool::SizeClassGeneratorOptions& options = {}, std::string_view policy_name = "TunedSizeClassPolicy" )
+	{
+		using namespace os_memory::memory_pool;
+		write_size_class_policy( output_stream, generate_size_classes( SizeHistogramRecorder::instance().snapshot(), options ), policy_name );
+	}
 }
 
 // 带调试信息的分配宏
@@ -131,11 +329,19 @@ namespace os_memory::api
 	#define ALLOCATE_NOTHROW(size) os_memory::api::my_allocate(size, 0, __FILE__, __LINE__, true)
 	#define ALLOCATE_ALIGNED(size, alignment) os_memory::api::my_allocate(size, alignment, __FILE__, __LINE__, false)
 	#define ALLOCATE_ALIGNED_NOTHROW(size, alignment) os_memory::api::my_allocate(size, alignment, __FILE__, __LINE__, true)
+	#define ALLOCATE_ZEROED(count, size) os_memory::api::my_allocate_zeroed(count, size, 0, __FILE__, __LINE__, false)
+	#define ALLOCATE_ZEROED_NOTHROW(count, size) os_memory::api::my_allocate_zeroed(count, size, 0, __FILE__, __LINE__, true)
+	#define REALLOCATE(pointer, size) os_memory::api::my_reallocate(pointer, size, 0, __FILE__, __LINE__, false)
+	#define REALLOCATE_NOTHROW(pointer, size) os_memory::api::my_reallocate(pointer, size, 0, __FILE__, __LINE__, true)
 #else
 	#define ALLOCATE(size) os_memory::api::my_allocate(size)
 	#define ALLOCATE_NOTHROW(size) os_memory::api::my_allocate(size, 0, nullptr, 0, true)
 	#define ALLOCATE_ALIGNED(size, alignment) os_memory::api::my_allocate(size, alignment)
 	#define ALLOCATE_ALIGNED_NOTHROW(size, alignment) os_memory::api::my_allocate(size, alignment, nullptr, 0, true)
+	#define ALLOCATE_ZEROED(count, size) os_memory::api::my_allocate_zeroed(count, size)
+	#define ALLOCATE_ZEROED_NOTHROW(count, size) os_memory::api::my_allocate_zeroed(count, size, 0, nullptr, 0, true)
+	#define REALLOCATE(pointer, size) os_memory::api::my_reallocate(pointer, size)
+	#define REALLOCATE_NOTHROW(pointer, size) os_memory::api::my_reallocate(pointer, size, 0, nullptr, 0, true)
 #endif
 
 #ifdef _DEBUG
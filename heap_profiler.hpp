@@ -0,0 +1,604 @@
+/**
+ * @file   heap_profiler.hpp
+ * @brief  采样堆剖析器 / Sampling heap profiler
+ *
+ * @details
+ * 1. 按字节做泊松采样（平均每 N 字节一次），只有被采中的分配才抓取调用栈，未采中的分配只付出一次线程本地减法。
+ * 2. 样本按调用栈聚合为「存活字节」与「累计分配」两张表；释放经存在性计数过滤，只有被采样的指针才加锁查表。
+ * 3. 按需导出 pprof 堆文件（heap_v2，由 pprof 自行反采样）或折叠栈格式（flamegraph.pl / speedscope）。
+ * 4. 全部表为定长数组，剖析与导出过程都不向任何分配器申请内存，可以安全地挂在内存池自身的分配路径上。
+ *
+ * 1. Poisson sampling by bytes (one sample per N bytes on average): only sampled allocations capture a stack,
+ *    the rest pay a single thread-local subtraction.
+ * 2. Samples aggregate per call stack into live-byte and cumulative-allocation tables; frees are filtered by
+ *    presence counters, so only sampled pointers take a lock.
+ * 3. Dumps on demand as a pprof heap profile (heap_v2, pprof does the unsampling) or as collapsed stacks
+ *    (flamegraph.pl / speedscope).
+ * 4. Every table is a fixed-size array: neither profiling nor dumping asks any allocator for memory, so the
+ *    profiler can sit on the pool's own allocation path.
+ *
+ * 代码风格说明 / Style Notes
+ * ---------------------------------------------------------------------------
+ * 1. 彻底避免缩写：所有标识符均使用完整单词 (stack, sample, pointer...)；
+ * 2. 中英文注释并存，支持 Doxygen 文档 / Bilingual comments with Doxygen support.
+ */
+
+#pragma once
+#ifndef HEAP_PROFILER_HPP
+#define HEAP_PROFILER_HPP
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <execinfo.h>  // backtrace
+#include <dlfcn.h>	   // dladdr
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <utility>
+
+/*---------------------------------- 类 / Class -----------------------------*/
+class HeapProfiler
+{
+public:
+	static constexpr std::size_t DEFAULT_SAMPLING_RATE = 512 * 1024;  //!< 平均每 512 KiB 采样一次 / One sample per 512 KiB on average
+	static constexpr std::size_t MAX_STACK_FRAMES = 32;				  //!< 每个样本保留的栈帧数 / Frames kept per sample
+	static constexpr std::size_t SKIPPED_FRAMES = 2;				  //!< 跳过剖析器自身的栈帧 / Frames of the profiler itself to skip
+	static constexpr std::size_t STACK_TABLE_BITS = 12;				  //!< 调用栈表 2^12 槽 / Stack table holds 2^12 slots
+	static constexpr std::size_t SAMPLE_SHARD_BITS = 6;				  //!< 64 个样本分片 / 64 sample shards
+	static constexpr std::size_t SAMPLE_SLOT_BITS = 10;				  //!< 每分片 2^10 个样本槽 / 2^10 sample slots per shard
+	static constexpr std::size_t PRESENCE_BITS = 14;				  //!< 存在性计数槽位数（2^14）/ Presence counter slots (2^14)
+
+	/// @brief 折叠栈导出的取值 / Value written per collapsed stack
+	enum class View
+	{
+		LiveBytes,		 //!< 估计的存活字节 / estimated live bytes
+		AllocatedBytes,	 //!< 估计的累计分配字节 / estimated bytes allocated since the first start
+		AllocationRate	 //!< 估计的分配速率（字节/秒）/ estimated allocation rate in bytes per second
+	};
+
+	/*----------------------------- 单例接口 / Singleton ---------------------*/
+	static HeapProfiler& instance()
+	{
+		static HeapProfiler profiler_instance;
+		return profiler_instance;
+	}
+
+	/*----------------------------- 控制 / Control ---------------------------*/
+	/**
+     * @brief 开始采样 / Start sampling
+     * @param mean_bytes_between_samples 平均每多少字节采一个样本，0 或 1 表示每次分配都采样
+     *                                   mean bytes between two samples; 0 or 1 samples every allocation
+     * @note  结果跨多次 start/stop 累积 / Results accumulate across start/stop cycles
+     */
+	void start( std::size_t mean_bytes_between_samples = DEFAULT_SAMPLING_RATE )
+	{
+		sampling_rate.store( mean_bytes_between_samples > 1 ? mean_bytes_between_samples : 1, std::memory_order_relaxed );
+
+		std::int64_t unset = 0;
+		started_at_nanoseconds.compare_exchange_strong( unset, now_nanoseconds(), std::memory_order_relaxed );
+
+		// 首次 backtrace 会加载展开库并可能分配，先在锁外预热 / The first backtrace loads the unwinder and may allocate, so warm it up outside any lock
+		void* frames[ MAX_STACK_FRAMES ];
+		capture_stack( frames );
+
+		running.store( true, std::memory_order_release );
+	}
+
+	/// @brief 停止采样；已采样的指针在释放时仍会被扣除 / Stop sampling; sampled pointers are still subtracted when freed
+	void stop()
+	{
+		running.store( false, std::memory_order_release );
+	}
+
+	bool is_running() const
+	{
+		return running.load( std::memory_order_relaxed );
+	}
+
+	std::size_t get_sampling_rate() const
+	{
+		return sampling_rate.load( std::memory_order_relaxed );
+	}
+
+	/*----------------------------- 钩子 / Hooks -----------------------------*/
+	/**
+     * @brief 分配完成后调用 / Call after an allocation succeeded
+     * @note  未运行或未采中时只有一次原子读与一次线程本地减法 / When stopped or not sampled this is one atomic load and one thread-local subtraction
+     */
+	void record_allocation( void* user_pointer, std::size_t bytes )
+	{
+		if ( !running.load( std::memory_order_relaxed ) || !user_pointer )
+			return;
+
+		ThreadState& state = thread_state();
+		state.bytes_until_sample -= static_cast<std::int64_t>( bytes );
+		if ( state.bytes_until_sample > 0 )
+			return;	 // 未被采样 / Not sampled
+		sample_allocation( state, user_pointer, bytes );
+	}
+
+	/**
+     * @brief 释放之前调用（地址被复用前）/ Call before a free, while the address cannot be reused yet
+     */
+	void record_deallocation( void* user_pointer )
+	{
+		if ( live_samples.load( std::memory_order_relaxed ) == 0 || !user_pointer )
+			return;
+		if ( presence_of( user_pointer ).load( std::memory_order_relaxed ) == 0 )
+			return;	 // 从未被采样 / Never sampled
+		remove_sample( user_pointer );
+	}
+
+	/// @brief 原地调整大小后调用：按新尺寸重新计入 / Call after an in-place resize: re-counts the block at its new size
+	void record_reallocation( void* old_pointer, void* new_pointer, std::size_t bytes )
+	{
+		record_deallocation( old_pointer );
+		record_allocation( new_pointer, bytes );
+	}
+
+	/// @brief 是否还有未释放的样本 / Whether any sample is still live
+	bool has_live_samples() const
+	{
+		return live_samples.load( std::memory_order_relaxed ) != 0;
+	}
+
+	/*----------------------------- 查询 / Queries ---------------------------*/
+	/// @brief 估计的存活字节总数 / Estimated live bytes over all stacks
+	std::size_t estimated_live_bytes()
+	{
+		return sum_over_stacks( View::LiveBytes );
+	}
+
+	/// @brief 估计的累计分配字节总数 / Estimated bytes allocated over all stacks
+	std::size_t estimated_allocated_bytes()
+	{
+		return sum_over_stacks( View::AllocatedBytes );
+	}
+
+	/// @brief 因样本表满而丢弃的样本数 / Samples dropped because the sample table was full
+	std::size_t dropped_samples() const
+	{
+		return dropped_sample_count.load( std::memory_order_relaxed );
+	}
+
+	/*----------------------------- 导出 / Output ----------------------------*/
+	/**
+     * @brief 导出 pprof 堆文件（gperftools 文本格式，heap_v2）/ Write a pprof heap profile (gperftools text format, heap_v2)
+     * @details 计数为原始样本值，由 pprof 按 heap_v2/<rate> 反采样；Linux 下附带 /proc/self/maps 供符号化。
+     *          Counts are raw sample values that pprof unsamples by heap_v2/<rate>; on Linux /proc/self/maps is
+     *          appended for symbolization.
+     */
+	void write_pprof( std::ostream& output_stream = std::cerr )
+	{
+		OutputGuard guard( thread_state() );
+
+		std::lock_guard<std::mutex> lock( stack_mutex );
+
+		std::int64_t totals[ 4 ] = {};
+		for_each_stack( [ &totals ]( const StackRecord& record ) {
+			totals[ 0 ] += record.live_objects.load( std::memory_order_relaxed );
+			totals[ 1 ] += record.live_bytes.load( std::memory_order_relaxed );
+			totals[ 2 ] += record.allocated_objects.load( std::memory_order_relaxed );
+			totals[ 3 ] += record.allocated_bytes.load( std::memory_order_relaxed );
+		} );
+
+		char line[ 128 + MAX_STACK_FRAMES * 24 ];
+		int	 length = std::snprintf( line, sizeof( line ), "heap profile: %lld: %lld [%lld: %lld] @ heap_v2/%zu\n", static_cast<long long>( totals[ 0 ] ), static_cast<long long>( totals[ 1 ] ), static_cast<long long>( totals[ 2 ] ), static_cast<long long>( totals[ 3 ] ), get_sampling_rate() );
+		write_output( output_stream, line, static_cast<std::size_t>( length ) );
+
+		for_each_stack( [ &output_stream, &line ]( const StackRecord& record ) {
+			int offset = std::snprintf( line, sizeof( line ), "%lld: %lld [%lld: %lld] @", static_cast<long long>( record.live_objects.load( std::memory_order_relaxed ) ), static_cast<long long>( record.live_bytes.load( std::memory_order_relaxed ) ), static_cast<long long>( record.allocated_objects.load( std::memory_order_relaxed ) ), static_cast<long long>( record.allocated_bytes.load( std::memory_order_relaxed ) ) );
+			for ( std::size_t frame = 0; frame < record.depth; ++frame )
+				offset += std::snprintf( line + offset, sizeof( line ) - offset, " 0x%llx", static_cast<unsigned long long>( reinterpret_cast<std::uintptr_t>( record.frames[ frame ] ) ) );
+			line[ offset++ ] = '\n';
+			write_output( output_stream, line, static_cast<std::size_t>( offset ) );
+		} );
+
+#if !defined( _WIN32 )
+		write_output( output_stream, "\nMAPPED_LIBRARIES:\n", 19 );
+		const int maps_descriptor = ::open( "/proc/self/maps", O_RDONLY );
+		if ( maps_descriptor >= 0 )
+		{
+			char	chunk[ 4096 ];
+			ssize_t read_bytes = 0;
+			while ( ( read_bytes = ::read( maps_descriptor, chunk, sizeof( chunk ) ) ) > 0 )
+				write_output( output_stream, chunk, static_cast<std::size_t>( read_bytes ) );
+			::close( maps_descriptor );
+		}
+#endif
+	}
+
+	/**
+     * @brief 导出折叠栈：每行「根;...;叶 值」/ Write collapsed stacks: one "root;...;leaf value" line per stack
+     * @param view 每行的取值 / value written on each line
+     */
+	void write_collapsed( std::ostream& output_stream = std::cerr, View view = View::LiveBytes )
+	{
+		OutputGuard guard( thread_state() );
+
+		std::lock_guard<std::mutex> lock( stack_mutex );
+
+		double seconds = static_cast<double>( now_nanoseconds() - started_at_nanoseconds.load( std::memory_order_relaxed ) ) / 1e9;
+		if ( seconds <= 0.0 )
+			seconds = 1e-9;
+
+		for_each_stack( [ &output_stream, view, seconds ]( const StackRecord& record ) {
+			std::int64_t value = 0;
+			if ( view == View::LiveBytes )
+				value = record.live_weighted_bytes.load( std::memory_order_relaxed );
+			else
+				value = record.allocated_weighted_bytes.load( std::memory_order_relaxed );
+			if ( view == View::AllocationRate )
+				value = static_cast<std::int64_t>( static_cast<double>( value ) / seconds );
+			if ( value <= 0 )
+				return;
+
+			char line[ 512 ];
+			// 折叠栈以根在前，抓取的栈以叶在前 / Collapsed stacks are root first, captured stacks are leaf first
+			for ( std::size_t frame = record.depth; frame-- > 0; )
+			{
+				const std::size_t length = describe_frame( record.frames[ frame ], line, sizeof( line ) - 1 );
+				line[ length ] = frame == 0 ? ' ' : ';';
+				write_output( output_stream, line, length + 1 );
+			}
+			if ( record.depth == 0 )
+				write_output( output_stream, "[unknown] ", 10 );
+			const int length = std::snprintf( line, sizeof( line ), "%lld\n", static_cast<long long>( value ) );
+			write_output( output_stream, line, static_cast<std::size_t>( length ) );
+		} );
+	}
+
+private:
+	HeapProfiler() = default;
+	~HeapProfiler() = default;
+	HeapProfiler( const HeapProfiler& ) = delete;
+	HeapProfiler& operator=( const HeapProfiler& ) = delete;
+
+	/*----------------------------- 数据结构 / Data --------------------------*/
+	/// @brief 一条调用栈的聚合 / Aggregate of one call stack
+	struct StackRecord
+	{
+		std::uint64_t hash = 0;							   //!< 栈帧散列，受 stack_mutex 保护 / Frame hash, guarded by stack_mutex
+		std::size_t	  depth = 0;						   //!< 有效帧数 / Valid frames
+		bool		  occupied = false;					   //!< 受 stack_mutex 保护 / Guarded by stack_mutex
+		void*		  frames[ MAX_STACK_FRAMES ] = {};	   //!< 叶在前 / Leaf first
+		std::atomic<std::int64_t> live_objects { 0 };		   //!< 存活样本数 / Live samples
+		std::atomic<std::int64_t> live_bytes { 0 };			   //!< 存活样本的原始字节 / Raw bytes of live samples
+		std::atomic<std::int64_t> live_weighted_bytes { 0 };   //!< 估计的存活字节 / Estimated live bytes
+		std::atomic<std::int64_t> allocated_objects { 0 };	   //!< 累计样本数 / Samples taken
+		std::atomic<std::int64_t> allocated_bytes { 0 };	   //!< 累计样本的原始字节 / Raw bytes of samples taken
+		std::atomic<std::int64_t> allocated_weighted_bytes { 0 };  //!< 估计的累计分配字节 / Estimated bytes allocated
+	};
+
+	/// @brief 一个仍存活的样本 / One sample that is still live
+	struct SampleEntry
+	{
+		void*		 user_pointer = nullptr;  //!< 空表示空槽 / Null marks an empty slot
+		StackRecord* stack = nullptr;		  //!< 所属调用栈 / Owning stack
+		std::int64_t bytes = 0;				  //!< 原始字节 / Raw bytes
+		std::int64_t weighted_bytes = 0;	  //!< 代表的字节 / Bytes it stands for
+	};
+
+	/// @brief 按地址散列的样本分片（线性探测）/ Sample shard hashed by address (linear probing)
+	struct alignas( 64 ) SampleShard
+	{
+		std::mutex												  mutex;
+		std::size_t												  used = 0;
+		std::array<SampleEntry, std::size_t( 1 ) << SAMPLE_SLOT_BITS> entries {};
+	};
+
+	/// @brief 每线程状态，平凡类型，不需要线程退出钩子 / Per-thread state; trivial, so no thread-exit hook is needed
+	struct ThreadState
+	{
+		std::int64_t  bytes_until_sample = 0;  //!< 距下次采样的剩余字节 / Bytes left before the next sample
+		std::uint64_t random_state = 0;		   //!< xorshift 状态，0 表示未播种 / xorshift state, 0 until seeded
+		bool		  busy = false;			   //!< 正在采样或导出，重入的分配不采样 / Sampling or dumping: reentrant allocations are not sampled
+	};
+
+	/// @brief 导出期间屏蔽本线程的采样 / Masks this thread's sampling while dumping
+	struct OutputGuard
+	{
+		ThreadState& state;
+		bool		 was_busy;
+		explicit OutputGuard( ThreadState& thread ) : state( thread ), was_busy( std::exchange( thread.busy, true ) ) {}
+		~OutputGuard()
+		{
+			state.busy = was_busy;
+		}
+	};
+
+	static ThreadState& thread_state()
+	{
+		static thread_local ThreadState state;
+		return state;
+	}
+
+	/*----------------------------- 采样 / Sampling --------------------------*/
+	void sample_allocation( ThreadState& state, void* user_pointer, std::size_t bytes )
+	{
+		const std::size_t rate = get_sampling_rate();
+		const bool		  seeded = state.random_state != 0;
+		state.bytes_until_sample = next_sample_interval( state, rate );
+		// 未播种时只抽取首个间隔；重入（抓栈或导出时的分配）不采样 / Unseeded threads only draw the first interval; reentrant allocations are skipped
+		if ( !seeded || state.busy )
+			return;
+
+		state.busy = true;
+		void*			  frames[ MAX_STACK_FRAMES ];
+		const std::size_t depth = capture_stack( frames );
+		StackRecord&	  record = find_stack( frames, depth );
+
+		const std::int64_t weighted_bytes = sample_weight( bytes, rate );
+		record.allocated_objects.fetch_add( 1, std::memory_order_relaxed );
+		record.allocated_bytes.fetch_add( static_cast<std::int64_t>( bytes ), std::memory_order_relaxed );
+		record.allocated_weighted_bytes.fetch_add( weighted_bytes, std::memory_order_relaxed );
+
+		insert_sample( { user_pointer, &record, static_cast<std::int64_t>( bytes ), weighted_bytes } );
+		state.busy = false;
+	}
+
+	/// @brief 指数分布的下一个采样间隔（均值 rate）/ Next exponentially distributed sampling interval (mean rate)
+	static std::int64_t next_sample_interval( ThreadState& state, std::size_t rate )
+	{
+		if ( state.random_state == 0 )
+			state.random_state = ( reinterpret_cast<std::uintptr_t>( &state ) | 1 ) * 0x9E3779B97F4A7C15ull;
+		if ( rate <= 1 )
+			return 0;
+
+		// xorshift64*，取高 53 位得到 (0, 1] 上的均匀数 / xorshift64*, the high 53 bits give a uniform value in (0, 1]
+		state.random_state ^= state.random_state >> 12;
+		state.random_state ^= state.random_state << 25;
+		state.random_state ^= state.random_state >> 27;
+		const double uniform = static_cast<double>( ( ( state.random_state * 0x2545F4914F6CDD1Dull ) >> 11 ) + 1 ) * ( 1.0 / 9007199254740992.0 );
+		return static_cast<std::int64_t>( -std::log( uniform ) * static_cast<double>( rate ) ) + 1;
+	}
+
+	/// @brief 一次采样代表的字节数：size 除以被采中的概率 / Bytes a sample stands for: size divided by its chance of being sampled
+	static std::int64_t sample_weight( std::size_t bytes, std::size_t rate )
+	{
+		if ( bytes == 0 || rate <= 1 )
+			return static_cast<std::int64_t>( bytes );
+		const double ratio = static_cast<double>( bytes ) / static_cast<double>( rate );
+		return static_cast<std::int64_t>( static_cast<double>( bytes ) / -std::expm1( -ratio ) );
+	}
+
+	/// @brief 抓取调用栈（叶在前）/ Capture the call stack, leaf first
+	static std::size_t capture_stack( void* ( &frames )[ MAX_STACK_FRAMES ] )
+	{
+#if defined( _WIN32 )
+		return RtlCaptureStackBackTrace( static_cast<DWORD>( SKIPPED_FRAMES ), static_cast<DWORD>( MAX_STACK_FRAMES ), frames, nullptr );
+#else
+		void*			  buffer[ MAX_STACK_FRAMES + SKIPPED_FRAMES ];
+		const int		  captured = ::backtrace( buffer, static_cast<int>( MAX_STACK_FRAMES + SKIPPED_FRAMES ) );
+		const std::size_t depth = captured > static_cast<int>( SKIPPED_FRAMES ) ? static_cast<std::size_t>( captured ) - SKIPPED_FRAMES : 0;
+		std::memcpy( frames, buffer + SKIPPED_FRAMES, depth * sizeof( void* ) );
+		return depth;
+#endif
+	}
+
+	/*----------------------------- 调用栈表 / Stacks ------------------------*/
+	/// @brief 查找或登记调用栈；表满 7/8 后并入溢出记录 / Find or register a stack; past 7/8 full, stacks fold into the overflow record
+	StackRecord& find_stack( void* const* frames, std::size_t depth )
+	{
+		std::uint64_t hash = 0xCBF29CE484222325ull;
+		for ( std::size_t frame = 0; frame < depth; ++frame )
+			hash = ( hash ^ static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>( frames[ frame ] ) ) ) * 0x100000001B3ull;
+
+		constexpr std::size_t	   capacity = std::size_t( 1 ) << STACK_TABLE_BITS;
+		std::lock_guard<std::mutex> lock( stack_mutex );
+		for ( std::size_t probe = 0, slot = static_cast<std::size_t>( hash ) & ( capacity - 1 ); probe < capacity; ++probe, slot = ( slot + 1 ) & ( capacity - 1 ) )
+		{
+			StackRecord& record = stacks[ slot ];
+			if ( !record.occupied )
+			{
+				if ( stack_count >= capacity - capacity / 8 )
+					break;
+				record.hash = hash;
+				record.depth = depth;
+				std::memcpy( record.frames, frames, depth * sizeof( void* ) );
+				record.occupied = true;
+				++stack_count;
+				return record;
+			}
+			if ( record.hash == hash && record.depth == depth && std::memcmp( record.frames, frames, depth * sizeof( void* ) ) == 0 )
+				return record;
+		}
+		return overflow_stack;
+	}
+
+	/// @brief 遍历所有调用栈，调用方持有 stack_mutex / Visit every stack; the caller holds stack_mutex
+	template <typename Visitor>
+	void for_each_stack( Visitor&& visitor )
+	{
+		for ( const StackRecord& record : stacks )
+		{
+			if ( record.occupied )
+				visitor( record );
+		}
+		if ( overflow_stack.allocated_objects.load( std::memory_order_relaxed ) != 0 )
+			visitor( overflow_stack );
+	}
+
+	std::size_t sum_over_stacks( View view )
+	{
+		std::lock_guard<std::mutex> lock( stack_mutex );
+		std::int64_t				total = 0;
+		for_each_stack( [ &total, view ]( const StackRecord& record ) {
+			total += view == View::LiveBytes ? record.live_weighted_bytes.load( std::memory_order_relaxed ) : record.allocated_weighted_bytes.load( std::memory_order_relaxed );
+		} );
+		return total > 0 ? static_cast<std::size_t>( total ) : 0;
+	}
+
+	/*----------------------------- 样本表 / Samples -------------------------*/
+	static std::uint64_t address_hash( const void* user_pointer )
+	{
+		return ( static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>( user_pointer ) ) >> 4 ) * 0x9E3779B97F4A7C15ull;
+	}
+
+	SampleShard& shard_of( std::uint64_t hash )
+	{
+		return sample_shards[ static_cast<std::size_t>( hash >> ( 64 - SAMPLE_SHARD_BITS ) ) ];
+	}
+
+	static std::size_t home_slot_of( std::uint64_t hash )
+	{
+		return static_cast<std::size_t>( hash >> ( 64 - SAMPLE_SHARD_BITS - SAMPLE_SLOT_BITS ) ) & ( ( std::size_t( 1 ) << SAMPLE_SLOT_BITS ) - 1 );
+	}
+
+	// 存在性槽按 16 B 粒度取低位 / Presence slots use the low bits at 16-byte granularity
+	std::atomic<std::uint32_t>& presence_of( const void* user_pointer )
+	{
+		return presence[ ( reinterpret_cast<std::uintptr_t>( user_pointer ) >> 4 ) & ( ( std::size_t( 1 ) << PRESENCE_BITS ) - 1 ) ];
+	}
+
+	static void add_live( const SampleEntry& entry, std::int64_t sign )
+	{
+		entry.stack->live_objects.fetch_add( sign, std::memory_order_relaxed );
+		entry.stack->live_bytes.fetch_add( sign * entry.bytes, std::memory_order_relaxed );
+		entry.stack->live_weighted_bytes.fetch_add( sign * entry.weighted_bytes, std::memory_order_relaxed );
+	}
+
+	void insert_sample( const SampleEntry& entry )
+	{
+		constexpr std::size_t mask = ( std::size_t( 1 ) << SAMPLE_SLOT_BITS ) - 1;
+		const std::uint64_t	  hash = address_hash( entry.user_pointer );
+		SampleShard&		  shard = shard_of( hash );
+
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		std::size_t					slot = home_slot_of( hash );
+		while ( shard.entries[ slot ].user_pointer && shard.entries[ slot ].user_pointer != entry.user_pointer )
+			slot = ( slot + 1 ) & mask;
+
+		SampleEntry& target = shard.entries[ slot ];
+		if ( target.user_pointer )
+		{
+			// 同一地址的旧样本未经钩子释放：先扣除再覆盖 / A stale sample at this address was freed without the hook: subtract it, then overwrite
+			add_live( target, -1 );
+		}
+		else
+		{
+			if ( shard.used >= mask - mask / 8 )
+			{
+				dropped_sample_count.fetch_add( 1, std::memory_order_relaxed );
+				return;
+			}
+			++shard.used;
+			presence_of( entry.user_pointer ).fetch_add( 1, std::memory_order_relaxed );
+			live_samples.fetch_add( 1, std::memory_order_relaxed );
+		}
+		target = entry;
+		add_live( entry, 1 );
+	}
+
+	void remove_sample( void* user_pointer )
+	{
+		constexpr std::size_t mask = ( std::size_t( 1 ) << SAMPLE_SLOT_BITS ) - 1;
+		const std::uint64_t	  hash = address_hash( user_pointer );
+		SampleShard&		  shard = shard_of( hash );
+
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		std::size_t					slot = home_slot_of( hash );
+		while ( shard.entries[ slot ].user_pointer != user_pointer )
+		{
+			if ( !shard.entries[ slot ].user_pointer )
+				return;	 // 存在性误报 / Presence false positive
+			slot = ( slot + 1 ) & mask;
+		}
+
+		add_live( shard.entries[ slot ], -1 );
+		presence_of( user_pointer ).fetch_sub( 1, std::memory_order_relaxed );
+		live_samples.fetch_sub( 1, std::memory_order_relaxed );
+		--shard.used;
+
+		// 反向移位删除，保持探测链连续 / Backward-shift deletion keeps probe chains unbroken
+		std::size_t hole = slot;
+		for ( std::size_t next = ( hole + 1 ) & mask; shard.entries[ next ].user_pointer; next = ( next + 1 ) & mask )
+		{
+			const std::size_t home = home_slot_of( address_hash( shard.entries[ next ].user_pointer ) );
+			if ( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )
+			{
+				shard.entries[ hole ] = shard.entries[ next ];
+				hole = next;
+			}
+		}
+		shard.entries[ hole ] = SampleEntry {};
+	}
+
+	/*----------------------------- 输出 / Output ----------------------------*/
+	static std::int64_t now_nanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	/// @brief 帧名：有符号时用符号名，否则为地址 / Frame name: the symbol when one is known, otherwise the address
+	static std::size_t describe_frame( void* frame, char* buffer, std::size_t capacity )
+	{
+#if !defined( _WIN32 )
+		Dl_info information {};
+		if ( ::dladdr( frame, &information ) && information.dli_sname )
+		{
+			std::size_t length = std::strlen( information.dli_sname );
+			if ( length > capacity )
+				length = capacity;
+			std::memcpy( buffer, information.dli_sname, length );
+			// 折叠栈以 ';' 和 ' ' 作分隔 / Collapsed stacks use ';' and ' ' as separators
+			for ( std::size_t index = 0; index < length; ++index )
+			{
+				if ( buffer[ index ] == ';' || buffer[ index ] == ' ' )
+					buffer[ index ] = '_';
+			}
+			return length;
+		}
+#endif
+		const int length = std::snprintf( buffer, capacity, "0x%llx", static_cast<unsigned long long>( reinterpret_cast<std::uintptr_t>( frame ) ) );
+		return length > 0 ? static_cast<std::size_t>( length ) : 0;
+	}
+
+	/**
+     * @brief 低级输出函数 / Low-level output to avoid allocations
+     */
+	static void write_output( std::ostream& output_stream, const char* text, std::size_t length )
+	{
+		if ( &output_stream == &std::cerr )
+		{
+			std::fwrite( text, 1, length, stderr );
+		}
+		else if ( &output_stream == &std::cout )
+		{
+			std::fwrite( text, 1, length, stdout );
+		}
+		else
+		{
+			output_stream.write( text, static_cast<std::streamsize>( length ) );
+		}
+	}
+
+	/*----------------------------- 成员 / Members ---------------------------*/
+	std::atomic<bool>		  running { false };					   //!< 是否采样 / Sampling on?
+	std::atomic<std::size_t>  sampling_rate { DEFAULT_SAMPLING_RATE }; //!< 平均采样间隔（字节）/ Mean bytes between samples
+	std::atomic<std::int64_t> started_at_nanoseconds { 0 };			   //!< 首次启动的时刻 / Time of the first start
+	std::atomic<std::size_t>  live_samples { 0 };					   //!< 存活样本数，为 0 时释放钩子立即返回 / Live samples; at 0 the free hook returns at once
+	std::atomic<std::size_t>  dropped_sample_count { 0 };			   //!< 丢弃的样本数 / Dropped samples
+
+	std::mutex														   stack_mutex;		//!< 保护调用栈表的登记与遍历 / Guards stack registration and traversal
+	std::size_t														   stack_count = 0;	//!< 已登记调用栈数 / Registered stacks
+	std::array<StackRecord, std::size_t( 1 ) << STACK_TABLE_BITS>	   stacks {};		//!< 开放寻址调用栈表 / Open-addressing stack table
+	StackRecord														   overflow_stack;	//!< 表满后的汇总记录 / Aggregate once the table is full
+	std::array<SampleShard, std::size_t( 1 ) << SAMPLE_SHARD_BITS>	   sample_shards {};	//!< 样本分片 / Sample shards
+	std::array<std::atomic<std::uint32_t>, std::size_t( 1 ) << PRESENCE_BITS> presence {};	//!< 地址槽存在性计数 / Presence counters per address slot
+};
+
+#endif	// HEAP_PROFILER_HPP
@@ -1,6 +1,8 @@
 #include "global_allocator_api.hpp"
 #include "stl_allocator.hpp"
 #include "safe_memory_leak_reporter.hpp"
+#include "arena.hpp"
+#include "object_pool.hpp"
 
 #include <iostream>
 #include <algorithm>
@@ -9,6 +11,8 @@
 #include <random>
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <sstream>
 
 /*
  * Detailed Explanation of Two Key Lines for C++ I/O Optimization
@@ -264,7 +268,691 @@ void test_multithreaded()
 	}
 }
 
+/// @brief 生产者线程分配、消费者线程释放，块应回到生产者 / Producer allocates, consumer frees: blocks should flow back to the producer
+void test_cross_thread_free()
+{
+	std::cout << "\n=== Testing Cross-Thread Free ===\n";
+
+	constexpr size_t	block_count = 20000;
+	std::vector<void*>	allocation_pointer_list( block_count );
+	size_t				warm_usage = 0;
+
+	for ( int round_index = 0; round_index < 8; ++round_index )
+	{
+		std::thread producer_thread( [ & ]() {
+			for ( size_t block_index = 0; block_index < block_count; ++block_index )
+				allocation_pointer_list[ block_index ] = ALLOCATE( 16 + block_index % 2000 );
+		} );
+		producer_thread.join();
+
+		std::thread consumer_thread( [ & ]() {
+			for ( void* allocation_pointer : allocation_pointer_list )
+				DEALLOCATE( allocation_pointer );
+		} );
+		consumer_thread.join();
+
+		if ( round_index == 1 )
+			warm_usage = os_memory::used_memory_bytes_counter.load( std::memory_order_relaxed );
+	}
+
+	const size_t final_usage = os_memory::used_memory_bytes_counter.load( std::memory_order_relaxed );
+	if ( final_usage > warm_usage )
+		std::cout << "  ERROR: pool grew by " << ( final_usage - warm_usage ) << " bytes after warm-up\n";
+	else
+		std::cout << "  Cross-thread frees reused without growth\n";
+}
+
+/// @brief 释放一批块后 trim，应把空闲 chunk 归还 OS 且之后仍可分配 / After freeing a burst, trim should return idle chunks and allocation must still work
+void test_trim()
+{
+	std::cout << "\n=== Testing Trim ===\n";
+
+	constexpr size_t   block_count = 50000;
+	std::vector<void*> allocation_pointer_list( block_count );
+	for ( size_t block_index = 0; block_index < block_count; ++block_index )
+		allocation_pointer_list[ block_index ] = ALLOCATE( 64 + block_index % 4000 );
+	for ( void* allocation_pointer : allocation_pointer_list )
+		DEALLOCATE( allocation_pointer );
+
+	const size_t before_usage = os_memory::used_memory_bytes_counter.load( std::memory_order_relaxed );
+	const size_t released_bytes = os_memory::api::GlobalAllocator::trim();
+	const size_t after_usage = os_memory::used_memory_bytes_counter.load( std::memory_order_relaxed );
+	std::cout << "  Released " << released_bytes << " bytes, mapped " << before_usage << " -> " << after_usage << " bytes\n";
+	if ( released_bytes == 0 || after_usage >= before_usage )
+		std::cout << "  ERROR: trim returned nothing to the OS\n";
+
+	for ( size_t block_index = 0; block_index < block_count; ++block_index )
+	{
+		allocation_pointer_list[ block_index ] = ALLOCATE( 64 + block_index % 4000 );
+		std::memset( allocation_pointer_list[ block_index ], 0x5A, 64 );
+	}
+	for ( void* allocation_pointer : allocation_pointer_list )
+		DEALLOCATE( allocation_pointer );
+	std::cout << "  Reallocation after trim OK\n";
+}
+
 /// @brief 测试内存边界访问 / Test memory boundary access
+void test_page_policy()
+{
+	std::cout << "\n=== Testing Page Policy ===\n";
+
+	using os_memory::PagePolicy;
+	os_memory::api::GlobalAllocator::set_page_policy( PagePolicy::TRANSPARENT, PagePolicy::EXPLICIT_2M, PagePolicy::EXPLICIT_1G );
+
+	constexpr size_t medium_bytes = 8ull << 20;
+	constexpr size_t large_bytes = 600ull << 20;
+	char*			 medium_pointer = static_cast<char*>( ALLOCATE( medium_bytes ) );
+	char*			 large_pointer = static_cast<char*>( ALLOCATE( large_bytes ) );
+	std::memset( medium_pointer, 0x3C, medium_bytes );
+	large_pointer[ 0 ] = 1;
+	large_pointer[ large_bytes - 1 ] = 2;
+	if ( medium_pointer[ medium_bytes - 1 ] != 0x3C || large_pointer[ 0 ] + large_pointer[ large_bytes - 1 ] != 3 )
+		std::cout << "  ERROR: huge-page backed memory lost its contents\n";
+	DEALLOCATE( large_pointer );
+	DEALLOCATE( medium_pointer );
+
+	os_memory::api::GlobalAllocator::set_page_policy( PagePolicy::NORMAL, PagePolicy::NORMAL, PagePolicy::NORMAL );
+	std::cout << "  Medium/Large allocations under huge-page policies OK\n";
+}
+
+void test_reallocate()
+{
+	std::cout << "\n=== Testing Reallocate ===\n";
+
+	// 桶内增长返回原指针 / Growth inside the bucket keeps the pointer
+	char* pointer = static_cast<char*>( ALLOCATE( 1000 ) );
+	std::memset( pointer, 0x11, 1000 );
+	char* same_pointer = static_cast<char*>( REALLOCATE( pointer, 1010 ) );
+	if ( same_pointer != pointer )
+		std::cout << "  ERROR: growth inside the bucket moved the block\n";
+
+	// 跨层增长保留内容：Small → Medium → Large → Huge / Growth across tiers keeps the contents
+	const size_t sizes[] = { 64ull << 10, 3ull << 20, 200ull << 20, 700ull << 20, ( 1ull << 30 ) + ( 16ull << 20 ), 300ull << 20, 100 };
+	size_t		 filled_bytes = 1000;
+	for ( size_t size : sizes )
+	{
+		pointer = static_cast<char*>( REALLOCATE( same_pointer, size ) );
+		const size_t kept_bytes = filled_bytes < size ? filled_bytes : size;
+		if ( pointer[ 0 ] != 0x11 || pointer[ kept_bytes - 1 ] != 0x11 )
+			std::cout << "  ERROR: reallocate to " << size << " bytes lost the contents\n";
+		pointer[ size - 1 ] = 0x11;	 // 新尾部可写 / The new tail is writable
+		filled_bytes = kept_bytes;
+		same_pointer = pointer;
+	}
+	DEALLOCATE( same_pointer );
+
+	// 伙伴吸收：释放右半后左半原地扩大 / Buddy absorption: the left half grows in place once the right half is free
+	char* left_pointer = static_cast<char*>( ALLOCATE( ( 4ull << 20 ) - 4096 ) );
+	char* right_pointer = static_cast<char*>( ALLOCATE( ( 4ull << 20 ) - 4096 ) );
+	DEALLOCATE( right_pointer );
+	os_memory::api::GlobalAllocator::trim();  // 完成排队中的合并 / Settle queued merges
+	char* grown_pointer = static_cast<char*>( REALLOCATE( left_pointer, ( 8ull << 20 ) - 4096 ) );
+	std::cout << "  Medium growth " << ( grown_pointer == left_pointer ? "stayed in place" : "moved" ) << "\n";
+	DEALLOCATE( grown_pointer );
+
+	std::cout << "  Reallocate across tiers OK\n";
+}
+
+void test_sized_deallocate()
+{
+	std::cout << "\n=== Testing Sized Deallocate ===\n";
+
+	// 每层、每种对齐路径各一次：可用尺寸不小于请求，尾部可写，按尺寸释放 / Every tier and alignment path: usable size covers the request, the tail is writable, then a sized free
+	const size_t sizes[] = { 24, 900, 2000, 64ull << 10, 3ull << 20, 600ull << 20 };
+	const size_t alignments[] = { sizeof( void* ), 64, 4096 };
+	for ( size_t alignment : alignments )
+	{
+		for ( size_t size : sizes )
+		{
+			char*		 pointer = static_cast<char*>( ALLOCATE_ALIGNED( size, alignment ) );
+			const size_t usable = os_memory::api::my_usable_size( pointer );
+			if ( usable < size )
+				std::cout << "  ERROR: usable_size(" << size << ", align " << alignment << ") = " << usable << "\n";
+			pointer[ usable - 1 ] = 0x5A;
+			os_memory::api::my_deallocate( pointer, size, alignment );
+		}
+	}
+
+	// reallocate 之后以新尺寸释放 / After reallocate the new size is the one to pass
+	char* pointer = static_cast<char*>( ALLOCATE( 2000 ) );
+	pointer = static_cast<char*>( REALLOCATE( pointer, 2040 ) );
+	pointer = static_cast<char*>( REALLOCATE( pointer, 5ull << 20 ) );
+	os_memory::api::my_deallocate( pointer, 5ull << 20 );
+
+	std::cout << "  Sized deallocate OK\n";
+}
+
+void test_pointer_classification()
+{
+	std::cout << "\n=== Testing Pointer Classification ===\n";
+
+	// 每层、每种对齐：页表认得指针，并据此完成无尺寸释放 / Every tier and alignment: the page maps recognise the pointer and drive the unsized free
+	const size_t sizes[] = { 24, 2000, 64ull << 10, 3ull << 20, 600ull << 20 };
+	const size_t alignments[] = { sizeof( void* ), 64, 4096, 64ull << 10 };
+	for ( size_t alignment : alignments )
+	{
+		for ( size_t size : sizes )
+		{
+			char* pointer = static_cast<char*>( ALLOCATE_ALIGNED( size, alignment ) );
+			if ( !MemoryPool::owns( pointer ) )
+				std::cout << "  ERROR: pool pointer of " << size << " bytes (align " << alignment << ") not recognised\n";
+			if ( os_memory::api::my_usable_size( pointer ) < size )
+				std::cout << "  ERROR: usable_size(" << size << ", align " << alignment << ") too small\n";
+			os_memory::api::my_deallocate( pointer );
+		}
+	}
+
+	// 栈上缓冲与直接映射的页不属于池 / A stack buffer and a directly mapped page belong to no pool
+	alignas( 64 ) char stack_buffer[ 256 ];
+	void* const		   foreign_mapping = os_memory::allocate_memory( 4096 );
+	if ( MemoryPool::owns( stack_buffer + 64 ) || MemoryPool::owns( foreign_mapping ) )
+		std::cout << "  ERROR: foreign pointer classified as a pool pointer\n";
+	os_memory::deallocate_memory( foreign_mapping, 4096 );
+
+	std::cout << "  Pointer classification OK\n";
+}
+
+void test_batch_allocation()
+{
+	std::cout << "\n=== Testing Batch Allocation ===\n";
+
+	// slab、带头小块与中块各一批：指针互不重叠且可写，随后一次释放 / One batch each of slab, headered small and medium blocks: distinct writable pointers, then freed at once
+	const size_t sizes[] = { 48, 4000, 2ull << 20 };
+	const size_t counts[] = { 5000, 300, 4 };
+	for ( size_t k = 0; k < 3; ++k )
+	{
+		std::vector<void*> pointers( counts[ k ] );
+		if ( os_memory::api::GlobalAllocator::allocate_batch( sizes[ k ], counts[ k ], pointers.data() ) != counts[ k ] )
+			std::cout << "  ERROR: allocate_batch(" << sizes[ k ] << ") came up short\n";
+		for ( void* pointer : pointers )
+			std::memset( pointer, 0x3C, sizes[ k ] );
+
+		std::vector<void*> sorted( pointers );
+		std::sort( sorted.begin(), sorted.end() );
+		for ( size_t i = 1; i < sorted.size(); ++i )
+			if ( static_cast<char*>( sorted[ i - 1 ] ) + sizes[ k ] > sorted[ i ] )
+				std::cout << "  ERROR: batch blocks of " << sizes[ k ] << " bytes overlap\n";
+
+		os_memory::api::GlobalAllocator::deallocate_batch( pointers.data(), pointers.size() );
+	}
+
+	std::cout << "  Batch allocation OK\n";
+}
+
+void test_numa_allocation()
+{
+	std::cout << "\n=== Testing NUMA Allocation ===\n";
+
+	// 每个节点各分配一批，由另一线程释放：块须回到所属节点的分片 / Allocate on every node and free from another thread: blocks must go back to their node's shard
+	const size_t	   node_count = os_memory::api::GlobalAllocator::numa_node_count();
+	const size_t	   sizes[] = { 64, 8000, 3ull << 20 };
+	std::vector<void*> pointers;
+	for ( size_t node = 0; node < node_count; ++node )
+	{
+		for ( size_t size : sizes )
+		{
+			void* pointer = os_memory::api::GlobalAllocator::allocate_on_node( node, size );
+			std::memset( pointer, 0x6E, size );
+			pointers.push_back( pointer );
+		}
+	}
+	std::thread( [ &pointers ]() {
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+	} ).join();
+
+	std::cout << "  " << node_count << " node(s), cross-thread frees OK\n";
+}
+
+void test_memory_tracking()
+{
+	std::cout << "\n=== Testing Memory Tracking ===\n";
+
+	// 跨线程释放后占用须精确回到基线 / After cross-thread frees, usage must return exactly to the baseline
+	const size_t baseline = os_memory::api::get_current_memory_usage();
+	{
+		std::vector<void*> pointers( 4000 );
+		for ( void*& pointer : pointers )
+			pointer = ALLOCATE( 100 );
+		if ( os_memory::api::get_current_memory_usage() != baseline + pointers.size() * 100 )
+			std::cout << "  ERROR: exact usage mismatch after allocation\n";
+		std::thread( [ &pointers ]() {
+			for ( void* pointer : pointers )
+				DEALLOCATE( pointer );
+		} ).join();
+		if ( os_memory::api::get_current_memory_usage() != baseline )
+			std::cout << "  ERROR: exact usage mismatch after cross-thread frees\n";
+	}
+
+	// 采样模式：估计值应接近真实值，释放后回到基线 / Sampling mode: the estimate should be close, and return to the baseline after frees
+	os_memory::api::set_memory_tracking_sampling_rate( 4096 );
+	{
+		std::vector<void*> pointers( 20000 );
+		for ( void*& pointer : pointers )
+			pointer = ALLOCATE( 256 );
+		const double estimated = static_cast<double>( os_memory::api::get_current_memory_usage() - baseline );
+		const double actual = static_cast<double>( pointers.size() * 256 );
+		if ( estimated < actual * 0.75 || estimated > actual * 1.25 )
+			std::cout << "  ERROR: sampled estimate " << estimated << " too far from " << actual << "\n";
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+		if ( os_memory::api::get_current_memory_usage() != baseline )
+			std::cout << "  ERROR: sampled usage did not return to the baseline\n";
+	}
+	os_memory::api::set_memory_tracking_sampling_rate( 0 );
+
+	std::cout << "  Exact and sampled tracking OK\n";
+}
+
+void test_heap_profiler()
+{
+	std::cout << "\n=== Testing Heap Profiler ===\n";
+
+	HeapProfiler& profiler = HeapProfiler::instance();
+	const size_t  baseline = profiler.estimated_live_bytes();
+	os_memory::api::start_heap_profiling( 4096 );
+	{
+		// 估计的存活字节应接近真实值，释放后精确回到基线 / The live estimate should be close, and return exactly to the baseline after frees
+		std::vector<void*> pointers( 20000 );
+		for ( void*& pointer : pointers )
+			pointer = ALLOCATE( 256 );
+		const double estimated = static_cast<double>( profiler.estimated_live_bytes() - baseline );
+		const double actual = static_cast<double>( pointers.size() * 256 );
+		if ( estimated < actual * 0.75 || estimated > actual * 1.25 )
+			std::cout << "  ERROR: profiled estimate " << estimated << " too far from " << actual << "\n";
+
+		std::ostringstream pprof_output;
+		os_memory::api::write_heap_profile( pprof_output );
+		if ( pprof_output.str().rfind( "heap profile: ", 0 ) != 0 || pprof_output.str().find( "@ 0x" ) == std::string::npos )
+			std::cout << "  ERROR: pprof output malformed\n";
+
+		std::ostringstream collapsed_output;
+		os_memory::api::write_heap_profile_collapsed( collapsed_output );
+		if ( collapsed_output.str().empty() || collapsed_output.str().back() != '\n' )
+			std::cout << "  ERROR: collapsed output malformed\n";
+
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+		if ( profiler.estimated_live_bytes() != baseline )
+			std::cout << "  ERROR: profiled live bytes did not return to the baseline\n";
+	}
+	os_memory::api::stop_heap_profiling();
+
+	std::cout << "  Sampled heap profile OK\n";
+}
+
+void test_memory_statistics()
+{
+	std::cout << "\n=== Testing Memory Statistics ===\n";
+
+	// 计数在读取时汇总：slab 桶与 Medium 阶的增量须覆盖本次操作 / Counters are summed on read: slab bucket and Medium order deltas must cover this run
+	const size_t			   index = SmallMemoryManager::calculate_bucket_index( 200 );
+	const MemoryPoolStatistics before = os_memory::api::GlobalAllocator::statistics();
+	{
+		std::vector<void*> pointers( 1000 );
+		for ( void*& pointer : pointers )
+			pointer = ALLOCATE( 200 );
+		void* medium = ALLOCATE( 3ull << 20 );
+		DEALLOCATE( medium );
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+	}
+	const MemoryPoolStatistics after = os_memory::api::GlobalAllocator::statistics();
+
+	if ( after.slab_buckets[ index ].allocations - before.slab_buckets[ index ].allocations < 1000 || after.slab_buckets[ index ].frees - before.slab_buckets[ index ].frees < 1000 )
+		std::cout << "  ERROR: slab bucket counters missed allocations or frees\n";
+	if ( after.slab_buckets[ index ].requested_bytes - before.slab_buckets[ index ].requested_bytes < 1000 * 200 )
+		std::cout << "  ERROR: slab bucket requested bytes too low\n";
+	uint64_t medium_allocations = 0;
+	for ( size_t order = 0; order < after.medium_orders.size(); ++order )
+		medium_allocations += after.medium_orders[ order ].allocations - before.medium_orders[ order ].allocations;
+	if ( medium_allocations < 1 )
+		std::cout << "  ERROR: medium order counters missed the allocation\n";
+
+	std::ostringstream json_output;
+	os_memory::api::write_memory_statistics_json( json_output );
+	if ( json_output.str().rfind( "{\"small\":{", 0 ) != 0 || json_output.str().find( "\"huge\":{" ) == std::string::npos || json_output.str().back() != '\n' )
+		std::cout << "  ERROR: JSON output malformed\n";
+
+	std::ostringstream prometheus_output;
+	os_memory::api::write_memory_statistics_prometheus( prometheus_output );
+	if ( prometheus_output.str().find( "# TYPE memory_pool_small_allocations_total counter\n" ) == std::string::npos
+		 || prometheus_output.str().find( "memory_pool_small_allocations_total{kind=\"slab\",bucket=\"" + std::to_string( index ) + "\"" ) == std::string::npos )
+		std::cout << "  ERROR: Prometheus output malformed\n";
+
+	std::cout << "  Per-tier statistics OK\n";
+}
+
+void test_reserve()
+{
+	std::cout << "\n=== Testing Reserve ===\n";
+
+	ReserveProfile profile;
+	const size_t   slab_index = SmallMemoryManager::calculate_bucket_index( 728 );
+	const size_t   small_index = SmallMemoryManager::calculate_bucket_index( 46344 );
+	profile.slab_blocks[ slab_index ] = 500;
+	profile.small_blocks[ small_index ] = 40;
+	profile.medium_blocks[ 2 ] = 3;
+	if ( os_memory::api::GlobalAllocator::reserve( profile ) != profile.total_blocks() )
+		std::cout << "  ERROR: reserve did not pre-warm every block\n";
+
+	// 预热后的同类分配不再切分新 slab / chunk，也不再映射新 arena / Allocations after pre-warming carve no slab or chunk and map no arena
+	const MemoryPoolStatistics before = os_memory::api::GlobalAllocator::statistics();
+	{
+		std::vector<void*> pointers;
+		for ( int i = 0; i < 500; ++i )
+			pointers.push_back( ALLOCATE( 728 ) );
+		for ( int i = 0; i < 40; ++i )
+			pointers.push_back( ALLOCATE( 46344 - 16 ) );
+		for ( int i = 0; i < 3; ++i )
+			pointers.push_back( ALLOCATE( 3ull << 20 ) );
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+	}
+	const MemoryPoolStatistics after = os_memory::api::GlobalAllocator::statistics();
+	if ( after.slab_buckets[ slab_index ].carves != before.slab_buckets[ slab_index ].carves || after.small_buckets[ small_index ].carves != before.small_buckets[ small_index ].carves )
+		std::cout << "  ERROR: pre-warmed Small buckets carved again\n";
+	if ( after.medium_chunks != before.medium_chunks )
+		std::cout << "  ERROR: pre-warmed Medium order mapped a new arena\n";
+
+	// 快照 → 清单 → 文本 → 清单 / Snapshot to profile to text and back
+	MemoryPoolStatistics snapshot;
+	snapshot.slab_buckets[ 3 ].allocations = 10;
+	snapshot.slab_buckets[ 3 ].frees = 4;
+	snapshot.medium_orders[ 1 ].allocations = 1;
+	const ReserveProfile derived = ReserveProfile::from_statistics( snapshot, 2.0 );
+	if ( derived.slab_blocks[ 3 ] != 12 || derived.medium_blocks[ 1 ] != 2 || derived.total_blocks() != 14 )
+		std::cout << "  ERROR: profile derived from statistics is wrong\n";
+	std::stringstream text;
+	derived.write( text );
+	const ReserveProfile loaded = ReserveProfile::read( text );
+	if ( loaded.slab_blocks != derived.slab_blocks || loaded.small_blocks != derived.small_blocks || loaded.medium_blocks != derived.medium_blocks )
+		std::cout << "  ERROR: profile text round trip lost entries\n";
+
+	std::cout << "  Reserve OK\n";
+}
+
+void test_memory_limit()
+{
+	std::cout << "\n=== Testing Memory Limit ===\n";
+	using os_memory::api::GlobalAllocator;
+
+	struct PressureLog
+	{
+		int	 calls = 0;
+		bool last_hard = false;
+	} log;
+	auto record_pressure = []( const MemoryPressureEvent& event, void* context ) {
+		auto* pressure_log = static_cast<PressureLog*>( context );
+		++pressure_log->calls;
+		pressure_log->last_hard = event.hard;
+	};
+	if ( !GlobalAllocator::add_memory_pressure_callback( record_pressure, &log ) )
+		std::cout << "  ERROR: pressure callback was not registered\n";
+
+	// 先回收到底，之后的回收再也腾不出 48 MiB / Reclaim everything first so no later pass can find 48 MiB
+	GlobalAllocator::relieve_memory_pressure();
+	if ( log.calls == 0 )
+		std::cout << "  ERROR: relieve_memory_pressure did not call the callback\n";
+
+	// 硬上限：越过即拒绝 / Hard limit: a request crossing it is refused
+	const size_t used_bytes = GlobalAllocator::statistics().pool_mapped_bytes;
+	GlobalAllocator::set_memory_limit( 0, used_bytes + ( 16ull << 20 ) );
+	int calls = log.calls;
+	if ( GlobalAllocator::get()->allocate( 64ull << 20, sizeof( void* ), nullptr, 0, true ) != nullptr )
+		std::cout << "  ERROR: allocation above the hard limit succeeded\n";
+	if ( log.calls == calls || !log.last_hard )
+		std::cout << "  ERROR: hard pressure did not reach the callback\n";
+	bool thrown = false;
+	try
+	{
+		GlobalAllocator::get()->allocate( 64ull << 20 );
+	}
+	catch ( const std::bad_alloc& )
+	{
+		thrown = true;
+	}
+	if ( !thrown )
+		std::cout << "  ERROR: allocation above the hard limit did not throw\n";
+
+	// reallocate 的增长同样受硬上限约束，失败时原块不变 / Growth through reallocate obeys the hard limit too, leaving the block intact on failure
+	void* const growing = GlobalAllocator::get()->allocate( 2ull << 20, sizeof( void* ), nullptr, 0, true );
+	if ( !growing )
+		std::cout << "  ERROR: allocation below the hard limit failed\n";
+	else
+	{
+		if ( GlobalAllocator::get()->reallocate( growing, 64ull << 20, sizeof( void* ), nullptr, 0, true ) != nullptr )
+			std::cout << "  ERROR: reallocate above the hard limit succeeded\n";
+		GlobalAllocator::get()->deallocate( growing );
+	}
+
+	// 软上限：回收后照常分配，阈值重新武装后不再每次回收 / Soft limit: the allocation proceeds after a pass, and the re-armed threshold stops further passes
+	GlobalAllocator::set_memory_limit( GlobalAllocator::statistics().pool_mapped_bytes, 0 );
+	calls = log.calls;
+	void* const block = ALLOCATE( 64 * 1024 );
+	if ( !block || log.calls == calls || log.last_hard )
+		std::cout << "  ERROR: soft pressure did not run a pass\n";
+	calls = log.calls;
+	void* const small_block = ALLOCATE( 64 );
+	if ( log.calls != calls )
+		std::cout << "  ERROR: soft limit did not re-arm\n";
+	DEALLOCATE( small_block );
+	DEALLOCATE( block );
+
+	GlobalAllocator::set_memory_limit( 0, 0 );
+	GlobalAllocator::remove_memory_pressure_callback( record_pressure, &log );
+	std::cout << "  Memory limit OK\n";
+}
+
+void test_allocate_zeroed()
+{
+	std::cout << "\n=== Testing Zeroed Allocation ===\n";
+
+	// 先写脏再释放，同尺寸的清零分配多半复用同一块 / Dirty a block and free it so the zeroed allocation of the same size most likely reuses it
+	constexpr size_t stride = ( 64ull << 10 ) + 1;
+	const size_t	 sizes[] = { 100, 2000, 64ull << 10, 3ull << 20, 8ull << 20, 600ull << 20 };
+	for ( size_t size : sizes )
+	{
+		auto* dirty = static_cast<unsigned char*>( ALLOCATE( size ) );
+		for ( size_t offset = 0; offset < size; offset += stride )
+			dirty[ offset ] = 0xA5;
+		dirty[ size - 1 ] = 0xA5;
+		DEALLOCATE( dirty );
+
+		auto* zeroed = static_cast<unsigned char*>( ALLOCATE_ZEROED( 1, size ) );
+		bool  all_zero = zeroed[ size - 1 ] == 0;
+		for ( size_t offset = 0; offset < size && all_zero; offset += stride )
+			all_zero = zeroed[ offset ] == 0;
+		if ( !all_zero )
+			std::cout << "  ERROR: allocate_zeroed(" << size << ") returned non-zero bytes\n";
+		DEALLOCATE( zeroed );
+	}
+
+	// count * size 溢出 / count * size overflows
+	if ( ALLOCATE_ZEROED_NOTHROW( std::numeric_limits<size_t>::max() / 2, 4 ) != nullptr )
+		std::cout << "  ERROR: overflowing allocate_zeroed returned a pointer\n";
+	bool thrown = false;
+	try
+	{
+		ALLOCATE_ZEROED( std::numeric_limits<size_t>::max() / 2, 4 );
+	}
+	catch ( const std::bad_alloc& )
+	{
+		thrown = true;
+	}
+	if ( !thrown )
+		std::cout << "  ERROR: overflowing allocate_zeroed did not throw\n";
+
+	std::cout << "  Zeroed allocation OK\n";
+}
+
+void test_size_class_generator()
+{
+	std::cout << "\n=== Testing Size Class Generator ===\n";
+	using namespace os_memory::memory_pool;
+
+	// 峰值 48 / 96 / 320 字节，外加少量中等尺寸 / Peaks at 48 / 96 / 320 bytes plus a few mid-sized requests
+	SizeHistogramRecorder& recorder = SizeHistogramRecorder::instance();
+	recorder.reset();
+	recorder.start();
+	{
+		std::vector<void*> pointers;
+		for ( int i = 0; i < 3000; ++i )
+			pointers.push_back( ALLOCATE( i % 3 == 0 ? 48 : i % 3 == 1 ? 96 : 320 ) );
+		for ( int i = 0; i < 100; ++i )
+			pointers.push_back( ALLOCATE( 1500 ) );
+		for ( void* pointer : pointers )
+			DEALLOCATE( pointer );
+	}
+	recorder.stop();
+	const SizeHistogram histogram = recorder.snapshot();
+	if ( histogram.counts[ SizeHistogram::bin_of( 320 ) ] < 1000 || histogram.counts[ SizeHistogram::bin_of( 1500 + 16 ) ] < 100 )
+		std::cout << "  ERROR: recorder missed allocations\n";
+
+	const std::vector<size_t> sizes = generate_size_classes( histogram );
+	bool					  well_formed = sizes.size() <= 64 && sizes.back() == SmallMemoryManager::BUCKET_SIZES.back();
+	for ( size_t i = 0; i < sizes.size(); ++i )
+		well_formed = well_formed && ( i == 0 || sizes[ i ] > sizes[ i - 1 ] ) && ( sizes[ i ] > 1024 || sizes[ i ] % 8 == 0 );
+	for ( size_t peak : { size_t( 48 ), size_t( 96 ), size_t( 320 ), size_t( 1024 ) } )
+		well_formed = well_formed && std::binary_search( sizes.begin(), sizes.end(), peak );
+	if ( !well_formed )
+		std::cout << "  ERROR: generated table is malformed or misses a peak\n";
+	if ( expected_waste( histogram, sizes ) >= expected_waste( histogram, DefaultSizeClassPolicy::BUCKET_SIZES ) )
+		std::cout << "  ERROR: generated table wastes no less than the default\n";
+
+	// 放宽期望浪费换更少的桶 / A looser waste target buys fewer buckets
+	SizeClassGeneratorOptions loose;
+	loose.target_waste = 0.2;
+	if ( generate_size_classes( histogram, loose ).size() >= sizes.size() )
+		std::cout << "  ERROR: waste target did not reduce the bucket count\n";
+
+	std::stringstream histogram_text;
+	histogram.write( histogram_text );
+	if ( SizeHistogram::read( histogram_text ).counts != histogram.counts )
+		std::cout << "  ERROR: histogram text round trip lost bins\n";
+
+	std::ostringstream header;
+	write_size_class_policy( header, sizes );
+	if ( header.str().find( "struct TunedSizeClassPolicy" ) == std::string::npos || header.str().find( "#define MEMORY_POOL_SIZE_CLASS_POLICY TunedSizeClassPolicy" ) == std::string::npos )
+		std::cout << "  ERROR: policy header malformed\n";
+
+	std::cout << "  " << sizes.size() << " buckets, expected waste " << expected_waste( histogram, sizes ) << " vs default " << expected_waste( histogram, DefaultSizeClassPolicy::BUCKET_SIZES ) << "\n";
+	std::cout << "  Size class generator OK\n";
+}
+
+void test_arena()
+{
+	std::cout << "\n=== Testing Arena ===\n";
+	using namespace os_memory::allocator;
+
+	Arena arena;
+	void* first = arena.allocate( 24 );
+	void* aligned = arena.allocate( 100, 256 );
+	if ( !first || reinterpret_cast<uintptr_t>( aligned ) % 256 != 0 )
+		std::cout << "  ERROR: arena allocation misaligned\n";
+	std::memset( aligned, 0xAB, 100 );
+
+	// 嵌套回卷：内层 chunk 全部归还，外层位置不变 / Nested rewinds: inner chunks all go back, the outer position is kept
+	const size_t outer_chunks = arena.chunk_count();
+	{
+		ScopedArena outer( arena );
+		for ( int i = 0; i < 4000; ++i )
+			arena.allocate( 64 );
+		const size_t middle_chunks = arena.chunk_count();
+		{
+			ScopedArena inner( arena );
+			arena.allocate( 3ull << 20 );  // 单独成块 / A chunk of its own
+			if ( arena.chunk_count() != middle_chunks + 1 )
+				std::cout << "  ERROR: oversized request did not take its own chunk\n";
+		}
+		if ( arena.chunk_count() != middle_chunks )
+			std::cout << "  ERROR: inner rewind kept chunks\n";
+	}
+	if ( arena.chunk_count() != outer_chunks || arena.used_bytes() != 124 )
+		std::cout << "  ERROR: outer rewind did not restore the arena\n";
+	if ( arena.allocate( 8, 4 ) != static_cast<char*>( aligned ) + 100 )
+		std::cout << "  ERROR: rewind did not reuse the bump position\n";
+
+	{
+		std::vector<int, ArenaAllocator<int>> values { ArenaAllocator<int>( arena ) };
+		for ( int i = 0; i < 10000; ++i )
+			values.push_back( i );
+		if ( values[ 9999 ] != 9999 )
+			std::cout << "  ERROR: arena-backed vector lost data\n";
+	}
+
+	arena.reset();
+	if ( arena.chunk_count() != 0 || arena.reserved_bytes() != 0 )
+		std::cout << "  ERROR: reset kept chunks\n";
+
+	std::cout << "  Checkpoints, rewind and STL adapter OK\n";
+}
+
+void test_object_pool()
+{
+	std::cout << "\n=== Testing ObjectPool ===\n";
+	using namespace os_memory::allocator;
+
+	struct OrderNode
+	{
+		uint64_t   identifier;
+		double	   price;
+		OrderNode* next;
+	};
+	struct alignas( 64 ) WideState
+	{
+		char bytes[ 100 ];
+	};
+	struct ThrowingState
+	{
+		explicit ThrowingState( bool fail )
+		{
+			if ( fail )
+				throw std::runtime_error( "construction failed" );
+		}
+	};
+	static_assert( ObjectPool<OrderNode>::BLOCK_BYTES == SmallMemoryManager::BUCKET_SIZES[ SmallMemoryManager::calculate_bucket_index( sizeof( OrderNode ) ) ] && ObjectPool<OrderNode>::USES_SLAB );
+	static_assert( ObjectPool<WideState>::BLOCK_BYTES == SmallMemoryManager::BUCKET_SIZES[ SmallMemoryManager::calculate_bucket_index( sizeof( WideState ) ) ] && !ObjectPool<WideState>::USES_SLAB );
+	static_assert( sizeof( PooledPointer<OrderNode> ) == sizeof( OrderNode* ) );
+
+	std::vector<PooledPointer<OrderNode>> nodes;
+	for ( uint64_t i = 0; i < 5000; ++i )
+		nodes.push_back( make_pooled<OrderNode>( OrderNode { i, 1.5 * static_cast<double>( i ), nullptr } ) );
+	for ( uint64_t i = 0; i < nodes.size(); ++i )
+	{
+		if ( nodes[ i ]->identifier != i || nodes[ i ]->price != 1.5 * static_cast<double>( i ) )
+			std::cout << "  ERROR: pooled object corrupted\n";
+	}
+
+	// 另一线程销毁：块进入该线程的链表，线程退出时归还 / Destroyed on another thread: blocks join that thread's list and go back when it exits
+	std::thread( [ &nodes ]() { nodes.clear(); } ).join();
+
+	PooledPointer<WideState> wide = make_pooled<WideState>();
+	if ( reinterpret_cast<uintptr_t>( wide.get() ) % 64 != 0 )
+		std::cout << "  ERROR: over-aligned pooled object misaligned\n";
+	wide.reset();
+
+	const size_t cached = ObjectPool<ThrowingState>::cached_count();
+	try
+	{
+		make_pooled<ThrowingState>( true );
+		std::cout << "  ERROR: constructor exception was swallowed\n";
+	}
+	catch ( const std::runtime_error& )
+	{
+	}
+	if ( ObjectPool<ThrowingState>::cached_count() < cached || ObjectPool<ThrowingState>::cached_count() > ObjectPool<ThrowingState>::FREE_LIST_LIMIT )
+		std::cout << "  ERROR: slot of a failed construction was lost\n";
+
+	ObjectPool<OrderNode>::release_cached();
+	ObjectPool<WideState>::release_cached();
+	ObjectPool<ThrowingState>::release_cached();
+	if ( ObjectPool<OrderNode>::cached_count() != 0 )
+		std::cout << "  ERROR: release_cached kept blocks\n";
+
+	std::cout << "  Typed free lists and make_pooled OK\n";
+}
+
 void test_memory_boundary_access()
 {
 	std::cout << "\n=== Testing Memory Boundary Access ===\n";
@@ -364,6 +1052,29 @@ void test_memory_boundary_access()
 	}
 }
 
+/// @brief 测试各级对齐请求均由池内层级满足 / Test that every supported alignment is served from the pool tiers
+void test_aligned_allocation()
+{
+	std::cout << "\n=== Testing Aligned Allocation ===\n";
+
+	const std::array<size_t, 4> size_options = { 8, 200, 4000, 2 * 1024 * 1024 };
+	for ( size_t alignment = 16; alignment <= MAX_ALLOWED_ALIGNMENT; alignment <<= 1 )
+	{
+		for ( size_t allocation_size : size_options )
+		{
+			char* aligned_pointer = static_cast<char*>( ALLOCATE_ALIGNED( allocation_size, alignment ) );
+			if ( reinterpret_cast<uintptr_t>( aligned_pointer ) % alignment != 0 )
+			{
+				std::cout << "  ERROR: " << allocation_size << " bytes @ alignment " << alignment << " misaligned\n";
+			}
+			aligned_pointer[ 0 ] = 'A';
+			aligned_pointer[ allocation_size - 1 ] = 'Z';
+			DEALLOCATE( aligned_pointer );
+		}
+	}
+	std::cout << "  Aligned allocations up to " << MAX_ALLOWED_ALIGNMENT << " bytes checked\n";
+}
+
 /// @brief 故意泄漏测试 / Intentional leak test
 void test_leak_scenario()
 {
@@ -420,6 +1131,39 @@ void test_vector_with_allocator()
 	std::cout << "[vector] reserve, push_back & access OK\n";
 }
 
+/// @brief 测试绑定池的分配器与 pmr 资源 / Test the pool-bound allocator and the pmr resource
+void test_pool_bound_allocator()
+{
+	using namespace os_memory::allocator;
+
+	// 子系统自有的池；容器移到另一线程销毁，释放仍回到这个池 / A subsystem's own pool; the container is destroyed on another thread and still frees into it
+	PoolAllocator						 subsystem_pool;
+	std::vector<int, PoolBoundAllocator<int>> values { PoolBoundAllocator<int>( subsystem_pool ) };
+	for ( int i = 0; i < 10000; ++i )
+		values.push_back( i );
+	assert( &values.get_allocator().allocator() == &subsystem_pool );
+	assert( values.get_allocator() != PoolBoundAllocator<int>( *os_memory::api::GlobalAllocator::get() ) );
+	std::thread( [ &values ]() {
+		auto moved = std::move( values );
+		assert( moved[ 9999 ] == 9999 );
+	} ).join();
+
+	// STL_Allocator 共用 GlobalAllocator，跨线程释放同样安全 / STL_Allocator shares GlobalAllocator, so a cross-thread free is safe too
+	std::vector<int, STL_Allocator<int>> shared_values( 1000, 7 );
+	std::thread( [ &shared_values ]() { std::vector<int, STL_Allocator<int>>().swap( shared_values ); } ).join();
+
+	PoolMemoryResource resource( subsystem_pool );
+	{
+		std::pmr::vector<std::pmr::string> strings( &resource );
+		for ( int i = 0; i < 100; ++i )
+			strings.emplace_back( 64, static_cast<char>( 'a' + i % 26 ) );
+		assert( strings[ 99 ][ 63 ] == 'a' + 99 % 26 );
+	}
+	assert( resource.is_equal( PoolMemoryResource( subsystem_pool ) ) );
+	assert( !resource.is_equal( PoolMemoryResource() ) );
+	std::cout << "[pool-bound] subsystem pool, cross-thread free & pmr resource OK\n";
+}
+
 /// @brief 测试对齐设置及 nothrow 模式 / Test alignment and nothrow mode
 void test_alignment_and_nothrow()
 {
@@ -471,16 +1215,35 @@ int main( int argument_count, char** argument_values )
 	std::cout << "=== Running STL_Allocator Tests ===\n";
 	test_direct_allocate();
 	test_vector_with_allocator();
+	test_pool_bound_allocator();
 	test_alignment_and_nothrow();
 	std::cout << "=== All Tests Passed ===\n";
 
 	std::cout << "=== Running GlobalAllocator or PoolAllocator Tests ===\n";
 	test_memory_boundary_access();	// 测试通过 / Test passed
+	test_aligned_allocation();
 	test_nothrow();					// 测试通过 / Test passed
 	test_memory_leak();				// 测试通过 / Test passed
 	test_fragmentation();			// 测试通过 / Test passed
 	test_large_fragmentation();		// 测试通过 / Test passed
 	test_multithreaded();			// 测试通过 / Test passed
+	test_cross_thread_free();
+	test_trim();
+	test_page_policy();
+	test_reallocate();
+	test_sized_deallocate();
+	test_pointer_classification();
+	test_batch_allocation();
+	test_numa_allocation();
+	test_memory_tracking();
+	test_heap_profiler();
+	test_memory_statistics();
+	test_reserve();
+	test_memory_limit();
+	test_allocate_zeroed();
+	test_size_class_generator();
+	test_arena();
+	test_object_pool();
 	std::cout << "=== All Tests Exexcuted ===\n";
 
 	// test_leak_scenario();    // 测试通过 / Test passed
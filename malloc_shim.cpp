@@ -0,0 +1,809 @@
+/**
+ * @file malloc_shim.cpp
+ * @brief malloc/free 与全局 operator new/delete 替换层 / Drop-in replacement for malloc/free and global operator new/delete
+ *
+ * @details
+ * 把整个进程的堆分配接到 GlobalAllocator 的池上，第三方库与普通 new 也走线程本地快路径：
+ * Routes every heap allocation of the process to GlobalAllocator's pool, so third-party libraries and plain new take the
+ * thread-local fast path too:
+ * 1. C 接口 / C interface: malloc, free, calloc, realloc, posix_memalign, aligned_alloc, memalign, valloc, pvalloc,
+ *    malloc_usable_size（仅 Linux/ELF，可 LD_PRELOAD 或静态链接 / Linux/ELF only, via LD_PRELOAD or static linking）;
+ * 2. C++ 接口 / C++ interface: 全部可替换的 operator new/delete，含 nothrow、带尺寸与对齐版本 /
+ *    every replaceable operator new/delete, including the nothrow, sized and aligned variants (all platforms).
+ *
+ * 自举与回退 / Bootstrap and fallback
+ * - 池在本模块的最早期构造函数里创建，之前（动态加载器、C/C++ 运行库初始化）的请求走回退分配器；
+ *   The pool is created by this module's earliest constructor; requests made before that (dynamic loader, C/C++ runtime
+ *   start-up) go to the fallback allocator.
+ * - 池内部自身的分配（容器增长、后台线程、错误输出）在线程本地标记下也走回退，避免重入同一把锁；
+ *   GlobalAllocator 的每个入口与池的后台线程同样带此标记。
+ *   Allocations made by the pool itself (container growth, background threads, diagnostics) are flagged thread-locally and
+ *   also go to the fallback, so they never re-enter a lock the pool already holds; every GlobalAllocator entry point and the
+ *   pool's background threads carry the same flag.
+ * - 回退块来自系统分配器（glibc 的 __libc_malloc、Windows 的进程堆），其他平台来自静态引导区或直接映射的页；
+ *   指针前方有带魔数的 FallbackHeader。free 先查 slab 页表，再认魔数，其余交给池，因此回退指针与池指针可以混用同一个 free。
+ *   Fallback blocks come from the system allocator (glibc's __libc_malloc, the Windows process heap), elsewhere from a static
+ *   bootstrap arena or pages mapped directly, with a FallbackHeader carrying a magic number right before the pointer; free
+ *   checks the slab page map first, then the magic, and hands everything else to the pool, so fallback and pool pointers
+ *   share one free.
+ * - malloc 与 operator new 不经过泄漏追踪；my_allocate 照常追踪。
+ *   malloc and operator new are not leak-tracked; my_allocate is tracked as usual.
+ * - 替换层的池永不析构：atexit 与线程退出回调中的释放仍然安全。
+ *   The shim's pool is never destroyed, so frees from atexit handlers and thread-exit callbacks stay safe.
+ *
+ * 构建 / Build
+ *   LD_PRELOAD: g++ -std=c++20 -O2 -fPIC -shared -pthread malloc_shim.cpp memory_pool.cpp -latomic -o libpoolmalloc.so
+ *               LD_PRELOAD=./libpoolmalloc.so ./application
+ *   静态链接 / Static linking: 把 malloc_shim.cpp 加入可执行文件的源文件 / add malloc_shim.cpp to the executable's sources.
+ *
+ * @note 链入替换层后 GlobalAllocator 即替换层的池（my_allocate 与 malloc 互通），之后不要再调用 GlobalAllocator::set。
+ *       Once the shim is linked in, GlobalAllocator is the shim's pool (my_allocate and malloc interoperate); do not call
+ *       GlobalAllocator::set afterwards.
+ */
+
+#include "global_allocator_api.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#if !defined( _WIN32 )
+#include <unistd.h>
+#endif
+#if defined( __GLIBC__ )
+#include <malloc.h>
+
+extern "C" void* __libc_malloc( std::size_t bytes );
+extern "C" void	 __libc_free( void* pointer );
+#endif
+
+namespace
+{
+	using os_memory::allocator::InterfaceAllocator;
+	using os_memory::allocator::PoolAllocator;
+
+	constexpr std::size_t FUNDAMENTAL_ALIGNMENT = alignof( std::max_align_t );	 //!< malloc 的对齐保证 / Alignment malloc guarantees
+	constexpr std::uint64_t FALLBACK_MAGIC = 0xF0A11BAC4B10C5EDull;				 //!< 非规范地址，不会与块头中的指针或尺寸相同 / Non-canonical, so never equal to a pointer or size in a pool header
+#if !defined( __GLIBC__ ) && !defined( _WIN32 )
+	constexpr std::size_t BOOTSTRAP_ARENA_BYTES = 256 * 1024;  //!< 引导区容量 / Bootstrap arena capacity
+	constexpr std::size_t BOOTSTRAP_BLOCK_LIMIT = 4096;		   //!< 更大的回退块直接映射页 / Larger fallback blocks map pages directly
+#endif
+
+	/**
+	 * @brief 回退块头，紧贴用户指针之前 / Fallback block header, immediately before the user pointer
+	 * @note magic 位于 pointer - 8：池指针在该处是 NotAlignHeader::raw 或 AlignHeader::size
+	 *       magic sits at pointer - 8, where a pool pointer has NotAlignHeader::raw or AlignHeader::size
+	 */
+	struct FallbackHeader
+	{
+		void*		  base;			   //!< 系统块或映射的首地址，引导区块为 nullptr / System block or mapping base, nullptr for bootstrap blocks
+		std::size_t	  mapping_bytes;   //!< 映射字节数，系统块为 0 / Mapping size, 0 for system blocks
+		std::size_t	  usable_bytes;	   //!< 用户可用字节数 / Usable bytes
+		std::uint64_t magic;		   //!< == FALLBACK_MAGIC
+	};
+
+#if !defined( __GLIBC__ ) && !defined( _WIN32 )
+	alignas( 64 ) char		 bootstrap_arena[ BOOTSTRAP_ARENA_BYTES ];
+	std::atomic<std::size_t> bootstrap_cursor { 0 };
+#endif
+
+	std::atomic<bool> shim_ready { false };	 //!< 池已构造且运行库已初始化 / Pool constructed and runtimes initialised
+	alignas( PoolAllocator ) unsigned char pool_storage[ sizeof( PoolAllocator ) ];
+	PoolAllocator* shim_pool = nullptr;
+
+	/// @brief 本线程正在执行池代码：嵌套请求走回退 / This thread is running pool code, so nested requests go to the fallback
+#if defined( __GNUC__ )
+	__attribute__( ( tls_model( "initial-exec" ) ) )
+#endif
+	thread_local bool inside_pool = false;
+
+	/// @brief 作用域内标记 inside_pool，可嵌套 / Marks inside_pool for a scope; scopes nest
+	struct PoolScope
+	{
+		bool was_inside;
+		PoolScope() : was_inside( std::exchange( inside_pool, true ) ) {}
+		~PoolScope()
+		{
+			inside_pool = was_inside;
+		}
+	};
+
+	/* ------------------------------ 回退分配器 / Fallback allocator ------------------------------ */
+
+	/// @brief 在 [base, base + bytes) 内放置块头并返回对齐的用户指针 / Place the header inside [base, base + bytes) and return the aligned user pointer
+	void* place_fallback( void* base, std::size_t bytes, std::size_t mapping_bytes, std::size_t alignment ) noexcept
+	{
+		const std::uintptr_t user = ( reinterpret_cast<std::uintptr_t>( base ) + sizeof( FallbackHeader ) + alignment - 1 ) & ~( static_cast<std::uintptr_t>( alignment ) - 1 );
+		auto*				 header = reinterpret_cast<FallbackHeader*>( user ) - 1;
+		*header = { base, mapping_bytes, bytes - static_cast<std::size_t>( user - reinterpret_cast<std::uintptr_t>( base ) ), FALLBACK_MAGIC };
+		return reinterpret_cast<void*>( user );
+	}
+
+	void* fallback_allocate( std::size_t bytes, std::size_t alignment ) noexcept
+	{
+		alignment = std::max( alignment, FUNDAMENTAL_ALIGNMENT );
+		if ( bytes > SIZE_MAX - sizeof( FallbackHeader ) - alignment )
+			return nullptr;
+		const std::size_t total_bytes = bytes + sizeof( FallbackHeader ) + alignment;
+
+#if defined( __GLIBC__ ) || defined( _WIN32 )
+		/* 系统分配器：本模块之外的堆，与池的锁无关 / The system allocator: a heap outside this module, independent of the pool's locks */
+#if defined( __GLIBC__ )
+		void* const base = __libc_malloc( total_bytes );
+#else
+		void* const base = HeapAlloc( GetProcessHeap(), 0, total_bytes );
+#endif
+		return base ? place_fallback( base, total_bytes, 0, alignment ) : nullptr;
+#else
+		/* 1) 小块：从引导区顺序切分，释放时不回收 / Small blocks: bumped out of the bootstrap arena, never reclaimed */
+		if ( bytes <= BOOTSTRAP_BLOCK_LIMIT && alignment <= BOOTSTRAP_BLOCK_LIMIT )
+		{
+			std::size_t cursor = bootstrap_cursor.load( std::memory_order_relaxed );
+			for ( ;; )
+			{
+				const std::uintptr_t base = reinterpret_cast<std::uintptr_t>( bootstrap_arena );
+				const std::uintptr_t user = ( base + cursor + sizeof( FallbackHeader ) + alignment - 1 ) & ~( static_cast<std::uintptr_t>( alignment ) - 1 );
+				const std::size_t	 next_cursor = static_cast<std::size_t>( user - base ) + bytes;
+				if ( next_cursor > BOOTSTRAP_ARENA_BYTES )
+					break;	// 引导区已满，改为映射 / Arena exhausted, map pages instead
+				if ( bootstrap_cursor.compare_exchange_weak( cursor, next_cursor, std::memory_order_relaxed ) )
+				{
+					auto* header = reinterpret_cast<FallbackHeader*>( user ) - 1;
+					*header = { nullptr, 0, bytes, FALLBACK_MAGIC };
+					return reinterpret_cast<void*>( user );
+				}
+			}
+		}
+
+		/* 2) 其余：直接映射，不计入池的字节计数 / Otherwise map pages directly, not counted as pool bytes */
+		void* const mapping = os_memory::allocate_memory( total_bytes );
+		return mapping ? place_fallback( mapping, total_bytes, total_bytes, alignment ) : nullptr;
+#endif
+	}
+
+	/// @brief 读取回退块头；不是回退块返回 false / Read a fallback header, false when the pointer is not a fallback block
+	bool find_fallback( void* pointer, FallbackHeader& header ) noexcept
+	{
+		// 池指针由页表判定，不读其前方内存（slab 对象前方是相邻对象的数据）/ Pool pointers are classified by the page maps without reading in front of them (a slab object has its neighbour's data there)
+		if ( MemoryPool::owns( pointer ) )
+			return false;
+		std::memcpy( &header, static_cast<const FallbackHeader*>( pointer ) - 1, sizeof( header ) );
+		return header.magic == FALLBACK_MAGIC;
+	}
+
+	void fallback_deallocate( const FallbackHeader& header ) noexcept
+	{
+		if ( !header.base )
+			return;	 // 引导区块不回收 / Bootstrap blocks are not reclaimed
+		if ( header.mapping_bytes != 0 )
+			os_memory::deallocate_memory( header.base, header.mapping_bytes );
+#if defined( __GLIBC__ )
+		else
+			__libc_free( header.base );
+#elif defined( _WIN32 )
+		else
+			HeapFree( GetProcessHeap(), 0, header.base );
+#endif
+	}
+
+	/* ------------------------------ 池接入 / Pool routing ------------------------------ */
+
+	/// @brief 能满足 bytes 字节任意基本对象的对齐 / Alignment enough for any fundamental object of bytes bytes
+	std::size_t natural_alignment( std::size_t bytes ) noexcept
+	{
+		return bytes >= FUNDAMENTAL_ALIGNMENT ? FUNDAMENTAL_ALIGNMENT : sizeof( void* );
+	}
+
+	bool use_pool( std::size_t alignment ) noexcept
+	{
+		return !inside_pool && alignment <= MAX_ALLOWED_ALIGNMENT && shim_ready.load( std::memory_order_acquire );
+	}
+
+	void* shim_allocate( std::size_t bytes, std::size_t alignment ) noexcept
+	{
+		bytes = std::max<std::size_t>( bytes, 1 );	// malloc(0) 返回唯一指针 / malloc(0) returns a unique pointer
+		alignment = std::max( alignment, natural_alignment( bytes ) );
+		if ( !use_pool( alignment ) )
+			return fallback_allocate( bytes, alignment );
+
+		PoolScope scope;
+		try
+		{
+			return shim_pool->allocate( bytes, alignment, nullptr, 0, true );
+		}
+		catch ( ... )
+		{
+			return nullptr;
+		}
+	}
+
+	/// @brief calloc 的池路径：池知道哪些块本就为零 / The pool path of calloc: the pool knows which blocks are zero already
+	void* shim_allocate_zeroed( std::size_t count, std::size_t bytes ) noexcept
+	{
+		if ( bytes != 0 && count > SIZE_MAX / bytes )
+			return nullptr;
+		const std::size_t total_bytes = std::max<std::size_t>( count * bytes, 1 );
+		const std::size_t alignment = natural_alignment( total_bytes );
+		if ( !use_pool( alignment ) )
+		{
+			void* const pointer = fallback_allocate( total_bytes, alignment );
+			if ( pointer )
+				std::memset( pointer, 0, total_bytes );	 // 引导区与 libc 回退块不保证为零 / Bootstrap and libc fallback blocks are not guaranteed to be zero
+			return pointer;
+		}
+
+		PoolScope scope;
+		try
+		{
+			return shim_pool->allocate_zeroed( 1, total_bytes, alignment, nullptr, 0, true );
+		}
+		catch ( ... )
+		{
+			return nullptr;
+		}
+	}
+
+	/**
+	 * @brief 释放任意来源的指针 / Free a pointer of either origin
+	 * @param bytes      非 0 时走带尺寸释放，须与分配时传给池的尺寸一致 / when non-zero, sized deallocation with the size the pool was given
+	 * @param alignment  同一次请求传给池的对齐 / alignment the pool was given for that same request
+	 */
+	void release( void* pointer, std::size_t bytes, std::size_t alignment ) noexcept
+	{
+		if ( !pointer )
+			return;
+		FallbackHeader header;
+		if ( find_fallback( pointer, header ) )
+		{
+			fallback_deallocate( header );
+			return;
+		}
+		if ( !shim_pool )
+			return;	 // 池构造前不可能有池指针：来历不明，放弃 / No pool pointer can exist before the pool: unknown origin, leave it
+
+		PoolScope scope;
+		try
+		{
+			if ( bytes == 0 )
+				shim_pool->deallocate( pointer );
+			else
+				shim_pool->deallocate( pointer, bytes, alignment );
+		}
+		catch ( ... )
+		{
+		}
+	}
+
+	/// @brief 释放 shim_allocate 的结果；尺寸与对齐按 shim_allocate 的规则还原 / Free a shim_allocate result, rebuilding size and alignment by its rules
+	void shim_deallocate( void* pointer, std::size_t bytes = 0, std::size_t alignment = 0 ) noexcept
+	{
+		if ( bytes == 0 )
+		{
+			release( pointer, 0, 0 );
+			return;
+		}
+		bytes = std::max<std::size_t>( bytes, 1 );
+		release( pointer, bytes, std::max( alignment, natural_alignment( bytes ) ) );
+	}
+
+	std::size_t shim_usable_size( void* pointer ) noexcept
+	{
+		if ( !pointer )
+			return 0;
+		FallbackHeader header;
+		if ( find_fallback( pointer, header ) )
+			return header.usable_bytes;
+		return shim_pool ? shim_pool->usable_size( pointer ) : 0;
+	}
+
+	void* shim_reallocate( void* pointer, std::size_t bytes ) noexcept
+	{
+		if ( !pointer )
+			return shim_allocate( bytes, 0 );
+		if ( bytes == 0 )
+		{
+			shim_deallocate( pointer );
+			return nullptr;
+		}
+
+		FallbackHeader header;
+		const bool	   is_fallback = find_fallback( pointer, header );
+		if ( !is_fallback && use_pool( 0 ) )
+		{
+			PoolScope scope;
+			try
+			{
+				return shim_pool->reallocate( pointer, bytes, natural_alignment( bytes ), nullptr, 0, true );
+			}
+			catch ( ... )
+			{
+				return nullptr;
+			}
+		}
+
+		/* 回退块，或池尚不可用：分配、复制、释放 / A fallback block, or the pool is unavailable: allocate, copy, free */
+		void* const moved = shim_allocate( bytes, 0 );
+		if ( !moved )
+			return nullptr;
+		std::memcpy( moved, pointer, std::min( bytes, is_fallback ? header.usable_bytes : shim_usable_size( pointer ) ) );
+		shim_deallocate( pointer );
+		return moved;
+	}
+
+	/**
+	 * @brief 登记为 GlobalAllocator 的包装：每个入口都标记 inside_pool，并自行做泄漏追踪
+	 *        The wrapper installed as GlobalAllocator: every entry marks inside_pool, and it does its own leak tracking
+	 * @note 底层 PoolAllocator 从不开启追踪，于是 malloc 不被登记，追踪器持锁时的分配也不会重入追踪器
+	 *       The PoolAllocator underneath never enables tracking, so malloc is not recorded and allocations the tracker makes
+	 *       under its locks never re-enter it
+	 */
+	class ShimAllocator final : public InterfaceAllocator
+	{
+	public:
+		void* allocate( size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			void* user_pointer;
+			{
+				PoolScope scope;
+				user_pointer = shim_pool->allocate( size, alignment, file, line, nothrow );
+			}
+			track_allocation( user_pointer, size, file, line );
+			return user_pointer;
+		}
+
+		void* allocate_zeroed( size_t count, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			void* user_pointer;
+			{
+				PoolScope scope;
+				user_pointer = shim_pool->allocate_zeroed( count, size, alignment, file, line, nothrow );
+			}
+			track_allocation( user_pointer, count * size, file, line );
+			return user_pointer;
+		}
+
+		void* allocate_on_node( size_t numa_node, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			void* user_pointer;
+			{
+				PoolScope scope;
+				user_pointer = shim_pool->allocate_on_node( numa_node, size, alignment, file, line, nothrow );
+			}
+			track_allocation( user_pointer, size, file, line );
+			return user_pointer;
+		}
+
+		void deallocate( void* user_pointer ) override
+		{
+			track_deallocation( user_pointer );
+			release( user_pointer, 0, 0 );
+		}
+
+		void deallocate( void* user_pointer, size_t size, size_t alignment ) override
+		{
+			track_deallocation( user_pointer );
+			release( user_pointer, size, alignment );
+		}
+
+		size_t allocate_batch( size_t size, size_t count, void** out_pointers, const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			size_t allocated;
+			{
+				PoolScope scope;
+				allocated = shim_pool->allocate_batch( size, count, out_pointers, file, line, nothrow );
+			}
+			for ( size_t i = 0; i < allocated; ++i )
+				track_allocation( out_pointers[ i ], size, file, line );
+			return allocated;
+		}
+
+		void deallocate_batch( void* const* pointers, size_t count ) override
+		{
+			for ( size_t i = 0; i < count; ++i )
+				track_deallocation( pointers[ i ] );
+			PoolScope scope;
+			shim_pool->deallocate_batch( pointers, count );
+		}
+
+		size_t usable_size( void* user_pointer ) override
+		{
+			return shim_usable_size( user_pointer );
+		}
+
+		void* reallocate( void* user_pointer, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( !user_pointer )
+				return allocate( size, alignment, file, line, nothrow );
+			if ( size == 0 )
+			{
+				deallocate( user_pointer );
+				return nullptr;
+			}
+
+			// 与 PoolAllocator::reallocate 相同：先注销，失败再恢复 / As PoolAllocator::reallocate does: untrack first, restore on failure
+			AllocationInformation old_information {};
+			const bool			  old_record_found = leak_detection_enabled_ && MemoryTracker::instance().find_allocation( user_pointer, old_information );
+			track_deallocation( user_pointer );
+			auto restore_old_record = [ & ]() {
+				if ( old_record_found )
+					MemoryTracker::instance().restore_allocation( old_information );
+			};
+
+			void* resized_pointer = nullptr;
+			try
+			{
+				FallbackHeader header;
+				if ( find_fallback( user_pointer, header ) )  // 自举期 malloc 的块交给 my_reallocate / A bootstrap malloc block handed to my_reallocate
+				{
+					PoolScope scope;
+					resized_pointer = shim_pool->allocate( size, alignment, file, line, nothrow );
+					if ( resized_pointer )
+					{
+						std::memcpy( resized_pointer, user_pointer, std::min( size, header.usable_bytes ) );
+						fallback_deallocate( header );
+					}
+				}
+				else
+				{
+					PoolScope scope;
+					resized_pointer = shim_pool->reallocate( user_pointer, size, alignment, file, line, nothrow );
+				}
+			}
+			catch ( ... )
+			{
+				restore_old_record();
+				throw;
+			}
+			if ( !resized_pointer )
+			{
+				restore_old_record();
+				return nullptr;
+			}
+			track_allocation( resized_pointer, size, file, line );
+			return resized_pointer;
+		}
+
+		void enable_leak_detection( bool detailed ) override
+		{
+			leak_detection_enabled_ = true;
+			MemoryTracker::instance().enable( detailed );
+		}
+
+		void report_leaks() override
+		{
+			MemoryTracker::instance().report_leaks();
+		}
+
+		size_t current_memory_usage() override
+		{
+			return MemoryTracker::instance().current_memory_usage();
+		}
+
+		size_t trim() override
+		{
+			PoolScope scope;
+			return shim_pool->trim();
+		}
+
+		void set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval ) override
+		{
+			PoolScope scope;
+			shim_pool->set_purge_policy( idle_period, interval );
+		}
+
+		void set_memory_limit( size_t soft_limit_bytes, size_t hard_limit_bytes ) override
+		{
+			PoolScope scope;
+			shim_pool->set_memory_limit( soft_limit_bytes, hard_limit_bytes );
+		}
+
+		bool add_memory_pressure_callback( MemoryPressureCallback callback, void* context ) override
+		{
+			PoolScope scope;
+			return shim_pool->add_memory_pressure_callback( callback, context );
+		}
+
+		void remove_memory_pressure_callback( MemoryPressureCallback callback, void* context ) override
+		{
+			PoolScope scope;
+			shim_pool->remove_memory_pressure_callback( callback, context );
+		}
+
+		size_t relieve_memory_pressure() override
+		{
+			PoolScope scope;
+			return shim_pool->relieve_memory_pressure();
+		}
+
+		size_t reserve( const ReserveProfile& profile ) override
+		{
+			PoolScope scope;
+			return shim_pool->reserve( profile );
+		}
+
+		void set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy ) override
+		{
+			PoolScope scope;
+			shim_pool->set_page_policy( medium_policy, large_policy, huge_policy );
+		}
+
+		MemoryPoolStatistics statistics() override
+		{
+			PoolScope scope;
+			return shim_pool->statistics();
+		}
+
+	private:
+		// 追踪调用不在 PoolScope 内：追踪表的分配走池本身 / Tracker calls stay outside PoolScope, so the tables allocate from the pool itself
+		void track_allocation( void* user_pointer, size_t size, const char* file, size_t line )
+		{
+			if ( leak_detection_enabled_ && user_pointer )
+				MemoryTracker::instance().track_allocation( user_pointer, size, file, static_cast<uint32_t>( line ) );
+		}
+
+		void track_deallocation( void* user_pointer )
+		{
+			if ( leak_detection_enabled_ && user_pointer )
+				MemoryTracker::instance().track_deallocation( user_pointer );
+		}
+
+		bool leak_detection_enabled_ = false;  //!< 是否启用泄露检测 / leak detection enabled
+	};
+
+	alignas( ShimAllocator ) unsigned char wrapper_storage[ sizeof( ShimAllocator ) ];
+
+	/// @brief 池的后台线程只做池内部的分配 / The pool's background threads allocate only for the pool itself
+	void enter_pool_worker()
+	{
+		inside_pool = true;
+	}
+
+	/// @brief 构造永不析构的池并登记包装为 GlobalAllocator / Construct the never-destroyed pool and install the wrapper as GlobalAllocator
+	void initialize_shim() noexcept
+	{
+		if ( shim_ready.load( std::memory_order_acquire ) )
+			return;
+		PoolScope scope;
+		MemoryPool::suppress_construction_warning();
+		MemoryPool::set_worker_thread_hook( &enter_pool_worker );
+		shim_pool = new ( pool_storage ) PoolAllocator();
+		os_memory::api::GlobalAllocator::set( new ( wrapper_storage ) ShimAllocator() );
+		shim_ready.store( true, std::memory_order_release );
+	}
+
+#if defined( _MSC_VER )
+#pragma warning( disable : 4073 )
+#pragma init_seg( lib )
+	struct ShimInitializer
+	{
+		ShimInitializer()
+		{
+			initialize_shim();
+		}
+	} shim_initializer;
+#else
+	/* 优先级 101：早于本可执行文件内其他静态构造 / Priority 101: before the other static constructors of this module */
+	__attribute__( ( constructor( 101 ) ) ) void shim_constructor()
+	{
+		initialize_shim();
+	}
+#endif
+
+	bool is_valid_alignment( std::size_t alignment ) noexcept
+	{
+		return alignment != 0 && ( alignment & ( alignment - 1 ) ) == 0;
+	}
+
+	/// @brief operator new 的失败语义：调用 new_handler 重试，没有时抛出 / operator new failure semantics: retry through new_handler, throw when none is set
+	void* allocate_or_throw( std::size_t bytes, std::size_t alignment )
+	{
+		for ( ;; )
+		{
+			if ( void* pointer = shim_allocate( bytes, alignment ) )
+				return pointer;
+			std::new_handler handler = std::get_new_handler();
+			if ( !handler )
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void* allocate_or_null( std::size_t bytes, std::size_t alignment ) noexcept
+	{
+		try
+		{
+			return allocate_or_throw( bytes, alignment );
+		}
+		catch ( ... )
+		{
+			return nullptr;
+		}
+	}
+
+	void* set_no_memory( void* pointer ) noexcept
+	{
+		if ( !pointer )
+			errno = ENOMEM;
+		return pointer;
+	}
+}  // namespace
+
+/* ================================ C 接口 / C interface ================================ */
+#if !defined( _WIN32 )
+extern "C"
+{
+	void* malloc( std::size_t bytes ) noexcept
+	{
+		return set_no_memory( shim_allocate( bytes, 0 ) );
+	}
+
+	void free( void* pointer ) noexcept
+	{
+		shim_deallocate( pointer );
+	}
+
+	void* calloc( std::size_t count, std::size_t bytes ) noexcept
+	{
+		return set_no_memory( shim_allocate_zeroed( count, bytes ) );
+	}
+
+	void* realloc( void* pointer, std::size_t bytes ) noexcept
+	{
+		void* const resized = shim_reallocate( pointer, bytes );
+		return bytes == 0 ? resized : set_no_memory( resized );
+	}
+
+	int posix_memalign( void** out_pointer, std::size_t alignment, std::size_t bytes ) noexcept
+	{
+		if ( !is_valid_alignment( alignment ) || alignment % sizeof( void* ) != 0 )
+			return EINVAL;
+		void* const pointer = shim_allocate( bytes, alignment );
+		if ( !pointer )
+			return ENOMEM;
+		*out_pointer = pointer;
+		return 0;
+	}
+
+	void* aligned_alloc( std::size_t alignment, std::size_t bytes ) noexcept
+	{
+		if ( !is_valid_alignment( alignment ) )
+		{
+			errno = EINVAL;
+			return nullptr;
+		}
+		return set_no_memory( shim_allocate( bytes, alignment ) );
+	}
+
+	void* memalign( std::size_t alignment, std::size_t bytes ) noexcept
+	{
+		if ( !is_valid_alignment( alignment ) )
+		{
+			errno = EINVAL;
+			return nullptr;
+		}
+		return set_no_memory( shim_allocate( bytes, alignment ) );
+	}
+
+	void* valloc( std::size_t bytes ) noexcept
+	{
+		return set_no_memory( shim_allocate( bytes, static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) ) ) );
+	}
+
+	void* pvalloc( std::size_t bytes ) noexcept
+	{
+		const std::size_t page_size = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+		return set_no_memory( shim_allocate( ( bytes + page_size - 1 ) & ~( page_size - 1 ), page_size ) );
+	}
+
+	std::size_t malloc_usable_size( void* pointer ) noexcept
+	{
+		return shim_usable_size( pointer );
+	}
+}
+#endif
+
+/* ================================ C++ 接口 / C++ interface ================================ */
+void* operator new( std::size_t bytes )
+{
+	return allocate_or_throw( bytes, 0 );
+}
+
+void* operator new[]( std::size_t bytes )
+{
+	return allocate_or_throw( bytes, 0 );
+}
+
+void* operator new( std::size_t bytes, const std::nothrow_t& ) noexcept
+{
+	return allocate_or_null( bytes, 0 );
+}
+
+void* operator new[]( std::size_t bytes, const std::nothrow_t& ) noexcept
+{
+	return allocate_or_null( bytes, 0 );
+}
+
+void* operator new( std::size_t bytes, std::align_val_t alignment )
+{
+	return allocate_or_throw( bytes, static_cast<std::size_t>( alignment ) );
+}
+
+void* operator new[]( std::size_t bytes, std::align_val_t alignment )
+{
+	return allocate_or_throw( bytes, static_cast<std::size_t>( alignment ) );
+}
+
+void* operator new( std::size_t bytes, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return allocate_or_null( bytes, static_cast<std::size_t>( alignment ) );
+}
+
+void* operator new[]( std::size_t bytes, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+	return allocate_or_null( bytes, static_cast<std::size_t>( alignment ) );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete( void* pointer, const std::nothrow_t& ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete[]( void* pointer, const std::nothrow_t& ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete( void* pointer, std::size_t bytes ) noexcept
+{
+	shim_deallocate( pointer, bytes );
+}
+
+void operator delete[]( void* pointer, std::size_t bytes ) noexcept
+{
+	shim_deallocate( pointer, bytes );
+}
+
+void operator delete( void* pointer, std::align_val_t ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete[]( void* pointer, std::align_val_t ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete[]( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+	shim_deallocate( pointer );
+}
+
+void operator delete( void* pointer, std::size_t bytes, std::align_val_t alignment ) noexcept
+{
+	shim_deallocate( pointer, bytes, static_cast<std::size_t>( alignment ) );
+}
+
+void operator delete[]( void* pointer, std::size_t bytes, std::align_val_t alignment ) noexcept
+{
+	shim_deallocate( pointer, bytes, static_cast<std::size_t>( alignment ) );
+}
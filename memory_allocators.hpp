@@ -5,7 +5,7 @@
  * @details
  * 1. 定义通用分配器接口 / Define general allocator interface;
  * 2. 基于 OS 内存请求的 SystemAllocator 实现 / SystemAllocator implementation using OS memory APIs;
- * 3. 基于线程本地 MemoryPool 的 PoolAllocator 实现 / PoolAllocator implementation using thread-local MemoryPool.
+ * 3. 基于按 NUMA 节点分片的 MemoryPool 的 PoolAllocator 实现 / PoolAllocator implementation using MemoryPool shards per NUMA node.
  *
  * 代码风格说明 / Style Notes
  * ---------------------------------------------------------------------------
@@ -27,7 +27,14 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
 
 namespace os_memory::allocator
 {
@@ -54,6 +61,109 @@ namespace os_memory::allocator
 		 */
 		virtual void deallocate( void* pointer ) = 0;
 
+		/**
+		 * @brief 带尺寸释放内存 / Sized deallocation
+		 * @param pointer        先前分配的指针 / pointer previously allocated
+		 * @param size           分配（或最近一次 reallocate）时的字节数 / byte count of the allocation or the latest reallocate
+		 * @param alignment      同一次请求的对齐 / alignment of that same request
+		 */
+		virtual void deallocate( void* pointer, size_t size, size_t alignment ) = 0;
+
+		/**
+		 * @brief 查询指针实际可用的字节数 / Query the bytes actually usable through a pointer
+		 * @param pointer        先前分配的指针 / pointer previously allocated
+		 * @return 不小于请求值的可用字节数，未知指针返回 0 / usable bytes, never less than requested; 0 for unknown pointers
+		 */
+		virtual size_t usable_size( void* pointer ) = 0;
+
+		/**
+		 * @brief 分配 count 个 size 字节的元素并清零 / Allocate count elements of size bytes each, zero-filled
+		 * @return count * size 溢出或分配失败时为 nullptr（nothrow 为 false 时抛出 std::bad_alloc）/ nullptr when count * size overflows or allocation fails (std::bad_alloc unless nothrow)
+		 * @note 默认实现为 allocate 加 memset / The default implementation is allocate plus memset
+		 * @see allocate
+		 */
+		virtual void* allocate_zeroed( size_t count, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			if ( size != 0 && count > std::numeric_limits<size_t>::max() / size )
+			{
+				if ( !nothrow )
+					throw std::bad_alloc();
+				return nullptr;
+			}
+			void* const user_pointer = allocate( count * size, alignment, file, line, nothrow );
+			if ( user_pointer )
+				std::memset( user_pointer, 0, count * size );
+			return user_pointer;
+		}
+
+		/**
+		 * @brief 从指定 NUMA 节点分配 / Allocate from a given NUMA node
+		 * @param numa_node      节点号，超出范围时按当前节点 / node number; out of range falls back to the current node
+		 * @note 默认实现忽略节点 / The default implementation ignores the node
+		 * @see allocate
+		 */
+		virtual void* allocate_on_node( size_t numa_node, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			( void )numa_node;
+			return allocate( size, alignment, file, line, nothrow );
+		}
+
+		/**
+		 * @brief 批量分配同尺寸内存 / Allocate a batch of same-size blocks
+		 * @param size           每块字节数 / bytes per block
+		 * @param count          块个数 / number of blocks
+		 * @param out_pointers   接收 count 个指针的数组 / array receiving count pointers
+		 * @param file           源文件名（可选，用于追踪）/ source file (optional, for tracking)
+		 * @param line           源代码行号（可选，用于追踪）/ source line (optional, for tracking)
+		 * @param nothrow        分配失败时是否抛出异常 / throw on failure if false
+		 * @return 成功时为 count，失败时为 0 且不保留任何块 / count on success, 0 on failure with no block kept
+		 * @note 默认实现逐个调用 allocate / The default implementation calls allocate once per block
+		 */
+		virtual size_t allocate_batch( size_t size, size_t count, void** out_pointers, const char* file = nullptr, size_t line = 0, bool nothrow = false )
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				try
+				{
+					out_pointers[ i ] = allocate( size, sizeof( void* ), file, line, nothrow );
+				}
+				catch ( ... )
+				{
+					deallocate_batch( out_pointers, i );
+					throw;
+				}
+				if ( out_pointers[ i ] == nullptr )
+				{
+					deallocate_batch( out_pointers, i );
+					return 0;
+				}
+			}
+			return count;
+		}
+
+		/**
+		 * @brief 批量释放内存 / Free a batch of blocks
+		 * @param pointers       先前分配的指针，nullptr 被跳过 / pointers previously allocated, nullptr is skipped
+		 * @param count          指针个数 / number of pointers
+		 */
+		virtual void deallocate_batch( void* const* pointers, size_t count )
+		{
+			for ( size_t i = 0; i < count; ++i )
+				deallocate( pointers[ i ] );
+		}
+
+		/**
+		 * @brief 调整内存大小 / Resize memory
+		 * @param pointer        先前分配的指针，nullptr 时等同 allocate / pointer previously allocated, nullptr behaves like allocate
+		 * @param size           新的字节数，0 时释放并返回 nullptr / new byte count, 0 frees and returns nullptr
+		 * @param alignment      对齐要求（字节）/ alignment in bytes
+		 * @param file           源文件名（可选，用于追踪）/ source file (optional, for tracking)
+		 * @param line           源代码行号（可选，用于追踪）/ source line (optional, for tracking)
+		 * @param nothrow        分配失败时是否抛出异常 / throw on failure if false
+		 * @return 调整后的指针；失败时原指针仍然有效 / resized pointer; the old pointer stays valid on failure
+		 */
+		virtual void* reallocate( void* pointer, size_t size, size_t alignment = sizeof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) = 0;
+
 		/**
 		 * @brief 启用或禁用内存泄露检测 / Enable or disable leak detection
 		 * @param detailed       是否开启详细追踪 / detailed tracking if true
@@ -68,6 +178,95 @@ namespace os_memory::allocator
 		 * @return 已分配的总字节数 / total bytes currently allocated
 		 */
 		virtual size_t current_memory_usage() = 0;
+
+		/**
+		 * @brief 把空闲的缓存内存归还操作系统 / Return idle cached memory to the OS
+		 * @return 归还的字节数，不缓存的分配器返回 0 / bytes returned, 0 for allocators that cache nothing
+		 */
+		virtual size_t trim()
+		{
+			return 0;
+		}
+
+		/**
+		 * @brief 配置后台归还策略 / Configure background purging
+		 * @param idle_period  空闲多久后归还 / how long memory must stay idle before it is returned
+		 * @param interval     扫描间隔，0 表示关闭 / scan interval, 0 disables it
+		 */
+		virtual void set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval )
+		{
+			( void )idle_period;
+			( void )interval;
+		}
+
+		/**
+		 * @brief 设置软/硬内存上限，0 表示不限 / Set the soft and hard memory limits, 0 meaning none
+		 * @note 不分层的分配器忽略 / Ignored by allocators without tiers
+		 * @see MemoryPool::set_memory_limit
+		 */
+		virtual void set_memory_limit( size_t soft_limit_bytes, size_t hard_limit_bytes )
+		{
+			( void )soft_limit_bytes;
+			( void )hard_limit_bytes;
+		}
+
+		/**
+		 * @brief 登记压力回调 / Register a pressure callback
+		 * @return 登记成功返回 true，不分层的分配器返回 false / true once registered, false for allocators without tiers
+		 */
+		virtual bool add_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+		{
+			( void )callback;
+			( void )context;
+			return false;
+		}
+
+		/// @brief 注销压力回调 / Unregister a pressure callback
+		virtual void remove_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+		{
+			( void )callback;
+			( void )context;
+		}
+
+		/**
+		 * @brief 立即执行一轮压力回收 / Run one pressure pass now
+		 * @return 归还的字节数，不分层的分配器返回 0 / bytes returned, 0 for allocators without tiers
+		 */
+		virtual size_t relieve_memory_pressure()
+		{
+			return 0;
+		}
+
+		/**
+		 * @brief 按清单预热各尺寸类 / Pre-warm size classes from a profile
+		 * @return 预热的块数，不分层的分配器返回 0 / blocks pre-warmed, 0 for allocators without tiers
+		 * @see MemoryPool::reserve
+		 */
+		virtual size_t reserve( const ReserveProfile& profile )
+		{
+			( void )profile;
+			return 0;
+		}
+
+		/**
+		 * @brief 为 Medium/Large/Huge 层的新映射选择页大小 / Choose the page size of new Medium/Large/Huge mappings
+		 * @note 不分层的分配器忽略 / Ignored by allocators without tiers
+		 */
+		virtual void set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy )
+		{
+			( void )medium_policy;
+			( void )large_policy;
+			( void )huge_policy;
+		}
+
+		/**
+		 * @brief 分层统计快照 / Per-tier statistics snapshot
+		 * @note 不分层的分配器返回全零快照 / Allocators without tiers return an all-zero snapshot
+		 */
+		virtual MemoryPoolStatistics statistics()
+		{
+			return {};
+		}
 	};
 
 	/// @brief 基于操作系统内存请求的分配器 / Allocator using OS memory APIs
@@ -83,7 +282,7 @@ namespace os_memory::allocator
 				std::cerr << "[SystemAllocator] Memory leak detected: " << leaked << " bytes still allocated." << std::endl;
 			}
 
-			const uint64_t original_point = os_memory::user_operation_counter.load( std::memory_order_seq_cst );
+			const int64_t original_point = os_memory::user_operation_counter.load( std::memory_order_seq_cst );
 			if ( original_point != 0 )
 			{
 				std::cerr << "[SystemAllocator] Operation imbalance detected: " << original_point << " net operations (allocs minus frees)." << std::endl;
@@ -104,8 +303,18 @@ namespace os_memory::allocator
 			}
 			assert( ( alignment & ( alignment - 1 ) ) == 0 && "alignment must be power of two" );
 
-			// 从操作系统请求内存 / request memory from OS
-			void* raw_pointer = os_memory::allocate_tracked( size, alignment );
+			// 从操作系统请求内存；映射本身页对齐，更大的对齐取 2 MiB 对齐的透明巨页区间
+			// request memory from OS; mappings are page aligned, larger alignments take a 2 MiB aligned transparent range
+			void* raw_pointer = nullptr;
+			if ( alignment > 0x1000 && alignment <= os_memory::HUGE_PAGE_2M_BYTES )
+			{
+				size = os_memory::round_to_pages( size, os_memory::PagePolicy::TRANSPARENT );
+				raw_pointer = os_memory::allocate_pages_tracked( size, os_memory::PagePolicy::TRANSPARENT );
+			}
+			else
+			{
+				raw_pointer = os_memory::allocate_tracked( size, alignment );
+			}
 			if ( raw_pointer == nullptr )
 			{
 				if ( !nothrow )
@@ -121,15 +330,25 @@ namespace os_memory::allocator
 			{
 				MemoryTracker::instance().track_allocation( raw_pointer, size, file, line );
 			}
-			else
-			{
-				// 记录指针和大小 / record pointer and size
-				pointer_map_[ raw_pointer ] = size;
-			}
+
+			// 记录指针和大小：释放与调整大小都需要映射长度 / record pointer and size: both free and resize need the mapping length
+			pointer_map_[ raw_pointer ] = size;
 
 			return raw_pointer;
 		}
 
+		/// @brief 每块都是新映射，本就为零，不再 memset / Every block is a fresh mapping and zero already, so there is no memset
+		void* allocate_zeroed( size_t count, size_t size, size_t alignment = alignof( std::max_align_t ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( size != 0 && count > std::numeric_limits<size_t>::max() / size )
+			{
+				if ( !nothrow )
+					throw std::bad_alloc();
+				return nullptr;
+			}
+			return allocate( count * size, alignment, file, line, nothrow );
+		}
+
 		void deallocate( void* pointer ) override
 		{
 			if ( pointer == nullptr )
@@ -155,6 +374,69 @@ namespace os_memory::allocator
 			os_memory::deallocate_tracked( pointer, allocated_size );
 		}
 
+		// 映射长度以 pointer_map_ 为准，尺寸提示无需使用 / The mapping length comes from pointer_map_, so the size hint is not needed
+		void deallocate( void* pointer, size_t size, size_t alignment ) override
+		{
+			( void )size;
+			( void )alignment;
+			deallocate( pointer );
+		}
+
+		size_t usable_size( void* pointer ) override
+		{
+			auto it = pointer_map_.find( pointer );
+			return it == pointer_map_.end() ? 0 : it->second;
+		}
+
+		void* reallocate( void* pointer, size_t size, size_t alignment = alignof( std::max_align_t ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( pointer == nullptr )
+			{
+				return allocate( size, alignment, file, line, nothrow );
+			}
+			if ( size == 0 )
+			{
+				deallocate( pointer );
+				return nullptr;
+			}
+
+			auto it = pointer_map_.find( pointer );
+			if ( it == pointer_map_.end() )
+			{
+				if ( !nothrow )
+				{
+					throw std::bad_alloc();
+				}
+				return nullptr;
+			}
+			const size_t old_size = it->second;
+
+			// 页内偏移经 mremap 保持不变，更大的对齐只能复制 / mremap keeps the offset within a page; larger alignments have to copy
+			if ( alignment <= 0x1000 )
+			{
+				if ( void* moved_pointer = os_memory::remap_tracked( pointer, old_size, size ) )
+				{
+					pointer_map_.erase( it );
+					pointer_map_[ moved_pointer ] = size;
+					if ( leak_detection_enabled_ )
+					{
+						MemoryTracker::instance().track_deallocation( pointer );
+						MemoryTracker::instance().track_allocation( moved_pointer, size, file, line );
+					}
+					return moved_pointer;
+				}
+			}
+
+			void* fresh_pointer = allocate( size, alignment, file, line, nothrow );
+			if ( fresh_pointer == nullptr )
+			{
+				return nullptr;
+			}
+			std::memcpy( fresh_pointer, pointer, old_size < size ? old_size : size );
+			deallocate( pointer );
+			return fresh_pointer;
+		}
+
 		void enable_leak_detection( bool detailed ) override
 		{
 			leak_detection_enabled_ = true;
@@ -207,7 +489,64 @@ namespace os_memory::allocator
 			}
 			else
 			{
-				insert_mapping( user_pointer, user_pointer );
+				insert_mapping( user_pointer );
+			}
+
+			return user_pointer;
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 清零分配 / zero-filled allocate
+		//────────────────────────────────────────────────────────────
+		void* allocate_zeroed( size_t count, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( count == 0 || size == 0 )
+				return nullptr;
+
+			// 溢出检查与清零都在池内：已知为零的新页不再 memset / The pool checks overflow and clears, skipping fresh pages known to be zero
+			void* user_pointer = memory_pool_.allocate_zeroed( count, size, alignment, file, line, nothrow );
+			if ( !user_pointer )
+			{
+				if ( !nothrow )
+					throw std::bad_alloc();
+				return nullptr;
+			}
+
+			if ( leak_detection_enabled_ )
+			{
+				MemoryTracker::instance().track_allocation( user_pointer, count * size, file, line );
+			}
+			else
+			{
+				insert_mapping( user_pointer );
+			}
+
+			return user_pointer;
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 指定节点分配 / allocate on a NUMA node
+		//────────────────────────────────────────────────────────────
+		void* allocate_on_node( size_t numa_node, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( size == 0 )
+				return nullptr;
+
+			void* user_pointer = memory_pool_.allocate_on_node( numa_node, size, alignment, nothrow );
+			if ( !user_pointer )
+			{
+				if ( !nothrow )
+					throw std::bad_alloc();
+				return nullptr;
+			}
+
+			if ( leak_detection_enabled_ )
+			{
+				MemoryTracker::instance().track_allocation( user_pointer, size, file, line );
+			}
+			else
+			{
+				insert_mapping( user_pointer );
 			}
 
 			return user_pointer;
@@ -233,6 +572,138 @@ namespace os_memory::allocator
 			memory_pool_.deallocate( user_pointer );
 		}
 
+		void deallocate( void* user_pointer, size_t size, size_t alignment ) override
+		{
+			if ( !user_pointer )
+				return;
+
+			if ( leak_detection_enabled_ )
+			{
+				MemoryTracker::instance().track_deallocation( user_pointer );
+			}
+			else
+			{
+				remove_mapping( user_pointer );
+			}
+
+			memory_pool_.deallocate( user_pointer, size, alignment );
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 批量分配 / batch allocate
+		//────────────────────────────────────────────────────────────
+		size_t allocate_batch( size_t size, size_t count, void** out_pointers, const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( size == 0 || count == 0 )
+				return 0;
+
+			if ( memory_pool_.allocate_batch( size, count, out_pointers, nothrow ) == 0 )
+				return 0;
+
+			if ( leak_detection_enabled_ )
+			{
+				for ( size_t i = 0; i < count; ++i )
+					MemoryTracker::instance().track_allocation( out_pointers[ i ], size, file, line );
+			}
+			else
+			{
+#if defined( _DEBUG )
+				for ( size_t i = 0; i < count; ++i )
+					insert_mapping( out_pointers[ i ] );
+#else
+				add_live_count( static_cast<std::int64_t>( count ) );	// 整批一次计数 / Count the whole batch at once
+#endif
+			}
+			return count;
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 批量释放 / batch deallocate
+		//────────────────────────────────────────────────────────────
+		void deallocate_batch( void* const* pointers, size_t count ) override
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				if ( !pointers[ i ] )
+					continue;
+				if ( leak_detection_enabled_ )
+					MemoryTracker::instance().track_deallocation( pointers[ i ] );
+				else
+					remove_mapping( pointers[ i ] );
+			}
+
+			memory_pool_.deallocate_batch( pointers, count );
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 可用字节数 / usable size
+		//────────────────────────────────────────────────────────────
+		size_t usable_size( void* user_pointer ) override
+		{
+			return memory_pool_.usable_size( user_pointer );
+		}
+
+		//────────────────────────────────────────────────────────────
+		// 调整大小 / reallocate
+		//────────────────────────────────────────────────────────────
+		void* reallocate( void* user_pointer, size_t size, size_t alignment = alignof( void* ), const char* file = nullptr, size_t line = 0, bool nothrow = false ) override
+		{
+			if ( !user_pointer )
+				return allocate( size, alignment, file, line, nothrow );
+			if ( size == 0 )
+			{
+				deallocate( user_pointer );
+				return nullptr;
+			}
+
+			// 先注销旧指针：搬迁时池先释放旧块，其地址可能立即被别的线程复用
+			// Untrack the old pointer first: a move frees the old block inside the pool, and another thread may reuse its address at once
+			AllocationInformation old_information {};
+			bool				  old_record_found = false;
+			if ( leak_detection_enabled_ )
+			{
+				old_record_found = MemoryTracker::instance().find_allocation( user_pointer, old_information );
+				MemoryTracker::instance().track_deallocation( user_pointer );
+			}
+			else
+			{
+				remove_mapping( user_pointer );
+			}
+
+			// 失败时原块仍有效，恢复登记 / The old block stays valid on failure, so restore its record
+			auto restore_old_record = [ & ]() {
+				if ( leak_detection_enabled_ )
+				{
+					if ( old_record_found )	 // 采样模式下旧块可能本就未被记录 / In sampling mode the old block may never have been recorded
+						MemoryTracker::instance().restore_allocation( old_information );
+				}
+				else
+					insert_mapping( user_pointer );
+			};
+
+			void* resized_pointer = nullptr;
+			try
+			{
+				resized_pointer = memory_pool_.reallocate( user_pointer, size, alignment, nothrow );
+			}
+			catch ( ... )
+			{
+				restore_old_record();
+				throw;
+			}
+			if ( !resized_pointer )
+			{
+				restore_old_record();
+				return nullptr;
+			}
+
+			if ( leak_detection_enabled_ )
+				MemoryTracker::instance().track_allocation( resized_pointer, size, file, line );
+			else
+				insert_mapping( resized_pointer );
+			return resized_pointer;
+		}
+
 		//────────────────────────────────────────────────────────────
 		// 泄漏检测接口
 		//────────────────────────────────────────────────────────────
@@ -253,14 +724,62 @@ namespace os_memory::allocator
 			return MemoryTracker::instance().current_memory_usage();
 		}
 
+		//────────────────────────────────────────────────────────────
+		// 归还空闲内存 / Purging
+		//────────────────────────────────────────────────────────────
+		size_t trim() override
+		{
+			return memory_pool_.trim();
+		}
+
+		void set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval ) override
+		{
+			memory_pool_.set_purge_policy( idle_period, interval );
+		}
+
+		void set_memory_limit( size_t soft_limit_bytes, size_t hard_limit_bytes ) override
+		{
+			memory_pool_.set_memory_limit( soft_limit_bytes, hard_limit_bytes );
+		}
+
+		bool add_memory_pressure_callback( MemoryPressureCallback callback, void* context ) override
+		{
+			return memory_pool_.add_memory_pressure_callback( callback, context );
+		}
+
+		void remove_memory_pressure_callback( MemoryPressureCallback callback, void* context ) override
+		{
+			memory_pool_.remove_memory_pressure_callback( callback, context );
+		}
+
+		size_t relieve_memory_pressure() override
+		{
+			return memory_pool_.relieve_memory_pressure();
+		}
+
+		size_t reserve( const ReserveProfile& profile ) override
+		{
+			return memory_pool_.reserve( profile );
+		}
+
+		void set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy ) override
+		{
+			memory_pool_.set_page_policy( medium_policy, large_policy, huge_policy );
+		}
+
+		MemoryPoolStatistics statistics() override
+		{
+			return memory_pool_.statistics();
+		}
+
 		//────────────────────────────────────────────────────────────
 		// 析构：提示未释放
 		//────────────────────────────────────────────────────────────
 		~PoolAllocator()
 		{
-			if ( !leak_detection_enabled_ && mapping_root_ != nullptr )
+			if ( !leak_detection_enabled_ )
 			{
-				size_t count = count_mappings( mapping_root_ );
+				size_t count = count_live_allocations();
 				if ( count != 0 )
 				{
 					std::cerr << "[PoolAllocator] WARNING: " << count << " allocations not freed\n";
@@ -272,111 +791,101 @@ namespace os_memory::allocator
 		//────────────────────────────────────────────────────────────
 		// 成员
 		//────────────────────────────────────────────────────────────
-		MemoryPool memory_pool_;  //!< 线程本地 MemoryPool
+		NumaMemoryPool memory_pool_;  //!< 按 NUMA 节点分片的 MemoryPool / MemoryPool sharded per NUMA node
 
 		bool leak_detection_enabled_ = false;
 		bool detailed_tracking_enabled_ = false;
 
-		struct TreeNode
-		{
-			std::uintptr_t address_key;		 //!< 用地址整数做排序键
-			void*		   aligned_pointer;	 //!< 对齐指针（也是 key 原值）
-			void*		   raw_pointer;		 //!< 原始指针（当前与 aligned 相同）
-			TreeNode*	   left_child;
-			TreeNode*	   right_child;
+		//────────────────────────────────────────────────────────────
+		// 活跃分配计数：按线程条带化，热路径只有一次 relaxed 原子加
+		// Live allocation count: striped by thread, so the hot path costs one relaxed atomic add
+		//────────────────────────────────────────────────────────────
+		static constexpr size_t LIVE_COUNT_STRIPES = 16;  //!< 计数条带数 / Number of counter stripes
 
-			~TreeNode() = default;
+		struct alignas( CLASS_DEFAULT_ALIGNMENT ) LiveCountStripe  // 64 B 对齐，避免条带间伪共享 / 64-byte aligned against false sharing
+		{
+			std::atomic<std::int64_t> count { 0 };	//!< 可为负：跨线程释放记在释放方条带 / May go negative: a cross-thread free counts on the freeing stripe
 		};
 
-		TreeNode*				  mapping_root_ = nullptr;
-		mutable std::shared_mutex mapping_mutex_;  //!< 保护整棵树的互斥锁
+		std::array<LiveCountStripe, LIVE_COUNT_STRIPES> live_count_stripes_ {};
 
-		//────────────────────────────────────────────────────────────
-		// 插入映射
-		//────────────────────────────────────────────────────────────
-		void insert_mapping( void* aligned_pointer, void* raw_pointer )
+		/// @brief 本线程的计数条带，按线程首次使用的顺序轮流分配 / This thread's stripe, handed out round-robin on first use
+		static size_t stripe_index()
 		{
-			std::uintptr_t						key = reinterpret_cast<std::uintptr_t>( aligned_pointer );
-			std::unique_lock<std::shared_mutex> lock( mapping_mutex_ );
-			mapping_root_ = insert_node( mapping_root_, key, aligned_pointer, raw_pointer );
+			static std::atomic<size_t> next_stripe { 0 };
+			static thread_local const size_t index = next_stripe.fetch_add( 1, std::memory_order_relaxed ) % LIVE_COUNT_STRIPES;
+			return index;
 		}
 
-		TreeNode* insert_node( TreeNode* node, std::uintptr_t key, void* aligned_pointer, void* raw_pointer )
+		void add_live_count( std::int64_t delta )
 		{
-			if ( node == nullptr )
-			{
-				void* storage = ::operator new( sizeof( TreeNode ) );
-				auto* new_node = new ( storage ) TreeNode { key, aligned_pointer, raw_pointer, nullptr, nullptr };
-				return new_node;
-			}
+			live_count_stripes_[ stripe_index() ].count.fetch_add( delta, std::memory_order_relaxed );
+		}
 
-			if ( key < node->address_key )
-				node->left_child = insert_node( node->left_child, key, aligned_pointer, raw_pointer );
-			else if ( key > node->address_key )
-				node->right_child = insert_node( node->right_child, key, aligned_pointer, raw_pointer );
-			// key 相等：已存在，不重复插入
-			return node;
+		size_t count_live_allocations() const
+		{
+			std::int64_t total = 0;
+			for ( const LiveCountStripe& stripe : live_count_stripes_ )
+				total += stripe.count.load( std::memory_order_relaxed );
+			return total > 0 ? static_cast<size_t>( total ) : 0;
 		}
 
+#if defined( _DEBUG )
 		//────────────────────────────────────────────────────────────
-		// 移除映射
+		// 调试：按地址分片的指针集合，用于报告未登记的释放
+		// Debug only: pointer sets sharded by address, used to report frees of untracked pointers
 		//────────────────────────────────────────────────────────────
-		void remove_mapping( void* aligned_pointer )
+		static constexpr size_t MAPPING_SHARD_BITS = 6;	 //!< 64 个分片 / 64 shards
+
+		struct alignas( CLASS_DEFAULT_ALIGNMENT ) MappingShard
 		{
-			std::uintptr_t						key = reinterpret_cast<std::uintptr_t>( aligned_pointer );
-			std::unique_lock<std::shared_mutex> lock( mapping_mutex_ );
-			mapping_root_ = remove_node( mapping_root_, key );
+			std::mutex				  mutex;
+			std::unordered_set<void*> pointers;
+		};
+
+		std::array<MappingShard, size_t( 1 ) << MAPPING_SHARD_BITS> mapping_shards_;
+
+		MappingShard& mapping_shard_of( void* user_pointer )
+		{
+			// 斐波那契散列取高位：池地址单调递增，低位规律性强 / Fibonacci hashing keeps the high bits: pool addresses are monotonic with regular low bits
+			const std::uint64_t address = reinterpret_cast<std::uintptr_t>( user_pointer );
+			return mapping_shards_[ ( address * 0x9E3779B97F4A7C15ull ) >> ( 64 - MAPPING_SHARD_BITS ) ];
 		}
+#endif
 
-		TreeNode* remove_node( TreeNode* node, std::uintptr_t key )
+		//────────────────────────────────────────────────────────────
+		// 登记 / 注销
+		//────────────────────────────────────────────────────────────
+		void insert_mapping( void* user_pointer )
 		{
-			if ( node == nullptr )
+#if defined( _DEBUG )
 			{
-				std::cerr << "Warning: deallocating untracked pointer " << reinterpret_cast<void*>( key ) << '\n';
-				return nullptr;
+				MappingShard&				shard = mapping_shard_of( user_pointer );
+				std::lock_guard<std::mutex> lock( shard.mutex );
+				shard.pointers.insert( user_pointer );
 			}
+#else
+			( void )user_pointer;
+#endif
+			add_live_count( 1 );
+		}
 
-			if ( key < node->address_key )
-			{
-				node->left_child = remove_node( node->left_child, key );
-			}
-			else if ( key > node->address_key )
-			{
-				node->right_child = remove_node( node->right_child, key );
-			}
-			else
+		void remove_mapping( void* user_pointer )
+		{
+#if defined( _DEBUG )
 			{
-				// 找到节点，删除
-				if ( node->left_child == nullptr || node->right_child == nullptr )
+				MappingShard&				shard = mapping_shard_of( user_pointer );
+				std::lock_guard<std::mutex> lock( shard.mutex );
+				if ( shard.pointers.erase( user_pointer ) == 0 )
 				{
-					TreeNode* child = node->left_child ? node->left_child : node->right_child;
-					node->~TreeNode();
-					::operator delete( node );
-					return child;
-				}
-				else  // 两个子节点都存在：找右子树最小节点替换
-				{
-					TreeNode* successor = node->right_child;
-					while ( successor->left_child )
-						successor = successor->left_child;
-
-					node->address_key = successor->address_key;
-					node->aligned_pointer = successor->aligned_pointer;
-					node->raw_pointer = successor->raw_pointer;
-					node->right_child = remove_node( node->right_child, successor->address_key );
+					std::cerr << "Warning: deallocating untracked pointer " << user_pointer << '\n';
+					return;
 				}
 			}
-			return node;
-		}
-
-		//────────────────────────────────────────────────────────────
-		// 统计映射数量
-		//────────────────────────────────────────────────────────────
-		size_t count_mappings( TreeNode* node ) const
-		{
-			if ( node == nullptr )
-				return 0;
-			return 1 + count_mappings( node->left_child ) + count_mappings( node->right_child );
+#else
+			( void )user_pointer;
+#endif
+			add_live_count( -1 );
 		}
 	};
 
@@ -1,957 +1,3749 @@
 #include "memory_pool.hpp"
 
+#include <string>
+
 // ============================ 静态成员定义 ============================
 std::atomic<bool> MemoryPool::construction_warning_shown { false };
+std::atomic<void ( * )()> MemoryPool::worker_thread_hook { nullptr };
 
 /* -------- TLS 实例 -------- */
 thread_local SmallMemoryManager::ThreadLocalCache SmallMemoryManager::thread_local_cache;
+SmallMemoryManager::GlobalBucket				  SmallMemoryManager::magazine_depot;
 
 /* =====================================================================
  *  SmallMemoryManager — 实现
  * ===================================================================== */
 
-/* -------- allocate -------- */
-void* SmallMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+/* -------- 全局栈工具 / Global stack helpers -------- */
+template <typename NodeType>
+NodeType* SmallMemoryManager::pop_global( BasicGlobalBucket<NodeType>& bucket )
 {
-	const std::size_t index = calculate_bucket_index( bytes );	// 计算桶索引 / Calculate bucket index
-	const std::size_t bucket_bytes = BUCKET_SIZES[ index ];		// 获取桶大小 / Get bucket size
-
-	/* 1) 线程本地缓存 / Thread local cache */
-	if ( auto* header = thread_local_cache.buckets[ index ] )
-	{
-		thread_local_cache.buckets[ index ] = header->next;
-		header->is_free.store( false, std::memory_order_relaxed );	// 标记为已分配 / Mark as allocated
-		header->magic = SmallMemoryHeader::MAGIC;					// 设置魔法值 / Set magic value
-		return header->data();										// 返回数据指针 / Return data pointer
-	}
-
-	/* 2) 全局 ABA-safe 栈 / Global ABA-safe stack */
-	GlobalBucket& bucket = global_buckets[ index ];
-
 #if SUPPORT_128BIT_CAS
-	typename PointerTag old_head = bucket.head.load( std::memory_order_acquire );
+	BasicPointerTag<NodeType> old_head = bucket.head.load( std::memory_order_acquire );
 
 	while ( old_head.pointer )
 	{
-		SmallMemoryHeader*	candidate = old_head.pointer;
-		typename PointerTag new_head = { candidate->next, old_head.tag + 1 };
+		NodeType*				  candidate = old_head.pointer;
+		BasicPointerTag<NodeType> new_head = { candidate->next, old_head.tag + 1 };
 
 		if ( bucket.head.compare_exchange_weak( old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire ) )
-		{
-			candidate->is_free.store( false, std::memory_order_relaxed );  // 标记为已分配 / Mark as allocated
-			candidate->magic = SmallMemoryHeader::MAGIC;				   // 设置魔法值 / Set magic value
-			return candidate->data();									   // 返回数据指针 / Return data pointer
-		}
+			return candidate;
 	}
+	return nullptr;
 #else
-	{
-		std::lock_guard<std::mutex> lock( bucket.mutex );					 // 加锁保护 / Lock protection
-		if ( auto* header = bucket.head.load( std::memory_order_relaxed ) )	 // 检查是否有可用块 / Check for available block
-		{
-			bucket.head.store( header->next, std::memory_order_relaxed );  // 更新头指针 / Update head pointer
-			header->is_free.store( false, std::memory_order_relaxed );	   // 标记为已分配 / Mark as allocated
-			header->magic = SmallMemoryHeader::MAGIC;					   // 设置魔法值 / Set magic value
-			return header->data();										   // 返回数据指针 / Return data pointer
-		}
-	}
+	std::lock_guard<std::mutex> lock( bucket.mutex );  // 加锁保护 / Lock protection
+	NodeType*					candidate = bucket.head.load( std::memory_order_relaxed );
+	if ( candidate )
+		bucket.head.store( candidate->next, std::memory_order_relaxed );  // 更新头指针 / Update head pointer
+	return candidate;
 #endif
+}
 
-	/* 3) 向操作系统申请新 Chunk / Request new chunk from OS */
-	const std::size_t block_bytes = sizeof( SmallMemoryHeader ) + bucket_bytes;
-	const std::size_t chunk_size = std::max<std::size_t>( 1 * 1024 * 1024, block_bytes * 128 );	 // 最大值 / Max size
+template <typename NodeType>
+void SmallMemoryManager::push_global_list( BasicGlobalBucket<NodeType>& bucket, NodeType* first, NodeType* last )
+{
+#if SUPPORT_128BIT_CAS
+	BasicPointerTag<NodeType> head_snapshot = bucket.head.load( std::memory_order_relaxed );
 
-	void* chunk_memory;
+	do
 	{
-		std::scoped_lock<std::mutex> lock( chunk_mutex );  // 加锁保护 / Lock protection
-		chunk_memory = os_memory::allocate_tracked( chunk_size, alignment );
-		if ( !chunk_memory )
-			throw std::bad_alloc();	 // 申请失败抛出异常 / Throw exception on failure
-		allocated_chunks.emplace_back( chunk_memory, chunk_size );
-	}
+		last->next = head_snapshot.pointer;	 // 将尾部连接到全局链表头 / Link tail to the global list head
+	} while ( !bucket.head.compare_exchange_weak( head_snapshot, { first, head_snapshot.tag + 1 }, std::memory_order_release, std::memory_order_relaxed ) );
+#else
+	std::lock_guard<std::mutex> lock( bucket.mutex );			 // 加锁保护 / Lock protection
+	last->next = bucket.head.load( std::memory_order_relaxed );	 // 将尾部连接到全局链表头 / Link tail to the global list head
+	bucket.head.store( first, std::memory_order_relaxed );		 // 更新全局链表头 / Update global list head
+#endif
+}
 
-	/* 切分 chunk / Split chunk */
-	const std::size_t block_count = chunk_size / block_bytes;
-	if ( block_count == 0 )
-	{
-		os_memory::deallocate_tracked( chunk_memory, chunk_size );	// 释放内存 / Deallocate memory
-		throw std::bad_alloc();										// 申请失败抛出异常 / Throw exception on failure
-	}
+/* -------- 线程堆 / Thread heaps -------- */
+SmallThreadHeap& SmallMemoryManager::local_heap()
+{
+	SmallThreadHeap* heap = thread_local_cache.last_heap;
+	if ( heap && heap->owner.load( std::memory_order_relaxed ) == this )
+		return *heap;
 
-	char*			   cursor = static_cast<char*>( chunk_memory );
-	SmallMemoryHeader* first_block = nullptr;
-	SmallMemoryHeader* previous_block = nullptr;
+	if ( ( heap = find_local_heap() ) != nullptr )
+		return *heap;
+	return attach_heap();
+}
 
-	for ( std::size_t i = 0; i < block_count; ++i, cursor += block_bytes )
+SmallThreadHeap* SmallMemoryManager::find_local_heap()
+{
+	ThreadLocalCache& cache = thread_local_cache;
+	SmallThreadHeap** link = &cache.heaps;
+	while ( SmallThreadHeap* heap = *link )
 	{
-		auto* block = reinterpret_cast<SmallMemoryHeader*>( cursor );
-		block->bucket_index = static_cast<std::uint32_t>( index );
-		block->block_size = static_cast<std::uint32_t>( bucket_bytes );
-		block->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
-		block->magic = SmallMemoryHeader::MAGIC;				  // 设置魔法值 / Set magic value
-		block->next = nullptr;
+		SmallMemoryManager* owner = heap->owner.load( std::memory_order_acquire );
+		if ( owner == this )
+		{
+			cache.last_heap = heap;
+			return heap;
+		}
 
-		if ( !first_block )
-			first_block = block;
-		if ( previous_block )
-			previous_block->next = block;
-		previous_block = block;
+		if ( owner == nullptr )
+		{
+			/* 所属管理器已释放：顺带摘除 / Owning manager already released: unlink it on the way */
+			*link = heap->next_in_thread;
+			if ( cache.last_heap == heap )
+				cache.last_heap = nullptr;
+			release_heap( heap );
+			continue;
+		}
+		link = &heap->next_in_thread;
 	}
+	return nullptr;
+}
 
-	/* 4) 将多余块批量推入全局栈 / Push excess blocks into global stack */
-	if ( block_count > 1 )
+SmallThreadHeap& SmallMemoryManager::attach_heap()
+{
+	SmallThreadHeap* heap = nullptr;
 	{
-#if SUPPORT_128BIT_CAS
-		typename PointerTag head_snapshot = bucket.head.load( std::memory_order_relaxed );
-		previous_block->next = head_snapshot.pointer;  // 连接到原全局链表 / Link to original global list
+		std::lock_guard<std::mutex> lock( heap_mutex );	 // 加锁保护 / Lock protection
 
-		typename PointerTag new_snapshot = { first_block->next, head_snapshot.tag + 1 };
+		/* 1) 接管已退出线程留下的堆 / Adopt a heap left behind by an exited thread */
+		for ( SmallThreadHeap* candidate = heaps; candidate; candidate = candidate->next_in_manager )
+		{
+			bool expected = false;
+			if ( candidate->attached.compare_exchange_strong( expected, true, std::memory_order_acq_rel ) )
+			{
+				heap = candidate;
+				break;
+			}
+		}
 
-		while ( !bucket.head.compare_exchange_weak( head_snapshot, new_snapshot, std::memory_order_release, std::memory_order_relaxed ) )
+		/* 2) 新建线程堆，元数据不计入池的字节计数 / Create a new heap; metadata is not counted as pool bytes */
+		if ( !heap )
 		{
-			previous_block->next = head_snapshot.pointer;  // 重试 / Retry
-			new_snapshot.tag = head_snapshot.tag + 1;
+			void* heap_memory = os_memory::allocate_memory( sizeof( SmallThreadHeap ), alignof( SmallThreadHeap ) );
+			if ( !heap_memory )
+				throw std::bad_alloc();	 // 申请失败抛出异常 / Throw exception on failure
+
+			heap = new ( heap_memory ) SmallThreadHeap();
+			heap->owner.store( this, std::memory_order_relaxed );
+			heap->attached.store( true, std::memory_order_relaxed );
+			heap->references.store( 1, std::memory_order_relaxed );	 // 管理器引用 / Manager reference
+			heap->shard_index = next_shard++ % shard_count;			 // 接管的堆保留原分片 / Adopted heaps keep theirs
+			heap->next_in_manager = heaps;
+			heaps = heap;
 		}
-#else
-		std::lock_guard<std::mutex> lock( bucket.mutex );  // 加锁保护 / Lock protection
-		previous_block->next = bucket.head.load( std::memory_order_relaxed );
-		bucket.head.store( first_block, std::memory_order_relaxed );  // 更新头指针 / Update head pointer
-#endif
+		heap->references.fetch_add( 1, std::memory_order_relaxed );  // 线程引用 / Thread reference
 	}
 
-	/* 返回首块 / Return the first block */
-	if ( first_block != nullptr )
-	{
-		first_block->is_free.store( false, std::memory_order_relaxed );	 // 标记为已分配 / Mark as allocated
-		first_block->magic = SmallMemoryHeader::MAGIC;					 // 设置魔法值 / Set magic value
-		return first_block->data();										 // 返回数据指针 / Return data pointer
-	}
-	else
-	{
-		throw std::runtime_error( "first_block is null during allocation." );  // 报错 / Error
-	}
+	ThreadLocalCache& cache = thread_local_cache;
+	heap->next_in_thread = cache.heaps;
+	cache.heaps = heap;
+	cache.last_heap = heap;
+	return *heap;
 }
 
-/* -------- deallocate -------- */
-void SmallMemoryManager::deallocate( SmallMemoryHeader* header )
+void SmallMemoryManager::flush_heap( SmallThreadHeap& heap )
 {
-	bool expected = false;
-	if ( !header->is_free.compare_exchange_strong( expected, true, std::memory_order_release, std::memory_order_relaxed ) )
-		return;	 // 双重释放 / Double free
+	/* 每个弹匣一次 CAS 交回全局桶，远程释放链一并封装交回 / One CAS per magazine back to the global bucket, remote frees included */
+	auto flush_bucket = []( CacheBucket& cache, GlobalBucket& bucket, std::atomic<SmallFreeLink*>& remote, std::size_t capacity ) {
+		if ( !export_magazine( bucket, cache.loaded ) )
+			cache.loaded = {};	// 描述符耗尽：块仍归 chunk 所有 / Out of descriptors: the blocks stay owned by their chunk
+		if ( !export_magazine( bucket, cache.previous ) )
+			cache.previous = {};
+
+		if ( remote.load( std::memory_order_relaxed ) )
+		{
+			SmallFreeLink* cursor = remote.exchange( nullptr, std::memory_order_acquire );
+			load_blocks( cache, bucket, capacity, [ &cursor ]() { return std::exchange( cursor, cursor ? cursor->next : nullptr ); } );
+			if ( !export_magazine( bucket, cache.loaded ) )
+				cache.loaded = {};
+		}
+	};
 
-	if ( header->in_tls )  // ★ 新增：检测双重回收
-	{
-		return;
-	}
+	for ( std::size_t i = 0; i < BUCKET_COUNT; ++i )
+		flush_bucket( heap.buckets[ i ], global_buckets[ i ].shards[ heap.shard_index ], heap.remote_frees[ i ], MAGAZINE_CAPACITIES[ i ] );
+	for ( std::size_t i = 0; i < SLAB_BUCKET_COUNT; ++i )
+		flush_bucket( heap.slab_buckets[ i ], slab_global_buckets[ i ].shards[ heap.shard_index ], heap.slab_remote_frees[ i ], MAGAZINE_CAPACITIES[ i ] );
+}
 
-	if ( header->magic != SmallMemoryHeader::MAGIC )
+bool SmallMemoryManager::reclaim_remote_frees( CacheBucket& cache, GlobalBucket& bucket, std::size_t index, bool slab_bucket )
+{
+	/* 整链交换对多个消费者同样安全：切分新内存前先收回滞留在空闲线程上的块 / Whole-list exchange is safe for any consumer: recover blocks parked on idle threads before carving */
+	bool						reclaimed = false;
+	std::lock_guard<std::mutex> lock( heap_mutex );
+	for ( SmallThreadHeap* heap = heaps; heap; heap = heap->next_in_manager )
 	{
-		std::cerr << "[Small] invalid magic during deallocation\n";	 // 魔法值错误 / Invalid magic value
-		return;
-	}
-	header->magic = 0;	 // 防止重复使用 / Prevent reuse
-	header->in_tls = 1;	 // ★ 标记“已进 TLS”——放最前
-
-	const std::size_t index = header->bucket_index;
-	header->next = thread_local_cache.buckets[ index ];
-	thread_local_cache.buckets[ index ] = header;
+		std::atomic<SmallFreeLink*>& remote = slab_bucket ? heap->slab_remote_frees[ index ] : heap->remote_frees[ index ];
+		if ( !remote.load( std::memory_order_relaxed ) )
+			continue;
 
-	if ( ++thread_local_cache.deallocation_counter >= 256 )
-		flush_thread_local_cache();
+		SmallFreeLink* cursor = remote.exchange( nullptr, std::memory_order_acquire );
+		load_blocks( cache, bucket, MAGAZINE_CAPACITIES[ index ], [ &cursor ]() { return std::exchange( cursor, cursor ? cursor->next : nullptr ); } );
+		reclaimed = true;
+	}
+	return reclaimed;
 }
 
+void SmallMemoryManager::release_heap( SmallThreadHeap* heap )
+{
+	if ( heap->references.fetch_sub( 1, std::memory_order_acq_rel ) != 1 )
+		return;
+	heap->~SmallThreadHeap();
+	os_memory::deallocate_memory( heap, sizeof( SmallThreadHeap ) );
+}
 
-/* -------- flush TLS -------- */
-void SmallMemoryManager::flush_thread_local_cache()
+void SmallMemoryManager::push_remote( std::atomic<SmallFreeLink*>& remote, SmallFreeLink* block )
 {
-	for ( std::size_t i = 0; i < BUCKET_COUNT; ++i )
+	SmallFreeLink* head = remote.load( std::memory_order_relaxed );
+	do
 	{
-		SmallMemoryHeader* local_head = std::exchange( thread_local_cache.buckets[ i ], nullptr );	// 获取线程本地缓存头部 / Get thread-local cache head
-		if ( !local_head )
-			continue;
+		block->next = head;
+	} while ( !remote.compare_exchange_weak( head, block, std::memory_order_release, std::memory_order_relaxed ) );
+}
 
-		GlobalBucket& bucket = global_buckets[ i ];	 // 获取全局桶 / Get global bucket
+/* -------- 线程退出钩子 / Thread-exit hook -------- */
+SmallMemoryManager::ThreadLocalCache::~ThreadLocalCache()
+{
+	while ( SmallThreadHeap* heap = heaps )
+	{
+		heaps = heap->next_in_thread;
+		if ( SmallMemoryManager* owner = heap->owner.load( std::memory_order_acquire ) )
+			owner->flush_heap( *heap );
+		heap->attached.store( false, std::memory_order_release );  // 允许新线程接管 / Let a new thread adopt it
+		release_heap( heap );
+	}
+	last_heap = nullptr;
 
-		/* 找尾结点一次即可，循环外保证正确性 / Find the tail node once, ensure correctness outside the loop */
-		SmallMemoryHeader* tail = local_head;
-		while ( tail->next )
-			tail = tail->next;
+	while ( SmallMagazine* magazine = spare_magazines )
+	{
+		spare_magazines = magazine->next;
+		push_global_list( magazine_depot, magazine, magazine );
+	}
+	spare_count = 0;
+}
 
-#if SUPPORT_128BIT_CAS
-		typename PointerTag head_snapshot = bucket.head.load( std::memory_order_relaxed );
+/* -------- 弹匣描述符 / Magazine descriptors -------- */
+SmallMagazine* SmallMemoryManager::acquire_magazine()
+{
+	/* 1) 线程保留的空描述符 / Thread-kept empty descriptor */
+	if ( SmallMagazine* magazine = thread_local_cache.spare_magazines )
+	{
+		thread_local_cache.spare_magazines = magazine->next;
+		--thread_local_cache.spare_count;
+		return magazine;
+	}
 
-		do
-		{
-			tail->next = head_snapshot.pointer;	 // 将尾部连接到全局链表头 / Link tail to the global list head
-		} while ( !bucket.head.compare_exchange_weak( head_snapshot, { local_head, head_snapshot.tag + 1 }, std::memory_order_release, std::memory_order_relaxed ) );
-#else
-		{
-			std::lock_guard<std::mutex> lock( bucket.mutex );			 // 加锁保护 / Lock protection
-			tail->next = bucket.head.load( std::memory_order_relaxed );	 // 将尾部连接到全局链表头 / Link tail to the global list head
-			bucket.head.store( local_head, std::memory_order_relaxed );	 // 更新全局链表头 / Update global list head
-		}
-#endif
+	/* 2) 进程级仓库 / Process-wide depot */
+	if ( SmallMagazine* magazine = pop_global( magazine_depot ) )
+		return magazine;
 
-		/* 清 in_tls 标记 */
-		for ( SmallMemoryHeader* node = local_head; node; node = node->next )
-			node->in_tls = 0;
+	/* 3) 向操作系统申请一批描述符：首个自用，其余入仓库 / Map a batch of descriptors: keep the first, stock the depot with the rest */
+	// 描述符永不归还，不计入池的字节计数 / Descriptors are never returned and are not counted as pool bytes
+	auto* descriptors = static_cast<SmallMagazine*>( os_memory::allocate_memory( MAGAZINE_DEPOT_CHUNK_BYTES ) );
+	if ( !descriptors )
+		return nullptr;
 
-		thread_local_cache.buckets[ i ] = nullptr;	// 清空线程本地缓存 / Clear thread-local cache
-	}
-	thread_local_cache.deallocation_counter = 0;  // 重置释放计数器 / Reset deallocation counter
+	constexpr std::size_t descriptor_count = MAGAZINE_DEPOT_CHUNK_BYTES / sizeof( SmallMagazine );
+	for ( std::size_t i = 1; i + 1 < descriptor_count; ++i )
+		descriptors[ i ].next = &descriptors[ i + 1 ];
+	push_global_list( magazine_depot, &descriptors[ 1 ], &descriptors[ descriptor_count - 1 ] );
+	return &descriptors[ 0 ];
 }
 
-/* -------- release_resources -------- */
-void SmallMemoryManager::release_resources()
+void SmallMemoryManager::retire_magazine( SmallMagazine* magazine )
 {
-	flush_thread_local_cache();	 // 清空线程本地缓存 / Clear thread-local cache
-
-	std::lock_guard<std::mutex> this_lock_guard( chunk_mutex );	 // 加锁保护 / Lock protection
-	for ( auto& [ pointer, size ] : allocated_chunks )
-		os_memory::deallocate_tracked( pointer, size );	 // 释放已分配的内存 / Deallocate allocated memory
-	allocated_chunks.clear();							 // 清空已分配块 / Clear allocated chunks
-
-	for ( auto& bucket : global_buckets )
+	if ( thread_local_cache.spare_count < MAGAZINE_SPARE_LIMIT )
 	{
-#if SUPPORT_128BIT_CAS
-		bucket.head.store( { nullptr, 0 }, std::memory_order_relaxed );	 // 清空全局桶头 / Clear global bucket head
-#else
-		bucket.head.store( nullptr, std::memory_order_relaxed );  // 清空全局桶头 / Clear global bucket head
-#endif
+		magazine->next = thread_local_cache.spare_magazines;
+		thread_local_cache.spare_magazines = magazine;
+		++thread_local_cache.spare_count;
+		return;
 	}
+	push_global_list( magazine_depot, magazine, magazine );
 }
 
-/* =====================================================================
- *  MediumMemoryManager — 实现
- * ===================================================================== */
-
-/*──────────────── allocate ────────────────*/
-void* MediumMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+/* -------- 线程缓存弹匣 / Thread cache magazines -------- */
+SmallMagazine* SmallMemoryManager::pop_sharded( ShardedGlobalBucket& bucket, std::size_t shard )
 {
-	const int want_order = order_from_size( bytes );  // 获取所需的内存块级别 / Get the required block level
-
-	// 边界检查：确保请求的order在有效范围内
-	if ( want_order < 0 || want_order >= LEVEL_COUNT )
+	/* 先取本分片，空则按序窃取；空分片只需一次读取 / Home shard first, then steal in turn; an empty shard costs a single load */
+	for ( std::size_t probe = 0; probe < shard_count; ++probe )
 	{
-		throw std::bad_alloc();
+		if ( SmallMagazine* magazine = pop_global( bucket.shards[ ( shard + probe ) % shard_count ] ) )
+			return magazine;
 	}
+	return nullptr;
+}
 
-	/* 第一阶段：常规分配尝试 */
-	for ( int current_order = want_order; current_order < LEVEL_COUNT; ++current_order )
+SmallFreeLink* SmallMemoryManager::pop_cached( CacheBucket& cache, ShardedGlobalBucket& bucket, std::size_t shard, std::atomic<SmallFreeLink*>& remote, std::size_t capacity )
+{
+	MagazineSlot& loaded = cache.loaded;
+	if ( loaded.count == 0 )
 	{
-		if ( auto* block = pop_block( current_order ) )
+		if ( cache.previous.count != 0 )
+		{
+			std::swap( loaded, cache.previous );  // 备用弹匣为满 / The spare magazine is full
+		}
+		else
 		{
-			if ( current_order > want_order )
+			BucketCounters::add( cache.counters.cache_misses );
+			if ( remote.load( std::memory_order_relaxed ) )
 			{
-				block = split_to_order( block, current_order, want_order );
+				/* 一次交换取走其他线程归还的全部块 / Take every block other threads handed back in one exchange */
+				SmallFreeLink* cursor = remote.exchange( nullptr, std::memory_order_acquire );
+				load_blocks( cache, bucket.shards[ shard ], capacity, [ &cursor ]() { return std::exchange( cursor, cursor ? cursor->next : nullptr ); } );
 			}
-			prepare_block( block, want_order );
-			return block->data();
 		}
-	}
-
-	/* 第二阶段：申请新chunk */
-	auto* fresh = request_new_chunk( want_order, alignment );
-	if ( !fresh )
-		throw std::bad_alloc();
 
-	// 占用检测：统计非空级别数量
-	size_t occupied_levels = 0;
-	for ( int i = 0; i < LEVEL_COUNT; i++ )
-	{
-		if ( free_lists[ i ].head.load( std::memory_order_acquire ).pointer )
+		// reclaim_remote_frees 可能已抢先取走远程链 / reclaim_remote_frees on another thread may have emptied the list first
+		if ( loaded.count == 0 )
 		{
-			occupied_levels++;
+			/* 一次 CAS 换入一整个满弹匣 / Trade for a whole full magazine in one CAS */
+			SmallMagazine* magazine = pop_sharded( bucket, shard );
+			if ( !magazine )
+				return nullptr;
+
+			loaded = { magazine->head, magazine->tail, magazine->count };
+			retire_magazine( magazine );
+			BucketCounters::add( cache.counters.global_refills );
+			cache.limit = std::min( capacity, std::max( cache.limit * 2, MAGAZINE_MIN_BLOCKS ) );  // 缺失说明桶变热 / A miss means the bucket is hot
 		}
 	}
 
-	const uint16_t mask = free_list_level_mask.load( std::memory_order_acquire );
+	SmallFreeLink* block = loaded.head;
+	loaded.head = block->next;
+	--loaded.count;
+	return block;
+}
 
-	// 策略选择
-	if ( mask != 0 )
-	{
-		/* 情况1：系统中有可用块 - 资源回收优先 */
-		push_block( fresh, want_order );  // 将新块加入资源池
+void SmallMemoryManager::push_cached( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, SmallFreeLink* block )
+{
+	if ( cache.limit == 0 )
+		cache.limit = std::min( capacity, MAGAZINE_MIN_BLOCKS );
 
-		// 重新尝试分配，利用可能的新资源
-		for ( int current_order = want_order; current_order < LEVEL_COUNT; ++current_order )
+	MagazineSlot& loaded = cache.loaded;
+	if ( loaded.count >= cache.limit )
+	{
+		if ( cache.previous.count == 0 )
 		{
-			if ( auto* block = pop_block( current_order ) )
-			{
-				if ( current_order > want_order )
-				{
-					block = split_to_order( block, current_order, want_order );
-				}
-				prepare_block( block, want_order );
-				return block->data();
-			}
+			std::swap( loaded, cache.previous );
 		}
-	}
-	else
-	{
-		/* 情况2：系统完全干涸 - 直接使用新资源 */
-		if ( want_order < LEVEL_COUNT - 1 )
+		else if ( export_magazine( bucket, cache.previous ) )  // 一次 CAS 交出满弹匣 / Hand over the full magazine in one CAS
 		{
-			// 仅当需要时才分割
-			fresh = split_to_order( fresh, want_order, want_order );
+			cache.previous = std::exchange( loaded, MagazineSlot {} );
+			cache.limit = std::min( capacity, cache.limit * 2 );  // 溢出说明桶变热 / An overflow means the bucket is hot
+			BucketCounters::add( cache.counters.global_flushes );
 		}
-		prepare_block( fresh, want_order );
-		return fresh->data();
+		// 描述符耗尽时暂时超出上限 / Run over the limit while no descriptor can be mapped
 	}
 
-	// 终极保障
-	throw std::bad_alloc();
+	block->next = loaded.head;
+	if ( loaded.count == 0 )
+		loaded.tail = block;
+	loaded.head = block;
+	++loaded.count;
 }
 
-/*──────────────── deallocate ────────────────*/
-void MediumMemoryManager::deallocate( MediumMemoryHeader* header )
+void SmallMemoryManager::push_cached_run( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, SmallFreeLink* head, SmallFreeLink* tail, std::size_t count )
 {
-	/* 确保不是重复释放 / Ensure no double free */
-	bool expected = false;
-	if ( !header->is_free.compare_exchange_strong( expected, true, std::memory_order_acq_rel, std::memory_order_relaxed ) )
-	{
-		return;	 // 如果已经释放过，直接返回 / Return if already freed
-	}
+	if ( cache.limit == 0 )
+		cache.limit = std::min( capacity, MAGAZINE_MIN_BLOCKS );
 
-	/* 校验魔法 / Validate magic value */
-	if ( header->magic != MediumMemoryHeader::MAGIC )
+	/* 放得下就整段接入 / Splice the whole run when it fits */
+	MagazineSlot& loaded = cache.loaded;
+	if ( loaded.count + count <= cache.limit )
 	{
-		std::cerr << "[MediumBuddy] invalid magic during deallocation\n";  // 魔法值无效 / Invalid magic value
+		tail->next = loaded.head;
+		if ( loaded.count == 0 )
+			loaded.tail = tail;
+		loaded.head = head;
+		loaded.count += count;
 		return;
 	}
 
-	// 创建合并请求 / Create merge request
-	const int order = order_from_size( header->block_size );
+	/* 否则按容量封成满弹匣，一次推入全局桶 / Otherwise seal it into full magazines and push them at once */
+	BucketCounters::add( cache.counters.global_flushes );
+	tail->next = nullptr;
+	SmallFreeLink* cursor = head;
+	load_blocks( cache, bucket, capacity, [ &cursor ]() { return std::exchange( cursor, cursor ? cursor->next : nullptr ); } );
+}
+
+bool SmallMemoryManager::export_magazine( GlobalBucket& bucket, MagazineSlot& slot )
+{
+	if ( slot.count == 0 )
+		return true;
+
+	SmallMagazine* magazine = acquire_magazine();
+	if ( !magazine )
+		return false;
+
+	magazine->head = slot.head;
+	magazine->tail = slot.tail;
+	magazine->count = slot.count;
+	push_global_list( bucket, magazine, magazine );
+	slot = {};
+	return true;
+}
 
-	// 无锁入队 - 环形缓冲区实现 / Lock-free enqueue - Circular buffer implementation
-	std::size_t cycle_queue_tail = merge_queue.tail.load( std::memory_order_relaxed );
-	std::size_t cycle_queue_next_tail = ( cycle_queue_tail + 1 ) % MERGE_QUEUE_SIZE;
+template <typename NextBlock>
+void SmallMemoryManager::load_blocks( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, NextBlock&& next_block )
+{
+	/* 首批装入 loaded，其余按容量封成满弹匣，一次推入全局桶 / First batch becomes loaded, the rest are sealed into full magazines and pushed at once */
+	SmallMagazine* first_magazine = nullptr;
+	SmallMagazine* last_magazine = nullptr;
+	MagazineSlot   slot;
 
-	// 检查队列是否满 / Check if the queue is full
-	if ( cycle_queue_next_tail == merge_queue.head.load( std::memory_order_acquire ) )
+	for ( SmallFreeLink* block = next_block(); block; )
 	{
-		// 队列满时直接尝试合并（安全，因为此时只有当前线程操作）/ If the queue is full, attempt merging directly (safe because only the current thread is operating)
-		try_merge_buddy( header, order );
-		return;
-	}
+		SmallFreeLink* following = next_block();  // 先取后继再改写链接 / Fetch the successor before the link is rewritten
+		block->next = nullptr;
+		if ( slot.count == 0 )
+			slot.head = block;
+		else
+			slot.tail->next = block;
+		slot.tail = block;
+		block = following;
 
-	// 加入队列 / Add to queue
-	merge_queue.requests[ cycle_queue_tail ].store( { header, order }, std::memory_order_relaxed );
-	merge_queue.tail.store( cycle_queue_next_tail, std::memory_order_release );
+		if ( ++slot.count < capacity && block )
+			continue;
 
-	// 确保合并工作线程运行 / Ensure the merge worker thread runs
-	if ( !merge_worker_active.load( std::memory_order_acquire ) && !merge_worker_active.exchange( true, std::memory_order_acq_rel ) )
-	{
-		std::thread( [ this ] { process_merge_queue(); } ).detach();  // 启动合并线程 / Start the merge thread
+		if ( cache.loaded.count == 0 )
+		{
+			cache.loaded = slot;
+		}
+		else if ( SmallMagazine* magazine = acquire_magazine() )
+		{
+			magazine->head = slot.head;
+			magazine->tail = slot.tail;
+			magazine->count = slot.count;
+			magazine->next = nullptr;
+			if ( last_magazine )
+				last_magazine->next = magazine;
+			else
+				first_magazine = magazine;
+			last_magazine = magazine;
+		}
+		// 否则丢弃该批：块仍属于本管理器，随 release_resources 归还 / Otherwise drop the batch: it still belongs to this manager and goes back with release_resources
+		slot = {};
 	}
+
+	if ( first_magazine )
+		push_global_list( bucket, first_magazine, last_magazine );
 }
 
-/*──────────────── 内部工具实现 ────────────────*/
-inline void MediumMemoryManager::prepare_block( MediumMemoryHeader* block, int order )
+void SmallMemoryManager::return_magazines( GlobalBucket& bucket )
 {
-	block->is_free.store( false, std::memory_order_relaxed );
-	block->magic = MediumMemoryHeader::MAGIC;
-	block->block_size = size_from_order( order );
-	block->next = nullptr;
+	while ( SmallMagazine* magazine = pop_global( bucket ) )
+		push_global_list( magazine_depot, magazine, magazine );
 }
 
-void MediumMemoryManager::push_block( MediumMemoryHeader* header, int order )
+/// @brief 带头块以数据区首部作为空闲链接 / Headered blocks keep their free link at the start of the data area
+static SmallMemoryHeader* header_of( SmallFreeLink* block )
 {
-	header->next = nullptr;
-	header->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
-
-	auto&	   list = free_lists[ order ];	// 获取空闲链表 / Get free list for the order
-	PointerTag head = list.head.load( std::memory_order_relaxed );
-
-	do
-	{
-		header->next = head.pointer;  // 将当前块链接到链表头 / Link the current block to the list head
-		PointerTag new_head { header, head.tag + 1 };
-	} while ( !list.head.compare_exchange_weak( head, { header, head.tag + 1 }, std::memory_order_release, std::memory_order_relaxed ) );
-
-	// 原子更新位掩码
-	uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
-	uint16_t new_mask;
-	do
-	{
-		new_mask = current_mask | ( 1 << order );  // 设置该级别位
-	} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+	return reinterpret_cast<SmallMemoryHeader*>( reinterpret_cast<char*>( block ) - sizeof( SmallMemoryHeader ) );
 }
 
-MediumMemoryHeader* MediumMemoryManager::pop_block( int order )
+/* -------- allocate -------- */
+void* SmallMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
 {
-	auto&	   list = free_lists[ order ];	// 获取空闲链表 / Get free list for the order
-	PointerTag head = list.head.load( std::memory_order_acquire );
+	const std::size_t index = calculate_bucket_index( bytes );	// 计算桶索引 / Calculate bucket index
+	const std::size_t bucket_bytes = BUCKET_SIZES[ index ];		// 获取桶大小 / Get bucket size
+	SmallThreadHeap&  heap = local_heap();
+	CacheBucket&	  cache = heap.buckets[ index ];
 
-	while ( head.pointer )
+	/* 1) 线程本地弹匣，缺失时先取远程释放链，再从全局 ABA-safe 栈换入满弹匣 / Thread local magazines, refilled from remote frees, then from the global ABA-safe stack */
+	SmallFreeLink* block = pop_cached( cache, global_buckets[ index ], heap.shard_index, heap.remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+	if ( !block && reclaim_remote_frees( cache, global_buckets[ index ].shards[ heap.shard_index ], index, false ) )
+		block = pop_cached( cache, global_buckets[ index ], heap.shard_index, heap.remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+
+	if ( !block )
 	{
-		PointerTag next { head.pointer->next, head.tag + 1 };
+		/* 2) 向操作系统申请新 Chunk / Request new chunk from OS */
+		const std::size_t block_bytes = sizeof( SmallMemoryHeader ) + bucket_bytes;
+		const std::size_t chunk_size = std::max<std::size_t>( 1 * 1024 * 1024, block_bytes * 128 );	 // 最大值 / Max size
 
-		//Try CompreAndSwap
-		if ( list.head.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_acquire ) )
+		void* chunk_memory;
 		{
-			// 成功取出一个块，检查取出后链表是否为空
-			if ( next.pointer == nullptr )
+			std::scoped_lock<std::mutex> lock( chunk_mutex );  // 加锁保护 / Lock protection
+			chunk_memory = os_memory::allocate_tracked( chunk_size, alignment, mapping_account );
+			if ( !chunk_memory )
+				throw std::bad_alloc();	 // 申请失败抛出异常 / Throw exception on failure
+			if ( !TierPageEntry::record( chunk_memory, chunk_size, 1, numa_node, index ) )
 			{
-				// 链表变空，清除掩码位
-				uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
-				uint16_t new_mask;
-				do
-				{
-					new_mask = current_mask & ~( 1 << order );
-				} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+				os_memory::deallocate_tracked( chunk_memory, chunk_size, mapping_account );
+				throw std::bad_alloc();
 			}
-			return head.pointer;
+			os_memory::bind_memory_to_node( chunk_memory, chunk_size, numa_node );	// 首次触碰之前 / Before the first touch
+			// 保持按地址排序，清理时二分查找块所在的 chunk / Kept sorted by address so a purge can binary-search a block's chunk
+			auto position = std::upper_bound( allocated_chunks.begin(), allocated_chunks.end(), chunk_memory, []( void* memory, const SmallChunk& chunk ) { return memory < chunk.memory; } );
+			allocated_chunks.insert( position, { chunk_memory, chunk_size, static_cast<std::uint32_t>( index ), static_cast<std::uint32_t>( chunk_size / block_bytes ) } );
 		}
-		// CompreAndSwap Failed, Retry
+		BucketCounters::add( cache.counters.carves );
+
+		/* 切分 chunk：首批装入本线程弹匣，其余成批推入全局栈 / Split chunk: first batch to this thread, the rest to the global stack */
+		const std::size_t block_count = chunk_size / block_bytes;
+		char* const		  chunk_base = static_cast<char*>( chunk_memory );
+		std::size_t		  carved_count = 0;
+		load_blocks( cache, global_buckets[ index ].shards[ heap.shard_index ], MAGAZINE_CAPACITIES[ index ], [ & ]() -> SmallFreeLink* {
+			if ( carved_count == block_count )
+				return nullptr;
+			auto* header = reinterpret_cast<SmallMemoryHeader*>( chunk_base + carved_count++ * block_bytes );
+			header->bucket_index = static_cast<std::uint32_t>( index );
+			header->block_size = static_cast<std::uint32_t>( bucket_bytes );
+			header->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
+			header->owner_heap = &heap;
+			return static_cast<SmallFreeLink*>( header->data() );
+		} );
+
+		block = pop_cached( cache, global_buckets[ index ], heap.shard_index, heap.remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+		if ( !block )
+			throw std::runtime_error( "first_block is null during allocation." );  // 报错 / Error
 	}
 
-	// 链表已经为空，确保掩码位被清除
-	uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
-	uint16_t new_mask;
-	do
-	{
-		new_mask = current_mask & ~( 1 << order );
-	} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+	BucketCounters::add( cache.counters.allocations );
+	BucketCounters::add( cache.counters.requested_bytes, bytes );
 
-	return nullptr;
+	SmallMemoryHeader* header = header_of( block );
+	header->is_free.store( false, std::memory_order_relaxed );	// 标记为已分配 / Mark as allocated
+	header->magic = SmallMemoryHeader::MAGIC;					// 设置魔法值 / Set magic value
+	return header->data();										// 返回数据指针 / Return data pointer
 }
 
-/*──────────────── process_merge_queue ────────────────*/
-void MediumMemoryManager::process_merge_queue()
+/* -------- deallocate -------- */
+void SmallMemoryManager::deallocate( SmallMemoryHeader* header )
 {
-	while ( true )
-	{
-		std::size_t cycle_queue_head = merge_queue.head.load( std::memory_order_relaxed );	// 获取队列头 / Get the queue head
-		std::size_t cycle_queue_tail = merge_queue.tail.load( std::memory_order_acquire );	// 获取队列尾 / Get the queue tail
+	bool expected = false;
+	if ( !header->is_free.compare_exchange_strong( expected, true, std::memory_order_release, std::memory_order_relaxed ) )
+		return;	 // 双重释放 / Double free
 
-		// 队列为空 / If the queue is empty
-		if ( cycle_queue_head == cycle_queue_tail )
-		{
-			// 设置非活跃状态前做最后检查 / Final check before setting inactive state
-			if ( merge_queue.head.load( std::memory_order_acquire ) == merge_queue.tail.load( std::memory_order_acquire ) )
-			{
-				merge_worker_active.store( false, std::memory_order_release );	// 设置工作线程非活跃 / Set the worker thread inactive
-				return;
-			}
-			continue;  // 继续循环 / Continue looping
-		}
+	if ( header->magic != SmallMemoryHeader::MAGIC )
+	{
+		std::cerr << "[Small] invalid magic during deallocation\n";	 // 魔法值错误 / Invalid magic value
+		return;
+	}
+	header->magic = 0;	// 防止重复使用 / Prevent reuse
 
-		// 取出请求 / Retrieve the request
-		MergeRequest request = merge_queue.requests[ cycle_queue_head ].load( std::memory_order_relaxed );
+	const std::size_t index = header->bucket_index;
+	SmallThreadHeap&  heap = local_heap();
+	SmallThreadHeap*  home = header->owner_heap;
+	auto*			  block = static_cast<SmallFreeLink*>( header->data() );
 
-		// 移动头指针 / Move the head pointer
-		std::size_t cycle_queue_next_head = ( cycle_queue_head + 1 ) % MERGE_QUEUE_SIZE;
-		merge_queue.head.store( cycle_queue_next_head, std::memory_order_release );
+	BucketCounters& counters = heap.buckets[ index ].counters;
+	BucketCounters::add( counters.frees );
 
-		// 处理合并 / Process the merge
-		try_merge_buddy( request.block, request.order );
+	/* 他人的块交还其线程堆；所属线程已退出则留在本地 / Hand foreign blocks back to their heap; keep them here if its thread has exited */
+	if ( home != &heap && home->attached.load( std::memory_order_relaxed ) )
+	{
+		BucketCounters::add( counters.remote_frees );
+		push_remote( home->remote_frees[ index ], block );
 	}
+	else
+		push_cached( heap.buckets[ index ], global_buckets[ index ].shards[ heap.shard_index ], MAGAZINE_CAPACITIES[ index ], block );
 }
 
-/*──────────────── try_merge_buddy ────────────────*/
-void MediumMemoryManager::try_merge_buddy( MediumMemoryHeader* block, int order )
+/* -------- slab allocate -------- */
+void* SmallMemoryManager::allocate_slab_object( std::size_t bytes )
 {
-	// 查找chunk的逻辑（与原始merge_buddy相同）/ Logic for finding the chunk (same as original merge_buddy)
-	void*		chunk_base = nullptr;
-	std::size_t chunk_bytes = 0;
-	for ( auto const& chunk : allocated_chunks )
-	{
-		char* base = static_cast<char*>( chunk.first );
-		if ( reinterpret_cast<char*>( block ) >= base && reinterpret_cast<char*>( block ) < base + chunk.second )
+	const std::size_t index = calculate_bucket_index( bytes );	// 计算桶索引 / Calculate bucket index
+	assert( index < SLAB_BUCKET_COUNT && "allocate_slab_object: request exceeds SLAB_MAX_BLOCK_BYTES" );
+	SmallThreadHeap& heap = local_heap();
+	CacheBucket&	 cache = heap.slab_buckets[ index ];
+
+	/* 1) 线程本地弹匣，缺失时先取远程释放链，再从全局 ABA-safe 栈换入满弹匣 / Thread local magazines, refilled from remote frees, then from the global ABA-safe stack */
+	SmallFreeLink* object = pop_cached( cache, slab_global_buckets[ index ], heap.shard_index, heap.slab_remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+	if ( !object && reclaim_remote_frees( cache, slab_global_buckets[ index ].shards[ heap.shard_index ], index, true ) )
+		object = pop_cached( cache, slab_global_buckets[ index ], heap.shard_index, heap.slab_remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+
+	if ( !object )
+	{
+		/* 2) 切分新 slab / Carve a new slab */
+		SmallSlabDescriptor* slab = request_new_slab( index, heap );
+		if ( !slab )
+			throw std::bad_alloc();	 // 申请失败抛出异常 / Throw exception on failure
+		BucketCounters::add( cache.counters.carves );
+
+		std::size_t carved_count = 0;
+		load_blocks( cache, slab_global_buckets[ index ].shards[ heap.shard_index ], MAGAZINE_CAPACITIES[ index ], [ & ]() {
+			return carved_count < slab->block_count ? static_cast<SmallFreeLink*>( slab->block_at( carved_count++ ) ) : nullptr;
+		} );
+
+		object = pop_cached( cache, slab_global_buckets[ index ], heap.shard_index, heap.slab_remote_frees[ index ], MAGAZINE_CAPACITIES[ index ] );
+		if ( !object )
+			throw std::bad_alloc();
+	}
+
+	BucketCounters::add( cache.counters.allocations );
+	BucketCounters::add( cache.counters.requested_bytes, bytes );
+
+	/* 标记为已分配 / Mark as allocated */
+	SmallSlabDescriptor* slab = SmallSlabDescriptor::from_pointer( object );
+	const std::size_t	 block_index = slab->block_index_of( object );
+	slab->allocated_bitmap[ block_index >> 6 ].fetch_or( std::uint64_t( 1 ) << ( block_index & 63 ), std::memory_order_relaxed );
+	return object;
+}
+
+/* -------- slab deallocate -------- */
+void SmallMemoryManager::deallocate_slab_object( SmallSlabDescriptor* slab, void* pointer )
+{
+	if ( slab->magic != SmallSlabDescriptor::MAGIC )
+	{
+		std::cerr << "[SmallSlab] invalid magic during deallocation\n";  // 魔法值错误 / Invalid magic value
+		return;
+	}
+
+	const std::size_t	block_index = slab->block_index_of( pointer );
+	const std::uint64_t block_bit = std::uint64_t( 1 ) << ( block_index & 63 );
+	if ( block_index >= slab->block_count || ( slab->allocated_bitmap[ block_index >> 6 ].fetch_and( ~block_bit, std::memory_order_acq_rel ) & block_bit ) == 0 )
+		return;	 // 双重释放或非法指针 / Double free or stray pointer
+
+	const std::size_t index = slab->bucket_index;
+	SmallThreadHeap&  heap = local_heap();
+	SmallThreadHeap*  home = slab->owner_heap;
+	auto*			  object = static_cast<SmallFreeLink*>( slab->block_at( block_index ) );
+
+	BucketCounters& counters = heap.slab_buckets[ index ].counters;
+	BucketCounters::add( counters.frees );
+
+	/* 他人的对象交还其线程堆；所属线程已退出则留在本地 / Hand foreign objects back to their heap; keep them here if its thread has exited */
+	if ( home != &heap && home->attached.load( std::memory_order_relaxed ) )
+	{
+		BucketCounters::add( counters.remote_frees );
+		push_remote( home->slab_remote_frees[ index ], object );
+	}
+	else
+		push_cached( heap.slab_buckets[ index ], slab_global_buckets[ index ].shards[ heap.shard_index ], MAGAZINE_CAPACITIES[ index ], object );
+}
+
+/* -------- batch -------- */
+void SmallMemoryManager::allocate_slab_batch( std::size_t bytes, std::size_t count, void** out )
+{
+	const std::size_t index = calculate_bucket_index( bytes );
+	assert( index < SLAB_BUCKET_COUNT && "allocate_slab_batch: request exceeds SLAB_MAX_BLOCK_BYTES" );
+	CacheBucket& cache = local_heap().slab_buckets[ index ];
+	std::size_t	 filled = 0;
+
+	try
+	{
+		while ( filled < count )
+		{
+			/* 整段取走当前弹匣 / Take the loaded magazine as one run */
+			MagazineSlot&	  loaded = cache.loaded;
+			const std::size_t run_start = filled;
+			while ( filled < count && loaded.count != 0 )
+			{
+				SmallFreeLink* object = loaded.head;
+				loaded.head = object->next;
+				--loaded.count;
+
+				SmallSlabDescriptor* slab = SmallSlabDescriptor::from_pointer( object );
+				const std::size_t	 block_index = slab->block_index_of( object );
+				slab->allocated_bitmap[ block_index >> 6 ].fetch_or( std::uint64_t( 1 ) << ( block_index & 63 ), std::memory_order_relaxed );
+				out[ filled++ ] = object;
+			}
+			BucketCounters::add( cache.counters.allocations, filled - run_start );
+			BucketCounters::add( cache.counters.requested_bytes, ( filled - run_start ) * bytes );
+
+			// 弹匣已空：单对象路径负责换批、取远程链或切分新 slab / Empty: the single-object path trades, reclaims or carves a fresh slab
+			if ( filled < count )
+				out[ filled++ ] = allocate_slab_object( bytes );
+		}
+	}
+	catch ( ... )
+	{
+		deallocate_slab_batch( out, filled );
+		throw;
+	}
+}
+
+void SmallMemoryManager::deallocate_slab_batch( void* const* pointers, std::size_t count )
+{
+	SmallThreadHeap& heap = local_heap();
+
+	SmallFreeLink* run_head = nullptr;
+	SmallFreeLink* run_tail = nullptr;
+	std::size_t	   run_count = 0;
+	std::size_t	   run_index = 0;
+	auto		   flush_run = [ & ]() {
+		  if ( run_count != 0 )
+			  push_cached_run( heap.slab_buckets[ run_index ], slab_global_buckets[ run_index ].shards[ heap.shard_index ], MAGAZINE_CAPACITIES[ run_index ], run_head, run_tail, run_count );
+		  run_head = run_tail = nullptr;
+		  run_count = 0;
+	};
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		SmallSlabDescriptor* slab = SmallSlabDescriptor::from_pointer( pointers[ i ] );
+		if ( slab->magic != SmallSlabDescriptor::MAGIC )
+		{
+			std::cerr << "[SmallSlab] invalid magic during deallocation\n";
+			continue;
+		}
+
+		const std::size_t	block_index = slab->block_index_of( pointers[ i ] );
+		const std::uint64_t block_bit = std::uint64_t( 1 ) << ( block_index & 63 );
+		if ( block_index >= slab->block_count || ( slab->allocated_bitmap[ block_index >> 6 ].fetch_and( ~block_bit, std::memory_order_acq_rel ) & block_bit ) == 0 )
+			continue;  // 双重释放或非法指针 / Double free or stray pointer
+
+		const std::size_t index = slab->bucket_index;
+		SmallThreadHeap*  home = slab->owner_heap;
+		auto*			  object = static_cast<SmallFreeLink*>( slab->block_at( block_index ) );
+		BucketCounters&	  counters = heap.slab_buckets[ index ].counters;
+		BucketCounters::add( counters.frees );
+
+		if ( home != &heap && home->attached.load( std::memory_order_relaxed ) )
+		{
+			BucketCounters::add( counters.remote_frees );
+			push_remote( home->slab_remote_frees[ index ], object );
+			continue;
+		}
+
+		if ( run_count != 0 && index != run_index )
+			flush_run();
+		object->next = run_head;
+		if ( run_count == 0 )
+			run_tail = object;
+		run_head = object;
+		run_index = index;
+		++run_count;
+	}
+	flush_run();
+}
+
+void SmallMemoryManager::allocate_batch( std::size_t bytes, std::size_t count, void** out )
+{
+	const std::size_t index = calculate_bucket_index( bytes );
+	CacheBucket&	  cache = local_heap().buckets[ index ];
+	std::size_t		  filled = 0;
+
+	try
+	{
+		while ( filled < count )
+		{
+			/* 整段取走当前弹匣 / Take the loaded magazine as one run */
+			MagazineSlot&	  loaded = cache.loaded;
+			const std::size_t run_start = filled;
+			while ( filled < count && loaded.count != 0 )
+			{
+				SmallFreeLink* block = loaded.head;
+				loaded.head = block->next;
+				--loaded.count;
+
+				SmallMemoryHeader* header = header_of( block );
+				header->is_free.store( false, std::memory_order_relaxed );
+				header->magic = SmallMemoryHeader::MAGIC;
+				out[ filled++ ] = header->data();
+			}
+			BucketCounters::add( cache.counters.allocations, filled - run_start );
+			BucketCounters::add( cache.counters.requested_bytes, ( filled - run_start ) * bytes );
+
+			if ( filled < count )
+				out[ filled++ ] = allocate( bytes, DEFAULT_ALIGNMENT );
+		}
+	}
+	catch ( ... )
+	{
+		for ( std::size_t i = 0; i < filled; ++i )
+			deallocate( reinterpret_cast<SmallMemoryHeader*>( static_cast<char*>( out[ i ] ) - sizeof( SmallMemoryHeader ) ) );
+		throw;
+	}
+}
+
+/* -------- 申请新 slab / Request a new slab -------- */
+SmallSlabDescriptor* SmallMemoryManager::request_new_slab( std::size_t index, SmallThreadHeap& heap )
+{
+	constexpr std::size_t SLAB_BYTES = SmallSlabDescriptor::SLAB_BYTES;
+
+	char* slab_memory = nullptr;
+	bool  recycled = false;
+	{
+		std::scoped_lock<std::mutex> lock( chunk_mutex );  // 加锁保护 / Lock protection
+
+		if ( !purged_slabs.empty() )
+		{
+			/* 优先复用已清理的 slab / Reuse a purged slab first */
+			slab_memory = reinterpret_cast<char*>( purged_slabs.back() );
+			purged_slabs.pop_back();
+			recycled = true;
+		}
+		else if ( slab_carve_cursor == slab_carve_end )
+		{
+			// 多映射一个 slab 的余量，保证段内能切出 SLABS_PER_SEGMENT 个对齐 slab / Over-map by one slab so the segment holds SLABS_PER_SEGMENT aligned slabs
+			const std::size_t segment_bytes = ( SLABS_PER_SEGMENT + 1 ) * SLAB_BYTES;
+			void*			  segment_memory = os_memory::allocate_tracked( segment_bytes, DEFAULT_ALIGNMENT, mapping_account );
+			if ( !segment_memory )
+				return nullptr;
+			os_memory::bind_memory_to_node( segment_memory, segment_bytes, numa_node );
+			slab_segments.emplace_back( segment_memory, segment_bytes );
+
+			const std::uintptr_t segment_address = reinterpret_cast<std::uintptr_t>( segment_memory );
+			slab_carve_cursor = reinterpret_cast<char*>( ( segment_address + SLAB_BYTES - 1 ) & ~( static_cast<std::uintptr_t>( SLAB_BYTES ) - 1 ) );
+			slab_carve_end = slab_carve_cursor + SLABS_PER_SEGMENT * SLAB_BYTES;
+		}
+
+		if ( !recycled )
+		{
+			slab_memory = slab_carve_cursor;
+			slab_carve_cursor += SLAB_BYTES;
+		}
+	}
+
+	if ( recycled && !os_memory::commit_memory( slab_memory, SLAB_BYTES ) )
+	{
+		std::scoped_lock<std::mutex> lock( chunk_mutex );
+		purged_slabs.push_back( reinterpret_cast<SmallSlabDescriptor*>( slab_memory ) );
+		return nullptr;
+	}
+
+	const std::size_t block_size = BUCKET_SIZES[ index ];
+	auto*			  slab = reinterpret_cast<SmallSlabDescriptor*>( slab_memory );
+	slab->magic = SmallSlabDescriptor::MAGIC;
+	slab->bucket_index = static_cast<std::uint32_t>( index );
+	slab->block_size = static_cast<std::uint32_t>( block_size );
+	slab->block_count = static_cast<std::uint32_t>( ( SLAB_BYTES - sizeof( SmallSlabDescriptor ) ) / block_size );
+	slab->block_reciprocal = ( ( std::uint64_t( 1 ) << 32 ) + block_size - 1 ) / block_size;
+	slab->owner = this;
+	slab->owner_heap = &heap;
+	slab->idle_scan = 0;
+	slab->idle_since = 0;
+	slab->purge_held = 0;
+	slab->purge_next = nullptr;
+	for ( auto& bitmap_word : slab->allocated_bitmap )
+		bitmap_word.store( 0, std::memory_order_relaxed );
+
+	// 登记到页表后，释放路径才能识别该 slab / Only once registered can the free path recognise the slab
+	if ( !AddressPageMap::instance().assign( slab, SLAB_BYTES, slab ) )
+		return nullptr;
+	return slab;
+}
+
+/* -------- flush TLS -------- */
+void SmallMemoryManager::flush_thread_local_cache()
+{
+	// 只查找不新建：线程退出钩子之后仍可能被调用 / Look up only, never create: may still run after the thread-exit hook
+	if ( SmallThreadHeap* heap = find_local_heap() )
+		flush_heap( *heap );
+}
+
+/* -------- release_resources -------- */
+void SmallMemoryManager::release_resources()
+{
+	flush_thread_local_cache();	 // 清空线程本地缓存 / Clear thread-local cache
+
+	/* 注销全部线程堆：挂接线程在下次查找或退出时摘除 / Retire every thread heap: attached threads unlink theirs on the next lookup or at exit */
+	{
+		std::lock_guard<std::mutex> lock( heap_mutex );
+		while ( SmallThreadHeap* heap = heaps )
+		{
+			heaps = heap->next_in_manager;
+			heap->owner.store( nullptr, std::memory_order_release );
+			release_heap( heap );
+		}
+	}
+
+	/* 弹匣描述符归还进程级仓库 / Hand the magazine descriptors back to the process-wide depot */
+	for ( auto& bucket : global_buckets )
+		for ( auto& shard : bucket.shards )
+			return_magazines( shard );
+	for ( auto& bucket : slab_global_buckets )
+		for ( auto& shard : bucket.shards )
+			return_magazines( shard );
+
+	std::lock_guard<std::mutex> this_lock_guard( chunk_mutex );	 // 加锁保护 / Lock protection
+	for ( auto& chunk : allocated_chunks )
+	{
+		TierPageEntry::erase( chunk.memory, chunk.bytes );			// 先注销页表 / Unregister from the page map first
+		os_memory::deallocate_tracked( chunk.memory, chunk.bytes, mapping_account );	// 释放已分配的内存 / Deallocate allocated memory
+	}
+	allocated_chunks.clear();									// 清空已分配块 / Clear allocated chunks
+
+	for ( auto& [ pointer, size ] : slab_segments )
+	{
+		AddressPageMap::instance().assign( pointer, size, nullptr );  // 先注销页表 / Unregister from the page map first
+		os_memory::deallocate_tracked( pointer, size, mapping_account );
+	}
+	slab_segments.clear();
+	purged_slabs.clear();
+	slab_carve_cursor = slab_carve_end = nullptr;
+}
+
+/* -------- statistics -------- */
+void SmallMemoryManager::collect_statistics( MemoryPoolStatistics& statistics )
+{
+	auto add_bucket = []( MemoryPoolStatistics::SmallBucket& total, const BucketCounters& counters ) {
+		total.allocations += counters.allocations.load( std::memory_order_relaxed );
+		total.frees += counters.frees.load( std::memory_order_relaxed );
+		total.requested_bytes += counters.requested_bytes.load( std::memory_order_relaxed );
+		total.cache_misses += counters.cache_misses.load( std::memory_order_relaxed );
+		total.global_refills += counters.global_refills.load( std::memory_order_relaxed );
+		total.global_flushes += counters.global_flushes.load( std::memory_order_relaxed );
+		total.remote_frees += counters.remote_frees.load( std::memory_order_relaxed );
+		total.carves += counters.carves.load( std::memory_order_relaxed );
+	};
+
+	for ( std::size_t i = 0; i < BUCKET_COUNT; ++i )
+		statistics.small_buckets[ i ].block_bytes = BUCKET_SIZES[ i ];
+	for ( std::size_t i = 0; i < SLAB_BUCKET_COUNT; ++i )
+		statistics.slab_buckets[ i ].block_bytes = BUCKET_SIZES[ i ];
+
+	/* 线程堆在线程退出后保留并被新线程接管，计数因此不会丢失 / Heaps outlive their threads and get adopted, so no count is lost */
+	{
+		std::lock_guard<std::mutex> lock( heap_mutex );
+		for ( SmallThreadHeap* heap = heaps; heap; heap = heap->next_in_manager )
+		{
+			for ( std::size_t i = 0; i < BUCKET_COUNT; ++i )
+				add_bucket( statistics.small_buckets[ i ], heap->buckets[ i ].counters );
+			for ( std::size_t i = 0; i < SLAB_BUCKET_COUNT; ++i )
+				add_bucket( statistics.slab_buckets[ i ], heap->slab_buckets[ i ].counters );
+			++statistics.small_thread_heaps;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock( chunk_mutex );
+	statistics.small_chunks += allocated_chunks.size();
+	for ( const SmallChunk& chunk : allocated_chunks )
+		statistics.small_chunk_bytes += chunk.bytes;
+	statistics.slab_segments += slab_segments.size();
+	for ( const auto& segment : slab_segments )
+		statistics.slab_segment_bytes += segment.second;
+}
+
+/* -------- purge -------- */
+std::size_t SmallMemoryManager::purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan )
+{
+	std::size_t released_bytes = 0;
+	for ( std::size_t i = 0; i < BUCKET_COUNT; ++i )
+		released_bytes += purge_bucket( i, false, now_nanoseconds, idle_nanoseconds, scan );
+	for ( std::size_t i = 0; i < SLAB_BUCKET_COUNT; ++i )
+		released_bytes += purge_bucket( i, true, now_nanoseconds, idle_nanoseconds, scan );
+	return released_bytes;
+}
+
+std::size_t SmallMemoryManager::purge_bucket( std::size_t index, bool slab_bucket, std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan )
+{
+	constexpr std::size_t SLAB_BYTES = SmallSlabDescriptor::SLAB_BYTES;
+	ShardedGlobalBucket&  sharded = slab_bucket ? slab_global_buckets[ index ] : global_buckets[ index ];
+	GlobalBucket&		  bucket = sharded.shards[ 0 ];	 // 剩余块交回首个分片，由其他线程窃取 / Leftovers go back to shard 0 for the others to steal
+
+	/* 0) 先收回各线程堆的远程释放链，否则已退出线程堆上的块会钉住 chunk / Recover remote frees first, or blocks parked on exited threads' heaps pin their chunks */
+	{
+		CacheBucket collected;
+		if ( reclaim_remote_frees( collected, bucket, index, slab_bucket ) && !export_magazine( bucket, collected.loaded ) )
+			collected.loaded = {};
+	}
+
+	/* 1) 取出各分片的全部满弹匣，其中的块归本线程独占 / Take every full magazine off every shard: their blocks are now exclusively ours */
+	SmallMagazine* magazines = nullptr;
+	for ( std::size_t shard = 0; shard < shard_count; ++shard )
+	{
+		while ( SmallMagazine* magazine = pop_global( sharded.shards[ shard ] ) )
+		{
+			magazine->next = magazines;
+			magazines = magazine;
+		}
+	}
+	if ( !magazines )
+		return 0;
+
+	/* 2) 按 chunk 统计手中的空闲块，计数记在 chunk / slab 自身，直到重新交回都持有 chunk_mutex
+	 *    Count the free blocks in hand per chunk on the chunk or slab itself; chunk_mutex stays held until they are handed back */
+	std::unique_lock<std::mutex> lock( chunk_mutex );
+	SmallSlabDescriptor*		 touched_slabs = nullptr;
+	for ( SmallMagazine* magazine = magazines; magazine; magazine = magazine->next )
+	{
+		SmallFreeLink* block = magazine->head;
+		for ( std::size_t i = 0; i < magazine->count; ++i, block = block->next )
+		{
+			if ( slab_bucket )
+			{
+				SmallSlabDescriptor* slab = SmallSlabDescriptor::from_pointer( block );
+				if ( slab->purge_held++ == 0 )
+				{
+					slab->purge_next = touched_slabs;
+					touched_slabs = slab;
+				}
+			}
+			else if ( SmallChunk* chunk = find_chunk( block ) )
+				++chunk->purge_held;
+		}
+	}
+
+	/* 3) 块全部在手且全空够久的 chunk 保留计数，其余清零 / Chunks whose blocks are all in hand and that have been fully free long enough keep their count; the rest reset it */
+	auto idle_long_enough = [ & ]( std::uint32_t& idle_scan, std::uint64_t& idle_since ) {
+		if ( idle_scan + 1 != scan )  // 上一轮未见全空则重新计时 / Restart the clock unless the previous scan saw it fully free too
+			idle_since = now_nanoseconds;
+		idle_scan = scan;
+		return now_nanoseconds - idle_since >= idle_nanoseconds;
+	};
+
+	SmallSlabDescriptor* released_slabs = nullptr;	// 整页在手，链接只归本线程 / Wholly in hand, so only this thread follows the links
+	while ( SmallSlabDescriptor* slab = touched_slabs )
+	{
+		touched_slabs = slab->purge_next;
+		if ( slab->purge_held == slab->block_count && idle_long_enough( slab->idle_scan, slab->idle_since ) )
+		{
+			AddressPageMap::instance().assign( slab, SLAB_BYTES, nullptr );	 // 先注销页表 / Unregister from the page map first
+			slab->purge_next = released_slabs;
+			released_slabs = slab;
+		}
+		else
+			slab->purge_held = 0;
+	}
+	for ( SmallChunk& chunk : allocated_chunks )
+	{
+		if ( chunk.purge_held != 0 && !( chunk.purge_held == chunk.block_count && idle_long_enough( chunk.idle_scan, chunk.idle_since ) ) )
+			chunk.purge_held = 0;
+	}
+
+	/* 4) 其余块重新封装交回全局栈 / Seal the remaining blocks back into magazines for the global stack */
+	auto is_released = [ & ]( SmallFreeLink* block ) {
+		if ( slab_bucket )
+			return SmallSlabDescriptor::from_pointer( block )->purge_held != 0;
+		const SmallChunk* chunk = find_chunk( block );
+		return chunk && chunk->purge_held != 0;
+	};
+
+	SmallMagazine* magazine = magazines;
+	SmallFreeLink* cursor = nullptr;
+	std::size_t	   remaining = 0;
+	auto		   next_held_block = [ & ]() -> SmallFreeLink* {
+		  for ( ;; )
+		  {
+			  while ( remaining == 0 )
+			  {
+				  if ( !magazine )
+					  return nullptr;
+				  cursor = magazine->head;
+				  remaining = magazine->count;
+				  SmallMagazine* consumed = magazine;
+				  magazine = magazine->next;
+				  retire_magazine( consumed );
+			  }
+			  SmallFreeLink* block = cursor;
+			  cursor = block->next;
+			  --remaining;
+			  if ( !is_released( block ) )
+				  return block;
+		  }
+	};
+
+	CacheBucket scratch;
+	load_blocks( scratch, bucket, MAGAZINE_CAPACITIES[ index ], next_held_block );
+	if ( !export_magazine( bucket, scratch.loaded ) )
+		scratch.loaded = {};  // 描述符耗尽：块仍归 chunk 所有 / Out of descriptors: the blocks stay owned by their chunk
+
+	/* 5) 出列的 chunk 以其首部串成链表，解锁后归还操作系统 / Retired chunks are chained through their own first bytes and returned to the OS after unlocking */
+	struct ReleasedChunk
+	{
+		ReleasedChunk* next;
+		std::size_t	   bytes;
+	};
+	ReleasedChunk* released_chunks = nullptr;
+	auto		   kept_end = std::remove_if( allocated_chunks.begin(), allocated_chunks.end(), [ & ]( const SmallChunk& chunk ) {
+		  if ( chunk.purge_held == 0 )
+			  return false;
+		  released_chunks = ::new ( chunk.memory ) ReleasedChunk { released_chunks, chunk.bytes };
+		  return true;
+	  } );
+	allocated_chunks.erase( kept_end, allocated_chunks.end() );	 // 保序删除，数组仍按地址排序 / Order-preserving removal keeps the array sorted
+	lock.unlock();
+
+	std::size_t released_bytes = 0;
+	while ( SmallSlabDescriptor* slab = released_slabs )
+	{
+		released_slabs = slab->purge_next;	 // decommit 会清零描述符 / decommit zeroes the descriptor
+		os_memory::decommit_memory( slab, SLAB_BYTES );	// 地址保留，留待复用 / Keep the address range for reuse
+		{
+			std::lock_guard<std::mutex> slab_lock( chunk_mutex );
+			purged_slabs.push_back( slab );
+		}
+		released_bytes += SLAB_BYTES;
+	}
+	while ( ReleasedChunk* chunk = released_chunks )
+	{
+		released_chunks = chunk->next;
+		const std::size_t bytes = chunk->bytes;
+		TierPageEntry::erase( chunk, bytes );
+		os_memory::deallocate_tracked( chunk, bytes, mapping_account );
+		released_bytes += bytes;
+	}
+	return released_bytes;
+}
+
+SmallMemoryManager::SmallChunk* SmallMemoryManager::find_chunk( const void* block )
+{
+	auto following = std::upper_bound( allocated_chunks.begin(), allocated_chunks.end(), block, []( const void* address, const SmallChunk& chunk ) { return address < chunk.memory; } );
+	if ( following == allocated_chunks.begin() )
+		return nullptr;
+	SmallChunk& chunk = *std::prev( following );
+	return static_cast<const char*>( block ) < static_cast<const char*>( chunk.memory ) + chunk.bytes ? &chunk : nullptr;
+}
+
+/* =====================================================================
+ *  MediumMemoryManager — 实现
+ * ===================================================================== */
+
+/*──────────────── allocate ────────────────*/
+void* MediumMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+{
+	// 块内先放 MediumMemoryHeader，阶数须把它算进去 / The block starts with its MediumMemoryHeader, so the order must cover it
+	const std::size_t block_bytes = bytes + sizeof( MediumMemoryHeader );
+	const int		  want_order = order_from_size( block_bytes );	// 获取所需的内存块级别 / Get the required block level
+
+	// 边界检查：确保请求的order在有效范围内
+	// 失败一律返回 nullptr，由 allocate_from_tiers 按 nothrow 决定是否抛出 / Every failure returns nullptr; allocate_from_tiers decides whether to throw from nothrow
+	if ( want_order < 0 || want_order >= LEVEL_COUNT || block_bytes > size_from_order( LEVEL_COUNT - 1 ) )
+	{
+		return nullptr;
+	}
+
+	// DEFERRED：合并代价由分配路径承担 / DEFERRED: the allocation path pays for merging
+	if ( merge_policy.load( std::memory_order_relaxed ) == MergePolicy::DEFERRED )
+		drain_merge_queue();
+
+	/* 第一阶段：常规分配尝试 */
+	for ( int attempt = 0; attempt < 2; ++attempt )
+	{
+		for ( int current_order = want_order; current_order < LEVEL_COUNT; ++current_order )
+		{
+			if ( auto* block = pop_block( current_order ) )
+			{
+				block = take_block( block, current_order, want_order );
+				if ( !block )
+					return nullptr;	 // 无法提交 / Could not commit
+				return block->data();
+			}
+		}
+
+		// 预留新 arena 前先完成排队中的合并 / Finish queued merges before reserving a new arena
+		if ( merge_queue.empty() )
+			break;
+		drain_merge_queue();
+	}
+
+	/* 第二阶段：预留新 arena，切出所需块，余下的伙伴块进入空闲链表 / Reserve a new arena, carve the block out and free-list the remaining buddies */
+	const int arena_order = std::max( want_order, ARENA_ORDER );
+	auto*	  arena = request_new_chunk( arena_order, alignment );
+	if ( !arena )
+		return nullptr;
+
+	auto* block = take_block( arena, arena_order, want_order );
+	if ( !block )
+		return nullptr;
+	return block->data();
+}
+
+MediumMemoryHeader* MediumMemoryManager::take_block( MediumMemoryHeader* block, int from_order, int to_order )
+{
+	if ( from_order > to_order )
+	{
+		block = split_to_order( block, from_order, to_order );
+		if ( !block )
+			return nullptr;
+	}
+	if ( !recommit_block( block ) )
+	{
+		push_block( block, to_order );
+		return nullptr;
+	}
+	prepare_block( block, to_order );
+	order_counters[ to_order ].allocations.fetch_add( 1, std::memory_order_relaxed );
+	return block;
+}
+
+/*──────────────── deallocate ────────────────*/
+void MediumMemoryManager::deallocate( MediumMemoryHeader* header )
+{
+	/* 确保不是重复释放 / Ensure no double free */
+	bool expected = false;
+	if ( !header->is_free.compare_exchange_strong( expected, true, std::memory_order_acq_rel, std::memory_order_relaxed ) )
+	{
+		return;	 // 如果已经释放过，直接返回 / Return if already freed
+	}
+
+	/* 校验魔法 / Validate magic value */
+	if ( header->magic != MediumMemoryHeader::MAGIC )
+	{
+		std::cerr << "[MediumBuddy] invalid magic during deallocation\n";  // 魔法值无效 / Invalid magic value
+		return;
+	}
+	header->clean = 0;	// 用户写过数据区 / The user has written the data area
+
+	// 创建合并请求 / Create merge request
+	const int		  order = order_from_size( header->block_size );
+	const MergePolicy policy = merge_policy.load( std::memory_order_relaxed );
+	order_counters[ order ].frees.fetch_add( 1, std::memory_order_relaxed );
+
+	// 队列满时退化为就地合并 / Fall back to merging inline when the queue is full
+	if ( policy == MergePolicy::INLINE || !merge_queue.try_push( { header, order } ) )
+	{
+		try_merge_buddy( header, order );
+		return;
+	}
+
+	if ( policy == MergePolicy::ASYNCHRONOUS )
+		wake_merge_worker();
+}
+
+/*──────────────── resize ────────────────*/
+bool MediumMemoryManager::resize( MediumMemoryHeader* header, std::size_t bytes )
+{
+	const std::size_t block_bytes = bytes + sizeof( MediumMemoryHeader );
+	if ( block_bytes > size_from_order( LEVEL_COUNT - 1 ) )
+		return false;
+
+	const int order = order_from_size( header->block_size );
+	const int want_order = order_from_size( block_bytes );
+	if ( want_order == order )
+		return true;
+
+	// 缩小到更低阶时交给搬迁：切下的尾块之后往往无法再合并（中间节点不可摘除），反而造成碎片
+	// Shrinking to a lower order is left to a move: split-off tails often cannot merge back later (middle nodes cannot be unlinked) and fragment the arena
+	if ( want_order < order )
+		return false;
+
+	/* 扩大：块须对齐到目标阶（即各级都是左伙伴），且不越过 chunk / Grow: the block must be aligned to the target order (left buddy at every level) and stay inside its chunk */
+	const auto* chunk = static_cast<const MediumChunk*>( MediumChunkMap::instance().find( header ) );
+	if ( !chunk )
+		return false;
+	const std::size_t offset = static_cast<std::size_t>( reinterpret_cast<char*>( header ) - chunk->base );
+	if ( ( offset & ( size_from_order( want_order ) - 1 ) ) != 0 || offset + size_from_order( want_order ) > chunk->bytes )
+		return false;
+
+	// 排队中的合并会把空闲伙伴放回链表 / Queued merges put free buddies back on the lists
+	if ( !merge_queue.empty() )
+		drain_merge_queue();
+
+	std::array<MediumMemoryHeader*, LEVEL_COUNT> absorbed {};
+	const std::uint8_t							 original_state = header->page_state;
+	int											 current_order = order;
+	for ( ; current_order < want_order; ++current_order )
+	{
+		auto* buddy = reinterpret_cast<MediumMemoryHeader*>( reinterpret_cast<char*>( header ) + size_from_order( current_order ) );
+		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( current_order ) || !take_from_freelist( buddy, current_order ) )
+			break;
+
+		/* 再次确认 buddy 状态 / Recheck buddy state */
+		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( current_order ) )
 		{
-			chunk_base = base;
-			chunk_bytes = chunk.second;
+			push_block( buddy, current_order );
 			break;
 		}
+
+		absorbed[ current_order ] = buddy;
+		if ( buddy->page_state != header->page_state )
+			header->page_state = MediumMemoryHeader::PAGES_MIXED;
+		header->block_size = size_from_order( current_order + 1 );
+	}
+
+	if ( current_order == want_order && recommit_block( header ) )
+	{
+		prepare_block( header, want_order );
+		return true;
+	}
+
+	// 退回已吸收的伙伴，块恢复原状 / Hand the absorbed buddies back and restore the block
+	for ( int level = order; level < current_order; ++level )
+		push_block( absorbed[ level ], level );
+	header->block_size = size_from_order( order );
+	header->page_state = original_state;
+	return false;
+}
+
+void MediumMemoryManager::set_merge_policy( MergePolicy policy )
+{
+	merge_policy.store( policy, std::memory_order_relaxed );
+	if ( policy == MergePolicy::INLINE )
+		drain_merge_queue();
+}
+
+/*──────────────── 内部工具实现 ────────────────*/
+inline void MediumMemoryManager::prepare_block( MediumMemoryHeader* block, int order )
+{
+	block->is_free.store( false, std::memory_order_relaxed );
+	block->magic = MediumMemoryHeader::MAGIC;
+	block->block_size = size_from_order( order );
+	block->next = nullptr;
+}
+
+void MediumMemoryManager::push_block( MediumMemoryHeader* header, int order )
+{
+	header->next = nullptr;
+	header->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
+
+	auto&	   list = free_lists[ order ];	// 获取空闲链表 / Get free list for the order
+	PointerTag head = list.head.load( std::memory_order_relaxed );
+
+	do
+	{
+		header->next = head.pointer;  // 将当前块链接到链表头 / Link the current block to the list head
+		PointerTag new_head { header, head.tag + 1 };
+	} while ( !list.head.compare_exchange_weak( head, { header, head.tag + 1 }, std::memory_order_release, std::memory_order_relaxed ) );
+
+	// 原子更新位掩码
+	uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
+	uint16_t new_mask;
+	do
+	{
+		new_mask = current_mask | ( 1 << order );  // 设置该级别位
+	} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+MediumMemoryHeader* MediumMemoryManager::pop_block( int order )
+{
+	auto&	   list = free_lists[ order ];	// 获取空闲链表 / Get free list for the order
+	PointerTag head = list.head.load( std::memory_order_acquire );
+
+	while ( head.pointer )
+	{
+		PointerTag next { head.pointer->next, head.tag + 1 };
+
+		//Try CompreAndSwap
+		if ( list.head.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_acquire ) )
+		{
+			// 成功取出一个块，检查取出后链表是否为空
+			if ( next.pointer == nullptr )
+			{
+				// 链表变空，清除掩码位
+				uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
+				uint16_t new_mask;
+				do
+				{
+					new_mask = current_mask & ~( 1 << order );
+				} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+			}
+			return head.pointer;
+		}
+		// CompreAndSwap Failed, Retry
+	}
+
+	// 链表已经为空，确保掩码位被清除
+	uint16_t current_mask = free_list_level_mask.load( std::memory_order_relaxed );
+	uint16_t new_mask;
+	do
+	{
+		new_mask = current_mask & ~( 1 << order );
+	} while ( !free_list_level_mask.compare_exchange_weak( current_mask, new_mask, std::memory_order_release, std::memory_order_relaxed ) );
+
+	return nullptr;
+}
+
+/*──────────────── merge queue ────────────────*/
+bool MediumMemoryManager::MergeQueue::try_push( const MergeRequest& request )
+{
+	std::size_t position = enqueue_position.load( std::memory_order_relaxed );
+	for ( ;; )
+	{
+		MergeCell&			cell = cells[ position & ( MERGE_QUEUE_SIZE - 1 ) ];
+		const std::size_t	sequence = cell.sequence.load( std::memory_order_acquire );
+		const std::intptr_t difference = static_cast<std::intptr_t>( sequence ) - static_cast<std::intptr_t>( position );
+		if ( difference == 0 )
+		{
+			// 抢到该格位后再写入 / Claim the cell, then fill it
+			if ( enqueue_position.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+			{
+				cell.request = request;
+				cell.sequence.store( position + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( difference < 0 )
+		{
+			return false;  // 队列已满 / Queue is full
+		}
+		else
+		{
+			position = enqueue_position.load( std::memory_order_relaxed );	// 被其他生产者抢先 / Another producer got there first
+		}
+	}
+}
+
+bool MediumMemoryManager::MergeQueue::try_pop( MergeRequest& request )
+{
+	std::size_t position = dequeue_position.load( std::memory_order_relaxed );
+	for ( ;; )
+	{
+		MergeCell&			cell = cells[ position & ( MERGE_QUEUE_SIZE - 1 ) ];
+		const std::size_t	sequence = cell.sequence.load( std::memory_order_acquire );
+		const std::intptr_t difference = static_cast<std::intptr_t>( sequence ) - static_cast<std::intptr_t>( position + 1 );
+		if ( difference == 0 )
+		{
+			if ( dequeue_position.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+			{
+				request = cell.request;
+				cell.sequence.store( position + MERGE_QUEUE_SIZE, std::memory_order_release );	// 交还给下一圈的生产者 / Hand the cell to the next lap's producer
+				return true;
+			}
+		}
+		else if ( difference < 0 )
+		{
+			return false;  // 队列为空 / Queue is empty
+		}
+		else
+		{
+			position = dequeue_position.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+bool MediumMemoryManager::MergeQueue::empty() const
+{
+	const std::size_t position = dequeue_position.load( std::memory_order_relaxed );
+	return cells[ position & ( MERGE_QUEUE_SIZE - 1 ) ].sequence.load( std::memory_order_acquire ) != position + 1;
+}
+
+/*──────────────── process_merge_queue ────────────────*/
+void MediumMemoryManager::process_merge_queue()
+{
+	MergeRequest batch[ MERGE_BATCH_SIZE ];
+	for ( ;; )
+	{
+		std::size_t count = 0;
+		while ( count < MERGE_BATCH_SIZE && merge_queue.try_pop( batch[ count ] ) )
+			++count;
+		for ( std::size_t i = 0; i < count; ++i )
+			try_merge_buddy( batch[ i ].block, batch[ i ].order );
+		if ( count != 0 )
+			continue;
+
+		// 先公布等待再复查队列，与 wake_merge_worker 的 fence 配对，避免丢失唤醒 / Publish the wait before rechecking the queue; pairs with the fence in wake_merge_worker so no wake-up is lost
+		std::unique_lock<std::mutex> lock( merge_mutex );
+		merge_worker_waiting.store( true, std::memory_order_seq_cst );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		merge_condition.wait( lock, [ this ]() { return merge_stop || !merge_queue.empty(); } );
+		merge_worker_waiting.store( false, std::memory_order_relaxed );
+		if ( merge_stop )
+			return;
+	}
+}
+
+void MediumMemoryManager::drain_merge_queue()
+{
+	MergeRequest request;
+	while ( merge_queue.try_pop( request ) )
+		try_merge_buddy( request.block, request.order );
+}
+
+void MediumMemoryManager::wake_merge_worker()
+{
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	if ( merge_worker_waiting.load( std::memory_order_relaxed ) )
+	{
+		std::lock_guard<std::mutex> lock( merge_mutex );
+		merge_condition.notify_one();
+		return;
+	}
+
+	// 工作线程只启动一次 / The worker is started only once
+	if ( merge_worker_started.load( std::memory_order_acquire ) )
+		return;
+	std::lock_guard<std::mutex> lock( merge_mutex );
+	if ( !merge_worker_started.load( std::memory_order_relaxed ) && !merge_stop )
+	{
+		merge_worker = std::thread( [ this ]() {  // 启动合并线程 / Start the merge thread
+			MemoryPool::enter_worker_thread();
+			process_merge_queue();
+		} );
+		merge_worker_started.store( true, std::memory_order_release );
+	}
+}
+
+void MediumMemoryManager::stop_merge_worker()
+{
+	{
+		std::lock_guard<std::mutex> lock( merge_mutex );
+		merge_stop = true;
+	}
+	merge_condition.notify_all();
+	if ( merge_worker.joinable() )
+		merge_worker.join();
+}
+
+/*──────────────── try_merge_buddy ────────────────*/
+void MediumMemoryManager::try_merge_buddy( MediumMemoryHeader* block, int order )
+{
+	// 页表 O(1) 查找所属 chunk，无需持锁 / O(1) lock-free page-map lookup of the owning chunk
+	const auto* chunk = static_cast<const MediumChunk*>( MediumChunkMap::instance().find( block ) );
+	if ( !chunk )
+		return;
+	char* const		  chunk_base = chunk->base;
+	const std::size_t chunk_bytes = chunk->bytes;
+
+	/* 尝试合并伙伴 / Try to merge buddy */
+	while ( order < LEVEL_COUNT - 1 )
+	{
+		// 计算当前块在chunk中的偏移量 / Calculate block's offset within the chunk
+		std::uintptr_t offset = reinterpret_cast<char*>( block ) - static_cast<char*>( chunk_base );
+		
+		// 使用XOR计算伙伴块的偏移量 / Calculate buddy's offset using XOR trick
+		std::uintptr_t buddy_offset = offset ^ ( size_from_order( order ) );
+
+		// 检查伙伴块是否超出chunk边界 / Check if buddy exceeds chunk boundary
+		if ( buddy_offset + size_from_order( order ) > chunk_bytes )
+			break;	// buddy 超出 chunk / Buddy exceeds chunk size
+
+		// 获取伙伴块头部指针 / Get buddy block header pointer
+		auto* buddy = reinterpret_cast<MediumMemoryHeader*>( static_cast<char*>( chunk_base ) + buddy_offset );
+
+		// 使用原子操作检查buddy状态 / Use atomic operation to check buddy state
+		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( order ) )
+		{
+			break;
+		}
+
+		/* 尝试原子性地移除buddy / Try to atomically remove buddy */
+		if ( !try_remove_from_freelist( buddy, order ) )
+		{
+			break;
+		}
+
+		/* 再次确认buddy状态 / Recheck buddy state */
+		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( order ) )
+		{
+			// 放回freelist / Put back to freelist
+			push_block( buddy, order );
+			break;
+		}
+
+		/* 合并 - 取较小地址为新块首 / Merge - take the smaller address as the new block's start */
+		// 两半状态不同则记为 MIXED：使用前需重新提交，清理时仍需归还已提交的一半 / Differing halves become MIXED: recommit before use, still purge the committed half
+		const std::uint8_t merged_state = ( block->page_state == buddy->page_state ) ? block->page_state : MediumMemoryHeader::PAGES_MIXED;
+		const bool		   merged_clean = block->clean && buddy->clean;
+		MediumMemoryHeader* const upper = ( offset < buddy_offset ) ? buddy : block;
+		block = ( offset < buddy_offset ) ? block : buddy;
+		if ( merged_clean )
+			std::memset( static_cast<void*>( upper ), 0, sizeof( MediumMemoryHeader ) );  // 上半的块头落进合并块的数据区 / The upper half's header now lies in the merged data area
+		block->block_size = size_from_order( order ) << 1;	// 合并后的块大小 / Merged block size
+		block->page_state = merged_state;
+		block->clean = merged_clean;
+		block->idle_scan = 0;
+		order_counters[ order ].merges.fetch_add( 1, std::memory_order_relaxed );
+		order++;
+	}
+
+	// 将合并后的块放回空闲列表 / Push the merged block back to the free list
+	push_block( block, order );
+}
+
+/*──────────────── try_remove_from_freelist ────────────────*/
+bool MediumMemoryManager::try_remove_from_freelist( MediumMemoryHeader* header, int order )
+{
+	auto&	   list = free_lists[ order ];	// 获取对应级别的空闲链表 / Get the corresponding free list for the order
+	PointerTag head = list.head.load( std::memory_order_acquire );
+
+	while ( true )
+	{
+		if ( head.pointer == header )
+		{
+			// =====================================================
+			// 场景1: 目标块是链表头节点 / Scenario 1: Target is the head
+			// =====================================================
+
+			PointerTag next { header->next, head.tag + 1 };
+
+			// 尝试原子性地替换链表头 / Attempt atomic head replacement
+			/*
+			 * 使用CAS解决ABA问题：
+			 * - 比较当前head和之前加载的head
+			 * - 如果相同，替换为new_head
+			 * - 如果不同，重试
+			 * 
+			 * CAS solves ABA problem:
+			 * - Compare current head with previously loaded head
+			 * - If same, replace with new_head
+			 * - If different, retry
+			 */
+			if ( list.head.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_acquire ) )
+			{
+				return true;  // 成功移除 / Successfully removed
+			}
+		}
+		else
+		{
+			// =====================================================
+			// 场景2: 目标块在链表中间 / Scenario 2: Target is in list middle
+			// =====================================================
+
+			/*
+			 * 无锁栈无法安全摘除中间节点：仅改写头标签并不会把目标移出链表，
+			 * 之后它仍会被弹出，与合并后的大块重叠。因此放弃本次合并。
+			 *
+			 * A lock-free stack cannot safely unlink a middle node: bumping the head tag does not take the
+			 * target off the list, so it would still be popped later while overlapping the merged block.
+			 * Give up on this merge instead.
+			 */
+			return false;
+		}
+	}
+}
+
+bool MediumMemoryManager::take_from_freelist( MediumMemoryHeader* header, int order )
+{
+	// 头节点直接用 CAS 摘下 / A head node comes off with a single CAS
+	if ( try_remove_from_freelist( header, order ) )
+		return true;
+
+	// 否则最多查看 TAKE_SCAN_LIMIT 个块，暂存在栈上 / Otherwise look at no more than TAKE_SCAN_LIMIT blocks, parked on the stack
+	std::array<MediumMemoryHeader*, TAKE_SCAN_LIMIT> others;
+	std::size_t										 other_count = 0;
+	bool											 found = false;
+	while ( other_count < TAKE_SCAN_LIMIT )
+	{
+		MediumMemoryHeader* block = pop_block( order );
+		if ( !block )
+			break;
+		if ( block == header )
+		{
+			found = true;
+			break;
+		}
+		others[ other_count++ ] = block;
+	}
+
+	// 逆序推回，保持原有顺序 / Push back in reverse to keep the original order
+	while ( other_count > 0 )
+		push_block( others[ --other_count ], order );
+	return found;
+}
+
+MediumMemoryHeader* MediumMemoryManager::split_to_order( MediumMemoryHeader* block, int from_order, int to_order )
+{
+	// 确保目标order在有效范围内
+	if ( to_order < 0 || to_order >= LEVEL_COUNT || to_order > from_order )
+	{
+		return block;
+	}
+
+	for ( int current_order = from_order - 1; current_order >= to_order; --current_order )
+	{
+		std::size_t half = size_from_order( current_order );				  // 计算每个块的一半 / Calculate half of the block size
+		char*		right_pointer = reinterpret_cast<char*>( block ) + half;  // 获取右侧块的位置 / Get the position of the right block
+
+		// 父块数据页未提交时，先提交右块的块头页 / Commit the right half's header page when the parent's data pages are not committed
+		if ( block->page_state != MediumMemoryHeader::PAGES_COMMITTED && !os_memory::commit_memory( right_pointer, PURGE_KEEP_BYTES ) )
+		{
+			push_block( block, current_order + 1 );	 // 按当前大小放回 / Put it back at its current size
+			return nullptr;
+		}
+
+		auto* right_header = reinterpret_cast<MediumMemoryHeader*>( right_pointer );  // 获取右侧块的头部 / Get the header of the right block
+		right_header->block_size = half;											  // 设置右侧块的大小 / Set the size of the right block
+		right_header->is_free.store( true, std::memory_order_relaxed );				  // 标记为可用 / Mark as free
+		right_header->magic = MediumMemoryHeader::MAGIC;							  // 设置魔法值 / Set magic value
+		right_header->page_state = block->page_state;								  // 继承父块的提交状态 / Inherit the parent's commit state
+		right_header->clean = block->clean;
+		right_header->idle_scan = 0;
+		right_header->next = nullptr;												  // 设置下一块为空 / Set next to null
+
+		push_block( right_header, current_order );	// 将右侧块推入空闲链表 / Push the right block into the free list
+		block->block_size = half;					// 更新原块的大小 / Update the original block's size
+		order_counters[ current_order + 1 ].splits.fetch_add( 1, std::memory_order_relaxed );
+	}
+	return block;  // 返回原块 / Return the original block
+}
+
+MediumMemoryHeader* MediumMemoryManager::request_new_chunk( int arena_order, std::size_t alignment = sizeof( std::max_align_t ) )
+{
+	std::lock_guard<std::mutex> this_lock_guard( chunk_mutex );	 // 加锁保护 / Lock protection
+
+	// 计算需要的内存块大小 / Calculate the required chunk size
+	const std::size_t chunk_bytes = size_from_order( arena_order );  // arena 字节数 / Arena bytes
+
+	( void )alignment;
+	os_memory::PagePolicy policy = page_policy.load( std::memory_order_relaxed );
+	if ( policy == os_memory::PagePolicy::EXPLICIT_1G )
+		policy = os_memory::PagePolicy::EXPLICIT_2M;
+
+	void*		 mapping = nullptr;
+	std::size_t	 mapping_bytes = 0;
+	char*		 chunk_memory = nullptr;
+	std::uint8_t initial_state = MediumMemoryHeader::PAGES_DECOMMITTED;
+	if ( policy == os_memory::PagePolicy::NORMAL )
+	{
+		// 多映射一个粒度的余量，使块区按 1 MiB 对齐、独占其页表粒度 / Over-map by one granule so the block area is 1 MiB aligned and owns its page-map granules
+		// 只预留地址，页在切出块时才提交 / Reserve addresses only; pages are committed as blocks are carved out
+		mapping_bytes = chunk_bytes + MIN_BUCKET_BYTES_UNIT;
+		mapping = os_memory::reserve_tracked( mapping_bytes, mapping_account );	// 向操作系统请求内存 / Request memory from the OS
+		if ( !mapping )
+			return nullptr;	 // 申请失败，返回空指针 / Return null if allocation fails
+		os_memory::bind_memory_to_node( mapping, mapping_bytes, numa_node );
+
+		const std::uintptr_t mapping_address = reinterpret_cast<std::uintptr_t>( mapping );
+		chunk_memory = reinterpret_cast<char*>( ( mapping_address + MIN_BUCKET_BYTES_UNIT - 1 ) & ~( static_cast<std::uintptr_t>( MIN_BUCKET_BYTES_UNIT ) - 1 ) );
+		if ( !os_memory::commit_memory( chunk_memory, PURGE_KEEP_BYTES ) )
+		{
+			os_memory::deallocate_tracked( mapping, mapping_bytes, mapping_account );
+			return nullptr;
+		}
+	}
+	else
+	{
+		// 巨页映射本身 2 MiB 对齐，无需余量；映射即提交 / Huge-page mappings are 2 MiB aligned already, no slack needed; they are committed as mapped
+		mapping_bytes = os_memory::round_to_pages( chunk_bytes, policy );
+		mapping = os_memory::allocate_pages_tracked( mapping_bytes, policy, &policy, mapping_account );
+		if ( !mapping )
+			return nullptr;
+		os_memory::bind_memory_to_node( mapping, mapping_bytes, numa_node );
+		chunk_memory = static_cast<char*>( mapping );
+		initial_state = MediumMemoryHeader::PAGES_COMMITTED;
+	}
+
+	MediumChunk& chunk = allocated_chunks.emplace_back( MediumChunk { mapping, mapping_bytes, chunk_memory, chunk_bytes, policy } );  // 记录已分配的 chunk / Record the allocated chunk
+	if ( !MediumChunkMap::instance().assign( chunk_memory, chunk_bytes, &chunk ) || !TierPageEntry::record( chunk_memory, chunk_bytes, 2, numa_node ) )
+	{
+		MediumChunkMap::instance().assign( chunk_memory, chunk_bytes, nullptr );
+		TierPageEntry::erase( chunk_memory, chunk_bytes );
+		allocated_chunks.pop_back();
+		os_memory::deallocate_tracked( mapping, mapping_bytes, mapping_account );
+		return nullptr;
+	}
+
+	// 整个 chunk 作为一个大块先放进最高层，再让 allocate 重新拿 / Place the entire chunk into the highest level first, then let allocate reuse it
+	auto* header = reinterpret_cast<MediumMemoryHeader*>( chunk_memory );
+	header->block_size = chunk_bytes;						   // 设置块大小 / Set the chunk size
+	header->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
+	header->magic = MediumMemoryHeader::MAGIC;				   // 设置魔法值 / Set magic value
+	header->page_state = initial_state;						   // 普通页 arena 仅块头页已提交 / A normal-page arena has only its header page committed
+	header->clean = 1;										   // 新映射全为零 / A fresh mapping is all zero
+	header->idle_scan = 0;
+	header->next = nullptr;									   // 设置下一块为空 / Set next to null
+
+	return header;
+}
+
+/*──────────────── purge ────────────────*/
+bool MediumMemoryManager::recommit_block( MediumMemoryHeader* block )
+{
+	if ( block->page_state == MediumMemoryHeader::PAGES_COMMITTED )
+		return true;
+	if ( !os_memory::commit_memory( reinterpret_cast<char*>( block ) + PURGE_KEEP_BYTES, block->block_size - PURGE_KEEP_BYTES ) )
+		return false;
+	block->page_state = MediumMemoryHeader::PAGES_COMMITTED;
+	return true;
+}
+
+std::size_t MediumMemoryManager::purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan )
+{
+	std::size_t decommitted_bytes = 0;
+	for ( int order = 0; order < LEVEL_COUNT; ++order )
+	{
+		/* 先整层取出，所有块归本线程独占后再处理 / Take the whole level first so every block is exclusively ours */
+		std::vector<MediumMemoryHeader*> blocks;
+		while ( MediumMemoryHeader* block = pop_block( order ) )
+			blocks.push_back( block );
+
+		for ( MediumMemoryHeader* block : blocks )
+		{
+			// 上一轮未见空闲则重新计时 / Restart the idle clock unless the previous scan also saw it free
+			if ( block->idle_scan + 1 != scan )
+				block->idle_since = now_nanoseconds;
+			block->idle_scan = scan;
+
+			if ( block->page_state != MediumMemoryHeader::PAGES_DECOMMITTED && now_nanoseconds - block->idle_since >= idle_nanoseconds )
+			{
+				// hugetlb / 大页无法按 4 KiB 归还 / hugetlb and large pages cannot be returned at 4 KiB granularity
+				const auto* chunk = static_cast<const MediumChunk*>( MediumChunkMap::instance().find( block ) );
+				if ( chunk && ( chunk->page_policy == os_memory::PagePolicy::EXPLICIT_2M || chunk->page_policy == os_memory::PagePolicy::EXPLICIT_1G ) )
+					continue;
+
+				const std::size_t data_bytes = block->block_size - PURGE_KEEP_BYTES;
+				if ( os_memory::decommit_memory( reinterpret_cast<char*>( block ) + PURGE_KEEP_BYTES, data_bytes ) )
+				{
+					// 其余页重新提交时为零，再清掉保留页的数据部分即整块为零 / The other pages come back zero, so clearing the data part of the kept page makes the whole block clean
+					if ( !block->clean )
+						std::memset( block->data(), 0, PURGE_KEEP_BYTES - sizeof( MediumMemoryHeader ) );
+					// 干净块自页归零后从未写入，其页多半从未提交，不计入 / A clean block was never written since its pages came back zero, so they are most likely uncommitted and not counted
+					if ( !block->clean )
+						decommitted_bytes += data_bytes;
+					block->clean = 1;
+					block->page_state = MediumMemoryHeader::PAGES_DECOMMITTED;
+				}
+			}
+		}
+
+		for ( MediumMemoryHeader* block : blocks )
+			push_block( block, order );
+	}
+	return decommitted_bytes;
+}
+
+/*──────────────── release_resources ────────────────*/
+void MediumMemoryManager::release_resources()
+{
+	stop_merge_worker();  // 工作线程不再访问块与 chunk 记录 / The worker no longer touches blocks or chunk records
+
+	/* 清空 freelist / Clear the freelist */
+	for ( auto& free_list : free_lists )
+	{
+		free_list.head.store( { nullptr, 0 }, std::memory_order_relaxed );	// 设置空头指针 / Set head pointer to null
+	}
+
+	for ( MediumChunk& chunk : allocated_chunks )
+	{
+		MediumChunkMap::instance().assign( chunk.base, chunk.bytes, nullptr );	// 先注销页表 / Unregister from the page maps first
+		TierPageEntry::erase( chunk.base, chunk.bytes );
+		os_memory::deallocate_tracked( chunk.mapping, chunk.mapping_bytes, mapping_account );	// 释放内存 / Deallocate memory
+	}
+	allocated_chunks.clear();  // 清空已分配块 / Clear the allocated chunks
+}
+
+/*──────────────── statistics ────────────────*/
+void MediumMemoryManager::collect_statistics( MemoryPoolStatistics& statistics )
+{
+	for ( int order = 0; order < LEVEL_COUNT; ++order )
+	{
+		MemoryPoolStatistics::MediumOrder& total = statistics.medium_orders[ order ];
+		const OrderCounters&			   counters = order_counters[ order ];
+		total.block_bytes = size_from_order( order );
+		total.allocations += counters.allocations.load( std::memory_order_relaxed );
+		total.frees += counters.frees.load( std::memory_order_relaxed );
+		total.splits += counters.splits.load( std::memory_order_relaxed );
+		total.merges += counters.merges.load( std::memory_order_relaxed );
+	}
+
+	// 先读出队位置：并发时深度只会偏小，不会回绕 / Read the dequeue side first so a concurrent read can only undercount, never wrap
+	const std::size_t dequeued = merge_queue.dequeue_position.load( std::memory_order_relaxed );
+	const std::size_t enqueued = merge_queue.enqueue_position.load( std::memory_order_relaxed );
+	statistics.merge_queue_depth += enqueued > dequeued ? enqueued - dequeued : 0;
+
+	std::lock_guard<std::mutex> lock( chunk_mutex );
+	statistics.medium_chunks += allocated_chunks.size();
+	for ( const MediumChunk& chunk : allocated_chunks )
+		statistics.medium_chunk_bytes += chunk.mapping_bytes;
+}
+
+/* =====================================================================
+ *  LargeMemoryManager — 实现
+ * ===================================================================== */
+
+namespace
+{
+	std::uint64_t steady_now_nanoseconds()
+	{
+		return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+	}
+}  // namespace
+
+void LargeMemoryManager::BlockList::push_front( LargeMemoryHeader* header )
+{
+	header->previous = nullptr;
+	header->next = head;
+	if ( head )
+		head->previous = header;
+	else
+		tail = header;
+	head = header;
+}
+
+void LargeMemoryManager::BlockList::remove( LargeMemoryHeader* header )
+{
+	( header->previous ? header->previous->next : head ) = header->next;
+	( header->next ? header->next->previous : tail ) = header->previous;
+	header->previous = header->next = nullptr;
+}
+
+void* LargeMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+{
+	const std::size_t			total = sizeof( LargeMemoryHeader ) + bytes;  // 计算总内存大小 / Calculate total memory size
+	const os_memory::PagePolicy policy = page_policy.load( std::memory_order_relaxed );
+	const std::size_t			mapping_bytes = os_memory::round_to_pages( ( total + CACHE_GRANULE - 1 ) & ~( CACHE_GRANULE - 1 ), policy );	 // 取整到尺寸类与页策略 / Round up to the size class and the page policy
+	const std::size_t class_index = cache_class( mapping_bytes );
+
+	LargeMemoryHeader* header = nullptr;
+	LargeMemoryHeader* expired = nullptr;
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
+		expired = take_expired( steady_now_nanoseconds(), cache_decay_nanoseconds );
+		if ( class_index < CACHE_CLASS_COUNT && ( header = cached_blocks[ class_index ].head ) != nullptr )
+		{
+			/* 命中缓存：复用最近释放的同类映射 / Cache hit: reuse the most recently freed mapping of this class */
+			cached_blocks[ class_index ].remove( header );
+			cached_bytes -= mapping_bytes;
+			header->magic = LargeMemoryHeader::MAGIC;
+			header->clean = 0;
+			header->block_size = bytes;
+			active_blocks.push_front( header );
+			++allocation_count;
+			++cache_hit_count;
+		}
+	}
+	unmap_chain( expired );
+	if ( header )
+		return header->data();
+
+	( void )alignment;
+	os_memory::PagePolicy obtained_policy = policy;
+	void*				  memory = os_memory::allocate_pages_tracked( mapping_bytes, policy, &obtained_policy, mapping_account );	// 向操作系统申请内存 / Request memory from the OS
+	if ( !memory )
+		return nullptr;	 // 由 allocate_from_tiers 按 nothrow 决定是否抛出 / allocate_from_tiers decides whether to throw from nothrow
+	// 缓存中的映射保持登记，命中缓存时无需重登 / Cached mappings stay registered, so a cache hit does not register again
+	if ( !TierPageEntry::record( memory, TierPageEntry::anchor_bytes( sizeof( LargeMemoryHeader ), mapping_bytes ), 3, numa_node ) )
+	{
+		os_memory::deallocate_tracked( memory, mapping_bytes, mapping_account );
+		return nullptr;
+	}
+	os_memory::bind_memory_to_node( memory, mapping_bytes, numa_node );
+
+	header = static_cast<LargeMemoryHeader*>( memory );	 // 获取内存头部 / Get the memory header
+	header->magic = LargeMemoryHeader::MAGIC;			 // 设置魔法值 / Set magic value
+	header->clean = 1;									 // 新映射全为零 / A fresh mapping is all zero
+	header->page_policy = obtained_policy;
+	header->block_size = bytes;							 // 设置块大小 / Set block size
+	header->mapping_bytes = mapping_bytes;
+	header->released_at = 0;
+
+	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
+	active_blocks.push_front( header );								// 记录已分配的块 / Record the allocated block
+	++allocation_count;
+
+	return header->data();	// 返回数据指针 / Return data pointer
+}
+
+LargeMemoryHeader* LargeMemoryManager::resize( LargeMemoryHeader* header, std::size_t bytes )
+{
+	const std::size_t total = sizeof( LargeMemoryHeader ) + bytes;
+	// 按映射自身的页策略取整，mremap 不能改变 hugetlb 的页大小 / Round with the mapping's own page policy; mremap cannot change a hugetlb page size
+	const std::size_t mapping_bytes = os_memory::round_to_pages( ( total + CACHE_GRANULE - 1 ) & ~( CACHE_GRANULE - 1 ), header->page_policy );
+	if ( mapping_bytes == header->mapping_bytes )
+	{
+		header->block_size = bytes;	 // 仍在同一尺寸类 / Still in the same size class
+		return header;
+	}
+
+	/* 锁外 mremap：先摘出活跃链表，结束后按新地址挂回 / mremap outside the lock: unlink from the active list, relink at the new address afterwards */
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );
+		active_blocks.remove( header );
+	}
+	// 旧地址在 mremap 之后可能立即被别的映射占用，所以先注销 / The old range may be mapped by someone else right after mremap, so unregister first
+	TierPageEntry::erase( header, TierPageEntry::anchor_bytes( sizeof( LargeMemoryHeader ), header->mapping_bytes ) );
+	auto* moved = static_cast<LargeMemoryHeader*>( os_memory::remap_tracked( header, header->mapping_bytes, mapping_bytes, mapping_account ) );
+	if ( moved )
+	{
+		moved->block_size = bytes;
+		moved->mapping_bytes = mapping_bytes;
+		header = moved;
+	}
+	if ( !TierPageEntry::record( header, TierPageEntry::anchor_bytes( sizeof( LargeMemoryHeader ), header->mapping_bytes ), 3, numa_node ) )
+		std::cerr << "[Large] page map registration failed after mremap\n";	 // 仅剩带尺寸释放可用 / Only sized deallocation still finds the block
+	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );
+	active_blocks.push_front( header );
+	if ( moved )
+		++remap_count;
+	return moved;
+}
+
+void LargeMemoryManager::deallocate( LargeMemoryHeader* header )
+{
+	if ( header->magic != LargeMemoryHeader::MAGIC )
+	{
+		std::cerr << "[Large] invalid magic during deallocation\n";	 // 魔法值无效 / Invalid magic value
+		return;
+	}
+	header->magic = 0;	// 清除魔法值 / Clear magic value
+
+	const std::size_t  class_index = cache_class( header->mapping_bytes );
+	LargeMemoryHeader* expired = nullptr;
+	bool			   cached = false;
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
+		active_blocks.remove( header );									// O(1) 摘除 / O(1) unlink
+		++free_count;
+
+		const std::uint64_t now = steady_now_nanoseconds();
+		expired = take_expired( now, cache_decay_nanoseconds );
+		if ( class_index < CACHE_CLASS_COUNT && header->mapping_bytes <= cache_budget_bytes )
+		{
+			// 超出预算时先淘汰最旧的映射 / Evict the oldest mappings while over budget
+			while ( cached_bytes + header->mapping_bytes > cache_budget_bytes )
+			{
+				LargeMemoryHeader* oldest = take_oldest();
+				oldest->next = expired;
+				expired = oldest;
+			}
+			header->released_at = now;
+			cached_blocks[ class_index ].push_front( header );
+			cached_bytes += header->mapping_bytes;
+			cached = true;
+		}
+	}
+
+	unmap_chain( expired );
+	if ( !cached )
+	{
+		TierPageEntry::erase( header, TierPageEntry::anchor_bytes( sizeof( LargeMemoryHeader ), header->mapping_bytes ) );
+		os_memory::deallocate_tracked( header, header->mapping_bytes, mapping_account );	 // 释放内存 / Deallocate memory
+	}
+}
+
+void LargeMemoryManager::set_cache_policy( std::size_t budget_bytes, std::uint64_t decay_nanoseconds )
+{
+	LargeMemoryHeader* expired = nullptr;
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );
+		cache_budget_bytes = budget_bytes;
+		cache_decay_nanoseconds = decay_nanoseconds;
+		while ( cached_bytes > cache_budget_bytes )
+		{
+			LargeMemoryHeader* oldest = take_oldest();
+			oldest->next = expired;
+			expired = oldest;
+		}
+	}
+	unmap_chain( expired );
+}
+
+std::size_t LargeMemoryManager::purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds )
+{
+	LargeMemoryHeader* expired = nullptr;
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );
+		expired = take_expired( now_nanoseconds, idle_nanoseconds );
+	}
+	return unmap_chain( expired );
+}
+
+LargeMemoryHeader* LargeMemoryManager::take_expired( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds )
+{
+	LargeMemoryHeader* expired = nullptr;
+	for ( BlockList& list : cached_blocks )
+	{
+		// 链尾最旧，遇到未过期的即可停止 / The tail is the oldest, stop at the first one still fresh
+		while ( list.tail && now_nanoseconds - list.tail->released_at >= idle_nanoseconds )
+		{
+			LargeMemoryHeader* header = list.tail;
+			list.remove( header );
+			cached_bytes -= header->mapping_bytes;
+			header->next = expired;
+			expired = header;
+		}
+	}
+	return expired;
+}
+
+LargeMemoryHeader* LargeMemoryManager::take_oldest()
+{
+	BlockList* oldest_list = nullptr;
+	for ( BlockList& list : cached_blocks )
+	{
+		if ( list.tail && ( !oldest_list || list.tail->released_at < oldest_list->tail->released_at ) )
+			oldest_list = &list;
+	}
+
+	LargeMemoryHeader* header = oldest_list->tail;
+	oldest_list->remove( header );
+	cached_bytes -= header->mapping_bytes;
+	return header;
+}
+
+std::size_t LargeMemoryManager::unmap_chain( LargeMemoryHeader* chain )
+{
+	std::size_t unmapped_bytes = 0;
+	while ( chain )
+	{
+		LargeMemoryHeader* next = chain->next;
+		const std::size_t  mapping_bytes = chain->mapping_bytes;
+		TierPageEntry::erase( chain, TierPageEntry::anchor_bytes( sizeof( LargeMemoryHeader ), mapping_bytes ) );
+		if ( os_memory::deallocate_tracked( chain, mapping_bytes, mapping_account ) )
+			unmapped_bytes += mapping_bytes;
+		chain = next;
+	}
+	return unmapped_bytes;
+}
+
+void LargeMemoryManager::release_resources()
+{
+	LargeMemoryHeader* chain = nullptr;
+	{
+		std::scoped_lock<std::mutex> lock( tracking_mutex );
+		auto take_all = [ &chain ]( BlockList& list ) {
+			while ( LargeMemoryHeader* header = list.head )
+			{
+				list.remove( header );
+				header->next = chain;
+				chain = header;
+			}
+		};
+		take_all( active_blocks );
+		for ( BlockList& list : cached_blocks )
+			take_all( list );
+		cached_bytes = 0;
+	}
+	unmap_chain( chain );  // 释放所有已分配与缓存的内存 / Deallocate every allocated and cached mapping
+}
+
+void LargeMemoryManager::collect_statistics( MemoryPoolStatistics& statistics )
+{
+	MemoryPoolStatistics::Large& total = statistics.large;
+	std::lock_guard<std::mutex>	 lock( tracking_mutex );
+	total.allocations += allocation_count;
+	total.frees += free_count;
+	total.cache_hits += cache_hit_count;
+	total.remaps += remap_count;
+	for ( const LargeMemoryHeader* header = active_blocks.head; header; header = header->next )
+	{
+		++total.active_blocks;
+		total.active_bytes += header->mapping_bytes;
+	}
+	for ( const BlockList& list : cached_blocks )
+		for ( const LargeMemoryHeader* header = list.head; header; header = header->next )
+			++total.cached_blocks;
+	total.cached_bytes += cached_bytes;
+}
+
+/* =====================================================================
+ *  HugeMemoryManager — 实现
+ * ===================================================================== */
+
+void* HugeMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+{
+	( void )alignment;
+	const os_memory::PagePolicy policy = page_policy.load( std::memory_order_relaxed );
+	const std::size_t			total = os_memory::round_to_pages( sizeof( HugeMemoryHeader ) + bytes, policy );  // 计算总内存大小 / Calculate total memory size
+	void*						memory = os_memory::allocate_pages_tracked( total, policy, nullptr, mapping_account );				 // 向操作系统申请内存 / Request memory from the OS
+	if ( !memory )
+		return nullptr;	 // 由 allocate_from_tiers 按 nothrow 决定是否抛出 / allocate_from_tiers decides whether to throw from nothrow
+	if ( !TierPageEntry::record( memory, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), total ), 4, numa_node ) )
+	{
+		os_memory::deallocate_tracked( memory, total, mapping_account );
+		return nullptr;
+	}
+	os_memory::bind_memory_to_node( memory, total, numa_node );
+
+	auto* header = static_cast<HugeMemoryHeader*>( memory );  // 获取内存头部 / Get the memory header
+	header->magic = HugeMemoryHeader::MAGIC;				  // 设置魔法值 / Set magic value
+	header->block_size = bytes;								  // 设置块大小 / Set block size
+	header->mapping_bytes = total;
+
+	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
+	active_blocks.emplace_back( memory, total );					// 记录已分配的块 / Record the allocated block
+	++allocation_count;
+
+	return header->data();	// 返回数据指针 / Return data pointer
+}
+
+void HugeMemoryManager::deallocate( HugeMemoryHeader* header )
+{
+	if ( header->magic != HugeMemoryHeader::MAGIC )
+	{
+		std::cerr << "[Huge] invalid magic during deallocation\n";	// 魔法值无效 / Invalid magic value
+		return;
+	}
+	header->magic = 0;	// 清除魔法值 / Clear magic value
+
+	{
+		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );																													   // 加锁保护 / Lock protection
+		auto						iter = std::find_if( active_blocks.begin(), active_blocks.end(), [ header ]( auto& reference_object ) { return reference_object.first == header; } );  // 查找并删除已释放块 / Find and remove the deallocated block
+		if ( iter != active_blocks.end() )
+		{
+			TierPageEntry::erase( iter->first, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), iter->second ) );
+			os_memory::deallocate_tracked( iter->first, iter->second, mapping_account );	 // 释放内存 / Deallocate memory
+			active_blocks.erase( iter );								 // 删除已释放块 / Remove the deallocated block
+			++free_count;
+			return;
+		}
+	}
+
+	TierPageEntry::erase( header, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), header->mapping_bytes ) );
+	os_memory::deallocate_tracked( header, header->mapping_bytes, mapping_account );	 // 释放内存 / Deallocate memory
+}
+
+HugeMemoryHeader* HugeMemoryManager::resize( HugeMemoryHeader* header, std::size_t bytes )
+{
+	const std::size_t total = os_memory::round_to_pages( sizeof( HugeMemoryHeader ) + bytes, page_policy.load( std::memory_order_relaxed ) );
+	if ( total == header->mapping_bytes )
+	{
+		header->block_size = bytes;
+		return header;
+	}
+
+	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );
+	auto iter = std::find_if( active_blocks.begin(), active_blocks.end(), [ header ]( auto& reference_object ) { return reference_object.first == header; } );
+	if ( iter == active_blocks.end() )
+		return nullptr;
+
+	TierPageEntry::erase( header, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), header->mapping_bytes ) );	// mremap 之前注销 / Unregister before mremap
+	auto* moved = static_cast<HugeMemoryHeader*>( os_memory::remap_tracked( header, header->mapping_bytes, total, mapping_account ) );
+	if ( !TierPageEntry::record( moved ? moved : header, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), moved ? total : header->mapping_bytes ), 4, numa_node ) )
+		std::cerr << "[Huge] page map registration failed after mremap\n";	// 仅剩带尺寸释放可用 / Only sized deallocation still finds the block
+	if ( !moved )
+		return nullptr;
+	moved->block_size = bytes;
+	moved->mapping_bytes = total;
+	*iter = { moved, total };
+	++remap_count;
+	return moved;
+}
+
+void HugeMemoryManager::release_resources()
+{
+	{
+		std::scoped_lock<std::mutex> lock( tracking_mutex );
+		for ( auto& [ pointer, size ] : active_blocks )
+		{
+			TierPageEntry::erase( pointer, TierPageEntry::anchor_bytes( sizeof( HugeMemoryHeader ), size ) );
+			os_memory::deallocate_tracked( pointer, size, mapping_account );	 // 释放所有已分配的内存 / Deallocate all allocated memory
+		}
+		active_blocks.clear();								 // 清空已分配块 / Clear the allocated blocks
+	}
+}
+
+void HugeMemoryManager::collect_statistics( MemoryPoolStatistics& statistics )
+{
+	MemoryPoolStatistics::Huge& total = statistics.huge;
+	std::lock_guard<std::mutex> lock( tracking_mutex );
+	total.allocations += allocation_count;
+	total.frees += free_count;
+	total.remaps += remap_count;
+	total.active_blocks += active_blocks.size();
+	for ( const auto& block : active_blocks )
+		total.active_bytes += block.second;
+}
+
+// =====================================================================
+//  MemoryPool 实现
+// =====================================================================
+
+MemoryPool::MemoryPool()
+{
+	/* 初始化全局小桶 & 中层空闲链头 / Initialize global small buckets and medium-level free list heads */
+	for ( auto& bucket : small_manager.global_buckets )
+	{
+		for ( auto& shard : bucket.shards )
+		{
+#if SUPPORT_128BIT_CAS
+			shard.head.store( { nullptr, 0 }, std::memory_order_relaxed );  // 使用128位CAS / Use 128-bit CAS
+#else
+			shard.head.store( nullptr, std::memory_order_relaxed );  // 普通指针CAS / Normal pointer CAS
+#endif
+		}
+	}
+	for ( auto& bucket : small_manager.slab_global_buckets )
+	{
+		for ( auto& shard : bucket.shards )
+		{
+#if SUPPORT_128BIT_CAS
+			shard.head.store( { nullptr, 0 }, std::memory_order_relaxed );
+#else
+			shard.head.store( nullptr, std::memory_order_relaxed );
+#endif
+		}
+	}
+
+	if ( !construction_warning_shown.exchange( true, std::memory_order_relaxed ) )
+	{
+		std::cerr << "\033[33m[MemoryPool Warning] 直接使用 MemoryPool 仅适合内部场景，生产代码请封装成 PoolAllocator！\033[0m\n";										   // 警告信息 / Warning message
+		std::cerr << "\033[32m[MemoryPool Warning] Direct use of MemoryPool may cause tracking misses or duplicates. Please use PoolAllocator instead!\033[0m\n";  // 警告信息 / Warning message
+	}
+
+	small_manager.mapping_account = &mapping_account;
+	medium_manager.mapping_account = &mapping_account;
+	large_manager.mapping_account = &mapping_account;
+	huge_manager.mapping_account = &mapping_account;
+}
+
+MemoryPool::MemoryPool( std::size_t numa_node ) : MemoryPool()
+{
+	node_index = static_cast<std::uint32_t>( numa_node );
+	small_manager.numa_node = numa_node;
+	medium_manager.numa_node = numa_node;
+	large_manager.numa_node = numa_node;
+	huge_manager.numa_node = numa_node;
+}
+
+MemoryPool::~MemoryPool()
+{
+	/* 0. 先停掉后台清理线程，避免它与资源释放并发 / Stop the purger before tearing anything down */
+	stop_purge_thread();
+
+	/* 1. 标记正在销毁（让各个 manager 在 flush/释放时知道不要往 thread-cache 再放） */
+	is_destructing.store( true, std::memory_order_release );  // 设置销毁标志 / Set destruction flag
+
+	/* 2. 刷新本线程的缓存，回收所有没还给 OS 的小/中/大块 */
+	flush_current_thread_cache();  // 刷新当前线程缓存 / Flush current thread cache
+
+	/* 3. 依次释放各等级的剩余资源 */
+	huge_manager.release_resources();	 // 释放超大内存资源 / Release huge memory resources
+	large_manager.release_resources();	 // 释放大内存资源 / Release large memory resources
+	medium_manager.release_resources();	 // 释放中等内存资源 / Release medium memory resources
+	small_manager.release_resources();	 // 释放小内存资源 / Release small memory resources
+
+	/* 4. 最终检查，本池的计数应为 0（全局计数包含其他仍存活的池）/ Final check: this pool's counters must be 0 (the global ones include pools still alive) */
+	const uint64_t leaked = mapping_account.mapped_bytes.load( std::memory_order_seq_cst );
+	if ( leaked != 0 )
+	{
+		std::cerr << "[MemoryPool] Memory leak detected: " << leaked << " bytes still allocated." << std::endl;
+	}
+
+	/* 5. 检查操作计数，allocate/deallocate 是否成对 */
+	const int64_t original_point = mapping_account.operations.load( std::memory_order_seq_cst );
+	if ( original_point != 0 )
+	{
+		std::cerr << "[MemoryPool] Operation imbalance detected: " << original_point << " net operations (allocs minus frees)." << std::endl;
+	}
+}
+
+/// @brief used + bytes 是否超过 limit（不溢出）/ Whether used + bytes exceeds limit, without overflowing
+static bool crosses_limit( std::uint64_t used_bytes, std::size_t bytes, std::uint64_t limit_bytes )
+{
+	return used_bytes > limit_bytes || bytes > limit_bytes - used_bytes;
+}
+
+void* MemoryPool::allocate( std::size_t requested_bytes, std::size_t requested_alignment, const char* file, std::uint32_t line, bool nothrow )
+{
+	if ( crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), requested_bytes, pressure_threshold_bytes.load( std::memory_order_relaxed ) ) &&
+		 !admit_under_pressure( requested_bytes, nothrow ) )
+		return nullptr;
+
+	void* const user_pointer = allocate_aligned( requested_bytes, requested_alignment, nothrow );
+	HeapProfiler::instance().record_allocation( user_pointer, requested_bytes );
+	os_memory::memory_pool::SizeHistogramRecorder::instance().record( requested_bytes );
+	return user_pointer;
+}
+
+void* MemoryPool::allocate_zeroed( std::size_t count, std::size_t bytes, std::size_t alignment, const char* file, std::uint32_t line, bool nothrow )
+{
+	if ( bytes != 0 && count > std::numeric_limits<std::size_t>::max() / bytes )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return nullptr;
+	}
+
+	const std::size_t total_bytes = count * bytes;
+	void* const		  user_pointer = allocate( total_bytes, alignment, file, line, nothrow );
+	if ( !user_pointer )
+		return nullptr;
+	if ( !clear_allocation( user_pointer, total_bytes ) )
+	{
+		deallocate( user_pointer );
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return nullptr;
+	}
+	return user_pointer;
+}
+
+/**
+ * @brief 清零一段区间：中间按 granule 对齐的整页交还操作系统换零页，首尾零头 memset
+ *        Zero a span: the granule-aligned interior pages go back to the OS for zero pages, the ragged ends are memset
+ * @return 页已交还却无法重新提交时返回 false / false when the pages were handed back but could not be committed again
+ */
+static bool clear_span( void* pointer, std::size_t bytes, std::size_t granule )
+{
+	char* const			 begin = static_cast<char*>( pointer );
+	char* const			 end = begin + bytes;
+	const std::uintptr_t mask = static_cast<std::uintptr_t>( granule ) - 1;
+	char* const			 first_page = reinterpret_cast<char*>( ( reinterpret_cast<std::uintptr_t>( begin ) + mask ) & ~mask );
+	char* const			 last_page = reinterpret_cast<char*>( reinterpret_cast<std::uintptr_t>( end ) & ~mask );
+	if ( first_page < last_page && os_memory::decommit_memory( first_page, static_cast<std::size_t>( last_page - first_page ) ) )
+	{
+		if ( !os_memory::commit_memory( first_page, static_cast<std::size_t>( last_page - first_page ) ) )
+			return false;
+		std::memset( begin, 0, static_cast<std::size_t>( first_page - begin ) );
+		std::memset( last_page, 0, static_cast<std::size_t>( end - last_page ) );
+		return true;
+	}
+	std::memset( begin, 0, bytes );	 // 无整页可交还，或 decommit 失败 / No whole page to hand back, or the decommit failed
+	return true;
+}
+
+bool MemoryPool::clear_allocation( void* user_pointer, std::size_t bytes )
+{
+	const TierBlock block = locate_block( user_pointer );
+	switch ( block.owner_type )
+	{
+	case 2:
+	{
+		const auto* header = static_cast<const MediumMemoryHeader*>( block.header );
+		if ( header->clean )
+			return true;
+		if ( bytes < ZEROING_DECOMMIT_MIN_BYTES )
+			break;
+		// 按 chunk 实际的页大小交还整页，至少 2 MiB 以免拆开透明巨页 / Hand back whole pages of the chunk's actual page size, at least 2 MiB so transparent huge pages are not split
+		const auto* chunk = static_cast<const MediumMemoryManager::MediumChunk*>( MediumChunkMap::instance().find( header ) );
+		const std::size_t granule = chunk ? os_memory::page_bytes( chunk->page_policy ) : os_memory::HUGE_PAGE_2M_BYTES;
+		return clear_span( user_pointer, bytes, std::max( os_memory::HUGE_PAGE_2M_BYTES, granule ) );
+	}
+	case 3:
+	{
+		const auto* header = static_cast<const LargeMemoryHeader*>( block.header );
+		if ( header->clean )
+			return true;
+		return clear_span( user_pointer, bytes, std::max( os_memory::HUGE_PAGE_2M_BYTES, os_memory::page_bytes( header->page_policy ) ) );
+	}
+	case 4:
+		return true;  // Huge 块总是新映射 / Huge blocks are always fresh mappings
+	default:
+		break;	// slab 与 Small 块总在复用，memset 已是向量化清零 / Slab and Small blocks are always recycled, and memset is already a vectorised clear
+	}
+	std::memset( user_pointer, 0, bytes );
+	return true;
+}
+
+void* MemoryPool::allocate_aligned( std::size_t requested_bytes, std::size_t requested_alignment, bool nothrow )
+{
+	/* ── 1. alignment validation ───────────────────────────── */
+	if ( requested_alignment == 0 )
+	{
+		requested_alignment = DEFAULT_ALIGNMENT;
+	}
+	else if ( ( requested_alignment & 1 ) == 1 || !os_memory::memory_pool::is_power_of_two( requested_alignment ) )
+	{
+		if ( requested_alignment > MAX_ALLOWED_ALIGNMENT && !nothrow )
+			throw std::bad_alloc();	 //!< illegal alignment
+
+		requested_alignment = DEFAULT_ALIGNMENT;
+	}
+
+	if ( requested_alignment > MAX_ALLOWED_ALIGNMENT )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();	 //!< alignment beyond MAX_ALLOWED_ALIGNMENT
+		return nullptr;
+	}
+
+	/* ── 2. default alignment : tier path as is ────────────── */
+	if ( requested_alignment <= DEFAULT_ALIGNMENT )
+	{
+		return allocate_from_tiers( requested_bytes, nothrow );
+	}
+
+	/* ── 3. large alignment, slab sized : interior pointer of a slab object ── */
+	// slab 按对象序号释放，内部指针无需 AlignHeader / Slabs free by object index, so an interior pointer needs no AlignHeader
+	const std::size_t slab_alignment_padding_bytes = requested_alignment - DEFAULT_ALIGNMENT;
+	if ( slab_alignment_padding_bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES && requested_bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES - slab_alignment_padding_bytes )
+	{
+		void* const			 object_pointer = small_manager.allocate_slab_object( requested_bytes + slab_alignment_padding_bytes );
+		const std::uintptr_t object_address = reinterpret_cast<std::uintptr_t>( object_pointer );
+		return reinterpret_cast<void*>( ( object_address + requested_alignment - 1 ) & ~( static_cast<std::uintptr_t>( requested_alignment ) - 1 ) );
+	}
+
+	/* ── 4. large alignment : carve inside a tier block ────── */
+	// 内部用户指针至少 DEFAULT_ALIGNMENT 对齐，因此只需 (alignment - DEFAULT_ALIGNMENT) 的填充
+	// The inner user pointer is at least DEFAULT_ALIGNMENT aligned, so (alignment - DEFAULT_ALIGNMENT) padding suffices
+	const std::size_t extra_alignment_padding_bytes = ALIGN_HEADER_BYTES + requested_alignment - DEFAULT_ALIGNMENT;
+	if ( requested_bytes > std::numeric_limits<std::size_t>::max() - extra_alignment_padding_bytes - NOT_ALIGN_HEADER_BYTES )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return nullptr;
+	}
+	const std::size_t total_allocated_bytes = requested_bytes + extra_alignment_padding_bytes;
+
+	void* const inner_user_pointer = allocate_from_tiers( total_allocated_bytes, nothrow );
+	if ( !inner_user_pointer )
+		return nullptr;
+
+	const std::uintptr_t inner_address = reinterpret_cast<std::uintptr_t>( inner_user_pointer );
+	const std::uintptr_t aligned_address = ( inner_address + ALIGN_HEADER_BYTES + requested_alignment - 1 ) & ~( static_cast<std::uintptr_t>( requested_alignment ) - 1 );
+	void* const			 aligned_user_pointer = reinterpret_cast<void*>( aligned_address );
+
+	auto* align_header_pointer = reinterpret_cast<AlignHeader*>( aligned_address - ALIGN_HEADER_BYTES );
+	align_header_pointer->tag = ALIGN_SENTINEL;
+	align_header_pointer->raw = inner_user_pointer;
+	align_header_pointer->size = total_allocated_bytes;
+	return aligned_user_pointer;
+}
+
+void* MemoryPool::allocate_from_tiers( std::size_t requested_bytes, bool nothrow )
+{
+	if ( requested_bytes > std::numeric_limits<std::size_t>::max() - NOT_ALIGN_HEADER_BYTES )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return nullptr;
+	}
+	/* slab 桶：对象即用户指针，没有任何头部 / Slab buckets: the object is the user pointer, no header at all */
+	if ( requested_bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES )
+	{
+		return small_manager.allocate_slab_object( requested_bytes );
+	}
+
+	const std::size_t total_bytes_including_header = requested_bytes + NOT_ALIGN_HEADER_BYTES;
+
+	std::size_t			block_header_size_bytes = 0;
+	const std::uint32_t block_owner_type_identifier = tier_of( total_bytes_including_header );
+	void*				internal_data_region_pointer = nullptr;	 // → points to data()
+
+	switch ( block_owner_type_identifier )
+	{
+	case 1:
+		block_header_size_bytes = sizeof( SmallMemoryHeader );
+		internal_data_region_pointer = small_manager.allocate( total_bytes_including_header, DEFAULT_ALIGNMENT );
+		break;
+	case 2:
+		block_header_size_bytes = sizeof( MediumMemoryHeader );
+		internal_data_region_pointer = medium_manager.allocate( total_bytes_including_header, DEFAULT_ALIGNMENT );
+		break;
+	case 3:
+		block_header_size_bytes = sizeof( LargeMemoryHeader );
+		internal_data_region_pointer = large_manager.allocate( total_bytes_including_header, DEFAULT_ALIGNMENT );
+		break;
+	default:
+		block_header_size_bytes = sizeof( HugeMemoryHeader );
+		internal_data_region_pointer = huge_manager.allocate( total_bytes_including_header, DEFAULT_ALIGNMENT );
+		break;
+	}
+
+	if ( !internal_data_region_pointer )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return nullptr;
+	}
+
+	auto* unaligned_block_header = reinterpret_cast<NotAlignHeader*>( internal_data_region_pointer );
+	unaligned_block_header->owner_type = block_owner_type_identifier;
+	unaligned_block_header->owner_node = node_index;
+	unaligned_block_header->raw = static_cast<char*>( internal_data_region_pointer ) - block_header_size_bytes;
+
+	return static_cast<char*>( internal_data_region_pointer ) + NOT_ALIGN_HEADER_BYTES;
+}
+
+std::uint32_t MemoryPool::tier_of( std::size_t total_bytes_including_header )
+{
+	if ( total_bytes_including_header <= SMALL_BLOCK_MAX_SIZE )
+		return 1;
+	if ( total_bytes_including_header + sizeof( MediumMemoryHeader ) <= MEDIUM_BLOCK_MAX_SIZE )
+		return 2;
+	if ( total_bytes_including_header <= HUGE_BLOCK_THRESHOLD )
+		return 3;
+	return 4;
+}
+
+bool MemoryPool::routes_to_slab( std::size_t bytes, std::size_t alignment )
+{
+	if ( alignment <= DEFAULT_ALIGNMENT )
+		return bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES;
+	const std::size_t slab_alignment_padding_bytes = alignment - DEFAULT_ALIGNMENT;
+	return slab_alignment_padding_bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES && bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES - slab_alignment_padding_bytes;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MemoryPool::deallocate( void* user_pointer )
+{
+	if ( !user_pointer )
+		return;
+	HeapProfiler::instance().record_deallocation( user_pointer );
+
+	/* ── 1. slab object : classified by the page map, no header read ── */
+	if ( SmallSlabDescriptor* slab = SmallMemoryManager::find_slab( user_pointer ) )
+	{
+		slab->owner->deallocate_slab_object( slab, user_pointer );
+		return;
+	}
+
+	deallocate_headered( user_pointer );
+}
+
+MemoryPool::TierBlock MemoryPool::locate_block( const void* user_pointer ) noexcept
+{
+	const TierPageEntry	 entry = TierPageEntry::of( user_pointer );
+	const std::uintptr_t user_pointer_address = reinterpret_cast<std::uintptr_t>( user_pointer );
+
+	TierBlock block;
+	block.owner_node = entry.node();
+	switch ( entry.tier() )
+	{
+	case 1:
+	{
+		// chunk 内块长固定且 chunk 小于 4 GiB：一次 32 位除法取整到块首 / Blocks have a fixed stride and chunks stay below 4 GiB: one 32-bit division rounds down to the block start
+		const std::uint32_t block_bytes = static_cast<std::uint32_t>( sizeof( SmallMemoryHeader ) + SmallMemoryManager::BUCKET_SIZES[ entry.bucket_index() ] );
+		const std::uint32_t offset = static_cast<std::uint32_t>( user_pointer_address - reinterpret_cast<std::uintptr_t>( entry.base() ) );
+		block.header = entry.base() + std::size_t( offset / block_bytes ) * block_bytes;
+		block.inner_pointer = static_cast<char*>( block.header ) + sizeof( SmallMemoryHeader ) + NOT_ALIGN_HEADER_BYTES;
+		break;
+	}
+	case 2:
+	{
+		// 伙伴块按自身大小（至少 1 MiB）对齐，用户指针距块首不足 1 MiB / Buddy blocks are aligned to their own size (1 MiB at least) and user pointers sit less than 1 MiB past the block start
+		block.header = reinterpret_cast<void*>( user_pointer_address & ~( static_cast<std::uintptr_t>( MediumMemoryManager::MIN_BUCKET_BYTES_UNIT ) - 1 ) );
+		block.inner_pointer = static_cast<char*>( block.header ) + sizeof( MediumMemoryHeader ) + NOT_ALIGN_HEADER_BYTES;
+		break;
+	}
+	case 3:
+		block.header = entry.base();
+		block.inner_pointer = entry.base() + sizeof( LargeMemoryHeader ) + NOT_ALIGN_HEADER_BYTES;
+		break;
+	case 4:
+		block.header = entry.base();
+		block.inner_pointer = entry.base() + sizeof( HugeMemoryHeader ) + NOT_ALIGN_HEADER_BYTES;
+		break;
+	default:
+		return {};
+	}
+	block.owner_type = entry.tier();
+	return block;
+}
+
+void MemoryPool::deallocate_headered( void* user_pointer )
+{
+	/* ── 2. tier block : classified by the page map, no header read ── */
+	const TierBlock block = locate_block( user_pointer );
+	if ( block.owner_type == 0 )
+	{
+#if defined( _DEBUG )
+		throw os_memory::bad_dealloc( "deallocate: pointer not owned by the pool" );
+#endif
+		return;	 // 非池指针：其前方内存从未被读取，忽略即可 / Foreign pointer: nothing in front of it was read, so it is simply ignored
+	}
+
+#if defined( _DEBUG )
+	NotAlignHeader stacked_copy_of_unaligned_header {};
+	std::memcpy( &stacked_copy_of_unaligned_header, block.inner_pointer - NOT_ALIGN_HEADER_BYTES, sizeof( stacked_copy_of_unaligned_header ) );
+	if ( stacked_copy_of_unaligned_header.owner_type != block.owner_type || stacked_copy_of_unaligned_header.raw != block.header )
+		throw os_memory::bad_dealloc( "deallocate: page map and header disagree" );
+#endif
+
+	/* ── 3. hand the block back to its tier ────────────────── */
+	deallocate_block( block );
+}
+
+void MemoryPool::deallocate_block( const TierBlock& block )
+{
+	switch ( block.owner_type )
+	{
+	case 1:
+		small_manager.deallocate( static_cast<SmallMemoryHeader*>( block.header ) );
+		return;
+	case 2:
+		medium_manager.deallocate( static_cast<MediumMemoryHeader*>( block.header ) );
+		return;
+	case 3:
+		large_manager.deallocate( static_cast<LargeMemoryHeader*>( block.header ) );
+		return;
+	default:
+		huge_manager.deallocate( static_cast<HugeMemoryHeader*>( block.header ) );
+		return;
 	}
-	if ( !chunk_base )
+}
+
+
+void MemoryPool::deallocate( void* user_pointer, std::size_t bytes, std::size_t alignment )
+{
+	if ( !user_pointer )
 		return;
+	HeapProfiler::instance().record_deallocation( user_pointer );
+	if ( alignment == 0 || ( alignment & ( alignment - 1 ) ) != 0 )
+		alignment = DEFAULT_ALIGNMENT;
 
-	/* 尝试合并伙伴 / Try to merge buddy */
-	while ( order < LEVEL_COUNT - 1 )
+	/* ── 1. slab object : the size alone says so, no page-map lookup ── */
+	if ( routes_to_slab( bytes, alignment ) )
 	{
-		// 计算当前块在chunk中的偏移量 / Calculate block's offset within the chunk
-		std::uintptr_t offset = reinterpret_cast<char*>( block ) - static_cast<char*>( chunk_base );
-		
-		// 使用XOR计算伙伴块的偏移量 / Calculate buddy's offset using XOR trick
-		std::uintptr_t buddy_offset = offset ^ ( size_from_order( order ) );
+#if defined( _DEBUG )
+		if ( !SmallMemoryManager::find_slab( user_pointer ) )
+			throw os_memory::bad_dealloc( "deallocate: size does not match a slab object" );
+#endif
+		SmallSlabDescriptor* slab = SmallSlabDescriptor::from_pointer( user_pointer );
+		slab->owner->deallocate_slab_object( slab, user_pointer );
+		return;
+	}
 
-		// 检查伙伴块是否超出chunk边界 / Check if buddy exceeds chunk boundary
-		if ( buddy_offset + size_from_order( order ) > chunk_bytes )
-			break;	// buddy 超出 chunk / Buddy exceeds chunk size
+	/* ── 2. default alignment : tier header at a fixed offset ── */
+	if ( alignment <= DEFAULT_ALIGNMENT )
+	{
+		deallocate_to_tiers( user_pointer, bytes );
+		return;
+	}
 
-		// 获取伙伴块头部指针 / Get buddy block header pointer
-		auto* buddy = reinterpret_cast<MediumMemoryHeader*>( static_cast<char*>( chunk_base ) + buddy_offset );
+	/* ── 3. large alignment : the padding is unknown, so locate through the page map ── */
+#if defined( _DEBUG )
+	auto* align_header_pointer = reinterpret_cast<AlignHeader*>( reinterpret_cast<std::uintptr_t>( user_pointer ) - ALIGN_HEADER_BYTES );
+	if ( align_header_pointer->tag != ALIGN_SENTINEL )
+		throw os_memory::bad_dealloc( "deallocate: alignment does not match the allocation" );
+	align_header_pointer->tag = 0;	// 块被复用后不留旧哨兵 / No stale sentinel once the block is recycled
+#endif
+	deallocate_headered( user_pointer );
+}
 
-		// 使用原子操作检查buddy状态 / Use atomic operation to check buddy state
-		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( order ) )
+void MemoryPool::deallocate_to_tiers( void* inner_pointer, std::size_t bytes )
+{
+	char* const			data_region_pointer = static_cast<char*>( inner_pointer ) - NOT_ALIGN_HEADER_BYTES;
+	const std::uint32_t owner_type = tier_of( bytes + NOT_ALIGN_HEADER_BYTES );
+
+#if defined( _DEBUG )
+	NotAlignHeader stacked_copy_of_unaligned_header {};
+	std::memcpy( &stacked_copy_of_unaligned_header, data_region_pointer, sizeof( stacked_copy_of_unaligned_header ) );
+	if ( stacked_copy_of_unaligned_header.owner_type != owner_type )
+		throw os_memory::bad_dealloc( "deallocate: size does not match the owning tier" );
+#endif
+
+	switch ( owner_type )
+	{
+	case 1:
+		small_manager.deallocate( reinterpret_cast<SmallMemoryHeader*>( data_region_pointer - sizeof( SmallMemoryHeader ) ) );
+		return;
+	case 2:
+		medium_manager.deallocate( reinterpret_cast<MediumMemoryHeader*>( data_region_pointer - sizeof( MediumMemoryHeader ) ) );
+		return;
+	case 3:
+		large_manager.deallocate( reinterpret_cast<LargeMemoryHeader*>( data_region_pointer - sizeof( LargeMemoryHeader ) ) );
+		return;
+	default:
+		huge_manager.deallocate( reinterpret_cast<HugeMemoryHeader*>( data_region_pointer - sizeof( HugeMemoryHeader ) ) );
+		return;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t MemoryPool::allocate_batch( std::size_t bytes, std::size_t count, void** out, bool nothrow )
+{
+	if ( count == 0 )
+		return 0;
+
+	const std::size_t total_bytes = bytes <= std::numeric_limits<std::size_t>::max() / count ? bytes * count : std::numeric_limits<std::size_t>::max();
+	if ( crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), total_bytes, pressure_threshold_bytes.load( std::memory_order_relaxed ) ) &&
+		 !admit_under_pressure( total_bytes, nothrow ) )
+	{
+		std::fill( out, out + count, nullptr );
+		return 0;
+	}
+
+	try
+	{
+		if ( bytes <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES )
 		{
-			break;
+			small_manager.allocate_slab_batch( bytes, count, out );
 		}
+		else if ( bytes <= SMALL_BLOCK_MAX_SIZE - NOT_ALIGN_HEADER_BYTES )
+		{
+			small_manager.allocate_batch( bytes + NOT_ALIGN_HEADER_BYTES, count, out );
 
-		/* 尝试原子性地移除buddy / Try to atomically remove buddy */
-		if ( !try_remove_from_freelist( buddy, order ) )
+			/* 一个紧凑循环写完全部 NotAlignHeader / Write every NotAlignHeader in one tight loop */
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				char* const data_region_pointer = static_cast<char*>( out[ i ] );
+				auto*		unaligned_block_header = reinterpret_cast<NotAlignHeader*>( data_region_pointer );
+				unaligned_block_header->owner_type = 1;
+				unaligned_block_header->owner_node = node_index;
+				unaligned_block_header->raw = data_region_pointer - sizeof( SmallMemoryHeader );
+				out[ i ] = data_region_pointer + NOT_ALIGN_HEADER_BYTES;
+			}
+		}
+		else
 		{
-			break;
+			/* Medium 及以上每块本就要一次层内分配 / Medium and above cost one tier allocation per block anyway */
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				try
+				{
+					out[ i ] = allocate_from_tiers( bytes, false );
+				}
+				catch ( ... )
+				{
+					deallocate_batch( out, i );
+					throw;
+				}
+			}
 		}
+	}
+	catch ( const std::bad_alloc& )
+	{
+		if ( !nothrow )
+			throw;
+		std::fill( out, out + count, nullptr );
+		return 0;
+	}
 
-		/* 再次确认buddy状态 / Recheck buddy state */
-		if ( !buddy->is_free.load( std::memory_order_acquire ) || buddy->block_size != size_from_order( order ) )
+	HeapProfiler& profiler = HeapProfiler::instance();
+	if ( profiler.is_running() )
+	{
+		for ( std::size_t i = 0; i < count; ++i )
+			profiler.record_allocation( out[ i ], bytes );
+	}
+	os_memory::memory_pool::SizeHistogramRecorder::instance().record( bytes, count );
+	return count;
+}
+
+void MemoryPool::deallocate_batch( void* const* pointers, std::size_t count )
+{
+	HeapProfiler& profiler = HeapProfiler::instance();
+	if ( profiler.has_live_samples() )
+	{
+		for ( std::size_t i = 0; i < count; ++i )
+			profiler.record_deallocation( pointers[ i ] );
+	}
+
+	std::size_t i = 0;
+	while ( i < count )
+	{
+		/* 连续的 slab 对象成段交给 Small 层 / Consecutive slab objects go to the Small tier as one run */
+		std::size_t run_end = i;
+		while ( run_end < count && pointers[ run_end ] && SmallMemoryManager::find_slab( pointers[ run_end ] ) )
+			++run_end;
+		if ( run_end != i )
 		{
-			// 放回freelist / Put back to freelist
-			push_block( buddy, order );
-			break;
+			small_manager.deallocate_slab_batch( pointers + i, run_end - i );
+			i = run_end;
+			continue;
 		}
 
-		/* 合并 - 取较小地址为新块首 / Merge - take the smaller address as the new block's start */
-		block = ( offset < buddy_offset ) ? block : buddy;
-		block->block_size = size_from_order( order ) << 1;	// 合并后的块大小 / Merged block size
-		order++;
+		if ( pointers[ i ] )
+			deallocate_headered( pointers[ i ] );
+		++i;
 	}
+}
 
-	// 将合并后的块放回空闲列表 / Push the merged block back to the free list
-	push_block( block, order );
+/* -------------------------------------------------------------------------- */
+
+/// @brief slab 所属管理器的节点号，未绑定为 0 / Node number of a slab's manager, 0 when unbound
+static std::size_t slab_node( const SmallSlabDescriptor* slab )
+{
+	const std::size_t numa_node = slab->owner->numa_node;
+	return numa_node == os_memory::ANY_NUMA_NODE ? 0 : numa_node;
 }
 
-/*──────────────── try_remove_from_freelist ────────────────*/
-bool MediumMemoryManager::try_remove_from_freelist( MediumMemoryHeader* header, int order )
+std::size_t MemoryPool::node_of( void* user_pointer )
 {
-	auto&	   list = free_lists[ order ];	// 获取对应级别的空闲链表 / Get the corresponding free list for the order
-	PointerTag head = list.head.load( std::memory_order_acquire );
+	if ( SmallSlabDescriptor* slab = SmallMemoryManager::find_slab( user_pointer ) )
+		return slab_node( slab );
+	return TierPageEntry::of( user_pointer ).node();
+}
 
-	while ( true )
+std::size_t MemoryPool::node_of( void* user_pointer, std::size_t bytes, std::size_t alignment )
+{
+	if ( alignment == 0 || ( alignment & ( alignment - 1 ) ) != 0 )
+		alignment = DEFAULT_ALIGNMENT;
+	if ( routes_to_slab( bytes, alignment ) )
+		return slab_node( SmallSlabDescriptor::from_pointer( user_pointer ) );
+	return TierPageEntry::of( user_pointer ).node();
+}
+
+bool MemoryPool::owns( const void* pointer ) noexcept
+{
+	return AddressPageMap::instance().find( pointer ) != nullptr || TierPageEntry::of( pointer ).tier() != 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t MemoryPool::usable_size( void* user_pointer )
+{
+	if ( !user_pointer )
+		return 0;
+
+	/* slab 对象：对象尾减去内部偏移 / Slab object: the object's end minus the interior offset */
+	if ( SmallSlabDescriptor* slab = SmallMemoryManager::find_slab( user_pointer ) )
 	{
-		if ( head.pointer == header )
-		{
-			// =====================================================
-			// 场景1: 目标块是链表头节点 / Scenario 1: Target is the head
-			// =====================================================
+		const char* object = static_cast<const char*>( slab->block_at( slab->block_index_of( user_pointer ) ) );
+		return slab->block_size - static_cast<std::size_t>( static_cast<const char*>( user_pointer ) - object );
+	}
 
-			PointerTag next { header->next, head.tag + 1 };
+	const TierBlock block = locate_block( user_pointer );
 
-			// 尝试原子性地替换链表头 / Attempt atomic head replacement
-			/*
-			 * 使用CAS解决ABA问题：
-			 * - 比较当前head和之前加载的head
-			 * - 如果相同，替换为new_head
-			 * - 如果不同，重试
-			 * 
-			 * CAS solves ABA problem:
-			 * - Compare current head with previously loaded head
-			 * - If same, replace with new_head
-			 * - If different, retry
-			 */
-			if ( list.head.compare_exchange_weak( head, { header, head.tag + 1 }, std::memory_order_acq_rel, std::memory_order_acquire ) )
+	std::size_t block_bytes = 0;  // 块头之后的字节数 / Bytes after the tier header
+	switch ( block.owner_type )
+	{
+	case 1:
+		block_bytes = static_cast<SmallMemoryHeader*>( block.header )->block_size;
+		break;
+	case 2:
+		block_bytes = static_cast<MediumMemoryHeader*>( block.header )->block_size - sizeof( MediumMemoryHeader );
+		break;
+	case 3:
+		block_bytes = static_cast<LargeMemoryHeader*>( block.header )->mapping_bytes - sizeof( LargeMemoryHeader );
+		break;
+	case 4:
+		block_bytes = static_cast<HugeMemoryHeader*>( block.header )->mapping_bytes - sizeof( HugeMemoryHeader );
+		break;
+	default:
+		return 0;
+	}
+	return block_bytes - NOT_ALIGN_HEADER_BYTES - static_cast<std::size_t>( static_cast<const char*>( user_pointer ) - block.inner_pointer );
+}
+
+void* MemoryPool::resize_in_tier( const TierBlock& block, std::size_t bytes, bool may_move )
+{
+	if ( bytes > std::numeric_limits<std::size_t>::max() - NOT_ALIGN_HEADER_BYTES - sizeof( MediumMemoryHeader ) )
+		return nullptr;
+	const std::size_t total_bytes_including_header = bytes + NOT_ALIGN_HEADER_BYTES;
+
+	// 原地结果必须仍在新尺寸对应的层级，带尺寸的 deallocate 才能直接定位块头；跨层时复制
+	// An in-place result must stay in the tier the new size maps to so sized deallocate can locate its header; crossing tiers copies
+	const std::uint32_t target_tier = tier_of( total_bytes_including_header );
+	switch ( block.owner_type )
+	{
+	case 1:
+	{
+		auto* header = static_cast<SmallMemoryHeader*>( block.header );
+		if ( bytes > SmallMemoryManager::SLAB_MAX_BLOCK_BYTES && target_tier == 1 &&
+			 SmallMemoryManager::calculate_bucket_index( total_bytes_including_header ) == header->bucket_index )
+			return block.inner_pointer;
+		return nullptr;
+	}
+	case 2:
+	{
+		auto* header = static_cast<MediumMemoryHeader*>( block.header );
+		if ( target_tier == 2 && medium_manager.resize( header, total_bytes_including_header ) )
+			return block.inner_pointer;
+		return nullptr;
+	}
+	case 3:
+	{
+		if ( !may_move || target_tier != 3 )
+			return nullptr;
+		LargeMemoryHeader* header = large_manager.resize( static_cast<LargeMemoryHeader*>( block.header ), total_bytes_including_header );
+		if ( !header )
+			return nullptr;
+		static_cast<NotAlignHeader*>( header->data() )->raw = header;  // 映射可能已移动 / The mapping may have moved
+		return static_cast<char*>( header->data() ) + NOT_ALIGN_HEADER_BYTES;
+	}
+	case 4:
+	{
+		if ( !may_move || target_tier != 4 )
+			return nullptr;
+		HugeMemoryHeader* header = huge_manager.resize( static_cast<HugeMemoryHeader*>( block.header ), total_bytes_including_header );
+		if ( !header )
+			return nullptr;
+		static_cast<NotAlignHeader*>( header->data() )->raw = header;
+		return static_cast<char*>( header->data() ) + NOT_ALIGN_HEADER_BYTES;
+	}
+	default:
+		return nullptr;
+	}
+}
+
+void* MemoryPool::reallocate( void* pointer, std::size_t bytes, std::size_t alignment, bool nothrow )
+{
+	if ( !pointer )
+		return allocate( bytes, alignment, nullptr, 0, nothrow );
+	if ( bytes == 0 )
+	{
+		deallocate( pointer );
+		return nullptr;
+	}
+	if ( alignment == 0 || ( alignment & ( alignment - 1 ) ) != 0 )
+		alignment = DEFAULT_ALIGNMENT;
+
+	const std::uintptr_t address = reinterpret_cast<std::uintptr_t>( pointer );
+	const std::size_t	 old_bytes = usable_size( pointer );
+
+	// 增长与新分配一样受上限约束：mremap 与搬迁都会映射新的页 / Growth obeys the limits like a fresh allocation: mremap and moving both map new pages
+	if ( bytes > old_bytes && crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), bytes - old_bytes, pressure_threshold_bytes.load( std::memory_order_relaxed ) ) &&
+		 !admit_under_pressure( bytes - old_bytes, nothrow ) )
+		return nullptr;
+
+	/* ── 1. 原地：对齐仍满足时尝试留在当前块 / In place: try to keep the current block while its alignment still holds ── */
+	if ( ( address & ( alignment - 1 ) ) == 0 )
+	{
+		if ( SmallSlabDescriptor* slab = SmallMemoryManager::find_slab( pointer ) )
+		{
+			const std::size_t interior_offset = slab->block_size - old_bytes;
+			if ( bytes <= old_bytes && routes_to_slab( bytes, alignment ) && SmallMemoryManager::calculate_bucket_index( bytes + interior_offset ) == slab->bucket_index )
 			{
-				return true;  // 成功移除 / Successfully removed
+				HeapProfiler::instance().record_reallocation( pointer, pointer, bytes );
+				return pointer;
 			}
 		}
 		else
 		{
-			// =====================================================
-			// 场景2: 目标块在链表中间 / Scenario 2: Target is in list middle
-			// =====================================================
+			// 超对齐指针位于内部指针之后，默认对齐时二者重合 / An over-aligned pointer lies past the inner pointer; with the default alignment they coincide
+			const TierBlock	  block = locate_block( pointer );
+			const std::size_t offset = static_cast<std::size_t>( address - reinterpret_cast<std::uintptr_t>( block.inner_pointer ) );
+			const bool		  has_align_header = offset != 0;
 
-			// 遍历链表查找 / Traverse the list to find
-			MediumMemoryHeader* current = head.pointer;
-			while ( current )
+			// 块的形态须与 (bytes, alignment) 的分配路径一致 / The block's shape must match the path allocate(bytes, alignment) would take
+			if ( block.owner_type != 0 && has_align_header == ( alignment > DEFAULT_ALIGNMENT ) && !routes_to_slab( bytes, alignment ) && bytes <= std::numeric_limits<std::size_t>::max() - offset )
 			{
-				if ( current == header )
+				// mremap 只保证页内偏移不变，超过页的对齐不能让映射移动 / mremap only preserves the offset within a page, so larger alignments must not move
+				if ( char* resized = static_cast<char*>( resize_in_tier( block, bytes + offset, alignment <= 0x1000 ) ) )
 				{
-					PointerTag new_head { head.pointer, head.tag + 1 };
-
-					// 尝试原子性地更新链表头 / Attempt atomic head update
-					/*
-					 * 为什么更新链表头？ 
-					 * 在无锁链表中，中间节点移除非常复杂。这里使用简化策略：
-					 * 通过修改链表头标签强制其他线程重试，间接使目标块"失效"
-					 * 
-					 * Why update list head?
-					 * Removing middle nodes in lock-free lists is complex.
-					 * Simplified strategy: Force other threads to retry by
-					 * changing head tag, indirectly "invalidating" target
-					 */
-					if ( list.head.compare_exchange_weak( head, new_head, std::memory_order_acq_rel, std::memory_order_acquire ) )
+					if ( has_align_header )
 					{
-						return true;  // 成功移除 / Successfully removed
+						auto* align_header_pointer = reinterpret_cast<AlignHeader*>( resized + offset - ALIGN_HEADER_BYTES );
+						align_header_pointer->raw = resized;
+						align_header_pointer->size = bytes + offset;
 					}
-					break;
+					HeapProfiler::instance().record_reallocation( pointer, resized + offset, bytes );
+					return resized + offset;
 				}
-				current = current->next;
 			}
-			return false;  // 没找到 / Not found
 		}
 	}
+
+	/* ── 2. 搬迁：分配、复制、释放 / Move: allocate, copy, free ── */
+	void* fresh_pointer = allocate( bytes, alignment, nullptr, 0, nothrow );
+	if ( !fresh_pointer )
+		return nullptr;
+	std::memcpy( fresh_pointer, pointer, std::min( old_bytes, bytes ) );
+	deallocate( pointer );
+	return fresh_pointer;
 }
 
-MediumMemoryHeader* MediumMemoryManager::split_to_order( MediumMemoryHeader* block, int from_order, int to_order )
+void MemoryPool::flush_current_thread_cache()
 {
-	// 确保目标order在有效范围内
-	if ( to_order < 0 || to_order >= LEVEL_COUNT || to_order > from_order )
+	small_manager.flush_thread_local_cache();  // 刷新线程本地缓存 / Flush thread-local cache
+}
+
+std::size_t MemoryPool::purge( std::chrono::nanoseconds idle_period )
+{
+	const std::uint32_t scan = purge_scan_counter.fetch_add( 1, std::memory_order_relaxed ) + 1;
+	const std::uint64_t now = steady_now_nanoseconds();
+	const std::uint64_t idle = static_cast<std::uint64_t>( idle_period.count() );
+
+	return small_manager.purge( now, idle, scan ) + medium_manager.purge( now, idle, scan ) + large_manager.purge( now, idle );
+}
+
+std::size_t MemoryPool::trim()
+{
+	flush_current_thread_cache();
+	return purge( std::chrono::nanoseconds::zero() );
+}
+
+namespace
+{
+	constexpr std::size_t PREFAULT_STRIDE_BYTES = 4096;	 //!< 最小页大小；巨页上只是多写几次 / Smallest page size; on huge pages it merely writes a few extra times
+
+	/// @brief 逐页写入一次以触发缺页 / Write once per page to take the page faults now
+	void prefault_pages( void* pointer, std::size_t bytes )
 	{
-		return block;
+		volatile char* const bytes_pointer = static_cast<char*>( pointer );
+		for ( std::size_t offset = 0; offset < bytes; offset += PREFAULT_STRIDE_BYTES )
+			bytes_pointer[ offset ] = 0;
+		bytes_pointer[ bytes - 1 ] = 0;
+	}
+}  // namespace
+
+std::size_t MemoryPool::reserve( const ReserveProfile& profile )
+{
+	std::vector<void*> blocks;
+	std::size_t		   reserved_blocks = 0;
+
+	/* 同时持有一类的全部块，再一起释放 / Hold every block of one class at once, then free them together */
+	auto reserve_class = [ & ]( std::size_t user_bytes, std::size_t count ) {
+		if ( count == 0 )
+			return;
+		blocks.resize( count );
+		allocate_batch( user_bytes, count, blocks.data() );	 // 失败时抛出且不保留任何块 / Throws on failure and keeps no block
+		if ( profile.prefault )
+		{
+			for ( void* block : blocks )
+				prefault_pages( block, user_bytes );
+		}
+		deallocate_batch( blocks.data(), count );
+		reserved_blocks += count;
+	};
+
+	for ( std::size_t i = 0; i < SmallMemoryManager::SLAB_BUCKET_COUNT; ++i )
+		reserve_class( SmallMemoryManager::BUCKET_SIZES[ i ], profile.slab_blocks[ i ] );
+	for ( std::size_t i = SmallMemoryManager::SLAB_BUCKET_COUNT; i < SmallMemoryManager::BUCKET_COUNT; ++i )
+		reserve_class( SmallMemoryManager::BUCKET_SIZES[ i ] - NOT_ALIGN_HEADER_BYTES, profile.small_blocks[ i ] );
+	for ( std::size_t order = 1; order < MediumMemoryManager::LEVEL_COUNT; ++order )
+	{
+		const std::size_t block_bytes = MediumMemoryManager::MIN_BUCKET_BYTES_UNIT << order;
+		if ( block_bytes > MEDIUM_BLOCK_MAX_SIZE )
+			break;	// 更高阶在本策略下落入 Large 层 / Higher orders belong to the Large tier under this policy
+		reserve_class( block_bytes - sizeof( MediumMemoryHeader ) - NOT_ALIGN_HEADER_BYTES, profile.medium_blocks[ order ] );
+	}
+
+	if ( !profile.fill_thread_cache )
+		flush_current_thread_cache();
+	return reserved_blocks;
+}
+
+void MemoryPool::set_memory_limit( std::size_t soft_limit, std::size_t hard_limit )
+{
+	std::lock_guard<std::mutex> lock( pressure_mutex );
+	soft_limit_bytes.store( soft_limit, std::memory_order_relaxed );
+	hard_limit_bytes.store( hard_limit, std::memory_order_relaxed );
+
+	// 新上限在下一次分配时生效，即便当前已超过软上限 / A new limit takes effect at the next allocation, even when usage is already above the soft limit
+	constexpr std::uint64_t unlimited = ~std::uint64_t( 0 );
+	pressure_threshold_bytes.store( std::min<std::uint64_t>( soft_limit ? soft_limit : unlimited, hard_limit ? hard_limit : unlimited ), std::memory_order_relaxed );
+}
+
+bool MemoryPool::add_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+{
+	std::lock_guard<std::mutex> lock( pressure_callback_mutex );
+	for ( auto& entry : pressure_callbacks )
+	{
+		if ( !entry.first )
+		{
+			entry = { callback, context };
+			return true;
+		}
+	}
+	return false;
+}
+
+void MemoryPool::remove_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+{
+	std::lock_guard<std::mutex> lock( pressure_callback_mutex );
+	for ( auto& entry : pressure_callbacks )
+	{
+		if ( entry.first == callback && entry.second == context )
+			entry = {};
+	}
+}
+
+std::size_t MemoryPool::relieve_memory_pressure()
+{
+	std::lock_guard<std::mutex> lock( pressure_mutex );
+	const std::size_t			released_bytes = reclaim_memory( 0, 0, false );	 // 目标 0：每一步都执行 / Target 0: every step runs
+	rearm_pressure_threshold();
+	return released_bytes;
+}
+
+void MemoryPool::rearm_pressure_threshold()
+{
+	constexpr std::uint64_t unlimited = ~std::uint64_t( 0 );
+	const std::uint64_t		soft_limit = soft_limit_bytes.load( std::memory_order_relaxed );
+	const std::uint64_t		hard_limit = hard_limit_bytes.load( std::memory_order_relaxed );
+	const std::uint64_t		used_bytes = mapping_account.mapped_bytes.load( std::memory_order_relaxed );
+
+	std::uint64_t threshold = unlimited;
+	if ( soft_limit != 0 )
+	{
+		// 已在软上限之上：再增长 soft / PRESSURE_REARM_FRACTION 才重新回收 / Already above the soft limit: wait for soft / PRESSURE_REARM_FRACTION more growth
+		const std::uint64_t step = std::max<std::uint64_t>( soft_limit / PRESSURE_REARM_FRACTION, 1 );
+		threshold = used_bytes < soft_limit ? soft_limit : ( used_bytes > unlimited - step ? unlimited : used_bytes + step );
+	}
+	if ( hard_limit != 0 )
+		threshold = std::min( threshold, hard_limit );
+	pressure_threshold_bytes.store( threshold, std::memory_order_relaxed );
+}
+
+bool MemoryPool::admit_under_pressure( std::size_t bytes, bool nothrow )
+{
+	// 回调里的分配直接放行，不嵌套回收 / Allocations made by the callbacks go ahead without a nested pass
+	static thread_local bool inside_pressure_pass = false;
+	if ( inside_pressure_pass )
+		return true;
+
+	const std::uint64_t hard_limit = hard_limit_bytes.load( std::memory_order_relaxed );
+	const bool			hard = hard_limit != 0 && crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), bytes, hard_limit );
+
+	// 软压力：已有线程在回收就不等待；硬压力：等它做完再自己判断 / Soft pressure: skip if another thread is reclaiming; hard pressure: wait for it, then judge again
+	std::unique_lock<std::mutex> lock( pressure_mutex, std::defer_lock );
+	if ( hard )
+		lock.lock();
+	else if ( !lock.try_lock() )
+		return true;
+
+	const std::uint64_t soft_limit = soft_limit_bytes.load( std::memory_order_relaxed );
+	const std::uint64_t used_bytes = mapping_account.mapped_bytes.load( std::memory_order_relaxed );
+	const bool			over_hard = hard_limit != 0 && crosses_limit( used_bytes, bytes, hard_limit );
+	if ( over_hard || crosses_limit( used_bytes, bytes, pressure_threshold_bytes.load( std::memory_order_relaxed ) ) )
+	{
+		struct PassScope
+		{
+			PassScope()
+			{
+				inside_pressure_pass = true;
+			}
+			~PassScope()
+			{
+				inside_pressure_pass = false;
+			}
+		} pass_scope;
+		// 回收到较低的那个上限之下 / Reclaim down to whichever limit is lower
+		const std::uint64_t target_bytes = soft_limit == 0 ? hard_limit : ( hard_limit == 0 ? soft_limit : std::min( soft_limit, hard_limit ) );
+		reclaim_memory( bytes, target_bytes, over_hard );
+		rearm_pressure_threshold();
+	}
+
+	if ( hard_limit != 0 && crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), bytes, hard_limit ) )
+	{
+		if ( !nothrow )
+			throw std::bad_alloc();
+		return false;
+	}
+	return true;
+}
+
+std::size_t MemoryPool::reclaim_memory( std::size_t bytes, std::uint64_t target_bytes, bool hard )
+{
+	auto relieved = [ & ]() {
+		return !crosses_limit( mapping_account.mapped_bytes.load( std::memory_order_relaxed ), bytes, target_bytes );
+	};
+
+	/* 1) 本线程缓存回到全局栈，排队的伙伴合并完成 / This thread's cache goes back to the global stacks and queued buddy merges complete */
+	flush_current_thread_cache();
+	medium_manager.drain_merge_queue();
+
+	/* 2) 丢弃 Large 映射缓存 / Drop the Large mapping cache */
+	std::size_t released_bytes = large_manager.purge( steady_now_nanoseconds(), 0 );
+	if ( relieved() )
+		return released_bytes;
+
+	/* 3) 归还全空 chunk、空闲 slab 与 Medium 空闲页 / Return fully free chunks, idle slabs and free Medium pages */
+	released_bytes += purge( std::chrono::nanoseconds::zero() );
+	if ( relieved() )
+		return released_bytes;
+
+	/* 4) 压力回调：应用收缩自身缓存，随后再归还一次 / Pressure callbacks: the application shrinks its caches, then one more return */
+	std::array<std::pair<MemoryPressureCallback, void*>, MAX_PRESSURE_CALLBACKS> callbacks;
+	{
+		std::lock_guard<std::mutex> lock( pressure_callback_mutex );
+		callbacks = pressure_callbacks;	 // 复制后在锁外调用，回调可以增删回调 / Called on a copy outside the lock, so callbacks may add or remove callbacks
+	}
+	MemoryPressureEvent event;
+	event.used_bytes = static_cast<std::size_t>( mapping_account.mapped_bytes.load( std::memory_order_relaxed ) );
+	event.requested_bytes = bytes;
+	event.soft_limit_bytes = static_cast<std::size_t>( soft_limit_bytes.load( std::memory_order_relaxed ) );
+	event.hard_limit_bytes = static_cast<std::size_t>( hard_limit_bytes.load( std::memory_order_relaxed ) );
+	event.hard = hard;
+	bool any_callback = false;
+	for ( const auto& [ callback, context ] : callbacks )
+	{
+		if ( callback )
+		{
+			callback( event, context );
+			any_callback = true;
+		}
 	}
-
-	for ( int current_order = from_order - 1; current_order >= to_order; --current_order )
+	if ( any_callback )
 	{
-		std::size_t half = size_from_order( current_order );				  // 计算每个块的一半 / Calculate half of the block size
-		char*		right_pointer = reinterpret_cast<char*>( block ) + half;  // 获取右侧块的位置 / Get the position of the right block
-
-		auto* right_header = reinterpret_cast<MediumMemoryHeader*>( right_pointer );  // 获取右侧块的头部 / Get the header of the right block
-		right_header->block_size = half;											  // 设置右侧块的大小 / Set the size of the right block
-		right_header->is_free.store( true, std::memory_order_relaxed );				  // 标记为可用 / Mark as free
-		right_header->magic = MediumMemoryHeader::MAGIC;							  // 设置魔法值 / Set magic value
-		right_header->next = nullptr;												  // 设置下一块为空 / Set next to null
-
-		push_block( right_header, current_order );	// 将右侧块推入空闲链表 / Push the right block into the free list
-		block->block_size = half;					// 更新原块的大小 / Update the original block's size
+		flush_current_thread_cache();
+		released_bytes += purge( std::chrono::nanoseconds::zero() );
 	}
-	return block;  // 返回原块 / Return the original block
+	return released_bytes;
 }
 
-MediumMemoryHeader* MediumMemoryManager::request_new_chunk( int min_order, std::size_t alignment = sizeof( std::max_align_t ) )
+void MemoryPool::set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval )
 {
-	std::lock_guard<std::mutex> this_lock_guard( chunk_mutex );	 // 加锁保护 / Lock protection
+	stop_purge_thread();
+	if ( interval.count() <= 0 )
+		return;
 
-	// 计算需要的内存块大小 / Calculate the required chunk size
-	const std::size_t chunk_bytes = size_from_order( min_order );							 // 使用 min_order 来计算内存块大小 / Use min_order to calculate the chunk size
-	void*			  chunk_memory = os_memory::allocate_tracked( chunk_bytes, alignment );	 // 向操作系统请求内存 / Request memory from the OS
-	if ( !chunk_memory )
-		return nullptr;	 // 申请失败，返回空指针 / Return null if allocation fails
+	purge_stop = false;
+	purge_thread = std::thread( [ this, idle_period, interval ]() {
+		enter_worker_thread();
+		std::unique_lock<std::mutex> lock( purge_mutex );
+		while ( !purge_condition.wait_for( lock, interval, [ this ]() { return purge_stop; } ) )
+		{
+			lock.unlock();
+			purge( idle_period );
+			lock.lock();
+		}
+	} );
+}
 
-	allocated_chunks.emplace_back( chunk_memory, chunk_bytes );	 // 记录已分配的 chunk / Record the allocated chunk
+void MemoryPool::stop_purge_thread()
+{
+	{
+		std::lock_guard<std::mutex> lock( purge_mutex );
+		purge_stop = true;
+	}
+	purge_condition.notify_all();
+	if ( purge_thread.joinable() )
+		purge_thread.join();
+}
 
-	// 整个 chunk 作为一个大块先放进最高层，再让 allocate 重新拿 / Place the entire chunk into the highest level first, then let allocate reuse it
-	auto* header = static_cast<MediumMemoryHeader*>( chunk_memory );
-	header->block_size = chunk_bytes;						   // 设置块大小 / Set the chunk size
-	header->is_free.store( true, std::memory_order_relaxed );  // 标记为可用 / Mark as free
-	header->magic = MediumMemoryHeader::MAGIC;				   // 设置魔法值 / Set magic value
-	header->next = nullptr;									   // 设置下一块为空 / Set next to null
+void MemoryPool::set_medium_merge_policy( MediumMemoryManager::MergePolicy policy )
+{
+	medium_manager.set_merge_policy( policy );
+}
 
-	return header;
+void MemoryPool::set_large_cache_policy( std::size_t budget_bytes, std::chrono::milliseconds decay )
+{
+	large_manager.set_cache_policy( budget_bytes, static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( decay ).count() ) );
 }
 
-/*──────────────── release_resources ────────────────*/
-void MediumMemoryManager::release_resources()
+void MemoryPool::set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy )
 {
-	/* 清空 freelist / Clear the freelist */
-	for ( auto& free_list : free_lists )
-	{
-		free_list.head.store( { nullptr, 0 }, std::memory_order_relaxed );	// 设置空头指针 / Set head pointer to null
-	}
+	medium_manager.page_policy.store( medium_policy, std::memory_order_relaxed );
+	large_manager.page_policy.store( large_policy, std::memory_order_relaxed );
+	huge_manager.page_policy.store( huge_policy, std::memory_order_relaxed );
+}
 
-	for ( auto& [ pointer, size ] : allocated_chunks )
-		os_memory::deallocate_tracked( pointer, size );	 // 释放内存 / Deallocate memory
-	allocated_chunks.clear();							 // 清空已分配块 / Clear the allocated chunks
+MemoryPoolStatistics MemoryPool::statistics()
+{
+	MemoryPoolStatistics snapshot;
+	small_manager.collect_statistics( snapshot );
+	medium_manager.collect_statistics( snapshot );
+	large_manager.collect_statistics( snapshot );
+	huge_manager.collect_statistics( snapshot );
+	snapshot.pool_mapped_bytes = mapping_account.mapped_bytes.load( std::memory_order_relaxed );
+	snapshot.os_mapped_bytes = os_memory::used_memory_bytes_counter.load( std::memory_order_relaxed );
+	snapshot.os_net_operations = os_memory::user_operation_counter.load( std::memory_order_relaxed );
+	return snapshot;
 }
 
 /* =====================================================================
- *  LargeMemoryManager — 实现
+ *  MemoryPoolStatistics — 汇总与导出 / Aggregation and export
  * ===================================================================== */
 
-void* LargeMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+namespace
 {
-	const std::size_t total = sizeof( LargeMemoryHeader ) + bytes;				 // 计算总内存大小 / Calculate total memory size
-	void*			  memory = os_memory::allocate_tracked( total, alignment );	 // 向操作系统申请内存 / Request memory from the OS
-	if ( !memory )
-		throw std::bad_alloc();	 // 如果申请失败，抛出异常 / Throw exception if allocation fails
-
-	auto* header = static_cast<LargeMemoryHeader*>( memory );  // 获取内存头部 / Get the memory header
-	header->magic = LargeMemoryHeader::MAGIC;				   // 设置魔法值 / Set magic value
-	header->block_size = bytes;								   // 设置块大小 / Set block size
-
-	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
-	active_blocks.push_back( header );								// 记录已分配的块 / Record the allocated block
+	using SmallCounter = std::uint64_t MemoryPoolStatistics::SmallBucket::*;
+	using MediumCounter = std::uint64_t MemoryPoolStatistics::MediumOrder::*;
 
-	return header->data();	// 返回数据指针 / Return data pointer
-}
+	struct SmallMetric
+	{
+		const char*	 name;
+		const char*	 help;
+		SmallCounter counter;
+	};
 
-void LargeMemoryManager::deallocate( LargeMemoryHeader* header )
-{
-	if ( header->magic != LargeMemoryHeader::MAGIC )
+	struct MediumMetric
 	{
-		std::cerr << "[Large] invalid magic during deallocation\n";	 // 魔法值无效 / Invalid magic value
-		return;
+		const char*	  name;
+		const char*	  help;
+		MediumCounter counter;
+	};
+
+	constexpr SmallMetric SMALL_METRICS[] = {
+		{ "allocations", "Small allocations", &MemoryPoolStatistics::SmallBucket::allocations },
+		{ "frees", "Small frees", &MemoryPoolStatistics::SmallBucket::frees },
+		{ "requested_bytes", "Bytes requested from the bucket", &MemoryPoolStatistics::SmallBucket::requested_bytes },
+		{ "cache_misses", "Allocations that found both thread magazines empty", &MemoryPoolStatistics::SmallBucket::cache_misses },
+		{ "global_refills", "Full magazines taken from the global stacks", &MemoryPoolStatistics::SmallBucket::global_refills },
+		{ "global_flushes", "Full magazines handed to the global stacks", &MemoryPoolStatistics::SmallBucket::global_flushes },
+		{ "remote_frees", "Frees handed back to another thread heap", &MemoryPoolStatistics::SmallBucket::remote_frees },
+		{ "carves", "Fresh chunks or slabs carved", &MemoryPoolStatistics::SmallBucket::carves },
+	};
+
+	constexpr MediumMetric MEDIUM_METRICS[] = {
+		{ "allocations", "Medium allocations", &MemoryPoolStatistics::MediumOrder::allocations },
+		{ "frees", "Medium frees", &MemoryPoolStatistics::MediumOrder::frees },
+		{ "splits", "Blocks of this order split in half", &MemoryPoolStatistics::MediumOrder::splits },
+		{ "merges", "Buddy pairs of this order merged", &MemoryPoolStatistics::MediumOrder::merges },
+	};
+
+	bool has_activity( const MemoryPoolStatistics::SmallBucket& bucket )
+	{
+		for ( const SmallMetric& metric : SMALL_METRICS )
+			if ( bucket.*metric.counter != 0 )
+				return true;
+		return false;
 	}
-	header->magic = 0;	// 清除魔法值 / Clear magic value
 
+	bool has_activity( const MemoryPoolStatistics::MediumOrder& order )
 	{
-		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );										 // 加锁保护 / Lock protection
-		auto						iter = std::find( active_blocks.begin(), active_blocks.end(), header );	 // 查找并删除已释放块 / Find and remove the deallocated block
-		if ( iter != active_blocks.end() )
-			active_blocks.erase( iter );  // 删除已释放块 / Remove the deallocated block
+		for ( const MediumMetric& metric : MEDIUM_METRICS )
+			if ( order.*metric.counter != 0 )
+				return true;
+		return false;
 	}
 
-	os_memory::deallocate_tracked( header, sizeof( LargeMemoryHeader ) + header->block_size );	// 释放内存 / Deallocate memory
-}
+	template <typename ValueType>
+	void write_prometheus_metric( std::ostream& output, std::string_view prefix, const char* name, const char* type, const char* help, ValueType value )
+	{
+		output << "# HELP " << prefix << '_' << name << ' ' << help << "\n";
+		output << "# TYPE " << prefix << '_' << name << ' ' << type << "\n";
+		output << prefix << '_' << name << ' ' << value << "\n";
+	}
+}  // namespace
 
-void LargeMemoryManager::release_resources()
+void MemoryPoolStatistics::accumulate( const MemoryPoolStatistics& other )
 {
+	auto add_small = []( auto& totals, const auto& others ) {
+		for ( std::size_t i = 0; i < totals.size(); ++i )
+		{
+			totals[ i ].block_bytes = others[ i ].block_bytes;
+			for ( const SmallMetric& metric : SMALL_METRICS )
+				totals[ i ].*metric.counter += others[ i ].*metric.counter;
+		}
+	};
+	add_small( small_buckets, other.small_buckets );
+	add_small( slab_buckets, other.slab_buckets );
+	small_chunks += other.small_chunks;
+	small_chunk_bytes += other.small_chunk_bytes;
+	slab_segments += other.slab_segments;
+	slab_segment_bytes += other.slab_segment_bytes;
+	small_thread_heaps += other.small_thread_heaps;
+
+	for ( std::size_t i = 0; i < medium_orders.size(); ++i )
 	{
-		std::scoped_lock<std::mutex> lock( tracking_mutex );
-		for ( auto* header : active_blocks )
-			os_memory::deallocate_tracked( header, sizeof( LargeMemoryHeader ) + header->block_size );	// 释放所有已分配的内存 / Deallocate all allocated memory
-		active_blocks.clear();																			// 清空已分配块 / Clear the allocated blocks
+		medium_orders[ i ].block_bytes = other.medium_orders[ i ].block_bytes;
+		for ( const MediumMetric& metric : MEDIUM_METRICS )
+			medium_orders[ i ].*metric.counter += other.medium_orders[ i ].*metric.counter;
 	}
+	medium_chunks += other.medium_chunks;
+	medium_chunk_bytes += other.medium_chunk_bytes;
+	merge_queue_depth += other.merge_queue_depth;
+
+	large.allocations += other.large.allocations;
+	large.frees += other.large.frees;
+	large.cache_hits += other.large.cache_hits;
+	large.remaps += other.large.remaps;
+	large.active_blocks += other.large.active_blocks;
+	large.active_bytes += other.large.active_bytes;
+	large.cached_blocks += other.large.cached_blocks;
+	large.cached_bytes += other.large.cached_bytes;
+
+	huge.allocations += other.huge.allocations;
+	huge.frees += other.huge.frees;
+	huge.remaps += other.huge.remaps;
+	huge.active_blocks += other.huge.active_blocks;
+	huge.active_bytes += other.huge.active_bytes;
+
+	pool_mapped_bytes += other.pool_mapped_bytes;
+
+	// 进程级计数各分片读到的是同一个值 / Every shard reads the same process-wide counters
+	os_mapped_bytes = other.os_mapped_bytes;
+	os_net_operations = other.os_net_operations;
 }
 
-/* =====================================================================
- *  HugeMemoryManager — 实现
- * ===================================================================== */
-
-void* HugeMemoryManager::allocate( std::size_t bytes, std::size_t alignment = sizeof( std::max_align_t ) )
+void MemoryPoolStatistics::write_json( std::ostream& output ) const
 {
-	const std::size_t total = sizeof( HugeMemoryHeader ) + bytes;				 // 计算总内存大小 / Calculate total memory size
-	void*			  memory = os_memory::allocate_tracked( total, alignment );	 // 向操作系统申请内存 / Request memory from the OS
-	if ( !memory )
-		throw std::bad_alloc();	 // 如果申请失败，抛出异常 / Throw exception if allocation fails
-
-	auto* header = static_cast<HugeMemoryHeader*>( memory );  // 获取内存头部 / Get the memory header
-	header->magic = HugeMemoryHeader::MAGIC;				  // 设置魔法值 / Set magic value
-	header->block_size = bytes;								  // 设置块大小 / Set block size
+	output << "{\"small\":{\"thread_heaps\":" << small_thread_heaps << ",\"chunks\":" << small_chunks << ",\"chunk_bytes\":" << small_chunk_bytes
+		   << ",\"slab_segments\":" << slab_segments << ",\"slab_segment_bytes\":" << slab_segment_bytes << ",\"buckets\":[";
+	bool first = true;
+	auto write_buckets = [ & ]( const auto& buckets, const char* kind ) {
+		for ( std::size_t i = 0; i < buckets.size(); ++i )
+		{
+			const SmallBucket& bucket = buckets[ i ];
+			if ( !has_activity( bucket ) )
+				continue;
+			output << ( first ? "" : "," ) << "{\"kind\":\"" << kind << "\",\"index\":" << i << ",\"block_bytes\":" << bucket.block_bytes;
+			for ( const SmallMetric& metric : SMALL_METRICS )
+				output << ",\"" << metric.name << "\":" << bucket.*metric.counter;
+			output << ",\"thread_cache_hit_rate\":" << bucket.thread_cache_hit_rate() << ",\"internal_fragmentation\":" << bucket.internal_fragmentation() << "}";
+			first = false;
+		}
+	};
+	write_buckets( small_buckets, "headered" );
+	write_buckets( slab_buckets, "slab" );
 
-	std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );	// 加锁保护 / Lock protection
-	active_blocks.emplace_back( memory, total );					// 记录已分配的块 / Record the allocated block
+	output << "]},\"medium\":{\"chunks\":" << medium_chunks << ",\"chunk_bytes\":" << medium_chunk_bytes << ",\"merge_queue_depth\":" << merge_queue_depth << ",\"orders\":[";
+	first = true;
+	for ( std::size_t i = 0; i < medium_orders.size(); ++i )
+	{
+		const MediumOrder& order = medium_orders[ i ];
+		if ( !has_activity( order ) )
+			continue;
+		output << ( first ? "" : "," ) << "{\"order\":" << i << ",\"block_bytes\":" << order.block_bytes;
+		for ( const MediumMetric& metric : MEDIUM_METRICS )
+			output << ",\"" << metric.name << "\":" << order.*metric.counter;
+		output << "}";
+		first = false;
+	}
 
-	return header->data();	// 返回数据指针 / Return data pointer
+	output << "]},\"large\":{\"allocations\":" << large.allocations << ",\"frees\":" << large.frees << ",\"cache_hits\":" << large.cache_hits << ",\"remaps\":" << large.remaps
+		   << ",\"active_blocks\":" << large.active_blocks << ",\"active_bytes\":" << large.active_bytes << ",\"cached_blocks\":" << large.cached_blocks
+		   << ",\"cached_bytes\":" << large.cached_bytes << "}";
+	output << ",\"huge\":{\"allocations\":" << huge.allocations << ",\"frees\":" << huge.frees << ",\"remaps\":" << huge.remaps << ",\"active_blocks\":" << huge.active_blocks
+		   << ",\"active_bytes\":" << huge.active_bytes << "}";
+	output << ",\"pool\":{\"mapped_bytes\":" << pool_mapped_bytes << "}";
+	output << ",\"os\":{\"mapped_bytes\":" << os_mapped_bytes << ",\"net_operations\":" << os_net_operations << "}}\n";
 }
 
-void HugeMemoryManager::deallocate( HugeMemoryHeader* header )
+void MemoryPoolStatistics::write_prometheus( std::ostream& output, std::string_view prefix ) const
 {
-	if ( header->magic != HugeMemoryHeader::MAGIC )
+	/* 同名样本须连续输出：按指标逐个遍历桶 / Samples of one family must be contiguous: walk the buckets once per metric */
+	for ( const SmallMetric& metric : SMALL_METRICS )
 	{
-		std::cerr << "[Huge] invalid magic during deallocation\n";	// 魔法值无效 / Invalid magic value
-		return;
+		output << "# HELP " << prefix << "_small_" << metric.name << "_total " << metric.help << "\n";
+		output << "# TYPE " << prefix << "_small_" << metric.name << "_total counter\n";
+		auto write_samples = [ & ]( const auto& buckets, const char* kind ) {
+			for ( std::size_t i = 0; i < buckets.size(); ++i )
+			{
+				if ( !has_activity( buckets[ i ] ) )
+					continue;
+				output << prefix << "_small_" << metric.name << "_total{kind=\"" << kind << "\",bucket=\"" << i << "\",block_bytes=\"" << buckets[ i ].block_bytes << "\"} "
+					   << buckets[ i ].*metric.counter << "\n";
+			}
+		};
+		write_samples( small_buckets, "headered" );
+		write_samples( slab_buckets, "slab" );
 	}
-	header->magic = 0;	// 清除魔法值 / Clear magic value
+	write_prometheus_metric( output, prefix, "small_thread_heaps", "gauge", "Thread heaps attached to the Small tier", small_thread_heaps );
+	write_prometheus_metric( output, prefix, "small_chunk_bytes", "gauge", "Bytes of headered Small chunks", small_chunk_bytes );
+	write_prometheus_metric( output, prefix, "small_slab_segment_bytes", "gauge", "Bytes of Small slab segments", slab_segment_bytes );
 
+	for ( const MediumMetric& metric : MEDIUM_METRICS )
 	{
-		std::lock_guard<std::mutex> this_lock_guard( tracking_mutex );																													   // 加锁保护 / Lock protection
-		auto						iter = std::find_if( active_blocks.begin(), active_blocks.end(), [ header ]( auto& reference_object ) { return reference_object.first == header; } );  // 查找并删除已释放块 / Find and remove the deallocated block
-		if ( iter != active_blocks.end() )
+		output << "# HELP " << prefix << "_medium_" << metric.name << "_total " << metric.help << "\n";
+		output << "# TYPE " << prefix << "_medium_" << metric.name << "_total counter\n";
+		for ( std::size_t i = 0; i < medium_orders.size(); ++i )
 		{
-			os_memory::deallocate_tracked( iter->first, iter->second );	 // 释放内存 / Deallocate memory
-			active_blocks.erase( iter );								 // 删除已释放块 / Remove the deallocated block
-			return;
+			if ( !has_activity( medium_orders[ i ] ) )
+				continue;
+			output << prefix << "_medium_" << metric.name << "_total{order=\"" << i << "\",block_bytes=\"" << medium_orders[ i ].block_bytes << "\"} " << medium_orders[ i ].*metric.counter << "\n";
 		}
 	}
-
-	os_memory::deallocate_tracked( header, sizeof( HugeMemoryHeader ) + header->block_size );  // 释放内存 / Deallocate memory
+	write_prometheus_metric( output, prefix, "medium_chunk_bytes", "gauge", "Bytes of Medium arenas", medium_chunk_bytes );
+	write_prometheus_metric( output, prefix, "medium_merge_queue_depth", "gauge", "Pending Medium merge requests", merge_queue_depth );
+
+	write_prometheus_metric( output, prefix, "large_allocations_total", "counter", "Large allocations", large.allocations );
+	write_prometheus_metric( output, prefix, "large_frees_total", "counter", "Large frees", large.frees );
+	write_prometheus_metric( output, prefix, "large_cache_hits_total", "counter", "Large allocations served from the mapping cache", large.cache_hits );
+	write_prometheus_metric( output, prefix, "large_remaps_total", "counter", "Large mremap calls", large.remaps );
+	write_prometheus_metric( output, prefix, "large_active_bytes", "gauge", "Bytes of Large mappings in use", large.active_bytes );
+	write_prometheus_metric( output, prefix, "large_cached_bytes", "gauge", "Bytes of cached Large mappings", large.cached_bytes );
+
+	write_prometheus_metric( output, prefix, "huge_allocations_total", "counter", "Huge allocations", huge.allocations );
+	write_prometheus_metric( output, prefix, "huge_frees_total", "counter", "Huge frees", huge.frees );
+	write_prometheus_metric( output, prefix, "huge_remaps_total", "counter", "Huge mremap calls", huge.remaps );
+	write_prometheus_metric( output, prefix, "huge_active_bytes", "gauge", "Bytes of Huge mappings in use", huge.active_bytes );
+
+	write_prometheus_metric( output, prefix, "pool_mapped_bytes", "gauge", "Bytes this pool has mapped from the OS", pool_mapped_bytes );
+	write_prometheus_metric( output, prefix, "os_mapped_bytes", "gauge", "Bytes mapped from the OS, process wide", os_mapped_bytes );
+	write_prometheus_metric( output, prefix, "os_net_operations", "gauge", "OS mappings minus unmappings, process wide", os_net_operations );
 }
 
-void HugeMemoryManager::release_resources()
+/* =====================================================================
+ *  ReserveProfile — 实现
+ * ===================================================================== */
+
+namespace
 {
+	std::size_t scaled_live_blocks( std::uint64_t allocations, std::uint64_t frees, double scale )
 	{
-		std::scoped_lock<std::mutex> lock( tracking_mutex );
-		for ( auto& [ pointer, size ] : active_blocks )
-			os_memory::deallocate_tracked( pointer, size );	 // 释放所有已分配的内存 / Deallocate all allocated memory
-		active_blocks.clear();								 // 清空已分配块 / Clear the allocated blocks
+		if ( allocations <= frees || !( scale > 0.0 ) )
+			return 0;
+		return static_cast<std::size_t>( std::ceil( static_cast<double>( allocations - frees ) * scale ) );
 	}
-}
+}  // namespace
 
-// =====================================================================
-//  MemoryPool 实现
-// =====================================================================
+ReserveProfile ReserveProfile::from_statistics( const MemoryPoolStatistics& snapshot, double scale )
+{
+	ReserveProfile profile;
+	for ( std::size_t i = 0; i < profile.slab_blocks.size(); ++i )
+		profile.slab_blocks[ i ] = scaled_live_blocks( snapshot.slab_buckets[ i ].allocations, snapshot.slab_buckets[ i ].frees, scale );
+	for ( std::size_t i = SmallMemoryManager::SLAB_BUCKET_COUNT; i < profile.small_blocks.size(); ++i )
+		profile.small_blocks[ i ] = scaled_live_blocks( snapshot.small_buckets[ i ].allocations, snapshot.small_buckets[ i ].frees, scale );
+	for ( std::size_t i = 1; i < profile.medium_blocks.size(); ++i )
+		profile.medium_blocks[ i ] = scaled_live_blocks( snapshot.medium_orders[ i ].allocations, snapshot.medium_orders[ i ].frees, scale );
+	return profile;
+}
 
-MemoryPool::MemoryPool()
+void ReserveProfile::write( std::ostream& output ) const
 {
-	/* 初始化全局小桶 & 中层空闲链头 / Initialize global small buckets and medium-level free list heads */
-	for ( auto& bucket : small_manager.global_buckets )
-	{
-#if SUPPORT_128BIT_CAS
-		bucket.head.store( { nullptr, 0 }, std::memory_order_relaxed );	 // 使用128位CAS / Use 128-bit CAS
-#else
-		bucket.head.store( nullptr, std::memory_order_relaxed );  // 普通指针CAS / Normal pointer CAS
-#endif
-	}
+	auto write_counts = [ & ]( const auto& counts, const char* kind ) {
+		for ( std::size_t i = 0; i < counts.size(); ++i )
+		{
+			if ( counts[ i ] != 0 )
+				output << kind << " " << i << " " << counts[ i ] << "\n";
+		}
+	};
+	write_counts( slab_blocks, "slab" );
+	write_counts( small_blocks, "small" );
+	write_counts( medium_blocks, "medium" );
+}
 
-	if ( !construction_warning_shown.exchange( true, std::memory_order_relaxed ) )
+ReserveProfile ReserveProfile::read( std::istream& input )
+{
+	ReserveProfile profile;
+	std::string	   kind;
+	std::size_t	   index = 0;
+	std::size_t	   blocks = 0;
+	while ( input >> kind >> index >> blocks )
 	{
-		std::cerr << "\033[33m[MemoryPool Warning] 直接使用 MemoryPool 仅适合内部场景，生产代码请封装成 PoolAllocator！\033[0m\n";										   // 警告信息 / Warning message
-		std::cerr << "\033[32m[MemoryPool Warning] Direct use of MemoryPool may cause tracking misses or duplicates. Please use PoolAllocator instead!\033[0m\n";  // 警告信息 / Warning message
+		if ( kind == "slab" && index < profile.slab_blocks.size() )
+			profile.slab_blocks[ index ] = blocks;
+		else if ( kind == "small" && index < profile.small_blocks.size() )
+			profile.small_blocks[ index ] = blocks;
+		else if ( kind == "medium" && index < profile.medium_blocks.size() )
+			profile.medium_blocks[ index ] = blocks;
 	}
+	return profile;
 }
 
-MemoryPool::~MemoryPool()
+std::size_t ReserveProfile::total_blocks() const
 {
-	/* 1. 标记正在销毁（让各个 manager 在 flush/释放时知道不要往 thread-cache 再放） */
-	is_destructing.store( true, std::memory_order_release );  // 设置销毁标志 / Set destruction flag
-
-	/* 2. 刷新本线程的缓存，回收所有没还给 OS 的小/中/大块 */
-	flush_current_thread_cache();  // 刷新当前线程缓存 / Flush current thread cache
+	std::size_t total = 0;
+	for ( std::size_t blocks : slab_blocks )
+		total += blocks;
+	for ( std::size_t blocks : small_blocks )
+		total += blocks;
+	for ( std::size_t blocks : medium_blocks )
+		total += blocks;
+	return total;
+}
 
-	/* 3. 依次释放各等级的剩余资源 */
-	huge_manager.release_resources();	 // 释放超大内存资源 / Release huge memory resources
-	large_manager.release_resources();	 // 释放大内存资源 / Release large memory resources
-	medium_manager.release_resources();	 // 释放中等内存资源 / Release medium memory resources
-	small_manager.release_resources();	 // 释放小内存资源 / Release small memory resources
+/* =====================================================================
+ *  NumaMemoryPool — 实现
+ * ===================================================================== */
 
-	/* 4. 最终检查，全局计数器应为 0 */
-	const uint64_t leaked = os_memory::used_memory_bytes_counter.load( std::memory_order_seq_cst );
-	if ( leaked != 0 )
+NumaMemoryPool::NumaMemoryPool()
+{
+	const std::size_t node_count = os_memory::numa_node_count();
+	if ( node_count <= 1 )
 	{
-		std::cerr << "[MemoryPool] Memory leak detected: " << leaked << " bytes still allocated." << std::endl;
+		shards.push_back( std::make_unique<MemoryPool>() );	 // 单节点无需绑定 / A single node needs no binding
+		return;
 	}
 
-	/* 5. 检查操作计数，allocate/deallocate 是否成对 */
-	const uint64_t original_point = os_memory::user_operation_counter.load( std::memory_order_seq_cst );
-	if ( original_point != 0 )
-	{
-		std::cerr << "[MemoryPool] Operation imbalance detected: " << original_point << " net operations (allocs minus frees)." << std::endl;
-	}
+	shards.reserve( node_count );
+	for ( std::size_t node = 0; node < node_count; ++node )
+		shards.push_back( std::make_unique<MemoryPool>( node ) );
 }
 
-void* MemoryPool::allocate( std::size_t requested_bytes, std::size_t requested_alignment, const char* file, std::uint32_t line, bool nothrow )
+MemoryPool& NumaMemoryPool::local_shard()
 {
-	/* ── 1. alignment validation ───────────────────────────── */
-	if ( (requested_alignment & 1) == 1 || !os_memory::memory_pool::is_power_of_two( requested_alignment ))
-	{
-		if ( requested_alignment > MAX_ALLOWED_ALIGNMENT && !nothrow )
-			throw std::bad_alloc();	 //!< illegal alignment
+	if ( shards.size() == 1 )
+		return *shards.front();
+	const std::size_t node = os_memory::current_numa_node();
+	return *shards[ node < shards.size() ? node : 0 ];
+}
 
-		if ( requested_alignment > 0 )
-		{
-			requested_alignment = DEFAULT_ALIGNMENT;
-		}
-	}
+MemoryPool& NumaMemoryPool::owner_shard( void* pointer )
+{
+	if ( shards.size() == 1 )
+		return *shards.front();
+	const std::size_t node = MemoryPool::node_of( pointer );
+	return *shards[ node < shards.size() ? node : 0 ];
+}
 
-	/* ── 2. slow path : large alignment ────────────────────── */
-	if ( requested_alignment > DEFAULT_ALIGNMENT )
-	{
-		const std::size_t extra_alignment_padding_bytes = requested_alignment - 1 + ALIGN_HEADER_BYTES;
-		const std::size_t total_allocated_bytes = requested_bytes + extra_alignment_padding_bytes;
+void* NumaMemoryPool::allocate( std::size_t bytes, std::size_t alignment, const char* source_file, std::uint32_t source_line, bool nothrow )
+{
+	return local_shard().allocate( bytes, alignment, source_file, source_line, nothrow );
+}
 
-		void* const raw_block_pointer = os_memory::allocate_tracked( total_allocated_bytes, requested_bytes );
-		if ( !raw_block_pointer )
-		{
-			if ( !nothrow )
-				throw std::bad_alloc();
-			return nullptr;
-		}
+void* NumaMemoryPool::allocate_zeroed( std::size_t count, std::size_t bytes, std::size_t alignment, const char* source_file, std::uint32_t source_line, bool nothrow )
+{
+	return local_shard().allocate_zeroed( count, bytes, alignment, source_file, source_line, nothrow );
+}
 
-		char*		data_region_begin = static_cast<char*>( raw_block_pointer ) + ALIGN_HEADER_BYTES;
-		std::size_t remaining_space_bytes = total_allocated_bytes - ALIGN_HEADER_BYTES;
-		void*		aligned_user_pointer = data_region_begin;
+void* NumaMemoryPool::allocate_on_node( std::size_t numa_node, std::size_t bytes, std::size_t alignment, bool nothrow )
+{
+	MemoryPool& shard = numa_node < shards.size() ? *shards[ numa_node ] : local_shard();
+	return shard.allocate( bytes, alignment, nullptr, 0, nothrow );
+}
 
-		if ( !std::align( requested_alignment, requested_bytes, aligned_user_pointer, remaining_space_bytes ) )
-		{
-			os_memory::deallocate_tracked( raw_block_pointer, total_allocated_bytes );
-			if ( !nothrow )
-				throw std::bad_alloc();
-			return nullptr;
-		}
+void NumaMemoryPool::deallocate( void* pointer )
+{
+	if ( !pointer )
+		return;
+	owner_shard( pointer ).deallocate( pointer );
+}
 
-		auto* align_header_pointer = reinterpret_cast<AlignHeader*>( static_cast<char*>( aligned_user_pointer ) - ALIGN_HEADER_BYTES );
-		align_header_pointer->tag = ALIGN_SENTINEL;
-		align_header_pointer->raw = raw_block_pointer;
-		align_header_pointer->size = total_allocated_bytes;
-		return aligned_user_pointer;
+void NumaMemoryPool::deallocate( void* pointer, std::size_t bytes, std::size_t alignment )
+{
+	if ( !pointer )
+		return;
+	if ( shards.size() == 1 )
+	{
+		shards.front()->deallocate( pointer, bytes, alignment );
+		return;
 	}
+	const std::size_t node = MemoryPool::node_of( pointer, bytes, alignment );
+	shards[ node < shards.size() ? node : 0 ]->deallocate( pointer, bytes, alignment );
+}
 
-	/* ── 3. fast path : default alignment ──────────────────── */
-	const std::size_t total_bytes_including_header = requested_bytes + NOT_ALIGN_HEADER_BYTES;
+void* NumaMemoryPool::reallocate( void* pointer, std::size_t bytes, std::size_t alignment, bool nothrow )
+{
+	// 搬迁后仍留在原节点：固定在某节点的缓冲区保持其位置 / A moved block stays on its node, so pinned buffers keep their placement
+	if ( !pointer )
+		return allocate( bytes, alignment, nullptr, 0, nothrow );
+	return owner_shard( pointer ).reallocate( pointer, bytes, alignment, nothrow );
+}
 
-	std::size_t	  block_header_size_bytes = 0;
-	std::uint32_t block_owner_type_identifier = 0;
-	void*		  internal_data_region_pointer = nullptr;  // → points to data()
+std::size_t NumaMemoryPool::usable_size( void* pointer )
+{
+	if ( !pointer )
+		return 0;
+	return owner_shard( pointer ).usable_size( pointer );
+}
 
-	if ( total_bytes_including_header <= SMALL_BLOCK_MAX_SIZE )
-	{
-		block_header_size_bytes = sizeof( SmallMemoryHeader );
-		block_owner_type_identifier = 1;
-		internal_data_region_pointer = small_manager.allocate( total_bytes_including_header, requested_alignment );
-	}
-	else if ( total_bytes_including_header <= MEDIUM_BLOCK_MAX_SIZE )
-	{
-		block_header_size_bytes = sizeof( MediumMemoryHeader );
-		block_owner_type_identifier = 2;
-		internal_data_region_pointer = medium_manager.allocate( total_bytes_including_header, requested_alignment );
-	}
-	else if ( total_bytes_including_header <= HUGE_BLOCK_THRESHOLD )
-	{
-		block_header_size_bytes = sizeof( LargeMemoryHeader );
-		block_owner_type_identifier = 3;
-		internal_data_region_pointer = large_manager.allocate( total_bytes_including_header, requested_alignment );
-	}
-	else
+std::size_t NumaMemoryPool::allocate_batch( std::size_t bytes, std::size_t count, void** out, bool nothrow )
+{
+	return local_shard().allocate_batch( bytes, count, out, nothrow );
+}
+
+void NumaMemoryPool::deallocate_batch( void* const* pointers, std::size_t count )
+{
+	if ( shards.size() == 1 )
 	{
-		block_header_size_bytes = sizeof( HugeMemoryHeader );
-		block_owner_type_identifier = 4;
-		internal_data_region_pointer = huge_manager.allocate( total_bytes_including_header, requested_alignment );
+		shards.front()->deallocate_batch( pointers, count );
+		return;
 	}
 
-	if ( !internal_data_region_pointer )
+	/* 按节点切成连续段 / Split into consecutive runs per node */
+	std::size_t run_begin = 0;
+	while ( run_begin < count )
 	{
-		if ( !nothrow )
-			throw std::bad_alloc();
-		return nullptr;
+		std::size_t run_end = run_begin;
+		std::size_t run_node = shards.size();
+		for ( ; run_end < count; ++run_end )
+		{
+			if ( !pointers[ run_end ] )
+				continue;
+			const std::size_t node = MemoryPool::node_of( pointers[ run_end ] );
+			if ( run_node == shards.size() )
+				run_node = node;
+			else if ( node != run_node )
+				break;
+		}
+		shards[ run_node < shards.size() ? run_node : 0 ]->deallocate_batch( pointers + run_begin, run_end - run_begin );
+		run_begin = run_end;
 	}
+}
 
-	auto* unaligned_block_header = reinterpret_cast<NotAlignHeader*>( internal_data_region_pointer );
-	unaligned_block_header->owner_type = block_owner_type_identifier;
-	unaligned_block_header->raw = static_cast<char*>( internal_data_region_pointer ) - block_header_size_bytes;
+void NumaMemoryPool::flush_current_thread_cache()
+{
+	for ( auto& shard : shards )
+		shard->flush_current_thread_cache();
+}
 
-	return static_cast<char*>( internal_data_region_pointer ) + NOT_ALIGN_HEADER_BYTES;
+std::size_t NumaMemoryPool::trim()
+{
+	std::size_t released_bytes = 0;
+	for ( auto& shard : shards )
+		released_bytes += shard->trim();
+	return released_bytes;
 }
 
-/* -------------------------------------------------------------------------- */
+std::size_t NumaMemoryPool::reserve( const ReserveProfile& profile )
+{
+	return local_shard().reserve( profile );
+}
 
-void MemoryPool::deallocate( void* user_pointer )
+void NumaMemoryPool::set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval )
 {
-	if ( !user_pointer )
-		return;
+	for ( auto& shard : shards )
+		shard->set_purge_policy( idle_period, interval );
+}
 
-	const std::uintptr_t user_pointer_address = reinterpret_cast<std::uintptr_t>( user_pointer );
+void NumaMemoryPool::set_memory_limit( std::size_t soft_limit, std::size_t hard_limit )
+{
+	// 各分片只按自己的映射字节计，均分后总量仍不超过上限 / Each shard counts only its own mappings, so an even split keeps the total within the limit
+	const std::size_t shard_count = shards.size();
+	auto			  share = [ shard_count ]( std::size_t limit ) {
+		 return limit == 0 ? 0 : std::max<std::size_t>( limit / shard_count, 1 );
+	};
+	for ( auto& shard : shards )
+		shard->set_memory_limit( share( soft_limit ), share( hard_limit ) );
+}
 
-	/* ── 1. check large‑alignment header ───────────────────── */
+bool NumaMemoryPool::add_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+{
+	for ( std::size_t i = 0; i < shards.size(); ++i )
 	{
-		auto* align_header_pointer = reinterpret_cast<const AlignHeader*>( user_pointer_address - ALIGN_HEADER_BYTES );
-
-		AlignHeader stacked_copy_of_align_header {};
-		std::memcpy( &stacked_copy_of_align_header, align_header_pointer, sizeof( stacked_copy_of_align_header ) );
-
-		if ( stacked_copy_of_align_header.tag == ALIGN_SENTINEL )
+		if ( !shards[ i ]->add_memory_pressure_callback( callback, context ) )
 		{
-			os_memory::deallocate_tracked( stacked_copy_of_align_header.raw, stacked_copy_of_align_header.size );
-			return;
+			while ( i-- > 0 )
+				shards[ i ]->remove_memory_pressure_callback( callback, context );
+			return false;
 		}
 	}
+	return true;
+}
 
-	/* ── 2. check default‑alignment header ─────────────────── */
-	{
-		auto* unaligned_header_pointer = reinterpret_cast<const NotAlignHeader*>( user_pointer_address - NOT_ALIGN_HEADER_BYTES );
+void NumaMemoryPool::remove_memory_pressure_callback( MemoryPressureCallback callback, void* context )
+{
+	for ( auto& shard : shards )
+		shard->remove_memory_pressure_callback( callback, context );
+}
 
-		NotAlignHeader stacked_copy_of_unaligned_header {};
-		std::memcpy( &stacked_copy_of_unaligned_header, unaligned_header_pointer, sizeof( stacked_copy_of_unaligned_header ) );
+std::size_t NumaMemoryPool::relieve_memory_pressure()
+{
+	std::size_t released_bytes = 0;
+	for ( auto& shard : shards )
+		released_bytes += shard->relieve_memory_pressure();
+	return released_bytes;
+}
 
-		switch ( stacked_copy_of_unaligned_header.owner_type )
-		{
-		case 1:
-			small_manager.deallocate( static_cast<SmallMemoryHeader*>( stacked_copy_of_unaligned_header.raw ) );
-			return;
-		case 2:
-			medium_manager.deallocate( static_cast<MediumMemoryHeader*>( stacked_copy_of_unaligned_header.raw ) );
-			return;
-		case 3:
-			large_manager.deallocate( static_cast<LargeMemoryHeader*>( stacked_copy_of_unaligned_header.raw ) );
-			return;
-		case 4:
-			huge_manager.deallocate( static_cast<HugeMemoryHeader*>( stacked_copy_of_unaligned_header.raw ) );
-			return;
-		default:
-#if defined( _DEBUG )
-			throw os_memory::bad_dealloc( "deallocate: invalid owner type" );
-#endif
-		}
-	}
+void NumaMemoryPool::set_medium_merge_policy( MediumMemoryManager::MergePolicy policy )
+{
+	for ( auto& shard : shards )
+		shard->set_medium_merge_policy( policy );
+}
 
-#if defined( _DEBUG )
-	throw os_memory::bad_dealloc( "deallocate: invalid pointer" );
-#endif
+void NumaMemoryPool::set_large_cache_policy( std::size_t budget_bytes, std::chrono::milliseconds decay )
+{
+	for ( auto& shard : shards )
+		shard->set_large_cache_policy( budget_bytes, decay );
 }
 
+void NumaMemoryPool::set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy )
+{
+	for ( auto& shard : shards )
+		shard->set_page_policy( medium_policy, large_policy, huge_policy );
+}
 
-void MemoryPool::flush_current_thread_cache()
+MemoryPoolStatistics NumaMemoryPool::statistics()
 {
-	small_manager.flush_thread_local_cache();  // 刷新线程本地缓存 / Flush thread-local cache
+	MemoryPoolStatistics snapshot = shards.front()->statistics();
+	for ( std::size_t node = 1; node < shards.size(); ++node )
+		snapshot.accumulate( shards[ node ]->statistics() );
+	return snapshot;
 }
@@ -3,6 +3,8 @@
 #define MEMORY_POOL_HPP
 
 #include "os_memory.hpp"
+#include "heap_profiler.hpp"
+#include "size_class_policy.hpp"
 
 #include <cstdio>
 #include <cstdint>
@@ -10,6 +12,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <cassert>
+#include <cstring>
 
 #include <iostream>
 #include <algorithm>
@@ -18,7 +21,15 @@
 #include <new>
 #include <mutex>
 #include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <array>
+#include <string_view>
+#include <bit>
 
 /**
  * @file memory_pool.hpp
@@ -26,7 +37,7 @@
  * 
  * @details
  * 采用四层结构处理不同尺寸的内存分配：
- * 1. 小内存 (<1 MiB)  – 线程本地缓存 + 全局 64 桶
+ * 1. 小内存 (<1 MiB)  – 线程本地缓存 + 全局 64 桶（≤1 KiB 的桶使用无对象头的 slab 页）
  * 2. 中内存 (1 MiB–512 MiB) – 无锁共享空闲链表 + Buddy-based + 标记抢占法
  * 3. 大内存 (512 MiB–1 GiB) – 直接操作系统分配并跟踪 (因为没有任何算法能够处理这个大小)
  * 4. 超大内存 (≥1 GiB) – 单块映射，释放即返还操作系统
@@ -47,17 +58,33 @@ static constexpr std::size_t MAX_ALLOWED_ALIGNMENT = 64 * 1024;		//!< 最大允
 #endif
 
 static constexpr std::uint64_t ALIGN_SENTINEL = 0xDEADBEEFCAFEBABEull;	//!< 对齐标识符 / Alignment sentinel
+
+/**
+ * @brief 对齐块头 / Header in front of an over-aligned user pointer
+ *
+ * @details
+ * 对齐请求不再直接向操作系统申请，而是从四层管理器中多申请 (alignment - DEFAULT_ALIGNMENT + ALIGN_HEADER_BYTES) 字节，
+ * 再在块内部切出对齐地址。raw 指向层级路径返回的内部用户指针（其前方是 NotAlignHeader）。
+ * 释放路径经 TierPageMap 定位块，不再读取这两个头部；它们只供 _DEBUG 核对。
+ *
+ * Over-aligned requests are carved out of the four tier managers instead of a raw OS mapping:
+ * the tier block is over-sized by (alignment - DEFAULT_ALIGNMENT + ALIGN_HEADER_BYTES) bytes and the
+ * aligned address is cut out of it. raw points at the inner user pointer returned by the tier path
+ * (preceded by a NotAlignHeader). Free paths locate the block through the TierPageMap and no longer read
+ * either header; they remain for _DEBUG cross-checks.
+ */
 struct AlignHeader
 {
 	std::uint64_t tag;	 //!< == ALIGN_SENTINEL
-	void*		  raw;	 //!< 原始块首地址 / Raw block base address
-	std::size_t	  size;	 //!< 总字节数 / Total bytes
+	void*		  raw;	 //!< 层级内部用户指针 / Inner user pointer returned by the tier path
+	std::size_t	  size;	 //!< 向层级申请的总字节数 / Total bytes requested from the tier
 };
 static constexpr std::size_t ALIGN_HEADER_BYTES = sizeof( AlignHeader );  //!< 对齐头部字节数 / Alignment header size
 
 struct NotAlignHeader
 {
 	std::uint32_t owner_type;  //!< 0 = nullpointer 1 = Small, 2 = Medium, 3 = Large, 4 = Huge
+	std::uint32_t owner_node;  //!< 所属 MemoryPool 的 NUMA 节点（未绑定为 0）/ NUMA node of the owning MemoryPool (0 when unbound)
 	void*		  raw;		   //!< 原始块首地址 / Raw block base address
 };
 
@@ -66,6 +93,9 @@ static constexpr std::size_t NOT_ALIGN_HEADER_BYTES = sizeof( NotAlignHeader );
 // ============================ Header 结构 ============================
 
 /* -------------- 小块头 -------------- */
+struct SmallThreadHeap;
+struct MemoryPoolStatistics;
+
 struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallMemoryHeader
 {
 	static constexpr std::uint32_t MAGIC = 0x534D4853;	//!< 'SMHS'
@@ -73,8 +103,7 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallMemoryHeader
 	std::uint32_t				   bucket_index;		//!< 桶索引 / Bucket index
 	std::uint32_t				   block_size;			//!< 块大小 / Block size
 	std::atomic<bool>			   is_free;				//!< 是否空闲 / Free flag
-	SmallMemoryHeader*			   next;				//!< 下一个块头 / Next block header
-	std::uint8_t				   in_tls;
+	SmallThreadHeap*			   owner_heap;			//!< 切分该块的线程堆 / Thread heap that carved the block
 
 	void* data()
 	{
@@ -82,13 +111,111 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallMemoryHeader
 	}
 };
 
+/* -------------- 小块 slab 描述符 -------------- */
+struct SmallMemoryManager;
+
+/**
+ * @brief 空闲小块的侵入式链接 / Intrusive link stored inside a free small block
+ * @note 仅在块空闲时有效：slab 对象占用对象前 8 字节，带头块占用数据区前 8 字节
+ *       Only valid while the block is free: slab objects keep it in their first 8 bytes, headered blocks in the first 8 bytes of their data area
+ */
+struct SmallFreeLink
+{
+	SmallFreeLink* next;  //!< 下一个空闲块 / Next free block
+};
+
+/**
+ * @brief 弹匣：同一桶的一批空闲块，作为整体在线程缓存与全局桶之间搬运 / Magazine: a batch of same-bucket free blocks moved as one unit
+ *
+ * @details
+ * 块本身仍通过 SmallFreeLink 串联，描述符只记录首尾与数量，因此交换一整批块只需一次 CAS 且无需遍历链表。
+ * 描述符取自进程级仓库，永不归还操作系统，保证全局栈上的 ABA 标记始终指向有效内存。
+ *
+ * The blocks stay chained through their SmallFreeLink; the descriptor only records head, tail and count, so
+ * swapping a whole batch costs one CAS and no list walk. Descriptors come from a process-wide depot and are
+ * never returned to the OS, which keeps every pointer on the tagged global stacks valid.
+ */
+struct SmallMagazine
+{
+	SmallMagazine* next;   //!< 全局栈链接 / Link in a global stack
+	SmallFreeLink* head;   //!< 首个空闲块 / First free block
+	SmallFreeLink* tail;   //!< 末个空闲块 / Last free block
+	std::size_t	   count;  //!< 块数量 / Number of blocks
+};
+
+/**
+ * @brief 单一尺寸类的 slab 页描述符 / Descriptor of a single size-class slab page
+ *
+ * @details
+ * 每个 slab 为 SLAB_BYTES 对齐的 64 KiB 页，描述符位于页首，对象紧随其后且没有任何逐对象头部。
+ * 对象指针按 SLAB_BYTES 掩码即可得到描述符；分配位图用于检测重复释放。
+ *
+ * Every slab is a 64 KiB page aligned to SLAB_BYTES. The descriptor sits at the start of the page and
+ * the objects follow it without any per-object header. Masking an object pointer with SLAB_BYTES yields
+ * the descriptor; the allocation bitmap catches double frees.
+ *
+ * @note 内存布局 / Memory layout:
+ *       [SmallSlabDescriptor | object 0 | object 1 | ... | object N-1 | tail]
+ *       |←──────────────────────── SLAB_BYTES ────────────────────────→|
+ */
+struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallSlabDescriptor
+{
+	static constexpr std::uint32_t MAGIC = 0x534C4253;						 //!< 'SLBS'
+	static constexpr std::size_t   SLAB_BYTES = 64 * 1024;					 //!< slab 大小与对齐 / Slab size and alignment
+	static constexpr std::size_t   MIN_BLOCK_BYTES = 8;						 //!< 最小对象尺寸 / Smallest object size
+	static constexpr std::size_t   BITMAP_WORDS = SLAB_BYTES / MIN_BLOCK_BYTES / 64;  //!< 位图字数 / Bitmap words
+
+	std::uint32_t			   magic;							 //!< 魔法值 / Magic value
+	std::uint32_t			   bucket_index;					 //!< 桶索引 / Bucket index
+	std::uint32_t			   block_size;						 //!< 对象大小 / Object size
+	std::uint32_t			   block_count;						 //!< 对象个数 / Object count
+	std::uint64_t			   block_reciprocal;				 //!< ceil(2^32 / block_size)，免除除法 / avoids a division
+	SmallMemoryManager*		   owner;							 //!< 所属管理器 / Owning manager
+	SmallThreadHeap*		   owner_heap;						 //!< 切分该 slab 的线程堆 / Thread heap that carved the slab
+	std::uint32_t			   idle_scan;						 //!< 最近一次被观察到全空的清理轮次 / Last purge scan that saw the slab fully free
+	std::uint64_t			   idle_since;						 //!< 连续全空起始时间 (ns) / Start of the fully-free streak (ns)
+	std::uint32_t			   purge_held;						 //!< 清理时在手的空闲对象数（受 chunk_mutex 保护）/ Free objects a purge holds (guarded by chunk_mutex)
+	SmallSlabDescriptor*	   purge_next;						 //!< 清理期间的侵入式链接 / Intrusive link during a purge
+	std::atomic<std::uint64_t> allocated_bitmap[ BITMAP_WORDS ];  //!< 已分配位图 / Allocation bitmap
+
+	char* first_block()
+	{
+		return reinterpret_cast<char*>( this ) + sizeof( SmallSlabDescriptor );	 //!< 首个对象 / First object
+	}
+
+	/// @brief 任意（含内部）指针所在对象的序号 / Index of the object containing (possibly interior) pointer
+	std::size_t block_index_of( const void* pointer )
+	{
+		const std::uint64_t offset = static_cast<std::uint64_t>( static_cast<const char*>( pointer ) - first_block() );
+		return static_cast<std::size_t>( ( offset * block_reciprocal ) >> 32 );
+	}
+
+	void* block_at( std::size_t block_index )
+	{
+		return first_block() + block_index * block_size;
+	}
+
+	/// @brief 由对象指针掩码得到描述符 / Mask an object pointer down to its descriptor
+	static SmallSlabDescriptor* from_pointer( const void* pointer )
+	{
+		return reinterpret_cast<SmallSlabDescriptor*>( reinterpret_cast<std::uintptr_t>( pointer ) & ~( static_cast<std::uintptr_t>( SLAB_BYTES ) - 1 ) );
+	}
+};
+
 /* -------------- 中块头 / 脚 -------------- */
 struct alignas( CLASS_DEFAULT_ALIGNMENT ) MediumMemoryHeader
 {
 	static constexpr std::uint32_t MAGIC = 0x4D4D4853;	//!< 'MMHS'
+	static constexpr std::uint8_t  PAGES_COMMITTED = 0;		//!< 数据页全部提交 / All data pages committed
+	static constexpr std::uint8_t  PAGES_DECOMMITTED = 1;	//!< 数据页全部归还 / All data pages decommitted
+	static constexpr std::uint8_t  PAGES_MIXED = 2;			//!< 合并自状态不同的两半 / Merged from halves in different states
 	std::uint32_t				   magic;				//!< 魔法值 / Magic value
 	std::size_t					   block_size;			//!< 块大小 / Block size
 	std::atomic<bool>			   is_free;				//!< 是否空闲 / Free flag
+	std::uint8_t				   page_state;			//!< 数据页提交状态 (PAGES_*) / Commit state of the data pages (PAGES_*)
+	std::uint8_t				   clean;				//!< 块头之后全为零，块被释放时清除 / Every byte after the header is zero; cleared when the block is freed
+	std::uint32_t				   idle_scan;			//!< 最近一次被观察到空闲的清理轮次 / Last purge scan that saw the block free
+	std::uint64_t				   idle_since;			//!< 连续空闲起始时间 (ns) / Start of the idle streak (ns)
 	MediumMemoryHeader*			   next;				//!< 下一个块头 / Next block header
 
 	void* data()
@@ -104,7 +231,13 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) LargeMemoryHeader
 {
 	static constexpr std::uint32_t MAGIC = 0x4C4D4853;	//!< 'LMHS'
 	std::uint32_t				   magic;				//!< 魔法值 / Magic value
+	std::uint8_t				   clean;				//!< 新映射（全为零），命中缓存时为 0 / A fresh, all-zero mapping; 0 on a cache hit
+	os_memory::PagePolicy		   page_policy;			//!< 映射实际取得的页策略（含回退）/ Page policy the mapping actually obtained, fallbacks included
 	std::size_t					   block_size;			//!< 块大小 / Block size
+	std::size_t					   mapping_bytes;		//!< 实际映射字节数（按缓存粒度取整）/ Mapped bytes, rounded up to the cache granule
+	std::uint64_t				   released_at;			//!< 进入缓存的时间 (ns) / Time the mapping entered the cache (ns)
+	LargeMemoryHeader*			   previous;			//!< 所在链表（活跃或缓存）的前驱 / Previous node in its list (active or cached)
+	LargeMemoryHeader*			   next;				//!< 所在链表的后继 / Next node in its list
 
 	void* data()
 	{
@@ -117,6 +250,7 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) HugeMemoryHeader
 	static constexpr std::uint32_t MAGIC = 0x484D4853;	//!< 'HMHS'
 	std::uint32_t				   magic;				//!< 魔法值 / Magic value
 	std::size_t					   block_size;			//!< 块大小 / Block size
+	std::size_t					   mapping_bytes;		//!< 实际映射字节数（按页策略取整）/ Mapped bytes, rounded up to the page policy
 
 	void* data()
 	{
@@ -125,60 +259,478 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) HugeMemoryHeader
 };
 
 /*------------------------------------------------------------------*\
-|  1. SmallMemoryManager — 64 桶 + TLS + 全局 ABA-safe 栈             |
+|  0. AddressPageMap — 两级基数页表（无锁读取）                       |
+\*------------------------------------------------------------------*/
+/**
+ * @brief 地址 → 元数据 的两级基数页表 / Two-level radix page map from address to metadata
+ *
+ * @tparam GranuleShift 粒度位数；登记的区间必须按粒度对齐 / Granule bits; recorded ranges must be granule-aligned
+ *
+ * @details
+ * 以 2^GranuleShift 为粒度覆盖 48 位用户地址空间：根表常驻（零页，未触碰不占物理内存），
+ * 叶子表按需向操作系统申请且永不释放，因此读取无需加锁也无需纪元保护；增长只是 CAS 安装新叶子。
+ * - AddressPageMap（64 KiB）：释放时不读取用户指针前方内存即可判定指针是否属于 slab；
+ * - MediumChunkMap（1 MiB）：中块合并时 O(1) 找到所属 chunk；
+ * - TierPageMap（4 KiB）：带头块的层级、桶与节点，释放时据此定位块头（见 TierPageEntry）。
+ *
+ * Covers the 48-bit user address space at 2^GranuleShift granularity: the root lives in zero pages
+ * (no RSS until touched), leaves are mapped on demand and never released, so lookups need neither
+ * locks nor epochs; growth is just a CAS that installs a new leaf.
+ * - AddressPageMap (64 KiB): classifies slab pointers on free without reading memory in front of them;
+ * - MediumChunkMap (1 MiB): finds the owning chunk of a medium block in O(1) when merging;
+ * - TierPageMap (4 KiB): tier, bucket and node of headered blocks, which free uses to find the block header (see TierPageEntry).
+ */
+template <std::size_t GranuleShift>
+struct BasicAddressPageMap
+{
+	static constexpr std::size_t GRANULE_SHIFT = GranuleShift;						  //!< 粒度位数 / Granule bits
+	static constexpr std::size_t ADDRESS_BITS = 48;									  //!< 覆盖的地址位 / Covered address bits
+	static constexpr std::size_t LEAF_BITS = 16;									  //!< 叶子索引位 / Leaf index bits
+	static constexpr std::size_t ROOT_BITS = ADDRESS_BITS - GRANULE_SHIFT - LEAF_BITS;	 //!< 根索引位 / Root index bits
+
+	struct Leaf
+	{
+		std::atomic<void*> entries[ std::size_t( 1 ) << LEAF_BITS ];
+	};
+
+	/// @brief 全局唯一实例 / The process-wide instance
+	static BasicAddressPageMap& instance()
+	{
+		static BasicAddressPageMap page_map;
+		return page_map;
+	}
+
+	/// @brief 查找地址所在粒度的元数据，无记录返回 nullptr / Metadata of the granule holding address, nullptr if none
+	void* find( const void* address ) const noexcept
+	{
+		const std::uintptr_t value = reinterpret_cast<std::uintptr_t>( address );
+		if ( ( value >> ADDRESS_BITS ) != 0 )
+			return nullptr;
+
+		const Leaf* leaf = root[ value >> ( GRANULE_SHIFT + LEAF_BITS ) ].load( std::memory_order_acquire );
+		if ( !leaf )
+			return nullptr;
+		return leaf->entries[ ( value >> GRANULE_SHIFT ) & ( ( std::size_t( 1 ) << LEAF_BITS ) - 1 ) ].load( std::memory_order_acquire );
+	}
+
+	/**
+	 * @brief 为 [begin, begin + bytes) 覆盖的所有粒度登记元数据 / Record metadata for every granule in [begin, begin + bytes)
+	 * @param value  nullptr 表示清除 / nullptr clears the range
+	 * @return 地址超出 48 位或叶子申请失败时返回 false / false if the range is out of 48-bit space or a leaf cannot be mapped
+	 */
+	bool assign( const void* begin, std::size_t bytes, void* value ) noexcept
+	{
+		const std::uintptr_t first = reinterpret_cast<std::uintptr_t>( begin ) >> GRANULE_SHIFT;
+		const std::uintptr_t last = ( reinterpret_cast<std::uintptr_t>( begin ) + bytes - 1 ) >> GRANULE_SHIFT;
+		if ( bytes == 0 || ( last >> ( ADDRESS_BITS - GRANULE_SHIFT ) ) != 0 )
+			return false;
+
+		for ( std::uintptr_t granule = first; granule <= last; ++granule )
+		{
+			Leaf* leaf = leaf_for( granule >> LEAF_BITS, value != nullptr );
+			if ( !leaf )
+			{
+				if ( value == nullptr )
+					continue;  // 清除时叶子不存在即已为空 / Nothing to clear
+				return false;
+			}
+			leaf->entries[ granule & ( ( std::size_t( 1 ) << LEAF_BITS ) - 1 ) ].store( value, std::memory_order_release );
+		}
+		return true;
+	}
+
+private:
+	std::atomic<Leaf*> root[ std::size_t( 1 ) << ROOT_BITS ] {};
+
+	Leaf* leaf_for( std::size_t root_index, bool create ) noexcept
+	{
+		Leaf* leaf = root[ root_index ].load( std::memory_order_acquire );
+		if ( leaf || !create )
+			return leaf;
+
+		// 叶子直接取自操作系统（零页），不计入池的字节计数 / Leaves come straight from the OS (zero pages), not counted as pool bytes
+		auto* fresh_leaf = static_cast<Leaf*>( os_memory::allocate_memory( sizeof( Leaf ) ) );
+		if ( !fresh_leaf )
+			return nullptr;
+		if ( !root[ root_index ].compare_exchange_strong( leaf, fresh_leaf, std::memory_order_acq_rel, std::memory_order_acquire ) )
+		{
+			os_memory::deallocate_memory( fresh_leaf, sizeof( Leaf ) );	 // 其他线程已安装 / Another thread won
+			return leaf;
+		}
+		return fresh_leaf;
+	}
+};
+
+using AddressPageMap = BasicAddressPageMap<16>;	 //!< 64 KiB 粒度，slab 判定 / 64 KiB granule, slab classification
+using MediumChunkMap = BasicAddressPageMap<20>;	 //!< 1 MiB 粒度，中块 chunk 索引 / 1 MiB granule, medium chunk index
+using TierPageMap = BasicAddressPageMap<12>;	 //!< 4 KiB 粒度，带头块的层级判定 / 4 KiB granule, tier classification of headered blocks
+
+/**
+ * @brief TierPageMap 的条目：一个字装下映射基址、层级、桶号与节点 / A TierPageMap entry: mapping base, tier, bucket and node in one word
+ *
+ * @details
+ * 基址按页对齐，低 12 位空出：位 0..2 为层级（1..4，与 owner_type 相同），位 3..10 为 Small 桶号；
+ * 48 位地址之上的 16 位为节点号。映射各自独占其 4 KiB 粒度，所以任意两个映射互不覆盖条目。
+ * - Small chunk 与 Medium arena 登记整段：块首由基址与块长（Small）或 1 MiB 对齐（Medium）算出；
+ * - Large / Huge 只登记前部 anchor_bytes：任何用户指针都落在块头之后这段内，基址即块头。
+ *
+ * The base is page aligned, leaving the low 12 bits free: bits 0..2 hold the tier (1..4, the same as owner_type) and
+ * bits 3..10 the Small bucket index; the 16 bits above the 48-bit address hold the node. Every mapping owns its 4 KiB
+ * granules, so no two mappings ever share an entry.
+ * - Small chunks and Medium arenas register their whole range: the block start follows from the base and the block
+ *   length (Small) or from the 1 MiB alignment (Medium);
+ * - Large / Huge register only their first anchor_bytes: every user pointer lies that close behind the header, and the
+ *   base is the header.
+ */
+struct TierPageEntry
+{
+	static constexpr std::uintptr_t TIER_MASK = 0x7;												  //!< 层级位 / Tier bits
+	static constexpr std::size_t	BUCKET_SHIFT = 3;												  //!< 桶号起始位 / First bucket-index bit
+	static constexpr std::uintptr_t BUCKET_MASK = 0xFF;												  //!< 桶号位宽 / Bucket-index width
+	static constexpr std::size_t	NODE_SHIFT = TierPageMap::ADDRESS_BITS;							  //!< 节点号起始位 / First node bit
+	static constexpr std::uintptr_t BASE_MASK = ( ( std::uintptr_t( 1 ) << NODE_SHIFT ) - 1 ) & ~( ( std::uintptr_t( 1 ) << TierPageMap::GRANULE_SHIFT ) - 1 );
+
+	std::uintptr_t value = 0;  //!< 0 表示不属于任何层级 / 0 means no tier owns the address
+
+	/// @brief 指针所在粒度的条目 / Entry of the granule holding pointer
+	static TierPageEntry of( const void* pointer ) noexcept
+	{
+		return { reinterpret_cast<std::uintptr_t>( TierPageMap::instance().find( pointer ) ) };
+	}
+
+	/**
+	 * @brief 为 [base, base + bytes) 登记条目 / Register the entry for [base, base + bytes)
+	 * @param numa_node  管理器的节点，ANY_NUMA_NODE 记为 0 / the manager's node, ANY_NUMA_NODE is stored as 0
+	 * @return 叶子申请失败返回 false / false if a leaf cannot be mapped
+	 */
+	static bool record( const void* base, std::size_t bytes, std::uint32_t tier, std::size_t numa_node, std::size_t bucket_index = 0 ) noexcept
+	{
+		const std::uintptr_t node = numa_node == os_memory::ANY_NUMA_NODE ? 0 : numa_node & 0xFFFF;
+		const std::uintptr_t entry = ( reinterpret_cast<std::uintptr_t>( base ) & BASE_MASK ) | ( node << NODE_SHIFT ) | ( ( bucket_index & BUCKET_MASK ) << BUCKET_SHIFT ) | tier;
+		return TierPageMap::instance().assign( base, bytes, reinterpret_cast<void*>( entry ) );
+	}
+
+	/// @brief 注销 [base, base + bytes)，须在解除映射之前 / Unregister [base, base + bytes); must happen before the unmap
+	static void erase( const void* base, std::size_t bytes ) noexcept
+	{
+		TierPageMap::instance().assign( base, bytes, nullptr );
+	}
+
+	/// @brief 整块映射需登记的前部字节 / Leading bytes a whole-block mapping registers
+	static constexpr std::size_t anchor_bytes( std::size_t header_bytes, std::size_t mapping_bytes ) noexcept
+	{
+		return std::min( mapping_bytes, header_bytes + NOT_ALIGN_HEADER_BYTES + ALIGN_HEADER_BYTES + MAX_ALLOWED_ALIGNMENT );
+	}
+
+	std::uint32_t tier() const noexcept
+	{
+		return static_cast<std::uint32_t>( value & TIER_MASK );
+	}
+	std::uint32_t node() const noexcept
+	{
+		return static_cast<std::uint32_t>( value >> NODE_SHIFT );
+	}
+	std::size_t bucket_index() const noexcept
+	{
+		return ( value >> BUCKET_SHIFT ) & BUCKET_MASK;
+	}
+	char* base() const noexcept
+	{
+		return reinterpret_cast<char*>( value & BASE_MASK );
+	}
+};
+
+namespace os_memory::memory_pool
+{
+	/**
+	 * @brief 编译期生成的 O(1) 尺寸类查找表 / Compile-time generated O(1) size-class lookup
+	 *
+	 * @details
+	 * 由升序桶尺寸表在编译期生成，映射结果与对该表做二分查找（首个 >= bytes 的桶，超出则落最后一桶）完全一致：
+	 * - bytes ≤ LINEAR_LIMIT_BYTES：按 8 字节步长直接索引；
+	 * - 更大的尺寸：用 bit_width（前导零计数）取 2 的幂区间，再取其后 SUB_BITS 位细分为 8 段查表，最后与一个桶边界比较一次。
+	 * 构造时校验前提（线性区桶尺寸为 8 的倍数、每段最多跨一个桶边界），不满足则无法通过编译期求值。
+	 *
+	 * Generated at compile time from an ascending bucket-size table. The mapping is identical to a binary search
+	 * over the table (first bucket >= bytes, clamped to the last bucket):
+	 * - bytes ≤ LINEAR_LIMIT_BYTES: direct index in 8-byte steps;
+	 * - larger sizes: bit_width (a leading-zero count) selects the power-of-two range, the next SUB_BITS bits split it
+	 *   into 8 slots for a table lookup, followed by a single compare against one bucket boundary.
+	 * The constructor checks its preconditions (linear-range sizes are multiples of 8, at most one bucket boundary per
+	 * slot); a table that violates them fails constant evaluation.
+	 *
+	 * @tparam BucketCount 桶数量（≤ 256）/ Number of buckets (≤ 256)
+	 */
+	template <std::size_t BucketCount>
+	struct BucketIndexLookup
+	{
+		static_assert( BucketCount > 0 && BucketCount <= 256, "bucket indices must fit in std::uint8_t" );
+
+		static constexpr std::size_t LINEAR_STEP_BYTES = 8;												  //!< 线性区步长 / Linear range step
+		static constexpr std::size_t LINEAR_LIMIT_BYTES = 1024;											  //!< 线性区上限 / Linear range limit
+		static constexpr std::size_t LINEAR_SLOTS = LINEAR_LIMIT_BYTES / LINEAR_STEP_BYTES + 1;			  //!< 线性区表项 / Linear slots
+		static constexpr std::size_t SUB_BITS = 3;														  //!< 每个 2 的幂区间的细分位 / Sub-bits per octave
+		static constexpr std::size_t SUB_COUNT = std::size_t( 1 ) << SUB_BITS;							  //!< 每个区间的细分段 / Slots per octave
+		static constexpr std::size_t FIRST_EXPONENT = std::bit_width( LINEAR_LIMIT_BYTES ) - 1;			  //!< 几何区首个指数 / First geometric exponent
+		static constexpr std::size_t EXPONENT_COUNT = std::numeric_limits<std::size_t>::digits - FIRST_EXPONENT;  //!< 几何区指数个数 / Geometric exponents
+
+		std::array<std::size_t, BucketCount>					  bucket_sizes {};		//!< 桶尺寸表副本 / Copy of the bucket sizes
+		std::array<std::uint8_t, LINEAR_SLOTS>					  linear_lookup {};		//!< 线性区索引 / Linear range indices
+		std::array<std::uint8_t, EXPONENT_COUNT * SUB_COUNT> geometric_lookup {};	//!< 几何区基准索引 / Geometric base indices
+
+		constexpr explicit BucketIndexLookup( const std::array<std::size_t, BucketCount>& sizes ) : bucket_sizes( sizes )
+		{
+			for ( std::size_t index = 0; index < BucketCount; ++index )
+			{
+				if ( index > 0 && sizes[ index ] <= sizes[ index - 1 ] )
+					throw "BucketIndexLookup: bucket sizes must be strictly ascending";
+				if ( sizes[ index ] < LINEAR_LIMIT_BYTES && sizes[ index ] % LINEAR_STEP_BYTES != 0 )
+					throw "BucketIndexLookup: linear-range bucket sizes must be multiples of LINEAR_STEP_BYTES";
+			}
+
+			for ( std::size_t slot = 0; slot < LINEAR_SLOTS; ++slot )
+				linear_lookup[ slot ] = static_cast<std::uint8_t>( search( sizes, slot * LINEAR_STEP_BYTES ) );
+
+			const std::size_t largest_bucket_bytes = sizes[ BucketCount - 1 ];
+			for ( std::size_t exponent = FIRST_EXPONENT; exponent < std::numeric_limits<std::size_t>::digits; ++exponent )
+			{
+				for ( std::size_t sub = 0; sub < SUB_COUNT; ++sub )
+				{
+					const std::size_t slot = ( exponent - FIRST_EXPONENT ) * SUB_COUNT + sub;
+					const std::size_t first_bytes = ( std::size_t( 1 ) << exponent ) + ( sub << ( exponent - SUB_BITS ) ) + 1;
+					if ( first_bytes > largest_bucket_bytes )
+					{
+						geometric_lookup[ slot ] = static_cast<std::uint8_t>( BucketCount - 1 );  // 由上限分支处理 / handled by the clamp
+						continue;
+					}
+
+					const std::size_t last_bytes = std::min( first_bytes - 1 + ( std::size_t( 1 ) << ( exponent - SUB_BITS ) ), largest_bucket_bytes );
+					const std::size_t base_index = search( sizes, first_bytes );
+					if ( search( sizes, last_bytes ) > base_index + 1 )
+						throw "BucketIndexLookup: more than one bucket boundary inside a lookup slot";
+					geometric_lookup[ slot ] = static_cast<std::uint8_t>( base_index );
+				}
+			}
+		}
+
+		/// @brief 参考映射：二分查找首个 >= bytes 的桶 / Reference mapping: binary search for the first bucket >= bytes
+		static constexpr std::size_t search( const std::array<std::size_t, BucketCount>& sizes, std::size_t bytes ) noexcept
+		{
+			std::size_t low = 0, high = BucketCount - 1;
+			while ( low < high )
+			{
+				const std::size_t middle = ( low + high ) >> 1;
+				if ( bytes <= sizes[ middle ] )
+					high = middle;
+				else
+					low = middle + 1;
+			}
+			return low;
+		}
+
+		/// @brief O(1) 查找 / O(1) lookup
+		constexpr std::size_t operator()( std::size_t bytes ) const noexcept
+		{
+			if ( bytes <= LINEAR_LIMIT_BYTES )
+				return linear_lookup[ ( bytes + LINEAR_STEP_BYTES - 1 ) / LINEAR_STEP_BYTES ];
+			if ( bytes > bucket_sizes[ BucketCount - 1 ] )
+				return BucketCount - 1;
+
+			const std::size_t value = bytes - 1;
+			const std::size_t exponent = static_cast<std::size_t>( std::bit_width( value ) ) - 1;
+			const std::size_t sub = ( value >> ( exponent - SUB_BITS ) ) & ( SUB_COUNT - 1 );
+			const std::size_t base_index = geometric_lookup[ ( exponent - FIRST_EXPONENT ) * SUB_COUNT + sub ];
+			return base_index + static_cast<std::size_t>( bytes > bucket_sizes[ base_index ] );
+		}
+	};
+}  // namespace os_memory::memory_pool
+
+/*------------------------------------------------------------------*\
+|  1. SmallMemoryManager — 64 桶 + TLS 弹匣 + 全局 ABA-safe 栈        |
 \*------------------------------------------------------------------*/
 struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallMemoryManager
 {
-	static constexpr std::size_t BUCKET_COUNT = 64;	 //!< 桶数量 / Number of buckets
+	/* ==========================================================
+        * 桶尺寸表来自构建时选择的尺寸类策略（默认 64 桶：前 32 线性 + 后 32 几何级数，最后落 1 MiB）
+        * The bucket table comes from the size-class policy chosen at build time
+        * (default 64 buckets: 32 linear + 32 geometric, ending at 1 MiB)
+        * ========================================================== */
+	static constexpr std::size_t BUCKET_COUNT = os_memory::memory_pool::ActiveSizeClassPolicy::BUCKET_SIZES.size();  //!< 桶数量 / Number of buckets
+	static constexpr std::array<std::size_t, BUCKET_COUNT> BUCKET_SIZES = os_memory::memory_pool::ActiveSizeClassPolicy::BUCKET_SIZES;
+
+	/* ==========================================================
+        * Slab 模式：尺寸 ≤ SLAB_BUCKET_LIMIT_BYTES 的桶不带逐对象头部
+        * Slab mode: buckets up to SLAB_BUCKET_LIMIT_BYTES carry no per-object header
+        * ========================================================== */
+	static constexpr std::size_t SLAB_BUCKET_LIMIT_BYTES = os_memory::memory_pool::SLAB_BUCKET_LIMIT_BYTES;  //!< 桶尺寸不超过该值的桶走 slab / Buckets up to this size use slabs
+	static constexpr std::size_t SLAB_BUCKET_COUNT = static_cast<std::size_t>( std::count_if( BUCKET_SIZES.begin(), BUCKET_SIZES.end(), []( std::size_t bucket_bytes ) { return bucket_bytes <= SLAB_BUCKET_LIMIT_BYTES; } ) );
+	static constexpr std::size_t SLAB_MAX_BLOCK_BYTES = BUCKET_SIZES[ SLAB_BUCKET_COUNT - 1 ];	 //!< slab 模式最大请求字节 / Largest request served by slabs
+
+	static constexpr std::size_t SLABS_PER_SEGMENT = 16;	 //!< 每次向系统申请的 slab 数 / Slabs mapped per OS request
 
 	/* ==========================================================
-        * 64-桶尺寸表 (前 32 线性 + 后 32 几何级数，最后落 1 MiB)
+        * 线程缓存弹匣：每桶容量按块尺寸封顶，并随使用热度从 MAGAZINE_MIN_BLOCKS 自适应增长
+        * Thread cache magazines: per-bucket capacity is capped by block size and the live limit
+        * grows adaptively from MAGAZINE_MIN_BLOCKS as the bucket gets hot
         * ========================================================== */
-	static constexpr std::array<std::size_t, BUCKET_COUNT> BUCKET_SIZES = { 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120, 128, 136, 144, 152, 160, 168, 176, 184, 192, 200, 208, 216, 224, 232, 240, 248, 256, 336, 432, 560, 728, 944, 1224, 1584, 2048, 2656, 3448, 4472, 5800, 7520, 9744, 12640, 16384, 21248, 27560, 35736, 46344, 60104, 77936, 101072, 131072, 169984, 220440, 285872, 370728, 480776, 623488, 808568, 1048576 };
+	static constexpr std::size_t MAGAZINE_MIN_BLOCKS = 4;				//!< 冷桶的初始弹匣容量 / Initial magazine size of a cold bucket
+	static constexpr std::size_t MAGAZINE_MAX_BLOCKS = 128;			//!< 弹匣块数上限 / Upper bound on blocks per magazine
+	static constexpr std::size_t MAGAZINE_MAX_BYTES = 256 * 1024;		//!< 单个弹匣缓存的字节上限 / Upper bound on bytes held by one magazine
+	static constexpr std::size_t MAGAZINE_SPARE_LIMIT = 8;				//!< 线程保留的空描述符上限 / Empty descriptors kept per thread
+	static constexpr std::size_t MAGAZINE_DEPOT_CHUNK_BYTES = 64 * 1024;  //!< 描述符仓库每次扩容字节数 / Depot growth per OS request
+
+	static constexpr std::array<std::size_t, BUCKET_COUNT> MAGAZINE_CAPACITIES = [] {
+		std::array<std::size_t, BUCKET_COUNT> capacities {};
+		for ( std::size_t index = 0; index < BUCKET_COUNT; ++index )
+			capacities[ index ] = std::clamp<std::size_t>( MAGAZINE_MAX_BYTES / BUCKET_SIZES[ index ], 1, MAGAZINE_MAX_BLOCKS );
+		return capacities;
+	}();
 
 	// -------- Thread-local 缓存 --------
+	/// @brief 线程缓存中的一个弹匣 / One magazine held by a thread cache
+	struct MagazineSlot
+	{
+		SmallFreeLink* head = nullptr;	//!< 首个空闲块 / First free block
+		SmallFreeLink* tail = nullptr;	//!< 末个空闲块 / Last free block
+		std::size_t	   count = 0;		//!< 块数量 / Number of blocks
+	};
+
+	/**
+	 * @brief 每个线程堆每桶的事件计数 / Per-heap, per-bucket event counters
+	 * @note 只有挂接线程写入（relaxed 读后写，无锁前缀），statistics() 在任意线程 relaxed 读取后汇总
+	 *       Only the attached thread writes (a relaxed load and store, no locked instruction); statistics() reads them
+	 *       relaxed from any thread and sums them up
+	 */
+	struct BucketCounters
+	{
+		std::atomic<std::uint64_t> allocations { 0 };	  //!< 分配次数 / Allocations
+		std::atomic<std::uint64_t> requested_bytes { 0 };  //!< 请求字节总和，对比桶尺寸即内部碎片 / Sum of requested bytes; against the bucket size it gives internal fragmentation
+		std::atomic<std::uint64_t> frees { 0 };			  //!< 释放次数 / Frees
+		std::atomic<std::uint64_t> cache_misses { 0 };	  //!< 两个弹匣都为空的分配 / Allocations that found both magazines empty
+		std::atomic<std::uint64_t> global_refills { 0 };	  //!< 从全局栈换入的满弹匣 / Full magazines taken from the global stacks
+		std::atomic<std::uint64_t> global_flushes { 0 };	  //!< 交给全局栈的满弹匣 / Full magazines handed to the global stacks
+		std::atomic<std::uint64_t> remote_frees { 0 };	  //!< 交还其他线程堆的释放 / Frees handed back to another thread's heap
+		std::atomic<std::uint64_t> carves { 0 };			  //!< 新切分的 chunk / slab / Fresh chunks or slabs carved
+
+		static void add( std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1 ) noexcept
+		{
+			counter.store( counter.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+		}
+	};
+
+	/**
+	 * @brief 每桶一对弹匣：loaded 供分配 / 释放，previous 为空或为满，避免在边界上来回换批
+	 *        A pair of magazines per bucket: loaded serves allocations and frees, previous is either empty or
+	 *        full so a thread oscillating at a batch boundary does not keep trading with the global bucket
+	 * @note 快路径只触碰首个缓存行：loaded、limit 与最常更新的计数 / The fast path only touches the first cache line: loaded, limit and the hottest counters
+	 */
+	struct alignas( CLASS_DEFAULT_ALIGNMENT ) CacheBucket
+	{
+		MagazineSlot   loaded;	  //!< 当前弹匣 / Current magazine
+		std::size_t	   limit = 0;	  //!< 当前弹匣容量，0 表示未初始化 / Current magazine size, 0 until first use
+		BucketCounters counters;  //!< 本桶事件计数 / Event counters of this bucket
+		MagazineSlot   previous;  //!< 备用弹匣 / Spare magazine
+	};
+
+	/**
+	 * @brief 线程本地注册表：本线程在各管理器上的线程堆 / Thread-local registry of this thread's heaps on every manager
+	 * @note 析构函数即线程退出钩子，把缓存交回各管理器的全局桶 / The destructor is the thread-exit hook that hands the caches back to each manager's global buckets
+	 */
 	struct ThreadLocalCache
 	{
-		SmallMemoryHeader* buckets[ BUCKET_COUNT ] = { nullptr };  //!< 每个桶的本地缓存 / Thread-local cache for each bucket
-		std::size_t		   deallocation_counter = 0;			   //!< 释放计数 / Deallocation counter
+		SmallThreadHeap* last_heap = nullptr;		  //!< 最近使用的线程堆 / Most recently used thread heap
+		SmallThreadHeap* heaps = nullptr;			  //!< 本线程持有的线程堆链 / Heaps held by this thread
+		SmallMagazine*	 spare_magazines = nullptr;  //!< 空描述符 / Empty magazine descriptors
+		std::size_t		 spare_count = 0;			  //!< 空描述符数量 / Number of empty descriptors
+
+		~ThreadLocalCache();
 	};
 	static thread_local ThreadLocalCache thread_local_cache;
 
 	// -------- 全局桶头 (ABA-safe) --------
-	struct alignas( CLASS_DEFAULT_ALIGNMENT ) PointerTag  // [FIX] 16 B 对齐，保证单指令 CAS
+	template <typename NodeType>
+	struct alignas( 2 * sizeof( void* ) ) BasicPointerTag  // 16 B 对齐，保证单指令 CAS / 16-byte aligned for a single-instruction CAS
 	{
-		SmallMemoryHeader* pointer;	 //!< 指向内存块的指针 / Pointer to memory block
-		std::uint64_t	   tag;		 //!< 标记 / Tag
+		NodeType*	  pointer;	//!< 指向节点的指针 / Pointer to node
+		std::uint64_t tag;		//!< 标记 / Tag
 	};
 
-	struct alignas( CLASS_DEFAULT_ALIGNMENT ) GlobalBucket
+	template <typename NodeType>
+	struct alignas( CLASS_DEFAULT_ALIGNMENT ) BasicGlobalBucket	 // 64 B 对齐，避免桶间伪共享 / 64-byte aligned against false sharing
 	{
 #if SUPPORT_128BIT_CAS
-		std::atomic<PointerTag> head;  //!< 原子头指针 / Atomic head pointer
+		std::atomic<BasicPointerTag<NodeType>> head;  //!< 原子头指针 / Atomic head pointer
 #else
-		std::atomic<SmallMemoryHeader*> head;	//!< 原子头指针 / Atomic head pointer
-		std::mutex						mutex;	//!< 互斥锁 / Mutex for synchronization
+		std::atomic<NodeType*> head;   //!< 原子头指针 / Atomic head pointer
+		std::mutex			   mutex;  //!< 互斥锁 / Mutex for synchronization
 #endif
 	};
-	std::array<GlobalBucket, BUCKET_COUNT> global_buckets;
+
+	using PointerTag = BasicPointerTag<SmallMagazine>;
+	using GlobalBucket = BasicGlobalBucket<SmallMagazine>;	//!< 满弹匣栈 / Stack of full magazines
+
+	/* ==========================================================
+        * 分片全局栈：每个尺寸类 GLOBAL_SHARD_COUNT 条，线程堆按挂接顺序轮流分配归属分片；
+        * 推入只进本分片，本分片为空时依次从其他分片窃取，满弹匣交换不再集中在同一个 16 B 头上
+        * Sharded global stacks: GLOBAL_SHARD_COUNT per size class, and thread heaps are handed a home shard
+        * round-robin as they attach; pushes only touch the home shard and a dry home shard steals from the
+        * others in turn, so magazine traffic no longer converges on one 16-byte head
+        * ========================================================== */
+	static constexpr std::size_t GLOBAL_SHARD_COUNT = 16;  //!< 每个尺寸类的分片上限 / Upper bound on shards per size class
+
+	/// @brief 一个尺寸类的全部分片 / Every shard of one size class
+	struct ShardedGlobalBucket
+	{
+		std::array<GlobalBucket, GLOBAL_SHARD_COUNT> shards;
+	};
+
+	std::array<ShardedGlobalBucket, BUCKET_COUNT>		global_buckets;
+	std::array<ShardedGlobalBucket, SLAB_BUCKET_COUNT> slab_global_buckets;
+
+	/// @brief 启用的分片数：不超过硬件线程数 / Shards in use: no more than the hardware threads
+	const std::size_t shard_count = std::clamp<std::size_t>( std::thread::hardware_concurrency(), 1, GLOBAL_SHARD_COUNT );
+	std::size_t		  next_shard = 0;  //!< 下一个新线程堆的归属分片，受 heap_mutex 保护 / Home shard of the next new heap, guarded by heap_mutex
+
+	static GlobalBucket magazine_depot;	 //!< 进程级空描述符仓库 / Process-wide depot of empty descriptors
+
+	// -------- 线程堆跟踪 --------
+	std::mutex		 heap_mutex;	   //!< 保护线程堆链 / Guards the heap list
+	SmallThreadHeap* heaps = nullptr;  //!< 本管理器的全部线程堆 / Every thread heap of this manager
 
 	// -------- 已分配 Chunk 跟踪 --------
-	std::mutex								   chunk_mutex;		  //!< 锁保护的已分配块 / Mutex for allocated chunks
-	std::vector<std::pair<void*, std::size_t>> allocated_chunks;  //!< 已分配的块 / Allocated chunks
+	/// @brief 带头块 chunk 记录 / Record of a headered-block chunk
+	struct SmallChunk
+	{
+		void*		  memory;		  //!< 起始地址 / Base address
+		std::size_t	  bytes;		  //!< 字节数 / Size in bytes
+		std::uint32_t bucket_index;	  //!< 所属桶 / Bucket it was carved for
+		std::uint32_t block_count;	  //!< 块数量 / Number of blocks
+		std::uint32_t idle_scan = 0;	  //!< 最近一次被观察到全空的清理轮次 / Last purge scan that saw it fully free
+		std::uint64_t idle_since = 0;  //!< 连续全空起始时间 (ns) / Start of the fully-free streak (ns)
+		std::uint32_t purge_held = 0;  //!< 清理时在手的空闲块数 / Free blocks a purge holds
+	};
+
+	std::mutex				chunk_mutex;	   //!< 锁保护的已分配块 / Mutex for allocated chunks
+	std::vector<SmallChunk> allocated_chunks;  //!< 已分配的块，按地址排序 / Allocated chunks, sorted by address
+
+	// -------- slab 段跟踪（受 chunk_mutex 保护）--------
+	std::vector<std::pair<void*, std::size_t>> slab_segments;				  //!< 已映射的 slab 段 / Mapped slab segments
+	std::vector<SmallSlabDescriptor*>		   purged_slabs;				  //!< 已归还物理页、可复用的 slab / Decommitted slabs ready for reuse
+	char*									   slab_carve_cursor = nullptr;  //!< 当前段中下一个未用 slab / Next unused slab in the current segment
+	char*									   slab_carve_end = nullptr;	 //!< 当前段中 slab 区域末尾 / End of the slab area in the current segment
+	std::size_t								   numa_node = os_memory::ANY_NUMA_NODE;  //!< 新 chunk / slab 段绑定的节点 / Node new chunks and slab segments are bound to
+	os_memory::MappingAccount*				   mapping_account = nullptr;			  //!< 所属池的映射计数 / Mapping counters of the owning pool
 
 	// ======================== 桶映射函数（保持外部接口名） ========================
-	[[nodiscard]] static std::size_t calculate_bucket_index( std::size_t bytes )
+	static constexpr os_memory::memory_pool::BucketIndexLookup<BUCKET_COUNT> BUCKET_INDEX_LOOKUP { BUCKET_SIZES };	//!< 编译期查找表 / Compile-time lookup table
+
+	/**
+	 * @brief 尺寸 → 桶索引，O(1) 查表 / Size → bucket index via O(1) table lookup
+	 * @note constexpr：编译期已知的尺寸可直接折叠为常量 / constexpr: compile-time sizes fold to a constant
+	 */
+	[[nodiscard]] static constexpr std::size_t calculate_bucket_index( std::size_t bytes ) noexcept
 	{
-		std::size_t low = 0, high = BUCKET_COUNT - 1;
-		while ( low < high )
-		{
-			const std::size_t middle = ( low + high ) >> 1;
-			if ( bytes <= BUCKET_SIZES[ middle ] )
-				high = middle;
-			else
-				low = middle + 1;
-		}
-		return low;
+		return BUCKET_INDEX_LOOKUP( bytes );
 	}
 
 	// ----------------------- 核心接口 -----------------------
@@ -186,14 +738,170 @@ struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallMemoryManager
 	void  deallocate( SmallMemoryHeader* header );
 	void  flush_thread_local_cache();
 	void  release_resources();
+
+	/// @brief 汇总各线程堆的桶计数与 chunk / slab 段用量 / Sum the bucket counters of every heap plus chunk and slab-segment usage
+	void collect_statistics( MemoryPoolStatistics& statistics );
+
+	/**
+	 * @brief 归还全空且空闲已久的 chunk / slab / Return chunks and slabs that have been fully free long enough
+	 *
+	 * @details
+	 * 逐桶取出全局栈上的全部满弹匣，按 chunk（或 slab）统计手中的空闲块；若某 chunk 的块全部在手且空闲时长达标，
+	 * 带头块 chunk 直接解除映射，slab 则归还物理页并留待任意尺寸类复用，其余块重新封装交回全局栈。
+	 * 仍在线程缓存中的块会让其 chunk 暂不满足条件。计数记在 SmallChunk / slab 描述符的 purge_held 上，不另行分配内存。
+	 *
+	 * Takes every full magazine off each global stack and counts the free blocks in hand per chunk (or slab), on
+	 * the purge_held field of the SmallChunk or slab descriptor so the pass allocates nothing.
+	 * A chunk whose blocks are all in hand and have been idle long enough is released: headered chunks are
+	 * unmapped, slabs are decommitted and kept for reuse by any size class. The remaining blocks are sealed
+	 * back into magazines. Blocks still sitting in thread caches keep their chunk alive for now.
+	 *
+	 * @param now_nanoseconds  当前时间 / current time
+	 * @param idle_nanoseconds chunk 需连续全空的时长，0 表示立即 / how long a chunk must have been fully free, 0 for immediately
+	 * @param scan             本轮清理序号 / sequence number of this purge scan
+	 * @return 归还的字节数 / bytes returned to the OS
+	 */
+	std::size_t purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan );
+
+	// ----------------------- slab 接口 -----------------------
+	/**
+	 * @brief 从 slab 桶分配一个无头对象 / Allocate a header-less object from a slab bucket
+	 * @param bytes 请求字节数（≤ SLAB_MAX_BLOCK_BYTES）/ requested bytes (≤ SLAB_MAX_BLOCK_BYTES)
+	 * @return 对象指针，即用户指针 / object pointer, which is the user pointer
+	 */
+	void* allocate_slab_object( std::size_t bytes );
+
+	/**
+	 * @brief 释放 slab 对象（允许内部指针）/ Free a slab object (interior pointers accepted)
+	 * @param slab    pointer 所在 slab 的描述符 / descriptor of the slab holding pointer
+	 * @param pointer 对象内任意地址 / any address inside the object
+	 */
+	void deallocate_slab_object( SmallSlabDescriptor* slab, void* pointer );
+
+	/**
+	 * @brief 批量分配同尺寸 slab 对象 / Allocate a batch of same-size slab objects
+	 * @param bytes  每个对象的请求字节数（≤ SLAB_MAX_BLOCK_BYTES）/ requested bytes per object (≤ SLAB_MAX_BLOCK_BYTES)
+	 * @param count  对象个数 / number of objects
+	 * @param out    接收对象指针的数组 / array receiving the object pointers
+	 *
+	 * @details 整段取走线程弹匣中的块，弹匣空时沿单对象路径补给一次，再继续成段取出；失败时已取出的对象全部归还后抛出。
+	 *          Takes whole runs out of the thread magazine and refills through the single-object path only when it
+	 *          runs dry; on failure every object already taken is returned before the exception propagates.
+	 */
+	void allocate_slab_batch( std::size_t bytes, std::size_t count, void** out );
+
+	/**
+	 * @brief 批量释放 slab 对象 / Free a batch of slab objects
+	 * @param pointers  find_slab 均已确认的对象指针 / object pointers that find_slab has already accepted
+	 * @param count     指针个数 / number of pointers
+	 *
+	 * @details 连续的、归属本线程的同桶对象先串成一段，整段接入弹匣或封成满弹匣推入全局栈。
+	 *          Consecutive same-bucket objects owned by this thread are chained first, then spliced into the magazine
+	 *          as one run or sealed into full magazines for the global stack.
+	 */
+	void deallocate_slab_batch( void* const* pointers, std::size_t count );
+
+	/**
+	 * @brief 批量分配同尺寸带头小块 / Allocate a batch of same-size headered small blocks
+	 * @param bytes  含 NotAlignHeader 的字节数 / bytes including the NotAlignHeader
+	 * @param count  块个数 / number of blocks
+	 * @param out    接收数据区指针的数组 / array receiving the data-area pointers
+	 */
+	void allocate_batch( std::size_t bytes, std::size_t count, void** out );
+
+	/// @brief 判定指针是否属于任何 slab，是则返回描述符 / Descriptor of the slab holding pointer, nullptr if none
+	static SmallSlabDescriptor* find_slab( const void* pointer )
+	{
+		if ( !AddressPageMap::instance().find( pointer ) )
+			return nullptr;
+		return SmallSlabDescriptor::from_pointer( pointer );
+	}
+
+private:
+	SmallSlabDescriptor* request_new_slab( std::size_t index, SmallThreadHeap& heap );
+	std::size_t			 purge_bucket( std::size_t index, bool slab_bucket, std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan );
+
+	/// @brief 块所在的带头 chunk，须持有 chunk_mutex / Headered chunk holding block; chunk_mutex must be held
+	SmallChunk* find_chunk( const void* block );
+
+	// ----------------------- 线程堆 / Thread heaps -----------------------
+	SmallThreadHeap& local_heap();
+	SmallThreadHeap* find_local_heap();
+	SmallThreadHeap& attach_heap();
+	void			 flush_heap( SmallThreadHeap& heap );
+	bool			 reclaim_remote_frees( CacheBucket& cache, GlobalBucket& bucket, std::size_t index, bool slab_bucket );
+	static void		 release_heap( SmallThreadHeap* heap );
+	static void		 push_remote( std::atomic<SmallFreeLink*>& remote, SmallFreeLink* block );
+
+	// ----------------------- 弹匣工具 / Magazine helpers -----------------------
+	SmallFreeLink*		  pop_cached( CacheBucket& cache, ShardedGlobalBucket& bucket, std::size_t shard, std::atomic<SmallFreeLink*>& remote, std::size_t capacity );
+	SmallMagazine*		  pop_sharded( ShardedGlobalBucket& bucket, std::size_t shard );
+	static void			  push_cached( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, SmallFreeLink* block );
+	static void			  push_cached_run( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, SmallFreeLink* head, SmallFreeLink* tail, std::size_t count );
+	static bool			  export_magazine( GlobalBucket& bucket, MagazineSlot& slot );
+	static void			  return_magazines( GlobalBucket& bucket );
+	static SmallMagazine* acquire_magazine();
+	static void			  retire_magazine( SmallMagazine* magazine );
+
+	template <typename NextBlock>
+	static void load_blocks( CacheBucket& cache, GlobalBucket& bucket, std::size_t capacity, NextBlock&& next_block );
+
+	template <typename NodeType>
+	static NodeType* pop_global( BasicGlobalBucket<NodeType>& bucket );
+
+	template <typename NodeType>
+	static void push_global_list( BasicGlobalBucket<NodeType>& bucket, NodeType* first, NodeType* last );
+};
+
+/**
+ * @brief 某线程在某个 SmallMemoryManager 上的私有堆 / A thread's private heap on one SmallMemoryManager
+ *
+ * @details
+ * 每个块记录切分它的线程堆。其他线程释放该块时，把它推入该堆的 MPSC 远程释放链（每桶一条），
+ * 所属线程在本地缓存缺失时一次性取走，因此生产者/消费者负载下内存回到生产者，而不是堆积在消费者的缓存里。
+ * 线程退出后堆被标记为未挂接，其缓存交回全局桶；之后的新线程会优先接管它。
+ * 引用计数由管理器与挂接线程各持一份，两者都放手后才归还操作系统。
+ *
+ * Every block records the thread heap that carved it. A thread freeing someone else's block pushes it onto
+ * that heap's MPSC remote-free list (one per bucket); the owner takes the whole list on a local cache miss,
+ * so producer/consumer workloads hand memory back to the producer instead of piling it up in the consumer's cache.
+ * When its thread exits the heap is marked detached and its cache goes back to the global buckets; the next new
+ * thread adopts it first. The manager and the attached thread each hold one reference, and the heap is only
+ * returned to the OS once both have let go.
+ */
+struct alignas( CLASS_DEFAULT_ALIGNMENT ) SmallThreadHeap
+{
+	std::atomic<SmallMemoryManager*> owner { nullptr };		 //!< 所属管理器，管理器释放后为 nullptr / Owning manager, nullptr once released
+	std::atomic<bool>				 attached { false };	 //!< 是否有线程挂接 / Whether a thread holds the heap
+	std::atomic<std::uint32_t>		 references { 0 };		 //!< 管理器 + 挂接线程 / Manager + attached thread
+	SmallThreadHeap*				 next_in_manager = nullptr;	 //!< 管理器的堆链 / Manager's heap list
+	SmallThreadHeap*				 next_in_thread = nullptr;	 //!< 线程的堆链 / Thread's heap list
+	std::size_t						 shard_index = 0;			 //!< 全局栈归属分片 / Home shard of the global stacks
+
+	SmallMemoryManager::CacheBucket buckets[ SmallMemoryManager::BUCKET_COUNT ];			  //!< 每个桶的本地缓存 / Thread-local cache for each bucket
+	SmallMemoryManager::CacheBucket slab_buckets[ SmallMemoryManager::SLAB_BUCKET_COUNT ];  //!< slab 桶的本地缓存 / Thread-local cache for slab buckets
+
+	alignas( CLASS_DEFAULT_ALIGNMENT ) std::atomic<SmallFreeLink*> remote_frees[ SmallMemoryManager::BUCKET_COUNT ] {};  //!< 远程释放链 / Remote-free lists
+	std::atomic<SmallFreeLink*> slab_remote_frees[ SmallMemoryManager::SLAB_BUCKET_COUNT ] {};							 //!< slab 远程释放链 / Slab remote-free lists
 };
 
+// 默认表的抽查；替换策略后不适用 / Spot checks of the default table; they do not apply once the policy is replaced
+static_assert( !std::is_same_v<os_memory::memory_pool::ActiveSizeClassPolicy, os_memory::memory_pool::DefaultSizeClassPolicy>
+			   || ( SmallMemoryManager::calculate_bucket_index( 0 ) == 0 && SmallMemoryManager::calculate_bucket_index( 8 ) == 0 && SmallMemoryManager::calculate_bucket_index( 9 ) == 1
+					&& SmallMemoryManager::calculate_bucket_index( 257 ) == 32 && SmallMemoryManager::calculate_bucket_index( 1025 ) == 37 && SmallMemoryManager::calculate_bucket_index( 1224 ) == 37
+					&& SmallMemoryManager::calculate_bucket_index( 1048576 ) == 63 && SmallMemoryManager::calculate_bucket_index( std::numeric_limits<std::size_t>::max() ) == 63 ) );
+static_assert( SmallMemoryManager::calculate_bucket_index( std::numeric_limits<std::size_t>::max() ) == SmallMemoryManager::BUCKET_COUNT - 1 );
+static_assert( os_memory::memory_pool::SizeHistogram::HEADERED_EXTRA_BYTES == NOT_ALIGN_HEADER_BYTES, "the histogram must charge headered buckets the real NotAlignHeader" );
+static_assert( SmallMemoryManager::BUCKET_COUNT <= TierPageEntry::BUCKET_MASK + 1, "the bucket index must fit its TierPageEntry bits" );
+
 // ============================ 中内存管理器 ============================
 struct MediumMemoryManager
 {
 	static constexpr std::size_t MIN_BUCKET_BYTES_UNIT = 1 << 20;  //!< 1 MiB / Minimum bucket bytss unit size
 	static constexpr int		 LEVEL_COUNT = 10;				   //!< 1 MiB–512 MiB / Number of levels
-	static constexpr std::size_t CHUNK_SIZE = 64ull << 20;		   // 64 MiB per chunk / Chunk size for OS allocation
+	static constexpr std::size_t CHUNK_SIZE = 64ull << 20;		   //!< 64 MiB：每次预留的最小 arena / Smallest arena reserved per OS request
+	static constexpr int		 ARENA_ORDER = std::countr_zero( CHUNK_SIZE / MIN_BUCKET_BYTES_UNIT );  //!< CHUNK_SIZE 对应的层级 / Order of CHUNK_SIZE
+	static_assert( std::has_single_bit( CHUNK_SIZE ) && ARENA_ORDER < LEVEL_COUNT, "CHUNK_SIZE must be a buddy order" );
 
 	struct alignas( CLASS_DEFAULT_ALIGNMENT ) PointerTag
 	{
@@ -214,27 +922,129 @@ struct MediumMemoryManager
 		int					order;
 	};
 
-	static constexpr size_t MERGE_QUEUE_SIZE = 128;
+	/**
+	 * @brief 伙伴合并在何处执行 / Where buddy merging is paid for
+	 * - ASYNCHRONOUS：释放入队，常驻工作线程批量合并（默认）/ frees enqueue, the persistent worker merges in batches (default)
+	 * - INLINE：释放线程立即合并 / the freeing thread merges immediately
+	 * - DEFERRED：释放入队，下一次中块分配时合并 / frees enqueue, the next medium allocation merges
+	 */
+	enum class MergePolicy : std::uint8_t
+	{
+		ASYNCHRONOUS,
+		INLINE,
+		DEFERRED
+	};
+
+	static constexpr std::size_t MERGE_QUEUE_SIZE = 1024;  //!< 2 的幂 / Power of two
+	static constexpr std::size_t MERGE_BATCH_SIZE = 32;	   //!< 工作线程每批处理数 / Requests merged per worker batch
+	static_assert( std::has_single_bit( MERGE_QUEUE_SIZE ), "MERGE_QUEUE_SIZE must be a power of two" );
+
+	/// @brief 有界 MPMC 环形队列（每格带序号）/ Bounded MPMC ring, one sequence number per cell
 	struct alignas( CLASS_DEFAULT_ALIGNMENT ) MergeQueue
 	{
-		std::atomic<MergeRequest> requests[ MERGE_QUEUE_SIZE ];	 //!< 固定大小环形缓冲区 / Fixed-size circular buffer
-		std::atomic<std::size_t>  head { 0 };
-		std::atomic<std::size_t>  tail { 0 };
+		struct MergeCell
+		{
+			std::atomic<std::size_t> sequence;	//!< 格位序号：== 位置可写，== 位置 + 1 可读 / == position: writable, == position + 1: readable
+			MergeRequest			 request;
+		};
+
+		MergeCell									 cells[ MERGE_QUEUE_SIZE ];
+		alignas( CLASS_DEFAULT_ALIGNMENT ) std::atomic<std::size_t> enqueue_position { 0 };
+		alignas( CLASS_DEFAULT_ALIGNMENT ) std::atomic<std::size_t> dequeue_position { 0 };
+
+		MergeQueue()
+		{
+			for ( std::size_t i = 0; i < MERGE_QUEUE_SIZE; ++i )
+				cells[ i ].sequence.store( i, std::memory_order_relaxed );
+		}
+
+		bool try_push( const MergeRequest& request );
+		bool try_pop( MergeRequest& request );
+		bool empty() const;
+	};
+
+	MergeQueue				 merge_queue;
+	std::atomic<MergePolicy> merge_policy { MergePolicy::ASYNCHRONOUS };
+	std::thread				 merge_worker;					  //!< 常驻合并线程，首次异步释放时启动 / Persistent merge thread, started on the first asynchronous free
+	std::mutex				 merge_mutex;					  //!< 保护线程启停与休眠 / Guards worker start/stop and sleeping
+	std::condition_variable	 merge_condition;				  //!< 唤醒休眠的工作线程 / Wakes the sleeping worker
+	std::atomic<bool>		 merge_worker_started { false };  //!< 工作线程已启动 / The worker has been started
+	std::atomic<bool>		 merge_worker_waiting { false };  //!< 工作线程正在等待 / The worker is waiting
+	bool					 merge_stop = false;			  //!< 停止请求（受 merge_mutex 保护）/ Stop request (guarded by merge_mutex)
+
+	/// @brief 已映射的 chunk；地址稳定，供 MediumChunkMap 无锁引用 / A mapped chunk; its address is stable so MediumChunkMap can reference it lock-free
+	struct MediumChunk
+	{
+		void*		mapping;		//!< 原始映射（含对齐余量）/ Raw mapping, alignment slack included
+		std::size_t mapping_bytes;	//!< 原始映射字节数 / Raw mapping bytes
+		char*		base;			//!< 按 MIN_BUCKET_BYTES_UNIT 对齐的块区起点 / Block area start, aligned to MIN_BUCKET_BYTES_UNIT
+		std::size_t bytes;			//!< 块区字节数 / Block area bytes
+		os_memory::PagePolicy page_policy;	//!< 实际得到的页策略 / Page policy actually obtained
+	};
+	static_assert( std::size_t( 1 ) << MediumChunkMap::GRANULE_SHIFT == MIN_BUCKET_BYTES_UNIT, "MediumChunkMap granule must match the chunk alignment" );
+
+	/// @brief 每阶事件计数，多线程 relaxed 累加 / Per-order event counters, relaxed increments from any thread
+	struct alignas( CLASS_DEFAULT_ALIGNMENT ) OrderCounters
+	{
+		std::atomic<std::uint64_t> allocations { 0 };  //!< 该阶分配次数 / Allocations of this order
+		std::atomic<std::uint64_t> frees { 0 };		   //!< 该阶释放次数 / Frees of this order
+		std::atomic<std::uint64_t> splits { 0 };		   //!< 该阶块被一分为二 / Blocks of this order split in half
+		std::atomic<std::uint64_t> merges { 0 };		   //!< 该阶伙伴对合并 / Buddy pairs of this order merged
 	};
 
-	MergeQueue		  merge_queue;
-	std::atomic<bool> merge_worker_active { false };
+	std::array<FreeList, LEVEL_COUNT>	   free_lists;
+	std::array<OrderCounters, LEVEL_COUNT> order_counters;
+	std::mutex						  chunk_mutex;
+	std::deque<MediumChunk>			  allocated_chunks;	 //!< deque：追加不移动已有记录 / deque: appending never moves existing records
 
-	std::array<FreeList, LEVEL_COUNT>		   free_lists;
-	std::mutex								   chunk_mutex;
-	std::vector<std::pair<void*, std::size_t>> allocated_chunks;
+	static constexpr std::size_t PURGE_KEEP_BYTES = 4096;  //!< 清理时保留块首页（块头所在页）/ First page kept committed on purge (it holds the header)
+
+	/// @brief 新 arena 的页策略；arena 不超过 512 MiB，EXPLICIT_1G 按 EXPLICIT_2M 处理 / Page policy of new arenas; arenas never exceed 512 MiB, so EXPLICIT_1G is treated as EXPLICIT_2M
+	std::atomic<os_memory::PagePolicy> page_policy { os_memory::PagePolicy::NORMAL };
+	std::size_t						   numa_node = os_memory::ANY_NUMA_NODE;  //!< 新 arena 绑定的节点 / Node new arenas are bound to
+	os_memory::MappingAccount*		   mapping_account = nullptr;			  //!< 所属池的映射计数 / Mapping counters of the owning pool
 
 	// ----------------------- 核心接口 -----------------------
 	void* allocate( std::size_t bytes, std::size_t alignment );
 	void  deallocate( MediumMemoryHeader* header );
 	void  release_resources();
 
+	/// @brief 汇总每阶计数、arena 用量与合并队列深度 / Collect per-order counters, arena usage and the merge-queue depth
+	void collect_statistics( MemoryPoolStatistics& statistics );
+
+	/// @brief 切换合并策略；离开入队策略时先清空队列 / Switch the merge policy; pending requests are drained when leaving a queueing policy
+	void set_merge_policy( MergePolicy policy );
+
+	/// @brief 在当前线程处理所有排队的合并请求 / Process every queued merge request on the calling thread
+	void drain_merge_queue();
+
+	/**
+	 * @brief 原地调整使用中块的大小 / Resize a block in use without moving it
+	 * @param header  使用中的块 / block in use
+	 * @param bytes   新的数据字节数（不含 MediumMemoryHeader）/ new data bytes, MediumMemoryHeader excluded
+	 * @return 成功返回 true；失败时块保持原样 / true on success; the block is unchanged on failure
+	 *
+	 * @details
+	 * 同阶直接成功；降阶返回 false 由调用方搬迁；扩大时块须是各级的左伙伴，且右伙伴空闲，逐级吸收。
+	 * Same order succeeds at once; a lower order returns false so the caller moves the block; growing requires the
+	 * block to be the left buddy at every level with a free right buddy, which is absorbed level by level.
+	 */
+	bool resize( MediumMemoryHeader* header, std::size_t bytes );
+
+	/**
+	 * @brief 归还空闲已久的块的数据页 / Decommit the data pages of blocks that have stayed free long enough
+	 * @param now_nanoseconds  当前时间 / current time
+	 * @param idle_nanoseconds 块需连续空闲的时长，0 表示立即 / how long a block must have stayed free, 0 for immediately
+	 * @param scan             本轮清理序号 / sequence number of this purge scan
+	 * @return 曾写入数据的块交还的字节数，上界：PAGES_MIXED 块按整块计；干净块照常 decommit 但不计入
+	 *         Bytes decommitted from blocks that held data, an upper bound since a PAGES_MIXED block counts whole;
+	 *         clean blocks are decommitted as well but not counted, their pages were most likely never committed
+	 */
+	std::size_t purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds, std::uint32_t scan );
+
 private:
+	bool recommit_block( MediumMemoryHeader* block );
+
 	static int order_from_size( std::size_t actual_byte_size )
 	{
 		std::size_t need = actual_byte_size;
@@ -289,24 +1099,21 @@ private:
 	MediumMemoryHeader* pop_block( int order );
 
 	/**
-	 * @brief 处理合并请求队列 / Processes the merge request queue
-	 * 
+	 * @brief 常驻合并线程主循环 / Main loop of the persistent merge worker
+	 *
 	 * @details
-	 * 此函数运行在专用合并工作线程中，持续处理异步合并请求队列。
-	 * 实现环形缓冲区的无锁消费逻辑，高效处理伙伴块合并请求。
-	 * 
-	 * This function runs in a dedicated merge worker thread, continuously processing
-	 * the asynchronous merge request queue. Implements lock-free consumption logic
-	 * for a circular buffer to efficiently handle buddy block merge requests.
+	 * 每次最多取 MERGE_BATCH_SIZE 个请求批量合并；队列为空时在 merge_condition 上休眠，
+	 * 由 wake_merge_worker 唤醒，release_resources 置 merge_stop 后退出。
 	 *
-	 * @note 环形缓冲区工作流程 / Circular buffer workflow:
-	 *       [头指针] → 待处理请求 → [尾指针]
-	 *       [Head] → pending requests → [Tail]
-	 *       缓冲区满时: (尾+1)%size == 头
-	 *       缓冲区空时: 头 == 尾
+	 * Takes up to MERGE_BATCH_SIZE requests per batch; sleeps on merge_condition while the queue is
+	 * empty, is woken by wake_merge_worker, and exits once release_resources sets merge_stop.
 	 */
 	void				process_merge_queue();
 
+	/// @brief 按需启动工作线程并在其休眠时唤醒 / Start the worker if needed and wake it if it sleeps
+	void				wake_merge_worker();
+	void				stop_merge_worker();
+
 	/**
 	 * @brief 尝试从空闲链表中移除特定内存块 / Attempts to remove a specific memory block from the free list
 	 * 
@@ -335,6 +1142,19 @@ private:
 	 */
 	bool				try_remove_from_freelist( MediumMemoryHeader* header, int order );
 
+	static constexpr std::size_t TAKE_SCAN_LIMIT = 8;  //!< take_from_freelist 最多弹出的块数 / Most blocks take_from_freelist pops
+
+	/**
+	 * @brief 从空闲链表摘下指定块，不要求它是头节点 / Unlink a given block from its free list, head or not
+	 * @details 先按头节点 CAS 摘除；否则最多弹出 TAKE_SCAN_LIMIT 个块寻找目标，再把其余块推回。
+	 *          代价有界且不分配内存，其他线程只会短暂看不到这几个块。
+	 *          Tries the head-node CAS first; otherwise pops at most TAKE_SCAN_LIMIT blocks looking for the target and
+	 *          pushes the rest back. The cost is bounded, nothing is allocated, and other threads miss only those few
+	 *          blocks for a moment.
+	 * @return 找到并摘下返回 true；目标更深时返回 false / true if the block was found and unlinked; false when it sits deeper
+	 */
+	bool				take_from_freelist( MediumMemoryHeader* header, int order );
+
 	/**
 	 * @brief 尝试合并伙伴内存块 / Attempts to merge buddy memory blocks
 	 * 
@@ -374,7 +1194,7 @@ private:
 	 * @param block      指向要分割的内存块头部的指针 / Pointer to the memory block header to split
 	 * @param from_order 当前块的层级 / Current order of the block
 	 * @param to_order   目标分割层级 / Target order to split to
-	 * @return           分割后剩余的左侧块头部指针 / Pointer to the left block header after splitting
+	 * @return           分割后剩余的左侧块头部指针；提交块头页失败时放回空闲链表并返回 nullptr / Pointer to the left block header after splitting; nullptr (block back on a free list) if a header page cannot be committed
 	 *
 	 * @note 内存布局示例 / Memory layout example:
 	 *       分割前 (Before split): 
@@ -388,18 +1208,103 @@ private:
 	 *          |←─────── size_from_order(from_order) ───────→|
 	 */
 	MediumMemoryHeader* split_to_order( MediumMemoryHeader* block, int from_order, int to_order );
-	MediumMemoryHeader* request_new_chunk( int min_order, std::size_t alignment );
+
+	/**
+	 * @brief 把取出的空闲块切到目标层级、提交数据页并标记占用 / Split a popped free block to the target order, commit its data pages and mark it in use
+	 * @return 失败时块已放回空闲链表并返回 nullptr / nullptr on failure, the block is back on a free list
+	 */
+	MediumMemoryHeader* take_block( MediumMemoryHeader* block, int from_order, int to_order );
+
+	/**
+	 * @brief 预留一个 size_from_order(arena_order) 的 arena / Reserve an arena of size_from_order(arena_order)
+	 * @return 覆盖整个 arena 的空闲块，仅块头页已提交 / A free block spanning the arena with only its header page committed
+	 */
+	MediumMemoryHeader* request_new_chunk( int arena_order, std::size_t alignment );
 };
 
 /*------------------------------------------------------------------*/
+/**
+ * @brief 大块管理器：整块直接映射，释放的映射按尺寸类缓存复用 / Large manager: whole-block mappings, freed mappings cached per size class
+ *
+ * @details
+ * 映射按 CACHE_GRANULE 取整成尺寸类；释放时放入该类的 LRU 链表，下次同类分配直接复用，省去 mmap/munmap 与缺页清零。
+ * 缓存受字节预算约束（超出时淘汰最旧的映射），并在存放超过 decay 时长后于下一次分配/释放或 purge 时归还。
+ * 活跃块与缓存块都挂在侵入式双向链表上，释放为 O(1)。
+ *
+ * Mappings are rounded up to CACHE_GRANULE size classes. A freed mapping goes onto its class's LRU list and the next
+ * allocation of that class reuses it, skipping mmap/munmap and page zeroing. The cache has a byte budget (the oldest
+ * mappings are evicted when it is exceeded) and mappings older than the decay period are returned on the next
+ * allocate/deallocate or purge. Active and cached blocks live on intrusive doubly linked lists, so free is O(1).
+ */
 struct LargeMemoryManager
 {
-	std::mutex						tracking_mutex;
-	std::vector<LargeMemoryHeader*> active_blocks;
+	static constexpr std::size_t   CACHE_GRANULE = 64ull << 20;						   //!< 尺寸类粒度 64 MiB / 64 MiB size-class granule
+	static constexpr std::size_t   CACHE_CLASS_COUNT = 17;							   //!< 覆盖至 1 GiB + 头部 / Covers up to 1 GiB plus the header
+	static constexpr std::size_t   DEFAULT_CACHE_BUDGET_BYTES = 2ull << 30;			   //!< 默认缓存预算 2 GiB / Default cache budget, 2 GiB
+	static constexpr std::uint64_t DEFAULT_CACHE_DECAY_NANOSECONDS = 10'000'000'000ull;  //!< 默认 10 秒衰减 / Default decay, 10 seconds
+
+	/// @brief 侵入式双向链表 / Intrusive doubly linked list
+	struct BlockList
+	{
+		LargeMemoryHeader* head = nullptr;	//!< 最新 / Newest
+		LargeMemoryHeader* tail = nullptr;	//!< 最旧 / Oldest
+
+		void push_front( LargeMemoryHeader* header );
+		void remove( LargeMemoryHeader* header );
+	};
+
+	std::mutex								 tracking_mutex;  //!< 保护以下所有链表与计数 / Guards every list and counter below
+	BlockList								 active_blocks;	  //!< 使用中的块 / Blocks in use
+	std::array<BlockList, CACHE_CLASS_COUNT> cached_blocks;	  //!< 每个尺寸类的空闲映射 / Free mappings per size class
+	std::size_t								 cached_bytes = 0;
+	std::size_t								 cache_budget_bytes = DEFAULT_CACHE_BUDGET_BYTES;
+	std::uint64_t							 allocation_count = 0;  //!< 分配次数 / Allocations
+	std::uint64_t							 free_count = 0;		  //!< 释放次数 / Frees
+	std::uint64_t							 cache_hit_count = 0;	  //!< 命中映射缓存的分配 / Allocations served from the mapping cache
+	std::uint64_t							 remap_count = 0;		  //!< mremap 次数 / mremap calls
+	std::uint64_t							 cache_decay_nanoseconds = DEFAULT_CACHE_DECAY_NANOSECONDS;
+	std::atomic<os_memory::PagePolicy>		 page_policy { os_memory::PagePolicy::NORMAL };	 //!< 新映射的页策略 / Page policy of new mappings
+	std::size_t								 numa_node = os_memory::ANY_NUMA_NODE;			 //!< 新映射绑定的节点 / Node new mappings are bound to
+	os_memory::MappingAccount*				 mapping_account = nullptr;						 //!< 所属池的映射计数 / Mapping counters of the owning pool
 
 	void* allocate( std::size_t bytes, std::size_t alignment );
 	void  deallocate( LargeMemoryHeader* header );
 	void  release_resources();
+	void  collect_statistics( MemoryPoolStatistics& statistics );
+
+	/**
+	 * @brief 用 mremap 调整映射，页表项迁移而数据不复制 / Resize the mapping with mremap; page-table entries move, data is not copied
+	 * @return 新块头（可能移动），失败返回 nullptr 且原块不变 / new header (possibly moved), nullptr on failure with the block unchanged
+	 */
+	LargeMemoryHeader* resize( LargeMemoryHeader* header, std::size_t bytes );
+
+	/**
+	 * @brief 设置映射缓存策略 / Configure the mapping cache
+	 * @param budget_bytes       缓存字节上限，0 表示关闭缓存 / cache byte budget, 0 disables caching
+	 * @param decay_nanoseconds  映射在缓存中最多停留的时长 / longest time a mapping stays cached
+	 */
+	void set_cache_policy( std::size_t budget_bytes, std::uint64_t decay_nanoseconds );
+
+	/**
+	 * @brief 归还缓存中停留至少 idle_nanoseconds 的映射 / Unmap cached mappings that have been idle for at least idle_nanoseconds
+	 * @return 归还的字节数 / bytes unmapped
+	 */
+	std::size_t purge( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds );
+
+private:
+	static std::size_t cache_class( std::size_t mapping_bytes )
+	{
+		return mapping_bytes / CACHE_GRANULE - 1;
+	}
+
+	/// @brief 摘下空闲够久的缓存映射，经 next 串成单链返回 / Unlink cached mappings idle long enough, chained through next
+	LargeMemoryHeader* take_expired( std::uint64_t now_nanoseconds, std::uint64_t idle_nanoseconds );
+
+	/// @brief 摘下全局最旧的缓存映射 / Unlink the oldest cached mapping
+	LargeMemoryHeader* take_oldest();
+
+	/// @brief 在锁外解除映射整条链 / Unmap a whole chain outside the lock
+	std::size_t unmap_chain( LargeMemoryHeader* chain );
 };
 
 /*------------------------------------------------------------------*/
@@ -407,20 +1312,205 @@ struct HugeMemoryManager
 {
 	std::mutex								   tracking_mutex;
 	std::vector<std::pair<void*, std::size_t>> active_blocks;
+	std::uint64_t							   allocation_count = 0;  //!< 受 tracking_mutex 保护 / Guarded by tracking_mutex
+	std::uint64_t							   free_count = 0;
+	std::uint64_t							   remap_count = 0;
+	std::atomic<os_memory::PagePolicy>		   page_policy { os_memory::PagePolicy::NORMAL };  //!< 新映射的页策略 / Page policy of new mappings
+	std::size_t								   numa_node = os_memory::ANY_NUMA_NODE;			 //!< 新映射绑定的节点 / Node new mappings are bound to
+	os_memory::MappingAccount*				   mapping_account = nullptr;						 //!< 所属池的映射计数 / Mapping counters of the owning pool
 
 	void* allocate( std::size_t bytes, std::size_t alignment );
 	void  deallocate( HugeMemoryHeader* header );
 	void  release_resources();
+	void  collect_statistics( MemoryPoolStatistics& statistics );
+
+	/// @brief 同 LargeMemoryManager::resize / Same as LargeMemoryManager::resize
+	HugeMemoryHeader* resize( HugeMemoryHeader* header, std::size_t bytes );
+};
+
+// ============================ 统计快照 ============================
+/**
+ * @brief 内存池统计快照 / Memory pool statistics snapshot
+ *
+ * @details
+ * 由 MemoryPool::statistics() 在读取时汇总：Small 层来自各线程堆的单写者计数，Medium 层来自每阶 relaxed 原子计数，
+ * Large / Huge 层来自各自 tracking_mutex 保护的计数。分配热路径上不因统计多出任何带锁前缀的指令。
+ * 各计数只增不减；快照之间相减即得速率。读取与分配并发时各字段之间不保证彼此一致。
+ *
+ * Aggregated on read by MemoryPool::statistics(): the Small tier from single-writer counters in every thread heap,
+ * the Medium tier from relaxed per-order atomics, Large / Huge from counters guarded by their tracking_mutex.
+ * Statistics add no locked instruction to the allocation fast path. Counters only grow, so subtracting two
+ * snapshots yields rates. Fields are not mutually consistent while allocations run concurrently with the read.
+ */
+struct MemoryPoolStatistics
+{
+	/// @brief 一个 Small 尺寸类 / One Small size class
+	struct SmallBucket
+	{
+		std::size_t	  block_bytes = 0;	  //!< 桶尺寸 / Bucket size
+		std::uint64_t allocations = 0;
+		std::uint64_t frees = 0;
+		std::uint64_t requested_bytes = 0;  //!< 请求字节总和 / Sum of requested bytes
+		std::uint64_t cache_misses = 0;	  //!< 本线程两个弹匣都为空 / Both thread magazines were empty
+		std::uint64_t global_refills = 0;   //!< 从全局栈换入的满弹匣 / Full magazines taken from the global stacks
+		std::uint64_t global_flushes = 0;   //!< 交给全局栈的满弹匣 / Full magazines handed to the global stacks
+		std::uint64_t remote_frees = 0;	  //!< 交还其他线程堆的释放 / Frees handed back to another thread's heap
+		std::uint64_t carves = 0;		  //!< 新切分的 chunk / slab / Fresh chunks or slabs carved
+
+		/// @brief 线程缓存命中率 / Thread-cache hit rate
+		double thread_cache_hit_rate() const
+		{
+			return allocations ? 1.0 - static_cast<double>( cache_misses ) / static_cast<double>( allocations ) : 0.0;
+		}
+
+		/// @brief 内部碎片：桶尺寸中未被请求的比例 / Internal fragmentation: share of the bucket size nobody asked for
+		double internal_fragmentation() const
+		{
+			const double carried = static_cast<double>( allocations ) * static_cast<double>( block_bytes );
+			return carried > 0.0 ? 1.0 - static_cast<double>( requested_bytes ) / carried : 0.0;
+		}
+	};
+
+	/// @brief 一个 Medium 伙伴阶 / One Medium buddy order
+	struct MediumOrder
+	{
+		std::size_t	  block_bytes = 0;
+		std::uint64_t allocations = 0;
+		std::uint64_t frees = 0;
+		std::uint64_t splits = 0;  //!< 该阶块被一分为二 / Blocks of this order split in half
+		std::uint64_t merges = 0;  //!< 该阶伙伴对合并 / Buddy pairs of this order merged
+	};
+
+	struct Large
+	{
+		std::uint64_t allocations = 0;
+		std::uint64_t frees = 0;
+		std::uint64_t cache_hits = 0;  //!< 命中映射缓存 / Served from the mapping cache
+		std::uint64_t remaps = 0;
+		std::size_t	  active_blocks = 0;
+		std::size_t	  active_bytes = 0;	 //!< 使用中映射的字节数 / Bytes of mappings in use
+		std::size_t	  cached_blocks = 0;
+		std::size_t	  cached_bytes = 0;
+	};
+
+	struct Huge
+	{
+		std::uint64_t allocations = 0;
+		std::uint64_t frees = 0;
+		std::uint64_t remaps = 0;
+		std::size_t	  active_blocks = 0;
+		std::size_t	  active_bytes = 0;
+	};
+
+	std::array<SmallBucket, SmallMemoryManager::BUCKET_COUNT>		 small_buckets {};	//!< 带头块 / Headered blocks
+	std::array<SmallBucket, SmallMemoryManager::SLAB_BUCKET_COUNT> slab_buckets {};	//!< 无头 slab 对象 / Header-less slab objects
+	std::size_t													 small_chunks = 0;
+	std::size_t													 small_chunk_bytes = 0;
+	std::size_t													 slab_segments = 0;
+	std::size_t													 slab_segment_bytes = 0;
+	std::size_t													 small_thread_heaps = 0;
+
+	std::array<MediumOrder, MediumMemoryManager::LEVEL_COUNT> medium_orders {};
+	std::size_t												  medium_chunks = 0;
+	std::size_t												  medium_chunk_bytes = 0;
+	std::size_t												  merge_queue_depth = 0;  //!< 排队中的合并请求 / Pending merge requests
+
+	Large large;
+	Huge  huge;
+
+	std::uint64_t pool_mapped_bytes = 0;	 //!< 本池（各分片之和）经 *_tracked 映射的字节 / Bytes this pool (summed over its shards) maps through the *_tracked functions
+	std::uint64_t os_mapped_bytes = 0;	 //!< 进程级 used_memory_bytes_counter / Process-wide used_memory_bytes_counter
+	std::int64_t  os_net_operations = 0;	 //!< 进程级 user_operation_counter / Process-wide user_operation_counter
+
+	/// @brief 叠加另一个分片的快照；进程级字段不重复相加 / Add another shard's snapshot; process-wide fields are not added twice
+	void accumulate( const MemoryPoolStatistics& other );
+
+	/// @brief 写出 JSON 对象；全零的尺寸类省略 / Write one JSON object; size classes without any activity are omitted
+	void write_json( std::ostream& output ) const;
+
+	/**
+	 * @brief 写出 Prometheus 文本格式 / Write the Prometheus text exposition format
+	 * @param prefix  指标名前缀 / metric name prefix
+	 * @note 全零的尺寸类省略 / Size classes without any activity are omitted
+	 */
+	void write_prometheus( std::ostream& output, std::string_view prefix = "memory_pool" ) const;
+};
+
+/**
+ * @brief 预热清单：每个尺寸类预先备好的块数 / Pre-warming profile: blocks to have ready per size class
+ *
+ * @details
+ * 由 MemoryPool::reserve 消费。下标与 MemoryPoolStatistics 的数组一致：slab_blocks 对应无头 slab 桶，
+ * small_blocks 只取 SLAB_BUCKET_COUNT 及以后的带头桶（更小的带头桶只服务超对齐请求，不预热），
+ * medium_blocks 对应伙伴阶；0 阶块只由拆分产生，不单独预热。
+ *
+ * Consumed by MemoryPool::reserve. Indices match the arrays of MemoryPoolStatistics: slab_blocks are the
+ * header-less slab buckets, small_blocks only uses the headered buckets from SLAB_BUCKET_COUNT on (smaller
+ * headered buckets only serve over-aligned requests and are not pre-warmed), and medium_blocks are the buddy
+ * orders; order-0 blocks only ever come from splits and are not pre-warmed on their own.
+ */
+struct ReserveProfile
+{
+	std::array<std::size_t, SmallMemoryManager::SLAB_BUCKET_COUNT> slab_blocks {};
+	std::array<std::size_t, SmallMemoryManager::BUCKET_COUNT>		small_blocks {};
+	std::array<std::size_t, MediumMemoryManager::LEVEL_COUNT>		medium_blocks {};
+
+	bool prefault = true;			  //!< 逐页写入一次，缺页在 reserve 内发生 / Write every page once so page faults happen inside reserve
+	bool fill_thread_cache = false;  //!< 调用线程的弹匣保持装满，而不是全部交给全局栈 / Keep the calling thread's magazines full instead of handing everything to the global stacks
+
+	/**
+	 * @brief 由上一次运行的统计快照得出清单 / Derive a profile from a previous run's statistics snapshot
+	 * @param snapshot  应在稳态、峰值附近取得 / should be taken at steady state, near the peak
+	 * @param scale     每类块数的倍率 / multiplier applied to every class
+	 * @return 每类取快照时仍在使用的块数（allocations - frees）乘以 scale / blocks in use per class at snapshot time (allocations - frees), times scale
+	 */
+	static ReserveProfile from_statistics( const MemoryPoolStatistics& snapshot, double scale = 1.0 );
+
+	/// @brief 写出 "slab|small|medium 下标 块数" 文本行，省略零项 / Write "slab|small|medium index blocks" text lines, zero entries omitted
+	void write( std::ostream& output ) const;
+
+	/**
+	 * @brief 读回 write 的输出 / Read back what write produced
+	 * @return 无法识别的行与越界下标被跳过 / unrecognised lines and out-of-range indices are skipped
+	 */
+	static ReserveProfile read( std::istream& input );
+
+	/// @brief 全部块数之和 / Sum of every block count
+	std::size_t total_blocks() const;
+};
+
+// ============================ 内存上限 / Memory limits ============================
+/**
+ * @brief 交给压力回调的事件 / Event handed to memory pressure callbacks
+ * @note 字节数均以所属池的 mapping_account 计：该池已映射（含仅预留）的字节
+ *       Every byte count is measured on the owning pool's mapping_account: bytes that pool has mapped, reservations included
+ */
+struct MemoryPressureEvent
+{
+	std::size_t used_bytes = 0;		   //!< 调用回调时的已映射字节 / Bytes mapped when the callbacks run
+	std::size_t requested_bytes = 0;   //!< 触发本轮回收的请求，手动回收为 0 / Request that triggered the pass, 0 for a manual pass
+	std::size_t soft_limit_bytes = 0;  //!< 0 表示未设 / 0 when unset
+	std::size_t hard_limit_bytes = 0;  //!< 0 表示未设 / 0 when unset
+	bool		hard = false;		   //!< 不回收就会越过硬上限 / The request would cross the hard limit unless memory is reclaimed
 };
 
+/**
+ * @brief 压力回调：收缩应用自身的缓存 / Pressure callback: shrink the application's own caches
+ * @details 可以释放池内存；回调里的分配不会再次触发回收。回调在回收上下文中同步运行，应尽快返回。
+ *          It may free pool memory; allocations made inside it never trigger another pass. It runs synchronously in
+ *          the reclaiming context and should return quickly.
+ */
+using MemoryPressureCallback = void ( * )( const MemoryPressureEvent& event, void* context );
+
 // ============================ MemoryPool 主类 ============================
 class MemoryPool
 {
 private:
 	// ------------------ 层级尺寸阈值 ------------------
-	static constexpr std::size_t SMALL_BLOCK_MAX_SIZE = 1 * 1024 * 1024;		 //!< 1 MiB (含) / Up to 1 MiB
-	static constexpr std::size_t MEDIUM_BLOCK_MAX_SIZE = 512 * 1024 * 1024;		 //!< 512 MiB (含) / Up to 512 MiB
-	static constexpr std::size_t HUGE_BLOCK_THRESHOLD = 1 * 1024 * 1024 * 1024;	 //!< 1 GiB (含) / Up to 1 GiB
+	// 来自尺寸类策略，默认 1 MiB / 512 MiB / 1 GiB（含）/ From the size-class policy, 1 MiB / 512 MiB / 1 GiB inclusive by default
+	static constexpr std::size_t SMALL_BLOCK_MAX_SIZE = os_memory::memory_pool::ActiveSizeClassPolicy::SMALL_BLOCK_MAX_SIZE;
+	static constexpr std::size_t MEDIUM_BLOCK_MAX_SIZE = os_memory::memory_pool::ActiveSizeClassPolicy::MEDIUM_BLOCK_MAX_SIZE;
+	static constexpr std::size_t HUGE_BLOCK_THRESHOLD = os_memory::memory_pool::ActiveSizeClassPolicy::HUGE_BLOCK_THRESHOLD;
 
 	// ======================== 成员实例 ========================
 	SmallMemoryManager	small_manager;	 //!< 小内存管理器实例 / Small memory manager instance
@@ -428,16 +1518,470 @@ private:
 	LargeMemoryManager	large_manager;	 //!< 大内存管理器实例 / Large memory manager instance
 	HugeMemoryManager	huge_manager;	 //!< 超大内存管理器实例 / Huge memory manager instance
 
+	os_memory::MappingAccount mapping_account;	//!< 本池各层经 *_tracked 映射的字节与次数 / Bytes and mappings this pool's tiers hold through the *_tracked functions
+
 	std::atomic<bool>		 is_destructing { false };	  //!< 析构标记 / Destruction flag
 	static std::atomic<bool> construction_warning_shown;  //!< 构造警告是否已显示 / Whether construction warning has been shown
+	static std::atomic<void ( * )()> worker_thread_hook;  //!< 后台线程启动时调用 / Called when a background thread starts
+	std::uint32_t			 node_index = 0;				  //!< 写入 NotAlignHeader::owner_node 的节点号 / Node number written to NotAlignHeader::owner_node
+
+	// ------------------ 内存上限 / Memory limits ------------------
+	static constexpr std::size_t MAX_PRESSURE_CALLBACKS = 16;  //!< 可登记的压力回调数 / Pressure callbacks that can be registered
+	static constexpr std::size_t PRESSURE_REARM_FRACTION = 8;  //!< 回收后仍超软上限时，再增长 soft / 8 才重新回收 / Still above the soft limit after a pass, the next pass waits for another soft / 8 of growth
+
+	std::atomic<std::uint64_t> soft_limit_bytes { 0 };								  //!< 0 表示未设 / 0 when unset
+	std::atomic<std::uint64_t> hard_limit_bytes { 0 };								  //!< 0 表示未设 / 0 when unset
+	std::atomic<std::uint64_t> pressure_threshold_bytes { ~std::uint64_t( 0 ) };	  //!< 快路径比较的门槛：min(重新布防的软上限, 硬上限) / Fast-path threshold: min(re-armed soft limit, hard limit)
+	std::mutex				   pressure_mutex;										  //!< 同一时刻只有一轮回收 / One reclamation pass at a time
+	std::mutex				   pressure_callback_mutex;								  //!< 保护回调表 / Guards the callback table
+	std::array<std::pair<MemoryPressureCallback, void*>, MAX_PRESSURE_CALLBACKS> pressure_callbacks {};
+
+	/**
+	 * @brief 分配越过门槛时的慢路径：按需回收，越过硬上限时拒绝 / Slow path of an allocation past the threshold: reclaim as needed, refuse past the hard limit
+	 * @return 允许分配返回 true；nothrow 下拒绝返回 false / true to go ahead; false for a refusal under nothrow
+	 * @throw std::bad_alloc 回收后仍会越过硬上限 / when the request still crosses the hard limit after reclaiming
+	 */
+	bool admit_under_pressure( std::size_t bytes, bool nothrow );
+
+	/**
+	 * @brief 逐级回收直到 已映射 + bytes 不超过 target_bytes / Reclaim step by step until mapped + bytes fits in target_bytes
+	 * @note 调用方持有 pressure_mutex / The caller holds pressure_mutex
+	 * @return 各步归还的字节数 / bytes the steps returned
+	 */
+	std::size_t reclaim_memory( std::size_t bytes, std::uint64_t target_bytes, bool hard );
+
+	/// @brief 按当前上限与已映射字节重新计算门槛 / Recompute the threshold from the limits and the bytes mapped now
+	void rearm_pressure_threshold();
+
+	// ------------------ 空闲归还 / Purging ------------------
+	std::atomic<std::uint32_t> purge_scan_counter { 1 };  //!< 清理轮次，首轮为 2（0 表示从未观察到）/ Purge round, first round is 2 (0 means never observed)
+	std::mutex				   purge_mutex;				  //!< 保护后台线程启停 / Guards purger start/stop
+	std::condition_variable	   purge_condition;			  //!< 唤醒/停止后台线程 / Wakes or stops the purger
+	std::thread				   purge_thread;			  //!< 后台清理线程（可选）/ Optional background purger
+	bool					   purge_stop = false;		  //!< 停止请求 / Stop request
+
+	/**
+	 * @brief 对 Small/Medium 与 Large 映射缓存做一次清理 / Run one purge pass over Small, Medium and the Large mapping cache
+	 * @param idle_period  块或缓存映射需要连续空闲的时长 / how long a block or cached mapping must stay idle
+	 * @return 归还给 OS 的字节数（Medium 部分按其 purge 的口径）/ bytes returned to the OS, the Medium share as its purge counts it
+	 */
+	std::size_t purge( std::chrono::nanoseconds idle_period );
+
+	void stop_purge_thread();
+
+	/**
+	 * @brief allocate 的主体：校验对齐并选择 slab、层内或 AlignHeader 路径 / Body of allocate: validates the alignment and picks the slab, tier or AlignHeader path
+	 * @note  不经过 HeapProfiler 钩子 / Bypasses the HeapProfiler hook
+	 */
+	void* allocate_aligned( std::size_t bytes, std::size_t alignment, bool nothrow );
+
+	/**
+	 * @brief 按默认对齐从四层管理器中分配 / Allocate from the four tiers with default alignment
+	 * @param bytes    用户可用字节数（不含 NotAlignHeader）/ usable bytes (NotAlignHeader excluded)
+	 * @param nothrow  失败时返回 nullptr 而不抛出 / return nullptr instead of throwing on failure
+	 * @return 内部用户指针，前方为 NotAlignHeader / inner user pointer, preceded by a NotAlignHeader
+	 */
+	void* allocate_from_tiers( std::size_t bytes, bool nothrow );
+
+	/// @brief 由 TierPageMap 解析出的带头块 / A headered block resolved through the TierPageMap
+	struct TierBlock
+	{
+		std::uint32_t owner_type = 0;		   //!< 1..4，0 表示不是池指针 / 1..4, 0 means not a pool pointer
+		std::uint32_t owner_node = 0;		   //!< 所属管理器的节点 / Node of the owning manager
+		void*		  header = nullptr;		   //!< 层级块头 / Tier header
+		char*		  inner_pointer = nullptr;  //!< allocate_from_tiers 返回的指针 / Pointer allocate_from_tiers returned
+	};
+
+	/**
+	 * @brief 只凭地址与页表条目定位带头块，不读用户指针前方的内存 / Locate a headered block from the address and its page-map entry alone, reading nothing in front of the user pointer
+	 * @details Small 按 chunk 基址与块长取整，Medium 取 1 MiB 对齐的块首，Large/Huge 的条目基址即块头。
+	 *          Small rounds down by the chunk base and block length, Medium takes the 1 MiB aligned block start, and a
+	 *          Large/Huge entry's base is the header itself.
+	 */
+	static TierBlock locate_block( const void* user_pointer ) noexcept;
+
+	/// @brief 把已定位的块交回所属层级 / Return a located block to its tier
+	void deallocate_block( const TierBlock& block );
+
+	/**
+	 * @brief 释放非 slab 指针：经 TierPageMap 定位，非池指针在 _DEBUG 下抛出、否则忽略 / Free a pointer already known not to be a slab object: located through the TierPageMap; a foreign pointer throws under _DEBUG and is ignored otherwise
+	 */
+	void deallocate_headered( void* user_pointer );
+
+	/**
+	 * @brief 按 allocate_from_tiers 的请求字节数直接定位块头 / Locate the tier header directly from the allocate_from_tiers byte count
+	 * @param inner_pointer  allocate_from_tiers 返回的指针 / pointer returned by allocate_from_tiers
+	 * @param bytes          分配（或最近一次 reallocate）时的字节数 / byte count of the allocation or latest reallocate
+	 */
+	void deallocate_to_tiers( void* inner_pointer, std::size_t bytes );
+
+	/**
+	 * @brief 含 NotAlignHeader 的总字节数落在哪一层（1..4，与 owner_type 相同）/ Tier (1..4, same as owner_type) of a total that includes the NotAlignHeader
+	 */
+	static std::uint32_t tier_of( std::size_t total_bytes_including_header );
+
+	/**
+	 * @brief allocate(bytes, alignment) 是否返回 slab 对象 / Whether allocate(bytes, alignment) returns a slab object
+	 */
+	static bool routes_to_slab( std::size_t bytes, std::size_t alignment );
+
+	/**
+	 * @brief 在所属层级内调整已定位的块 / Resize a located block within its tier
+	 * @param block          locate_block 的结果 / result of locate_block
+	 * @param bytes          新的用户字节数（不含 NotAlignHeader）/ new usable bytes, NotAlignHeader excluded
+	 * @param may_move       是否允许 Large/Huge 经 mremap 移动 / whether Large/Huge may move through mremap
+	 * @return 新的内部用户指针，失败返回 nullptr 且块不变 / new inner user pointer, nullptr on failure with the block unchanged
+	 */
+	void* resize_in_tier( const TierBlock& block, std::size_t bytes, bool may_move );
+
+	static constexpr std::size_t ZEROING_DECOMMIT_MIN_BYTES = 4 * 1024 * 1024;	//!< 不小于此的复用区段改为交还页来清零 / Recycled spans at least this large are cleared by handing their pages back
+
+	/**
+	 * @brief 把刚分配的 [user_pointer, user_pointer + bytes) 清零，已知为零的块跳过 / Zero a fresh allocation, skipping blocks known to be zero
+	 * @return 交还的页无法重新提交时返回 false / false when handed-back pages could not be committed again
+	 */
+	bool clear_allocation( void* user_pointer, std::size_t bytes );
 
 public:
 	MemoryPool();
+
+	/**
+	 * @brief 构造绑定到一个 NUMA 节点的池 / Construct a pool bound to one NUMA node
+	 * @param numa_node  四层新映射的物理页优先落在该节点 / new mappings of all four tiers prefer this node's memory
+	 */
+	explicit MemoryPool( std::size_t numa_node );
 	~MemoryPool();
 
+	/**
+	 * @brief 关闭构造时的一次性警告 / Silence the one-time construction warning
+	 * @note 供 malloc 替换层等嵌入方在首次构造前调用 / For embedders such as the malloc shim, called before the first construction
+	 */
+	static void suppress_construction_warning()
+	{
+		construction_warning_shown.store( true, std::memory_order_relaxed );
+	}
+
+	/**
+	 * @brief 设置后台线程（合并、清理）启动时调用的钩子 / Set the hook every background thread (merge, purge) calls when it starts
+	 * @note 这些线程的分配都是池内部的：malloc 替换层借此把它们标记为嵌套请求
+	 *       Everything those threads allocate is pool-internal: the malloc shim uses it to mark them as nested requests
+	 */
+	static void set_worker_thread_hook( void ( *hook )() )
+	{
+		worker_thread_hook.store( hook, std::memory_order_release );
+	}
+
+	/// @brief 由后台线程在入口处调用 / Called by a background thread on entry
+	static void enter_worker_thread()
+	{
+		if ( void ( *hook )() = worker_thread_hook.load( std::memory_order_acquire ) )
+			hook();
+	}
+
+	/**
+	 * @brief 指针所属池的节点号 / Node number of the pool that owns a pointer
+	 * @return 未绑定的池为 0 / 0 for unbound pools
+	 */
+	static std::size_t node_of( void* pointer );
+
+	/**
+	 * @brief 同上，但依据分配尺寸与对齐直接定位，不探测头部 / Same, but located from the allocation's size and alignment without probing
+	 */
+	static std::size_t node_of( void* pointer, std::size_t bytes, std::size_t alignment );
+
+	/**
+	 * @brief 指针是否为某个 MemoryPool 返回的用户指针（且映射尚在）/ Whether pointer is a user pointer some MemoryPool handed out (and still maps)
+	 * @details 只查 AddressPageMap 与 TierPageMap，从不读取指针处或其前方的内存，因此可用于任意来历的指针。
+	 *          Large/Huge 只登记映射前部，块内更深处的地址不在此列。
+	 *          Consults only the AddressPageMap and the TierPageMap and never reads memory at or in front of pointer, so
+	 *          it is safe on pointers of any origin. Large/Huge register only the front of their mapping, so addresses
+	 *          deeper inside such a block are not covered.
+	 */
+	static bool owns( const void* pointer ) noexcept;
+
 	void* allocate( std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, const char* source_file = nullptr, std::uint32_t source_line = 0, bool nothrow = false );
-	void  deallocate( void* pointer );
+
+	/**
+	 * @brief 分配 count 个 bytes 字节的元素并清零 / Allocate count elements of bytes bytes each, zero-filled
+	 * @throw std::bad_alloc count * bytes 溢出或分配失败（nothrow 时返回 nullptr）/ count * bytes overflows or allocation fails (nullptr under nothrow)
+	 *
+	 * @details
+	 * 直接来自操作系统的页本就为零：新 Medium arena 中从未分出过的块、新的 Large 映射与全部 Huge 映射不再 memset，
+	 * 未触碰的页保持未提交。复用的 Medium 块与命中缓存的 Large 映射，不小于 ZEROING_DECOMMIT_MIN_BYTES 时中间的整页
+	 * 经 decommit_memory（Linux 为 MADV_DONTNEED）换成零页，首尾零头与较小的块、Small/slab 块用 memset 清零。
+	 *
+	 * Pages straight from the OS are zero already: never-used blocks of a fresh Medium arena, fresh Large mappings
+	 * and every Huge mapping skip the memset, and pages nobody touches stay uncommitted. A recycled Medium block or a
+	 * Large mapping from the cache of at least ZEROING_DECOMMIT_MIN_BYTES trades its whole interior pages for zero
+	 * pages through decommit_memory (MADV_DONTNEED on Linux); the ragged ends, smaller blocks and Small/slab blocks
+	 * are cleared with memset.
+	 */
+	void* allocate_zeroed( std::size_t count, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, const char* source_file = nullptr, std::uint32_t source_line = 0, bool nothrow = false );
+
+	/**
+	 * @brief 无尺寸释放 / Unsized deallocation
+	 * @details 层级与块头来自 AddressPageMap / TierPageMap，不读取指针前方的 AlignHeader 或 NotAlignHeader；
+	 *          不属于任何池的指针在 _DEBUG 下抛出 bad_dealloc，否则被忽略。
+	 *          The tier and header come from the AddressPageMap / TierPageMap rather than the AlignHeader or NotAlignHeader
+	 *          in front of the pointer; a pointer no pool owns throws bad_dealloc under _DEBUG and is ignored otherwise.
+	 */
+	void deallocate( void* pointer );
+
+	/**
+	 * @brief 带尺寸的释放 / Sized deallocation
+	 * @param pointer    allocate/reallocate 返回的指针 / pointer from allocate or reallocate
+	 * @param bytes      分配（或最近一次 reallocate）时请求的字节数 / bytes requested by the allocation or the latest reallocate
+	 * @param alignment  同一次请求的对齐 / alignment of that same request
+	 *
+	 * @details 默认对齐时由尺寸直接算出层级和块头位置，不查页表；超对齐时与无尺寸释放一样查一次 TierPageMap。
+	 *          尺寸或对齐与分配时不符属于未定义行为；_DEBUG 下会与块头核对并抛出 bad_dealloc。
+	 *          With the default alignment the tier and header location follow from the size alone, with no page-map
+	 *          lookup; over-aligned pointers take one TierPageMap lookup like unsized deallocation. A size or alignment
+	 *          that differs from the allocation is undefined behaviour; _DEBUG builds cross-check the headers and throw
+	 *          bad_dealloc.
+	 */
+	void deallocate( void* pointer, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT );
+
+	/**
+	 * @brief 指针当前可用的字节数（不小于请求值）/ Bytes currently usable through a pointer (never less than requested)
+	 * @return 可直接写入而无需 reallocate 的字节数，nullptr 返回 0 / bytes writable without reallocate, 0 for nullptr
+	 */
+	std::size_t usable_size( void* pointer );
+
+	/**
+	 * @brief 批量分配同尺寸块（默认对齐）/ Allocate a batch of same-size blocks with default alignment
+	 * @param bytes    每块字节数 / bytes per block
+	 * @param count    块个数 / number of blocks
+	 * @param out      接收 count 个指针的数组 / array receiving count pointers
+	 * @param nothrow  失败时返回 0 而不抛出 / return 0 instead of throwing on failure
+	 * @return 成功时为 count；失败时不保留任何块 / count on success; on failure no block is kept
+	 *
+	 * @details Small 层（含 slab）整段取走线程弹匣并在一个紧凑循环里写 NotAlignHeader；更大的尺寸逐个分配。
+	 *          The Small tier (slabs included) takes whole magazine runs and writes the NotAlignHeaders in one tight
+	 *          loop; larger sizes are allocated one by one.
+	 */
+	std::size_t allocate_batch( std::size_t bytes, std::size_t count, void** out, bool nothrow = false );
+
+	/**
+	 * @brief 批量释放 / Free a batch of pointers
+	 * @param pointers  allocate / allocate_batch 返回的指针，可混合各层，nullptr 被跳过 / pointers from allocate or allocate_batch, tiers may be mixed, nullptr is skipped
+	 * @param count     指针个数 / number of pointers
+	 */
+	void deallocate_batch( void* const* pointers, std::size_t count );
+
 	void  flush_current_thread_cache();
+
+	/**
+	 * @brief 调整已分配块的大小 / Resize an allocated block
+	 * @param pointer    allocate 返回的指针，nullptr 时等同 allocate / pointer from allocate, nullptr behaves like allocate
+	 * @param bytes      新字节数，0 时释放并返回 nullptr / new byte count, 0 frees the block and returns nullptr
+	 * @param alignment  新块需满足的对齐 / alignment the resulting block must satisfy
+	 * @param nothrow    失败时返回 nullptr 而不抛出，原块保持有效 / return nullptr instead of throwing; the old block stays valid
+	 * @return 调整后的指针 / resized pointer
+	 *
+	 * @details
+	 * 1. 当前桶或伙伴阶仍合适时原样返回 / Returns the same pointer while the current bucket or buddy order still fits;
+	 * 2. 中块扩大时就地吸收空闲伙伴 / Medium blocks absorb free buddies in place on growth;
+	 * 3. Large/Huge 用 mremap(MREMAP_MAYMOVE) 移动页而不复制 / Large/Huge move pages with mremap(MREMAP_MAYMOVE) instead of copying;
+	 * 4. 其余情况分配新块、复制、释放旧块 / Otherwise allocates a new block, copies, and frees the old one.
+	 *
+	 * 原地结果始终处于 allocate(bytes, alignment) 会选中的层级，因此随后可用 deallocate(pointer, bytes, alignment) 释放。
+	 * In-place results always stay in the tier allocate(bytes, alignment) would pick, so deallocate(pointer, bytes, alignment) stays valid afterwards.
+	 */
+	void* reallocate( void* pointer, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, bool nothrow = false );
+
+	/**
+	 * @brief 立即把空闲的 Small/Medium 内存与 Large 映射缓存归还 OS / Return idle Small/Medium memory and the Large mapping cache to the OS now
+	 * @return 归还的字节数 / bytes returned
+	 *
+	 * @details 先刷新本线程缓存；其他线程缓存中的块不受影响。
+	 *          Flushes the calling thread's cache first; blocks cached by other threads are left alone.
+	 */
+	std::size_t trim();
+
+	/**
+	 * @brief 按清单预热：提前完成映射、切分与缺页 / Pre-warm from a profile: map, split and fault pages in ahead of time
+	 * @param profile  每个尺寸类的块数 / blocks per size class
+	 * @return 预热的块数 / blocks pre-warmed
+	 * @throw std::bad_alloc 映射失败；已取得的块全部归还 / when mapping fails; every block taken so far is returned
+	 *
+	 * @details
+	 * 每类同时取出 profile 给定数量的块（迫使 chunk / slab / arena 真正切出来），prefault 时逐页写入一次，
+	 * 随后全部释放：Small 块落入本线程弹匣并溢出到全局栈，Medium 块回到空闲链表。未设 fill_thread_cache 时
+	 * 最后刷新本线程缓存，使任意线程都能取到这些块。
+	 * 以逐页写入代替 MAP_POPULATE / PrefetchVirtualMemory：chunk 与 arena 映射在各层内部复用，写入对各平台一致。
+	 * 释放后的 Medium 伙伴可能重新合并，再次分配只需拆分，不会缺页；trim 与后台清理会撤销预热。
+	 *
+	 * Takes the profile's count of blocks per class all at once (so chunks, slabs and arenas are really carved),
+	 * writes every page once when prefault is set, then frees everything: Small blocks land in this thread's
+	 * magazines and spill to the global stacks, Medium blocks go back to their free lists. Without
+	 * fill_thread_cache the calling thread's cache is flushed at the end so any thread can pick the blocks up.
+	 * Pages are touched instead of using MAP_POPULATE / PrefetchVirtualMemory because chunk and arena mappings are
+	 * reused inside the tiers and a write behaves the same on every platform.
+	 * Freed Medium buddies may merge again; allocating them later only costs a split, not a page fault. trim and the
+	 * background purger undo the pre-warming.
+	 */
+	std::size_t reserve( const ReserveProfile& profile );
+
+	/**
+	 * @brief 设置软/硬内存上限，0 表示不设 / Set the soft and hard memory limits, 0 for none
+	 * @param soft_limit_bytes  越过时逐级回收并调用压力回调 / crossing it reclaims step by step and calls the pressure callbacks
+	 * @param hard_limit_bytes  回收后仍会越过时分配失败 / allocations that would still cross it after reclaiming fail
+	 * @note 新上限在下一次分配时生效 / A new limit takes effect at the next allocation
+	 *
+	 * @details
+	 * 以本池的 mapping_account 计量（本池各层经 *_tracked 映射的字节，Medium arena 按整段预留计入；其他池不计入）。
+	 * 每次分配前、以及 reallocate 增长前按增长的字节，把 已映射 + 请求字节 与门槛比较，只是一次 relaxed 读取；越过软上限时按
+	 * 以下顺序回收，任一步后回到软上限之内即停止：
+	 *   1. 刷新本线程缓存，处理排队的 Medium 合并；
+	 *   2. 丢弃 Large 映射缓存；
+	 *   3. 归还全空的 Small chunk、空闲 slab 与 Medium 空闲页（同 trim）；
+	 *   4. 调用压力回调，再刷新并归还一次。
+	 * 回收后仍超软上限时，要再增长 soft / 8 才重新回收，避免每次分配都付出回收代价。
+	 * 请求会越过硬上限时等待正在进行的回收并强制执行一轮；仍越过则抛出 std::bad_alloc（nothrow 时返回 nullptr）。
+	 * 硬上限按请求字节而非实际新映射判断，因此靠近上限时即便能由缓存满足的请求也可能被拒。
+	 *
+	 * Measured on this pool's mapping_account: the bytes its tiers map through the *_tracked functions, with Medium
+	 * arenas counted at their full reservation and other pools left out. Each allocation, and each reallocate that
+	 * grows (by the growth), compares mapped + requested bytes against a threshold, a single relaxed load. Crossing the soft limit reclaims in this
+	 * order, stopping as soon as the total is back under the soft limit:
+	 *   1. flush this thread's cache and process queued Medium merges;
+	 *   2. drop the Large mapping cache;
+	 *   3. return fully free Small chunks, idle slabs and free Medium pages (as trim does);
+	 *   4. call the pressure callbacks, then flush and return once more.
+	 * If the total stays above the soft limit, the next pass waits for another soft / 8 of growth so allocations do
+	 * not pay for reclamation one by one. A request that would cross the hard limit waits for a pass in progress
+	 * and forces one of its own; if it would still cross, it throws std::bad_alloc (nullptr under nothrow). The
+	 * hard limit judges the requested bytes rather than the mapping actually needed, so near the limit even a
+	 * request the caches could serve may be refused.
+	 */
+	void set_memory_limit( std::size_t soft_limit_bytes, std::size_t hard_limit_bytes );
+
+	/**
+	 * @brief 登记压力回调 / Register a pressure callback
+	 * @return 回调表已满返回 false / false when the callback table is full
+	 */
+	bool add_memory_pressure_callback( MemoryPressureCallback callback, void* context );
+
+	/// @brief 注销 (callback, context) / Unregister (callback, context)
+	void remove_memory_pressure_callback( MemoryPressureCallback callback, void* context );
+
+	/**
+	 * @brief 立即执行完整的一轮压力回收（含回调）/ Run one full pressure pass now, callbacks included
+	 * @return 归还的字节数 / bytes returned
+	 */
+	std::size_t relieve_memory_pressure();
+
+	/**
+	 * @brief 配置后台清理线程 / Configure the background purger
+	 * @param idle_period  块连续空闲多久后归还 / how long a block must stay idle before it is returned
+	 * @param interval     扫描间隔，0 表示关闭后台线程 / scan interval, 0 disables the purger
+	 *
+	 * @note 默认关闭；空闲时长以扫描轮次观察，实际归还延迟介于 idle_period 与 idle_period + interval 之间。
+	 *       Disabled by default; idleness is observed per scan, so the actual delay lies between
+	 *       idle_period and idle_period + interval.
+	 */
+	void set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval );
+
+	/**
+	 * @brief 选择中块伙伴合并的执行位置 / Choose where medium buddy merging runs
+	 * @param policy  ASYNCHRONOUS（默认）/ INLINE / DEFERRED，见 MediumMemoryManager::MergePolicy
+	 *                ASYNCHRONOUS (default) / INLINE / DEFERRED, see MediumMemoryManager::MergePolicy
+	 */
+	void set_medium_merge_policy( MediumMemoryManager::MergePolicy policy );
+
+	/**
+	 * @brief 设置大块映射缓存 / Configure the Large-tier mapping cache
+	 * @param budget_bytes  缓存字节上限，0 表示关闭 / cache byte budget, 0 disables it
+	 * @param decay         映射在缓存中最多停留的时长 / longest time a mapping stays cached
+	 */
+	void set_large_cache_policy( std::size_t budget_bytes, std::chrono::milliseconds decay );
+
+	/**
+	 * @brief 为各层的新映射选择页大小 / Choose the page size of new mappings per tier
+	 * @param medium_policy  中块 arena / Medium arenas
+	 * @param large_policy   大块映射 / Large mappings
+	 * @param huge_policy    超大块映射 / Huge mappings
+	 *
+	 * @note 默认均为 NORMAL；显式巨页不可用时逐级回退，已有映射不受影响。Small 层的 64 KiB slab 始终使用普通页。
+	 *       All default to NORMAL; explicit huge pages fall back step by step when unavailable and existing mappings
+	 *       are left alone. The Small tier's 64 KiB slabs always use normal pages.
+	 */
+	void set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy );
+
+	/**
+	 * @brief 汇总四层计数的快照 / Snapshot of the counters of all four tiers
+	 * @details 持各管理器的跟踪锁逐一读取，不阻塞 Small / Medium 快路径。
+	 *          Reads each manager under its tracking lock; the Small / Medium fast paths are never blocked.
+	 */
+	MemoryPoolStatistics statistics();
+};
+
+// ============================ NUMA 分片 ============================
+/**
+ * @brief 每个 NUMA 节点一个 MemoryPool 分片 / One MemoryPool shard per NUMA node
+ *
+ * @details
+ * 分配按调用线程当前所在节点路由；释放、reallocate 与 usable_size 依据块记录的节点回到所属分片，
+ * 因此跨节点释放的内存回到原节点的 arena，而不是留在释放线程的节点上。单节点机器只有一个未绑定的分片，
+ * 路由开销仅为一次比较。
+ *
+ * Allocations are routed to the node the calling thread is running on; frees, reallocate and usable_size go
+ * back to the shard recorded in the block, so memory freed from another node returns to its own node's arena
+ * instead of staying with the freeing thread. Single-node machines get one unbound shard and
+ * routing costs a single comparison.
+ */
+class NumaMemoryPool
+{
+public:
+	NumaMemoryPool();
+
+	void* allocate( std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, const char* source_file = nullptr, std::uint32_t source_line = 0, bool nothrow = false );
+	void* allocate_zeroed( std::size_t count, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, const char* source_file = nullptr, std::uint32_t source_line = 0, bool nothrow = false );
+
+	/**
+	 * @brief 从指定节点分配 / Allocate from a given node
+	 * @param numa_node  节点号，超出范围时按当前节点 / node number; out of range falls back to the current node
+	 */
+	void* allocate_on_node( std::size_t numa_node, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, bool nothrow = false );
+
+	void		deallocate( void* pointer );
+	void		deallocate( void* pointer, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT );
+	void*		reallocate( void* pointer, std::size_t bytes, std::size_t alignment = MIN_ALLOWED_ALIGNMENT, bool nothrow = false );
+	std::size_t usable_size( void* pointer );
+	std::size_t allocate_batch( std::size_t bytes, std::size_t count, void** out, bool nothrow = false );
+	void		deallocate_batch( void* const* pointers, std::size_t count );
+
+	void		flush_current_thread_cache();
+	std::size_t trim();
+
+	/// @brief 在调用线程所在节点的分片上预热 / Pre-warm the shard of the calling thread's node
+	std::size_t reserve( const ReserveProfile& profile );
+	void		set_purge_policy( std::chrono::milliseconds idle_period, std::chrono::milliseconds interval );
+
+	/// @brief 上限按分片数均分，回调每个分片都登记 / The limits are split evenly across the shards; every shard registers the callbacks
+	void		set_memory_limit( std::size_t soft_limit_bytes, std::size_t hard_limit_bytes );
+	bool		add_memory_pressure_callback( MemoryPressureCallback callback, void* context );
+	void		remove_memory_pressure_callback( MemoryPressureCallback callback, void* context );
+	std::size_t relieve_memory_pressure();
+	void		set_medium_merge_policy( MediumMemoryManager::MergePolicy policy );
+	void		set_large_cache_policy( std::size_t budget_bytes, std::chrono::milliseconds decay );
+	void		set_page_policy( os_memory::PagePolicy medium_policy, os_memory::PagePolicy large_policy, os_memory::PagePolicy huge_policy );
+
+	/// @brief 各分片快照之和 / Sum of every shard's snapshot
+	MemoryPoolStatistics statistics();
+
+	/// @brief 分片（节点）数 / Number of shards (nodes)
+	std::size_t node_count() const
+	{
+		return shards.size();
+	}
+
+private:
+	std::vector<std::unique_ptr<MemoryPool>> shards;  //!< 下标即节点号 / Indexed by node number
+
+	MemoryPool& local_shard();
+	MemoryPool& owner_shard( void* pointer );
 };
 
 
@@ -465,14 +2009,14 @@ namespace os_memory::memory_pool
 	constexpr inline bool is_power_of_two( std::size_t value ) noexcept
 	{
 #if !defined( _DEBUG )
-		// Release 模式：value==0 或 非 2 的幂 时中止 / Release mode: abort on zero or non-power-of-two
-		if ( value != 1 || ( value & ( value - 1 ) ) != 0 )
+		// Release 模式：value==0 或 非 2 的幂 时返回 false / Release mode: false on zero or non-power-of-two
+		if ( value == 0 || ( value & ( value - 1 ) ) != 0 )
 		{
 			return false;
 		}
 #else
 		// Debug 模式：断言 value 为非零的 2 的幂 / Debug mode: assert value is non-zero power of two
-		assert( value != 1 && ( value & ( value - 1 ) ) == 0 && "ensure_power_of_two: value must be non-zero power of two" );
+		assert( value != 0 && ( value & ( value - 1 ) ) == 0 && "ensure_power_of_two: value must be non-zero power of two" );
 #endif
 		return true;
 	}
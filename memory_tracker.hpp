@@ -6,7 +6,15 @@
  * 1. 采用「开启 / 关闭」两级追踪开关，可选详细模式（记录源码位置）。  
  * 2. 彻底避免缩写：所有标识符使用完整英文单词（例如 allocation_iterator、memory_mutex）。  
  * 3. 提供内存泄漏报告与当前内存占用统计。  
- * 4. 线程安全：所有共享数据均受 std::mutex 保护。
+ * 4. 线程安全且可扩展：记录先进入线程本地缓冲区，满后批量合并进按地址分片的表；
+ *    占用字节数由条带化原子计数器维护，查询为 O(1)；未登记指针的释放经存在性计数过滤，无需任何锁。
+ * 5. 采样模式：按字节做泊松采样（平均每 N 字节记录一次），样本按逆概率加权，使泄漏检测在高负载下也能常开。
+ *
+ * 1. Records first land in a thread-local buffer and are merged in batches into maps sharded by address;
+ *    live bytes live in striped atomic counters so the usage query is O(1); frees of untracked pointers are
+ *    filtered by presence counters without taking any lock.
+ * 2. Sampling mode: Poisson sampling by bytes (one record per N bytes on average), each sample weighted by
+ *    its inverse probability, so leak detection can stay enabled under load.
  *
  * 代码风格说明 / Style Notes
  * ---------------------------------------------------------------------------
@@ -21,10 +29,16 @@
 #include <cstdint>
 #include <cstddef>
 #include <cstdlib>
+#include <cmath>
 
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 /*--------------------------------- 结构体 / Struct -------------------------*/
@@ -39,12 +53,18 @@ struct AllocationInformation
 	uint32_t	line_number = 0;		 //!< 源代码行号 / line number
 	void*		user_pointer = nullptr;	 //!< 用户可见指针 / user pointer
 	void*		raw_pointer = nullptr;	 //!< 实际起始指针 / raw pointer (for aligned or pooled alloc)
+	size_t		sampled_bytes = 0;		 //!< 该记录代表的字节数（未采样时等于 size）/ bytes this record stands for (equals size when not sampling)
 };
 
 /*---------------------------------- 类 / Class -----------------------------*/
 class MemoryTracker
 {
 public:
+	static constexpr size_t SHARD_BITS = 6;				 //!< 64 个地址分片 / 64 address shards
+	static constexpr size_t PRESENCE_BITS = 14;			 //!< 存在性计数槽位数（2^14）/ Presence counter slots (2^14)
+	static constexpr size_t THREAD_BUFFER_RECORDS = 32;	 //!< 线程缓冲区满即合并 / A thread buffer merges once it holds this many
+	static constexpr size_t COUNTER_STRIPES = 16;		 //!< 占用计数条带数 / Live-byte counter stripes
+
 	/*----------------------------- 单例接口 / Singleton ---------------------*/
 	static MemoryTracker& instance()
 	{
@@ -59,35 +79,71 @@ public:
      */
 	void enable( bool is_detailed = false )
 	{
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		tracking_enabled = true;
-		detailed_tracking_on = is_detailed;
+		detailed_tracking_on.store( is_detailed, std::memory_order_relaxed );
+		tracking_enabled.store( true, std::memory_order_release );
 	}
 
 	/** 关闭追踪 / Disable tracking */
 	void disable()
 	{
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		tracking_enabled = false;
+		tracking_enabled.store( false, std::memory_order_release );
 	}
 
 	bool is_useable()
 	{
-		return tracking_enabled;
+		return tracking_enabled.load( std::memory_order_acquire );
+	}
+
+	/**
+     * @brief 设置采样间隔 / Set the sampling interval
+     * @param mean_bytes_between_samples 平均每多少字节记录一次；0 或 1 表示记录每次分配
+     *                                   mean bytes between two samples; 0 or 1 records every allocation
+     * @note  应在开启追踪前设置：已有记录按各自的权重计入占用 / Set it before tracking starts: existing records keep their own weight
+     */
+	void set_sampling_rate( size_t mean_bytes_between_samples )
+	{
+		sampling_rate.store( mean_bytes_between_samples, std::memory_order_relaxed );
+	}
+
+	size_t get_sampling_rate() const
+	{
+		return sampling_rate.load( std::memory_order_relaxed );
 	}
 
 	/*----------------------------- 分配 / Allocation ------------------------*/
 	/**
      * @brief 记录一次分配 / Track an allocation
-     * @note  若未开启追踪或指针为空，则直接返回。
+     * @note  若未开启追踪、指针为空或未被采样，则直接返回。
+     *        Returns at once if tracking is off, the pointer is null or the allocation is not sampled.
      */
 	void track_allocation( void* user_pointer, size_t allocation_size, const char* file_path = nullptr, uint32_t line_number = 0, void* raw_pointer = nullptr )
 	{
-		if ( !tracking_enabled || !user_pointer )
+		if ( !tracking_enabled.load( std::memory_order_relaxed ) || !user_pointer )
 			return;
 
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		allocation_map[ user_pointer ] = { allocation_size, file_path, line_number, user_pointer, raw_pointer ? raw_pointer : user_pointer };
+		size_t		 sampled_bytes = allocation_size;
+		const size_t rate = sampling_rate.load( std::memory_order_relaxed );
+		if ( rate > 1 )
+		{
+			ThreadState& state = thread_state();
+			state.bytes_until_sample -= static_cast<std::int64_t>( allocation_size );
+			if ( state.bytes_until_sample > 0 )
+				return;	 // 未被采样 / Not sampled
+			state.bytes_until_sample = next_sample_interval( state, rate );
+			sampled_bytes = sample_weight( allocation_size, rate );
+		}
+
+		insert_record( { allocation_size, file_path, line_number, user_pointer, raw_pointer ? raw_pointer : user_pointer, sampled_bytes } );
+	}
+
+	/**
+     * @brief 原样恢复一条先前取出的记录（不重新采样）/ Put back a record taken earlier, as is (no resampling)
+     */
+	void restore_allocation( const AllocationInformation& information )
+	{
+		if ( !tracking_enabled.load( std::memory_order_relaxed ) || !information.user_pointer )
+			return;
+		insert_record( information );
 	}
 
 	/**
@@ -95,25 +151,34 @@ public:
      */
 	void* find_tracked_pointer( void* user_pointer )
 	{
-		if ( !user_pointer )
-			return nullptr;
+		AllocationInformation information;
+		return find_allocation( user_pointer, information ) ? information.raw_pointer : nullptr;
+	}
 
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		auto						 allocation_iterator = allocation_map.find( user_pointer );
-		return ( allocation_iterator != allocation_map.end() ) ? allocation_iterator->second.raw_pointer : nullptr;
+	/**
+     * @brief 复制一条分配记录 / Copy an allocation record
+     * @return 找到返回 true / true if the pointer is tracked
+     */
+	bool find_allocation( void* user_pointer, AllocationInformation& information )
+	{
+		if ( !user_pointer || !maybe_tracked( user_pointer ) )
+			return false;
+		return locate_record( user_pointer, information, false );
 	}
 
 	/*----------------------------- 释放 / Deallocation ----------------------*/
 	/**
      * @brief 记录一次释放 / Track a deallocation
+     * @note  存在性计数为零的指针必未登记，直接返回，不加锁 / A pointer whose presence counter is zero is untracked: return without locking
      */
 	void track_deallocation( void* user_pointer )
 	{
-		if ( !tracking_enabled || !user_pointer )
+		if ( !tracking_enabled.load( std::memory_order_relaxed ) || !user_pointer || !maybe_tracked( user_pointer ) )
 			return;
 
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		allocation_map.erase( user_pointer );
+		AllocationInformation information;
+		if ( locate_record( user_pointer, information, true ) )
+			account_removal( information );
 	}
 
 	/*----------------------------- 报告 / Reports ---------------------------*/
@@ -122,31 +187,37 @@ public:
      */
 	void report_leaks( std::ostream& output_stream = std::cout )
 	{
-		if ( !tracking_enabled )
+		if ( !tracking_enabled.load( std::memory_order_acquire ) )
 			return;
 
 		std::vector<AllocationInformation> leak_list;
-
 		{
-			std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-			if ( allocation_map.empty() )
+			std::unique_lock<std::shared_mutex> registry_lock( registry_mutex );
+			merge_every_thread_buffer();
+			for ( Shard& shard : shards )
 			{
-				output_stream << "No memory leaks detected.\n";
-				return;
-			}
-			leak_list.reserve( allocation_map.size() );
-			for ( const auto& pair : allocation_map )
-			{
-				leak_list.push_back( pair.second );
+				std::scoped_lock<std::mutex> shard_lock( shard.mutex );
+				for ( const auto& pair : shard.allocation_map )
+					leak_list.push_back( pair.second );
 			}
 		}
 
+		if ( leak_list.empty() )
+		{
+			output_stream << "No memory leaks detected.\n";
+			return;
+		}
+
+		const size_t rate = sampling_rate.load( std::memory_order_relaxed );
 		output_stream << "\n=== Memory Leak Report ===\n";
-		output_stream << "Total leaks: " << leak_list.size() << "\n\n";
+		output_stream << "Total leaks: " << leak_list.size();
+		if ( rate > 1 )
+			output_stream << " sampled (1 per ~" << rate << " bytes, ~" << current_memory_usage() << " bytes estimated)";
+		output_stream << "\n\n";
 		for ( const auto& allocation : leak_list )
 		{
 			output_stream << "Leaked " << allocation.size << " bytes at " << allocation.user_pointer;
-			if ( detailed_tracking_on && allocation.file_path )
+			if ( detailed_tracking_on.load( std::memory_order_relaxed ) && allocation.file_path )
 			{
 				output_stream << " (allocated at " << allocation.file_path << ":" << allocation.line_number << ")";
 			}
@@ -156,40 +227,292 @@ public:
 	}
 
 	/**
-     * @brief 获取当前占用内存字节数 / Get current total allocated size
+     * @brief 获取当前占用内存字节数，O(1) / Get current total allocated size, O(1)
+     * @note  采样模式下为按权重的估计值 / An estimate from the sample weights in sampling mode
      */
 	size_t current_memory_usage()
 	{
-		std::scoped_lock<std::mutex> scoped_lock( memory_mutex );
-		size_t						 total_size = 0;
-		for ( const auto& pair : allocation_map )
+		std::int64_t total_size = 0;
+		for ( const CounterStripe& stripe : live_bytes )
+			total_size += stripe.bytes.load( std::memory_order_relaxed );
+		return total_size > 0 ? static_cast<size_t>( total_size ) : 0;
+	}
+
+private:
+	/*----------------------------- 内部结构 / Internals ---------------------*/
+	/// @brief 一个地址分片 / One address shard
+	struct alignas( 64 ) Shard
+	{
+		std::mutex										 mutex;			  //!< 保护 allocation_map / mutex guarding map
+		std::unordered_map<void*, AllocationInformation> allocation_map;  //!< 追踪表 / tracking map
+	};
+
+	/// @brief 线程本地的待合并记录 / A thread's records waiting to be merged
+	struct ThreadBuffer
+	{
+		std::mutex						   mutex;			//!< 所属线程几乎独占；合并与跨线程查找时才竞争 / Nearly owner-only; contended only by merges and cross-thread lookups
+		std::vector<void*>				   pointers;		//!< 与 records 同序的用户指针，查找只扫这一列 / User pointers in records order; lookups scan only this column
+		std::vector<AllocationInformation> records;			//!< 待合并记录 / Pending records
+		bool							   attached = true;	//!< 受 registry_mutex 保护 / Guarded by registry_mutex
+	};
+
+	/// @brief 条带化的占用字节计数 / Striped live-byte counter
+	struct alignas( 64 ) CounterStripe
+	{
+		std::atomic<std::int64_t> bytes { 0 };	//!< 可为负：跨线程释放记在释放方条带 / May go negative: a cross-thread free counts on the freeing stripe
+	};
+
+	/// @brief 每线程状态，析构即线程退出钩子 / Per-thread state; the destructor is the thread-exit hook
+	struct ThreadState
+	{
+		ThreadBuffer* buffer = nullptr;			  //!< 本线程的记录缓冲区 / This thread's record buffer
+		std::int64_t  bytes_until_sample = 0;	  //!< 距下次采样的剩余字节 / Bytes left before the next sample
+		std::uint64_t random_state = 0;			  //!< xorshift 状态，0 表示未播种 / xorshift state, 0 until seeded
+		size_t		  stripe = 0;				  //!< 计数条带 / Counter stripe
+
+		ThreadState()
 		{
-			total_size += pair.second.size;
+			static std::atomic<size_t> next_stripe { 0 };
+			stripe = next_stripe.fetch_add( 1, std::memory_order_relaxed ) % COUNTER_STRIPES;
 		}
-		return total_size;
+
+		~ThreadState()
+		{
+			if ( buffer )
+				MemoryTracker::instance().retire_thread_buffer( *std::exchange( buffer, nullptr ) );
+		}
+	};
+
+	static ThreadState& thread_state()
+	{
+		static thread_local ThreadState state;
+		return state;
+	}
+
+	/*----------------------------- 散列 / Hashing ---------------------------*/
+	// 分片按 64 KiB 区域散列：同一线程相邻的分配落在同一分片，不同线程的 chunk 自然分散
+	// Shards hash the 64 KiB region: neighbouring allocations of one thread share a shard while other threads' chunks spread out
+	static size_t shard_index_of( const void* user_pointer )
+	{
+		const std::uint64_t region = static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>( user_pointer ) ) >> 16;
+		return static_cast<size_t>( ( region * 0x9E3779B97F4A7C15ull ) >> ( 64 - SHARD_BITS ) );
+	}
+
+	Shard& shard_of( const void* user_pointer )
+	{
+		return shards[ shard_index_of( user_pointer ) ];
+	}
+
+	// 存在性槽按 16 B 粒度取低位，顺序分配顺序访问 / Presence slots use the low bits at 16-byte granularity, so sequential allocations touch them sequentially
+	std::atomic<std::uint32_t>& presence_of( const void* user_pointer )
+	{
+		return presence[ ( reinterpret_cast<std::uintptr_t>( user_pointer ) >> 4 ) & ( ( size_t( 1 ) << PRESENCE_BITS ) - 1 ) ];
+	}
+
+	bool maybe_tracked( const void* user_pointer )
+	{
+		return presence_of( user_pointer ).load( std::memory_order_relaxed ) != 0;
+	}
+
+	/*----------------------------- 采样 / Sampling --------------------------*/
+	/// @brief 指数分布的下一个采样间隔（均值 rate）/ Next exponentially distributed sampling interval (mean rate)
+	static std::int64_t next_sample_interval( ThreadState& state, size_t rate )
+	{
+		if ( state.random_state == 0 )
+			state.random_state = ( reinterpret_cast<std::uintptr_t>( &state ) | 1 ) * 0x9E3779B97F4A7C15ull;
+
+		// xorshift64*，取高 53 位得到 (0, 1] 上的均匀数 / xorshift64*, the high 53 bits give a uniform value in (0, 1]
+		state.random_state ^= state.random_state >> 12;
+		state.random_state ^= state.random_state << 25;
+		state.random_state ^= state.random_state >> 27;
+		const double uniform = static_cast<double>( ( ( state.random_state * 0x2545F4914F6CDD1Dull ) >> 11 ) + 1 ) * ( 1.0 / 9007199254740992.0 );
+		return static_cast<std::int64_t>( -std::log( uniform ) * static_cast<double>( rate ) ) + 1;
+	}
+
+	/// @brief 一次采样代表的字节数：size 除以被采中的概率 / Bytes a sample stands for: size divided by its chance of being sampled
+	static size_t sample_weight( size_t allocation_size, size_t rate )
+	{
+		if ( allocation_size == 0 )
+			return 0;
+		const double ratio = static_cast<double>( allocation_size ) / static_cast<double>( rate );
+		return static_cast<size_t>( static_cast<double>( allocation_size ) / -std::expm1( -ratio ) );
+	}
+
+	/*----------------------------- 记录 / Records ---------------------------*/
+	void insert_record( const AllocationInformation& information )
+	{
+		ThreadState& state = thread_state();
+		presence_of( information.user_pointer ).fetch_add( 1, std::memory_order_relaxed );
+		live_bytes[ state.stripe ].bytes.fetch_add( static_cast<std::int64_t>( information.sampled_bytes ), std::memory_order_relaxed );
+
+		ThreadBuffer& buffer = thread_buffer( state );
+		bool		  buffer_full;
+		{
+			std::scoped_lock<std::mutex> buffer_lock( buffer.mutex );
+			buffer.pointers.push_back( information.user_pointer );
+			buffer.records.push_back( information );
+			buffer_full = buffer.records.size() >= THREAD_BUFFER_RECORDS;
+		}
+		if ( buffer_full )
+		{
+			std::shared_lock<std::shared_mutex> registry_lock( registry_mutex );
+			merge_thread_buffer( buffer );
+		}
+	}
+
+	void account_removal( const AllocationInformation& information )
+	{
+		presence_of( information.user_pointer ).fetch_sub( 1, std::memory_order_relaxed );
+		live_bytes[ thread_state().stripe ].bytes.fetch_sub( static_cast<std::int64_t>( information.sampled_bytes ), std::memory_order_relaxed );
+	}
+
+	/// @brief 从缓冲区中查找（可选取出）一条记录 / Find, and optionally take, a record from a buffer
+	static bool take_from_buffer( ThreadBuffer& buffer, void* user_pointer, AllocationInformation& information, bool erase )
+	{
+		std::scoped_lock<std::mutex> buffer_lock( buffer.mutex );
+		for ( size_t index = buffer.pointers.size(); index-- > 0; )	// 新记录在尾部，短命对象先命中 / Newest at the back, so short-lived objects hit first
+		{
+			if ( buffer.pointers[ index ] != user_pointer )
+				continue;
+			information = buffer.records[ index ];
+			if ( erase )
+			{
+				buffer.pointers[ index ] = buffer.pointers.back();
+				buffer.pointers.pop_back();
+				buffer.records[ index ] = buffer.records.back();
+				buffer.records.pop_back();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	bool take_from_shard( void* user_pointer, AllocationInformation& information, bool erase )
+	{
+		Shard&						 shard = shard_of( user_pointer );
+		std::scoped_lock<std::mutex> shard_lock( shard.mutex );
+		auto						 allocation_iterator = shard.allocation_map.find( user_pointer );
+		if ( allocation_iterator == shard.allocation_map.end() )
+			return false;
+		information = allocation_iterator->second;
+		if ( erase )
+			shard.allocation_map.erase( allocation_iterator );
+		return true;
+	}
+
+	/**
+     * @brief 依次查找本线程缓冲区、分片、其他线程缓冲区 / Look in this thread's buffer, then the shard, then every other buffer
+     * @note  最后一步独占 registry_mutex，没有合并在途，记录不会在分片与缓冲区之间"看不见"
+     *        The last step holds registry_mutex exclusively, so no merge is in flight and a record cannot be missed between buffer and shard
+     */
+	bool locate_record( void* user_pointer, AllocationInformation& information, bool erase )
+	{
+		ThreadState& state = thread_state();
+		if ( state.buffer && take_from_buffer( *state.buffer, user_pointer, information, erase ) )
+			return true;
+		if ( take_from_shard( user_pointer, information, erase ) )
+			return true;
+
+		// 跨线程释放了尚未合并的记录，或存在性槽位冲突 / A cross-thread free of a record not merged yet, or a presence slot collision
+		std::unique_lock<std::shared_mutex> registry_lock( registry_mutex );
+		if ( take_from_shard( user_pointer, information, erase ) )
+			return true;
+		for ( const auto& buffer : thread_buffers )
+		{
+			if ( take_from_buffer( *buffer, user_pointer, information, erase ) )
+				return true;
+		}
+		return false;
+	}
+
+	/*----------------------------- 线程缓冲区 / Thread buffers --------------*/
+	ThreadBuffer& thread_buffer( ThreadState& state )
+	{
+		if ( state.buffer )
+			return *state.buffer;
+
+		std::unique_lock<std::shared_mutex> registry_lock( registry_mutex );
+		for ( const auto& buffer : thread_buffers )	// 接管已退出线程留下的缓冲区 / Adopt a buffer left behind by an exited thread
+		{
+			if ( !buffer->attached )
+			{
+				buffer->attached = true;
+				state.buffer = buffer.get();
+				return *state.buffer;
+			}
+		}
+		thread_buffers.push_back( std::make_unique<ThreadBuffer>() );
+		thread_buffers.back()->pointers.reserve( THREAD_BUFFER_RECORDS );
+		thread_buffers.back()->records.reserve( THREAD_BUFFER_RECORDS );
+		state.buffer = thread_buffers.back().get();
+		return *state.buffer;
+	}
+
+	void retire_thread_buffer( ThreadBuffer& buffer )
+	{
+		std::unique_lock<std::shared_mutex> registry_lock( registry_mutex );
+		merge_thread_buffer( buffer );
+		buffer.attached = false;
+	}
+
+	/// @brief 合并缓冲区，同一分片的连续记录只加锁一次 / Merge a buffer, locking once per run of records in the same shard
+	/// @note  调用方持有 registry_mutex（共享或独占）/ The caller holds registry_mutex, shared or exclusive
+	void merge_thread_buffer( ThreadBuffer& buffer )
+	{
+		std::scoped_lock<std::mutex> buffer_lock( buffer.mutex );
+		for ( size_t index = 0; index < buffer.records.size(); )
+		{
+			Shard&						 shard = shard_of( buffer.records[ index ].user_pointer );
+			std::scoped_lock<std::mutex> shard_lock( shard.mutex );
+			for ( ; index < buffer.records.size() && &shard_of( buffer.records[ index ].user_pointer ) == &shard; ++index )
+				shard.allocation_map[ buffer.records[ index ].user_pointer ] = buffer.records[ index ];
+		}
+		buffer.pointers.clear();
+		buffer.records.clear();
+	}
+
+	/// @note 调用方独占 registry_mutex / The caller holds registry_mutex exclusively
+	void merge_every_thread_buffer()
+	{
+		for ( const auto& buffer : thread_buffers )
+			merge_thread_buffer( *buffer );
 	}
 
-private:
 	/*----------------------------- 构造 & 数据 / Ctor & Data ---------------*/
 	MemoryTracker() = default;
 	~MemoryTracker()
 	{
 		// 如果追踪已启用且存在未释放的内存分配记录，则打印内存泄漏报告  
 		// If tracking is enabled and there are unfreed memory allocation records, print a memory leak report  
-		if(tracking_enabled && !allocation_map.empty())  
-		{  
+		if ( tracking_enabled.load( std::memory_order_acquire ) && has_records() )
+		{
 			report_leaks();
-			tracking_enabled = false;
+			tracking_enabled.store( false, std::memory_order_release );
 		}
 	}
 	MemoryTracker( const MemoryTracker& ) = delete;
 	MemoryTracker& operator=( const MemoryTracker& ) = delete;
 
-	std::mutex memory_mutex;				  //!< 保护 allocation_map / mutex guarding map
-	bool	   tracking_enabled = false;	  //!< 全局开关 / global enable flag
-	bool	   detailed_tracking_on = false;  //!< 是否记录源码位置 / detailed mode
+	bool has_records()
+	{
+		for ( const std::atomic<std::uint32_t>& counter : presence )
+		{
+			if ( counter.load( std::memory_order_relaxed ) != 0 )
+				return true;
+		}
+		return false;
+	}
+
+	std::atomic<bool>	tracking_enabled { false };		 //!< 全局开关 / global enable flag
+	std::atomic<bool>	detailed_tracking_on { false };	 //!< 是否记录源码位置 / detailed mode
+	std::atomic<size_t> sampling_rate { 0 };			 //!< 平均采样间隔（字节），≤ 1 表示全量 / Mean sampling interval in bytes, ≤ 1 records everything
+
+	std::array<Shard, size_t( 1 ) << SHARD_BITS>						   shards;		   //!< 按地址分片的追踪表 / tracking maps sharded by address
+	std::array<std::atomic<std::uint32_t>, size_t( 1 ) << PRESENCE_BITS> presence {};	   //!< 每槽已登记指针数 / tracked pointers per slot
+	std::array<CounterStripe, COUNTER_STRIPES>							   live_bytes {};  //!< 占用字节 / live bytes
 
-	std::unordered_map<void*, AllocationInformation> allocation_map;  //!< 追踪表 / tracking map
+	std::shared_mutex							registry_mutex;	 //!< 保护 thread_buffers；合并取共享，跨缓冲区查找取独占 / Guards thread_buffers; merges share it, cross-buffer lookups own it
+	std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;	 //!< 全部线程缓冲区 / every thread buffer
 };
 
 #endif	// MEMORY_TRACKER_HPP
@@ -0,0 +1,231 @@
+/**
+ * @file object_pool.hpp
+ * @brief 按类型特化的对象池 / Per-type specialised object pool
+ *
+ * @details
+ * 1. 桶尺寸、对齐与补给批量都由 sizeof(Type) / alignof(Type) 在编译期确定，运行时不再选层、不再查桶。
+ * 2. 每线程一条按类型区分的空闲链表；create 只是出链加 placement new，destroy 只是析构加入链。
+ * 3. 链表空时用 allocate_batch 从 GlobalAllocator 整段补给（slab 桶一次一个弹匣），过长时整段归还；线程退出时全部归还。
+ * 4. make_pooled 返回带无状态删除器的 unique_ptr，大小与裸指针相同。
+ *
+ * 1. The bucket size, alignment and refill batch all follow from sizeof(Type) / alignof(Type) at compile time, so there is
+ *    no tier selection and no bucket search at run time.
+ * 2. Each thread keeps one typed free list; create is a pop plus placement new, destroy a destructor call plus a push.
+ * 3. An empty list refills in one allocate_batch from GlobalAllocator (a whole magazine for slab buckets), an overlong
+ *    list hands a run back, and a thread returns everything when it exits.
+ * 4. make_pooled returns a unique_ptr with a stateless deleter, the size of a raw pointer.
+ *
+ * 代码风格说明 / Style Notes
+ * ---------------------------------------------------------------------------
+ * 1. 彻底避免缩写：所有标识符均使用完整单词 (slot, refill, release...)；
+ * 2. 中英文注释并存，支持 Doxygen 文档 / Bilingual comments with Doxygen support.
+ */
+
+#pragma once
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include "global_allocator_api.hpp"
+
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace os_memory::allocator
+{
+	/**
+	 * @brief 类型 Type 的对象池，全部为静态接口 / Object pool for Type; the interface is entirely static
+	 * @note 块来自 GlobalAllocator：不要在已有对象存活时调用 GlobalAllocator::set / Blocks come from GlobalAllocator: do not call GlobalAllocator::set while objects are alive
+	 */
+	template <typename Type>
+	class ObjectPool
+	{
+	public:
+		static constexpr std::size_t ALIGNMENT = std::max( alignof( Type ), alignof( void* ) );	//!< 块对齐 / Block alignment
+
+		/// @brief 块字节数：Small 层取整到所在桶的尺寸，整桶可用 / Block bytes: rounded up to the bucket size in the Small tier, so the whole bucket is used
+		static constexpr std::size_t BLOCK_BYTES = [] {
+			constexpr std::size_t bytes = std::max( sizeof( Type ), sizeof( void* ) );
+			if constexpr ( bytes <= SmallMemoryManager::BUCKET_SIZES.back() )
+				return SmallMemoryManager::BUCKET_SIZES[ SmallMemoryManager::calculate_bucket_index( bytes ) ];
+			else
+				return bytes;
+		}();
+
+		/// @brief 无头 slab 路径：slab 桶且对齐不超过池的默认对齐 / Header-less slab path: a slab bucket and no more than the pool's default alignment
+		static constexpr bool USES_SLAB = BLOCK_BYTES <= SmallMemoryManager::SLAB_MAX_BLOCK_BYTES && ALIGNMENT <= DEFAULT_ALIGNMENT;
+
+		/// @brief 每次补给的块数：Small 层为该桶的弹匣容量 / Blocks per refill: the bucket's magazine capacity in the Small tier
+		static constexpr std::size_t REFILL_COUNT = [] {
+			if constexpr ( BLOCK_BYTES <= SmallMemoryManager::BUCKET_SIZES.back() )
+				return SmallMemoryManager::MAGAZINE_CAPACITIES[ SmallMemoryManager::calculate_bucket_index( BLOCK_BYTES ) ];
+			else
+				return std::size_t( 1 );
+		}();
+
+		static constexpr std::size_t FREE_LIST_LIMIT = 2 * REFILL_COUNT;  //!< 超过即整段归还 / Above this a run is handed back
+
+		/**
+		 * @brief 构造一个对象 / Construct an object
+		 * @throw std::bad_alloc 补给失败，或 Type 的构造函数抛出的异常 / refill failure, or whatever Type's constructor throws
+		 */
+		template <typename... Arguments>
+		static Type* create( Arguments&&... arguments )
+		{
+			FreeList& list = thread_list();
+			if ( !list.head )
+				refill( list );
+			FreeSlot* const slot = list.head;
+			list.head = slot->next;
+			--list.count;
+			try
+			{
+				return ::new ( static_cast<void*>( slot ) ) Type( std::forward<Arguments>( arguments )... );
+			}
+			catch ( ... )
+			{
+				push( list, slot );
+				throw;
+			}
+		}
+
+		/// @brief 析构并回收对象，任意线程均可调用 / Destroy and recycle an object; any thread may call it
+		static void destroy( Type* object ) noexcept
+		{
+			if ( !object )
+				return;
+			object->~Type();
+			push( thread_list(), reinterpret_cast<FreeSlot*>( object ) );
+		}
+
+		/// @brief 本线程空闲链表中的块数 / Blocks in this thread's free list
+		static std::size_t cached_count() noexcept
+		{
+			return thread_list().count;
+		}
+
+		/// @brief 把本线程空闲链表全部归还 / Hand this thread's whole free list back
+		static void release_cached() noexcept
+		{
+			FreeList& list = thread_list();
+			release( list, list.count );
+		}
+
+	private:
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		struct FreeList
+		{
+			FreeSlot*	head = nullptr;
+			std::size_t count = 0;
+
+			~FreeList()
+			{
+				release( *this, count );
+			}
+		};
+
+		static_assert( BLOCK_BYTES >= sizeof( FreeSlot ) && ALIGNMENT % alignof( FreeSlot ) == 0 );
+
+		static FreeList& thread_list() noexcept
+		{
+			static thread_local FreeList list;
+			return list;
+		}
+
+		static void push( FreeList& list, FreeSlot* slot ) noexcept
+		{
+			slot->next = list.head;
+			list.head = slot;
+			if ( ++list.count > FREE_LIST_LIMIT )
+				release( list, REFILL_COUNT );
+		}
+
+		static void refill( FreeList& list )
+		{
+			InterfaceAllocator& allocator = *os_memory::api::GlobalAllocator::get();
+			void*				blocks[ REFILL_COUNT ];
+			if constexpr ( USES_SLAB )
+			{
+				allocator.allocate_batch( BLOCK_BYTES, REFILL_COUNT, blocks );	// 失败时抛出且不保留任何块 / Throws on failure and keeps no block
+			}
+			else
+			{
+				for ( std::size_t i = 0; i < REFILL_COUNT; ++i )
+				{
+					try
+					{
+						blocks[ i ] = allocator.allocate( BLOCK_BYTES, ALIGNMENT );
+					}
+					catch ( ... )
+					{
+						while ( i-- > 0 )
+							allocator.deallocate( blocks[ i ], BLOCK_BYTES, ALIGNMENT );
+						throw;
+					}
+				}
+			}
+			for ( void* block : blocks )
+			{
+				auto* slot = static_cast<FreeSlot*>( block );
+				slot->next = list.head;
+				list.head = slot;
+			}
+			list.count += REFILL_COUNT;
+		}
+
+		/// @brief 从链表头取下 count 个块归还池 / Take count blocks off the head of the list and return them to the pool
+		static void release( FreeList& list, std::size_t count ) noexcept
+		{
+			InterfaceAllocator& allocator = *os_memory::api::GlobalAllocator::get();
+			void*				blocks[ REFILL_COUNT ];
+			while ( count > 0 && list.head )
+			{
+				std::size_t taken = 0;
+				for ( ; taken < REFILL_COUNT && taken < count && list.head; ++taken )
+				{
+					blocks[ taken ] = list.head;
+					list.head = list.head->next;
+				}
+				list.count -= taken;
+				count -= taken;
+				if constexpr ( USES_SLAB )
+				{
+					allocator.deallocate_batch( blocks, taken );
+				}
+				else
+				{
+					for ( std::size_t i = 0; i < taken; ++i )
+						allocator.deallocate( blocks[ i ], BLOCK_BYTES, ALIGNMENT );
+				}
+			}
+		}
+	};
+
+	/// @brief 无状态删除器 / Stateless deleter
+	template <typename Type>
+	struct PooledDeleter
+	{
+		void operator()( Type* object ) const noexcept
+		{
+			ObjectPool<Type>::destroy( object );
+		}
+	};
+
+	template <typename Type>
+	using PooledPointer = std::unique_ptr<Type, PooledDeleter<Type>>;
+
+	/// @brief 从 ObjectPool<Type> 构造对象 / Construct an object from ObjectPool<Type>
+	template <typename Type, typename... Arguments>
+	PooledPointer<Type> make_pooled( Arguments&&... arguments )
+	{
+		return PooledPointer<Type>( ObjectPool<Type>::create( std::forward<Arguments>( arguments )... ) );
+	}
+}  // namespace os_memory::allocator
+
+#endif	// OBJECT_POOL_HPP
@@ -13,15 +13,19 @@
 #include <sys/syscall.h>
 #include <sys/mman.h>
 #include <linux/mman.h>	 // MAP_HUGETLB
+#include <sched.h>		 // getcpu
+#include <cstdio>
 #endif
 
 #include <cstdint>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
 
 #include <limits>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <array>
@@ -32,20 +36,83 @@ namespace os_memory
 
 	/**  
     * @brief 自定义异常类：bad_dealloc  
-    * @details 用于表示内存释放失败的异常  
+    * @details 用于表示内存释放失败的异常；基于 runtime_error 复制消息，各平台可用
+    *          Thrown when a deallocation fails; runtime_error copies the message and is available on every platform
     */
-	class bad_dealloc : public std::exception
+	class bad_dealloc : public std::runtime_error
 	{
 	public:
-		bad_dealloc() : exception( "bad deallocation", 1 ) {}
+		bad_dealloc() : runtime_error( "bad deallocation" ) {}
 
-		explicit bad_dealloc( const std::string& message ) : exception( message.c_str(), 1 ) {}
+		explicit bad_dealloc( const std::string& message ) : runtime_error( message ) {}
 
-		explicit bad_dealloc( const char* message ) : exception( message, 1 ) {}
+		explicit bad_dealloc( const char* message ) : runtime_error( message ) {}
 	};
 
+	/// @brief 经 *_tracked 映射的净字节数 / Net bytes mapped through the *_tracked functions
 	inline std::atomic<uint64_t> used_memory_bytes_counter { 0 };
-	inline std::atomic<uint32_t> user_operation_counter { 0 };
+	/// @brief 映射次数减解除次数；有符号 64 位，不会回绕 / Mappings minus unmappings; signed 64-bit so it never wraps
+	inline std::atomic<int64_t> user_operation_counter { 0 };
+
+	/**
+	 * @brief 一个所有者（例如一个池）的映射计数，与上面的全局计数同步增减
+	 *        Mapping counters of one owner (a pool, say), moved in step with the global counters above
+	 * @note 进程内有多个池时，各池只能依据自己的计数判断泄漏与上限 / With several pools in a process, each can judge leaks and limits only by its own counters
+	 */
+	struct MappingAccount
+	{
+		std::atomic<uint64_t> mapped_bytes { 0 };  //!< 净映射字节 / Net mapped bytes
+		std::atomic<int64_t>  operations { 0 };	   //!< 映射次数减解除次数 / Mappings minus unmappings
+	};
+
+	/**
+	 * @brief 页大小策略 / Page-size policy
+	 * @details
+	 * 由调用方显式选择，不再从对齐值推断；显式巨页失败时逐级回退：
+	 * EXPLICIT_1G → EXPLICIT_2M → TRANSPARENT → NORMAL
+	 * Chosen explicitly by the caller instead of being inferred from the alignment; explicit huge pages fall back step by step:
+	 * EXPLICIT_1G → EXPLICIT_2M → TRANSPARENT → NORMAL
+	 */
+	enum class PagePolicy : std::uint8_t
+	{
+		NORMAL,		  //!< 普通 4 KiB 页 / Regular 4 KiB pages
+		TRANSPARENT,  //!< 2 MiB 对齐并 madvise(MADV_HUGEPAGE) / 2 MiB aligned plus madvise(MADV_HUGEPAGE)
+		EXPLICIT_2M,  //!< hugetlb 2 MiB 页 / hugetlb 2 MiB pages
+		EXPLICIT_1G	  //!< hugetlb 1 GiB 页 / hugetlb 1 GiB pages
+	};
+
+	inline constexpr size_t HUGE_PAGE_2M_BYTES = size_t( 1 ) << 21;
+	inline constexpr size_t HUGE_PAGE_1G_BYTES = size_t( 1 ) << 30;
+
+	/**
+	 * @brief 策略对应的映射粒度 / Mapping granule of a policy
+	 */
+	constexpr size_t page_bytes( PagePolicy policy ) noexcept
+	{
+		switch ( policy )
+		{
+		case PagePolicy::EXPLICIT_1G:
+			return HUGE_PAGE_1G_BYTES;
+		case PagePolicy::EXPLICIT_2M:
+		case PagePolicy::TRANSPARENT:
+			return HUGE_PAGE_2M_BYTES;
+		default:
+			return 0x1000;
+		}
+	}
+
+	/**
+	 * @brief 把映射长度上取整到策略粒度 / Round a mapping length up to the policy granule
+	 * @note hugetlb 映射的 munmap 长度必须是巨页整数倍，调用方须用取整后的长度分配与释放
+	 *       munmap of a hugetlb mapping needs a whole number of huge pages, so callers allocate and release the rounded length
+	 */
+	constexpr size_t round_to_pages( size_t size, PagePolicy policy ) noexcept
+	{
+		const size_t granule = page_bytes( policy );
+		return ( size + granule - 1 ) & ~( granule - 1 );
+	}
+
+	inline constexpr size_t ANY_NUMA_NODE = ~size_t( 0 );  //!< 不绑定节点 / No node binding
 
 	/*--------------------------------- Linux实现 / Linux Implementation -------*/
 #if defined( __linux__ )
@@ -58,13 +125,15 @@ namespace os_memory
 	 * 
 	 * @details
 	 * 1. 使用直接系统调用绕过libc / Uses direct syscall bypassing libc
-	 * 2. 大页支持：对齐>4KB时启用巨页 / Hugepage support for alignments >4KB
+	 * 2. 映射总是页对齐；巨页由 allocate_pages 显式选择 / The mapping is always page aligned; huge pages are chosen explicitly via allocate_pages
 	 * 3. 返回原始内存指针 / Returns raw memory pointer
 	 */
 	inline void* allocate_memory( size_t size, size_t alignment = alignof( std::max_align_t ) )
 	{
+		( void )alignment;
+
 		// 配置内存映射标志 / Configure mmap flags
-		const long flags = MAP_PRIVATE | MAP_ANONYMOUS | ( ( alignment > 0x1000 ) ? MAP_HUGETLB : 0 );
+		const long flags = MAP_PRIVATE | MAP_ANONYMOUS;
 
 		// 直接系统调用：避免libc开销 / Direct syscall: avoids libc overhead
 		const long result = syscall( SYS_mmap,
@@ -79,13 +148,100 @@ namespace os_memory
 		// 错误处理：直接输出原始错误 / Error handling: outputs raw errno
 		if ( result < 0 )
 		{
-			std::cerr << "[Geek] mmap failure: errno=" << errno << " (" << strerr( errno ) << ")\n";
+			std::cerr << "[Geek] mmap failure: errno=" << errno << " (" << std::strerror( errno ) << ")\n";
 			return nullptr;
 		}
 
 		return reinterpret_cast<void*>( result );
 	}
 
+	/**
+	 * @brief 只预留地址范围 / Reserve an address range only
+	 * @param size 请求字节数 / requested byte count
+	 * @return 预留的起始地址 / reserved start address
+	 *
+	 * @note MAP_NORESERVE：不占交换/提交额度，页在首次访问时提交
+	 *       MAP_NORESERVE: no swap/commit charge, pages are committed on first touch
+	 */
+	inline void* reserve_memory( size_t size )
+	{
+		const long result = syscall( SYS_mmap, nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+		if ( result < 0 )
+		{
+			std::cerr << "[Geek] mmap failure: errno=" << errno << " (" << std::strerror( errno ) << ")\n";
+			return nullptr;
+		}
+		return reinterpret_cast<void*>( result );
+	}
+
+	/**
+	 * @brief 按页策略分配虚拟内存 / Allocate virtual memory under a page policy
+	 * @param size 字节数，须为 round_to_pages( size, policy ) / byte count, must equal round_to_pages( size, policy )
+	 * @param policy 期望的页策略 / requested page policy
+	 * @param obtained 可选：实际得到的策略 / optional: the policy actually obtained
+	 * @return 分配的内存地址 / allocated memory address
+	 *
+	 * @details
+	 * 1. EXPLICIT_*：MAP_HUGETLB | MAP_HUGE_2MB/1GB，巨页池不足时静默回退 / MAP_HUGETLB | MAP_HUGE_2MB/1GB, falls back silently when the pool is short
+	 * 2. TRANSPARENT：多映射 2 MiB 后裁掉首尾，使区间 2 MiB 对齐再 madvise(MADV_HUGEPAGE)
+	 *    TRANSPARENT: over-maps by 2 MiB and trims both ends so the range is 2 MiB aligned, then madvise(MADV_HUGEPAGE)
+	 * 3. NORMAL：等同 allocate_memory / NORMAL: same as allocate_memory
+	 */
+	inline void* allocate_pages( size_t size, PagePolicy policy, PagePolicy* obtained = nullptr )
+	{
+		if ( policy == PagePolicy::EXPLICIT_1G || policy == PagePolicy::EXPLICIT_2M )
+		{
+			const long huge_flag = ( policy == PagePolicy::EXPLICIT_1G ) ? MAP_HUGE_1GB : MAP_HUGE_2MB;
+			const long result = syscall( SYS_mmap, nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag, -1, 0 );
+			if ( result >= 0 )
+			{
+				if ( obtained )
+				{
+					*obtained = policy;
+				}
+				return reinterpret_cast<void*>( result );
+			}
+			return allocate_pages( size, policy == PagePolicy::EXPLICIT_1G ? PagePolicy::EXPLICIT_2M : PagePolicy::TRANSPARENT, obtained );
+		}
+
+		if ( policy == PagePolicy::TRANSPARENT )
+		{
+			const long result = syscall( SYS_mmap, nullptr, size + HUGE_PAGE_2M_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+			if ( result < 0 )
+			{
+				std::cerr << "[Geek] mmap failure: errno=" << errno << " (" << std::strerror( errno ) << ")\n";
+				return nullptr;
+			}
+
+			// 裁掉未对齐的首尾 / Trim the unaligned head and tail
+			char* const mapping = reinterpret_cast<char*>( result );
+			char* const aligned = reinterpret_cast<char*>( ( reinterpret_cast<std::uintptr_t>( mapping ) + HUGE_PAGE_2M_BYTES - 1 ) & ~( HUGE_PAGE_2M_BYTES - 1 ) );
+			const size_t head = static_cast<size_t>( aligned - mapping );
+			if ( head != 0 )
+			{
+				syscall( SYS_munmap, mapping, head );
+			}
+			if ( head != HUGE_PAGE_2M_BYTES )
+			{
+				syscall( SYS_munmap, aligned + size, HUGE_PAGE_2M_BYTES - head );
+			}
+
+			// THP 被禁用时 madvise 失败，区间仍可作普通页使用 / madvise fails when THP is disabled; the range still works as normal pages
+			const bool advised = syscall( SYS_madvise, aligned, size, MADV_HUGEPAGE ) == 0;
+			if ( obtained )
+			{
+				*obtained = advised ? PagePolicy::TRANSPARENT : PagePolicy::NORMAL;
+			}
+			return aligned;
+		}
+
+		if ( obtained )
+		{
+			*obtained = PagePolicy::NORMAL;
+		}
+		return allocate_memory( size );
+	}
+
 	/**
 	 * @brief 释放虚拟内存 / Deallocate virtual memory
 	 * @param raw_pointer 原始内存指针 / raw memory pointer
@@ -103,13 +259,140 @@ namespace os_memory
 		// 错误处理 / Error handling
 		if ( result < 0 )
 		{
-			std::cerr << "[Geek] munmap failure: errno=" << errno << " (" << strerr( errno ) << ")\n";
+			std::cerr << "[Geek] munmap failure: errno=" << errno << " (" << std::strerror( errno ) << ")\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief 调整映射长度，必要时移动页表项而不复制数据 / Resize a mapping, moving page-table entries instead of copying when needed
+	 * @param raw_pointer 映射起始地址 / mapping start address
+	 * @param old_size 当前映射字节数 / current mapping bytes
+	 * @param new_size 新映射字节数 / new mapping bytes
+	 * @return 新起始地址，失败返回 nullptr 且原映射不变 / new start address, nullptr on failure with the old mapping intact
+	 *
+	 * @note MREMAP_MAYMOVE：原地无法扩展时内核把页迁移到新地址 / MREMAP_MAYMOVE: the kernel relocates the pages when the mapping cannot grow in place
+	 */
+	inline void* remap_memory( void* raw_pointer, size_t old_size, size_t new_size )
+	{
+		const long result = syscall( SYS_mremap, raw_pointer, old_size, new_size, MREMAP_MAYMOVE );
+		if ( result < 0 )
+			return nullptr;	 // 调用方回退到复制 / Callers fall back to copying
+		return reinterpret_cast<void*>( result );
+	}
+
+	/**
+	 * @brief 归还物理页但保留地址范围 / Return the physical pages but keep the address range
+	 * @param raw_pointer 页对齐起始地址 / page-aligned start address
+	 * @param size 字节数 / byte count
+	 * @return 操作是否成功 / operation success status
+	 *
+	 * @note 使用 MADV_DONTNEED 而非 MADV_FREE：RSS 立即下降，再次访问得到零页
+	 *       Uses MADV_DONTNEED rather than MADV_FREE: RSS drops immediately and later reads see zero pages
+	 */
+	inline bool decommit_memory( void* raw_pointer, size_t size )
+	{
+		const long result = syscall( SYS_madvise, raw_pointer, size, MADV_DONTNEED );
+		if ( result < 0 )
+		{
+			std::cerr << "[Geek] madvise failure: errno=" << errno << " (" << std::strerror( errno ) << ")\n";
 			return false;
 		}
+		return true;
+	}
 
+	/**
+	 * @brief 重新提交 decommit_memory 归还的页 / Recommit pages returned by decommit_memory
+	 * @note Linux 下缺页时自动提交，无需操作 / Pages are committed on first touch on Linux, nothing to do
+	 */
+	inline bool commit_memory( void* raw_pointer, size_t size )
+	{
+		( void )raw_pointer;
+		( void )size;
 		return true;
 	}
 
+	/**
+	 * @brief NUMA 节点数 / Number of NUMA nodes
+	 * @return 最大在线节点编号 + 1，无 NUMA 信息时为 1 / highest online node + 1, 1 without NUMA information
+	 * @note 首次调用时读取 /sys/devices/system/node/online 并缓存 / Reads /sys/devices/system/node/online once and caches it
+	 */
+	inline size_t numa_node_count()
+	{
+		static const size_t node_count = [] {
+			size_t highest = 0;
+			if ( FILE* file = std::fopen( "/sys/devices/system/node/online", "r" ) )
+			{
+				// 形如 "0-1,3"：只需最大编号 / Looks like "0-1,3": only the highest number matters
+				size_t value = 0;
+				for ( int character = std::fgetc( file );; character = std::fgetc( file ) )
+				{
+					if ( character >= '0' && character <= '9' )
+					{
+						value = value * 10 + static_cast<size_t>( character - '0' );
+						continue;
+					}
+					highest = value > highest ? value : highest;
+					value = 0;
+					if ( character == EOF || character == '\n' )
+						break;
+				}
+				std::fclose( file );
+			}
+			return highest + 1;
+		}();
+		return node_count;
+	}
+
+	/**
+	 * @brief 当前线程所在 CPU 的 NUMA 节点 / NUMA node of the CPU the calling thread runs on
+	 * @note glibc 2.29+ 的 getcpu 走 vDSO，不陷入内核 / glibc 2.29+ serves getcpu from the vDSO without entering the kernel
+	 */
+	inline size_t current_numa_node()
+	{
+		unsigned cpu = 0;
+		unsigned node = 0;
+#if defined( __GLIBC__ ) && __GLIBC_PREREQ( 2, 29 )
+		if ( getcpu( &cpu, &node ) != 0 )
+			return 0;
+#else
+		if ( syscall( SYS_getcpu, &cpu, &node, nullptr ) != 0 )
+			return 0;
+#endif
+		return node;
+	}
+
+	/**
+	 * @brief 让一段映射的物理页优先落在指定节点 / Make the physical pages of a range prefer the given node
+	 * @param raw_pointer 页对齐起始地址 / page-aligned start address
+	 * @param size 字节数 / byte count
+	 * @param node 节点编号，ANY_NUMA_NODE 时不做任何事 / node number, ANY_NUMA_NODE does nothing
+	 * @return 操作是否成功 / operation success status
+	 *
+	 * @note 使用 mbind(MPOL_PREFERRED)：节点内存耗尽时回退到其他节点而不是触发 OOM；策略随映射保留，
+	 *       decommit 后重新触碰的页同样遵循。应在首次触碰前调用。
+	 *       Uses mbind(MPOL_PREFERRED): when the node runs out the kernel falls back to other nodes instead of
+	 *       invoking the OOM killer. The policy stays with the mapping, so pages touched again after a decommit
+	 *       follow it too. Call it before the range is first touched.
+	 */
+	inline bool bind_memory_to_node( void* raw_pointer, size_t size, size_t node )
+	{
+		if ( node == ANY_NUMA_NODE )
+			return true;
+
+		constexpr int	 MPOL_PREFERRED_MODE = 1;  // <linux/mempolicy.h> MPOL_PREFERRED
+		constexpr size_t MASK_BITS = 1024;
+		constexpr size_t WORD_BITS = sizeof( unsigned long ) * 8;
+		if ( node >= MASK_BITS )
+			return false;
+
+		unsigned long node_mask[ MASK_BITS / WORD_BITS ] = {};
+		node_mask[ node / WORD_BITS ] = 1UL << ( node % WORD_BITS );
+		return syscall( SYS_mbind, raw_pointer, size, MPOL_PREFERRED_MODE, node_mask, MASK_BITS, 0 ) == 0;
+	}
+
 	/*--------------------------------- Windows实现 / Windows Implementation ---*/
 #elif defined( _WIN32 )
 
@@ -163,19 +446,17 @@ namespace os_memory
 	 * 
 	 * @details
 	 * 1. 使用NT系统调用绕过Win32 API / Uses NT syscall bypassing Win32 API
-	 * 2. 大页支持：对齐>4KB时启用大页 / Large page support for alignments >4KB
+	 * 2. 映射总是页对齐；大页由 allocate_pages 显式选择 / The mapping is always page aligned; large pages are chosen explicitly via allocate_pages
 	 */
 	inline void* allocate_memory( size_t size, size_t alignment = alignof( std::max_align_t ) )
 	{
+		( void )alignment;
+
 		void*  base_address = nullptr;
 		SIZE_T allocation_size = size;
 
 		// 配置内存分配标志 / Configure allocation flags
-		ULONG allocation_type = MEM_RESERVE | MEM_COMMIT;
-		if ( alignment > 0x1000 )
-		{
-			allocation_type |= MEM_LARGE_PAGES;	 // 大页分配 / huge page allocation
-		}
+		const ULONG allocation_type = MEM_RESERVE | MEM_COMMIT;
 
 		// 调用NT内存分配函数 / Invoke NT memory allocation
 		const NTSTATUS status = get_nt_allocate_function()( GetCurrentProcess(),  // 当前进程 / current process
@@ -189,6 +470,57 @@ namespace os_memory
 		return NT_SUCCESS( status ) ? base_address : nullptr;
 	}
 
+	/**
+	 * @brief 只预留地址范围 / Reserve an address range only
+	 * @param size 请求字节数 / requested byte count
+	 * @return 预留的起始地址 / reserved start address
+	 * @note 访问前必须调用 commit_memory / commit_memory must be called before the range is touched
+	 */
+	inline void* reserve_memory( size_t size )
+	{
+		void*		   base_address = nullptr;
+		SIZE_T		   reservation_size = size;
+		const NTSTATUS status = get_nt_allocate_function()( GetCurrentProcess(), &base_address, 0, &reservation_size, MEM_RESERVE, PAGE_READWRITE );
+		return NT_SUCCESS( status ) ? base_address : nullptr;
+	}
+
+	/**
+	 * @brief 按页策略分配虚拟内存 / Allocate virtual memory under a page policy
+	 * @param size 字节数，须为 round_to_pages( size, policy ) / byte count, must equal round_to_pages( size, policy )
+	 * @param policy 期望的页策略 / requested page policy
+	 * @param obtained 可选：实际得到的策略 / optional: the policy actually obtained
+	 *
+	 * @details
+	 * 1. EXPLICIT_*：MEM_LARGE_PAGES（需 SeLockMemoryPrivilege，系统只提供一种大页尺寸），失败回退普通页
+	 *    EXPLICIT_*: MEM_LARGE_PAGES (needs SeLockMemoryPrivilege, the system offers a single large-page size), falls back to normal pages
+	 * 2. TRANSPARENT：Windows 无透明大页，按普通页分配 / TRANSPARENT: Windows has no transparent huge pages, normal pages are used
+	 */
+	inline void* allocate_pages( size_t size, PagePolicy policy, PagePolicy* obtained = nullptr )
+	{
+		const SIZE_T large_page_bytes = GetLargePageMinimum();
+		if ( ( policy == PagePolicy::EXPLICIT_1G || policy == PagePolicy::EXPLICIT_2M ) && large_page_bytes != 0 && size % large_page_bytes == 0 )
+		{
+			void*		   base_address = nullptr;
+			SIZE_T		   allocation_size = size;
+			const NTSTATUS status =
+				get_nt_allocate_function()( GetCurrentProcess(), &base_address, 0, &allocation_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+			if ( NT_SUCCESS( status ) )
+			{
+				if ( obtained )
+				{
+					*obtained = PagePolicy::EXPLICIT_2M;
+				}
+				return base_address;
+			}
+		}
+
+		if ( obtained )
+		{
+			*obtained = PagePolicy::NORMAL;
+		}
+		return allocate_memory( size );
+	}
+
 	/**
 	 * @brief 释放虚拟内存 / Deallocate virtual memory
 	 * @param raw_pointer 原始内存指针 / raw memory pointer
@@ -207,25 +539,163 @@ namespace os_memory
 		return NT_SUCCESS( status );
 	}
 
+	/**
+	 * @brief 调整映射长度 / Resize a mapping
+	 * @return Windows 无 mremap 等价物，总是返回 nullptr，调用方回退到复制 / Windows has no mremap equivalent; always nullptr so callers fall back to copying
+	 */
+	inline void* remap_memory( void* raw_pointer, size_t old_size, size_t new_size )
+	{
+		( void )raw_pointer;
+		( void )old_size;
+		( void )new_size;
+		return nullptr;
+	}
+
+	/**
+	 * @brief 归还物理页但保留地址范围 / Return the physical pages but keep the address range
+	 * @param raw_pointer 页对齐起始地址 / page-aligned start address
+	 * @param size 字节数 / byte count
+	 * @return 操作是否成功 / operation success status
+	 * @note 再次访问前必须调用 commit_memory / commit_memory must be called before the range is touched again
+	 */
+	inline bool decommit_memory( void* raw_pointer, size_t size )
+	{
+		SIZE_T		   decommit_size = size;
+		const NTSTATUS status = get_nt_free_function()( GetCurrentProcess(), &raw_pointer, &decommit_size, MEM_DECOMMIT );
+		return NT_SUCCESS( status );
+	}
+
+	/**
+	 * @brief 重新提交 decommit_memory 归还的页 / Recommit pages returned by decommit_memory
+	 */
+	inline bool commit_memory( void* raw_pointer, size_t size )
+	{
+		SIZE_T		   commit_size = size;
+		const NTSTATUS status = get_nt_allocate_function()( GetCurrentProcess(), &raw_pointer, 0, &commit_size, MEM_COMMIT, PAGE_READWRITE );
+		return NT_SUCCESS( status );
+	}
+
+	/**
+	 * @brief NUMA 节点数 / Number of NUMA nodes
+	 * @return 最大节点编号 + 1 / highest node number + 1
+	 */
+	inline size_t numa_node_count()
+	{
+		ULONG highest = 0;
+		if ( !GetNumaHighestNodeNumber( &highest ) )
+			return 1;
+		return static_cast<size_t>( highest ) + 1;
+	}
+
+	/**
+	 * @brief 当前线程所在处理器的 NUMA 节点 / NUMA node of the processor the calling thread runs on
+	 */
+	inline size_t current_numa_node()
+	{
+		PROCESSOR_NUMBER processor {};
+		GetCurrentProcessorNumberEx( &processor );
+		USHORT node = 0;
+		if ( !GetNumaProcessorNodeEx( &processor, &node ) )
+			return 0;
+		return node;
+	}
+
+	/**
+	 * @brief 让一段映射的物理页优先落在指定节点 / Make the physical pages of a range prefer the given node
+	 * @param node 节点编号，ANY_NUMA_NODE 时不做任何事 / node number, ANY_NUMA_NODE does nothing
+	 *
+	 * @note Windows 只能在提交时指定首选节点：已提交的子区间用 VirtualAllocExNuma 重新提交，尚未触碰的页随之落在该节点；
+	 *       仅预留的部分之后由 commit_memory 提交，沿用默认的首次触碰策略。
+	 *       Windows only takes a preferred node at commit time: committed sub-ranges are committed again through
+	 *       VirtualAllocExNuma so their untouched pages land on the node; reserved-only parts are committed later by
+	 *       commit_memory and keep the default first-touch placement.
+	 */
+	inline bool bind_memory_to_node( void* raw_pointer, size_t size, size_t node )
+	{
+		if ( node == ANY_NUMA_NODE )
+			return true;
+
+		char*		cursor = static_cast<char*>( raw_pointer );
+		char* const end = cursor + size;
+		bool		bound = true;
+		while ( cursor < end )
+		{
+			MEMORY_BASIC_INFORMATION information {};
+			if ( !VirtualQuery( cursor, &information, sizeof( information ) ) )
+				return false;
+			char* region_end = static_cast<char*>( information.BaseAddress ) + information.RegionSize;
+			region_end = region_end < end ? region_end : end;
+			if ( information.State == MEM_COMMIT &&
+				 !VirtualAllocExNuma( GetCurrentProcess(), cursor, static_cast<SIZE_T>( region_end - cursor ), MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>( node ) ) )
+				bound = false;
+			cursor = region_end;
+		}
+		return bound;
+	}
+
+#endif	// 平台选择结束 / End of platform selection
+
 	// ────────────────────────────────────────────────────────────
 	//  计数封装：allocate_tracked / deallocate_tracked
 	//  - 如果分配成功 (ptr != nullptr) →  memory_counter.fetch_add(size)
 	//  - 如果释放成功               →  memory_counter.fetch_sub(size)
 	//  - 计数单位：字节
-	//  - 线程安全：使用 relaxed 语义够用，想更严格自行换成 acq_rel
+	//  - 线程安全：纯统计量，不发布任何数据，relaxed 即可
+	//    Thread safety: pure statistics that publish nothing, so relaxed is enough
+	//  - account 非空时同样计入该所有者 / A non-null account is charged as well
 	// ────────────────────────────────────────────────────────────
-	inline void* allocate_tracked( size_t size, size_t alignment = alignof( std::max_align_t ) )
+	inline void count_mapping( MappingAccount* account, uint64_t bytes, int64_t operations )
+	{
+		used_memory_bytes_counter.fetch_add( bytes, std::memory_order_relaxed );	 // 无符号回绕即净增减 / Unsigned wrap-around yields the net change
+		user_operation_counter.fetch_add( operations, std::memory_order_relaxed );
+		if ( account != nullptr )
+		{
+			account->mapped_bytes.fetch_add( bytes, std::memory_order_relaxed );
+			account->operations.fetch_add( operations, std::memory_order_relaxed );
+		}
+	}
+
+	inline void* allocate_tracked( size_t size, size_t alignment = alignof( std::max_align_t ), MappingAccount* account = nullptr )
 	{
 		void* pointer = allocate_memory( size, alignment );
 		if ( pointer != nullptr )
 		{
-			used_memory_bytes_counter.fetch_add( size, std::memory_order_acq_rel ); // 成功才计数
-			user_operation_counter++;
+			count_mapping( account, size, 1 ); // 成功才计数
 		}
 		return pointer;
 	}
 
-	inline bool deallocate_tracked( void* raw_pointer, size_t size )
+	inline void* allocate_pages_tracked( size_t size, PagePolicy policy, PagePolicy* obtained = nullptr, MappingAccount* account = nullptr )
+	{
+		void* pointer = allocate_pages( size, policy, obtained );
+		if ( pointer != nullptr )
+		{
+			count_mapping( account, size, 1 );
+		}
+		return pointer;
+	}
+
+	inline void* reserve_tracked( size_t size, MappingAccount* account = nullptr )
+	{
+		void* pointer = reserve_memory( size );
+		if ( pointer != nullptr )
+		{
+			count_mapping( account, size, 1 ); // 预留同样计数，由 deallocate_tracked 扣减
+		}
+		return pointer;
+	}
+
+	inline void* remap_tracked( void* raw_pointer, size_t old_size, size_t new_size, MappingAccount* account = nullptr )
+	{
+		void* pointer = remap_memory( raw_pointer, old_size, new_size );
+		if ( pointer != nullptr )
+		{
+			count_mapping( account, uint64_t( new_size ) - uint64_t( old_size ), 0 );
+		}
+		return pointer;
+	}
+
+	inline bool deallocate_tracked( void* raw_pointer, size_t size, MappingAccount* account = nullptr )
 	{
 		if ( raw_pointer == nullptr )
 		{
@@ -235,14 +705,11 @@ namespace os_memory
 		const bool ok = deallocate_memory( raw_pointer, size );
 		if ( ok )
 		{
-			used_memory_bytes_counter.fetch_sub( size, std::memory_order_acq_rel ); // 只有真正释放成功才扣减
-			user_operation_counter--;
+			count_mapping( account, uint64_t( 0 ) - uint64_t( size ), -1 ); // 只有真正释放成功才扣减
 		}
 		return ok;
 	}
 
-#endif	// 平台选择结束 / End of platform selection
-
 }  // namespace os_memory
 
 #endif	// OS_MEMORY_HPP
\ No newline at end of file
@@ -0,0 +1,439 @@
+/**
+ * @file size_class_policy.hpp
+ * @brief 尺寸类策略、尺寸直方图与桶表生成 / Size-class policy, size histogram and bucket table generation
+ *
+ * @details
+ * 1. 尺寸类策略提供 Small 桶尺寸表与各层阈值，SmallMemoryManager 与 MemoryPool 的全部常量都由它派生。
+ *    构建时以 MEMORY_POOL_SIZE_CLASS_POLICY_HEADER 指向一个定义 MEMORY_POOL_SIZE_CLASS_POLICY 的头文件即可替换默认策略。
+ * 2. SizeHistogramRecorder 在运行中的进程里按桶请求尺寸记录直方图（开启前只有一次 relaxed 读）。
+ * 3. generate_size_classes 用动态规划在「桶数 / 期望浪费 / 最坏浪费」之间求最优表，write_size_class_policy 写出 constexpr 策略头文件。
+ *
+ * 1. A size-class policy supplies the Small bucket table and the tier thresholds; every related constant of
+ *    SmallMemoryManager and MemoryPool derives from it. Point MEMORY_POOL_SIZE_CLASS_POLICY_HEADER at a header that
+ *    defines MEMORY_POOL_SIZE_CLASS_POLICY to replace the default policy at build time.
+ * 2. SizeHistogramRecorder records a histogram of bucket request sizes in a running process (one relaxed load
+ *    until it is started).
+ * 3. generate_size_classes finds the optimal table for a bucket-count / expected-waste / worst-case-waste trade-off
+ *    by dynamic programming, and write_size_class_policy writes it out as a constexpr policy header.
+ *
+ * 代码风格说明 / Style Notes
+ * ---------------------------------------------------------------------------
+ * 1. 彻底避免缩写：所有标识符均使用完整单词 (bucket, histogram, candidate...)；
+ * 2. 中英文注释并存，支持 Doxygen 文档 / Bilingual comments with Doxygen support.
+ */
+
+#pragma once
+#ifndef SIZE_CLASS_POLICY_HPP
+#define SIZE_CLASS_POLICY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace os_memory::memory_pool
+{
+	static constexpr std::size_t SLAB_BUCKET_LIMIT_BYTES = 1024;			 //!< 桶尺寸不超过该值的桶走 slab / Buckets up to this size use slabs
+	static constexpr std::size_t SIZE_CLASS_MINIMUM_BUCKET_BYTES = 8;		 //!< 最小桶，slab 空闲链接的大小 / Smallest bucket, the size of a slab free link
+	static constexpr std::size_t SIZE_CLASS_MAXIMUM_SMALL_BYTES = 1 << 20;	 //!< Small 层上限不超过 Medium 最小块 / The Small tier never exceeds the smallest Medium block
+	static constexpr std::size_t SIZE_CLASS_MAXIMUM_MEDIUM_BYTES = 512 * 1024 * 1024;  //!< Medium 最高阶 / Top Medium order
+
+	/**
+	 * @brief 默认尺寸类策略：64 桶，线性到 256 后几何增长到 1 MiB / Default size-class policy: 64 buckets, linear to 256 then geometric to 1 MiB
+	 *
+	 * 策略须提供 BUCKET_SIZES（std::array，严格递增，末项即 SMALL_BLOCK_MAX_SIZE）与三个层级阈值。
+	 * A policy provides BUCKET_SIZES (a strictly ascending std::array whose last entry is SMALL_BLOCK_MAX_SIZE) and the three tier thresholds.
+	 */
+	struct DefaultSizeClassPolicy
+	{
+		static constexpr std::array<std::size_t, 64> BUCKET_SIZES = { 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120, 128, 136, 144, 152, 160, 168, 176, 184, 192, 200, 208, 216, 224, 232, 240, 248, 256, 336, 432, 560, 728, 944, 1224, 1584, 2048, 2656, 3448, 4472, 5800, 7520, 9744, 12640, 16384, 21248, 27560, 35736, 46344, 60104, 77936, 101072, 131072, 169984, 220440, 285872, 370728, 480776, 623488, 808568, 1048576 };
+
+		static constexpr std::size_t SMALL_BLOCK_MAX_SIZE = 1 * 1024 * 1024;		 //!< 1 MiB (含) / Up to 1 MiB
+		static constexpr std::size_t MEDIUM_BLOCK_MAX_SIZE = 512 * 1024 * 1024;		 //!< 512 MiB (含) / Up to 512 MiB
+		static constexpr std::size_t HUGE_BLOCK_THRESHOLD = 1 * 1024 * 1024 * 1024;	 //!< 1 GiB (含) / Up to 1 GiB
+	};
+
+	/**
+	 * @brief 策略的层级约束；桶表本身由 BucketIndexLookup 在常量求值时校验 / Tier constraints of a policy; the table itself is checked by BucketIndexLookup during constant evaluation
+	 */
+	template <typename Policy>
+	constexpr bool is_valid_size_class_policy()
+	{
+		constexpr auto& sizes = Policy::BUCKET_SIZES;
+		return sizes.size() > 0 && sizes.front() >= SIZE_CLASS_MINIMUM_BUCKET_BYTES && sizes.front() <= SLAB_BUCKET_LIMIT_BYTES	 // 至少一个 slab 桶 / at least one slab bucket
+			   && Policy::SMALL_BLOCK_MAX_SIZE == sizes.back() && Policy::SMALL_BLOCK_MAX_SIZE > SLAB_BUCKET_LIMIT_BYTES
+			   && Policy::SMALL_BLOCK_MAX_SIZE <= SIZE_CLASS_MAXIMUM_SMALL_BYTES && Policy::MEDIUM_BLOCK_MAX_SIZE > Policy::SMALL_BLOCK_MAX_SIZE
+			   && Policy::MEDIUM_BLOCK_MAX_SIZE <= SIZE_CLASS_MAXIMUM_MEDIUM_BYTES && Policy::HUGE_BLOCK_THRESHOLD >= Policy::MEDIUM_BLOCK_MAX_SIZE;
+	}
+
+	/* ============================================================
+	 *  尺寸直方图 / Size histogram
+	 * ============================================================ */
+
+	/**
+	 * @brief 按桶请求尺寸分箱的直方图 / Histogram binned by bucket request size
+	 *
+	 * @details
+	 * 分箱与 BucketIndexLookup 的查表粒度一致：≤ 1024 按 8 字节，之上每个 2 的幂区间 8 段，直到 1 MiB。
+	 * 箱的上界正是生成器可选的桶尺寸，因此对生成的表，期望浪费按箱内请求字节总和精确计算。
+	 * 记录的是桶需要容纳的字节：slab 范围内即请求字节，之上加 NotAlignHeader。
+	 *
+	 * Bins follow the lookup granularity of BucketIndexLookup: 8-byte steps up to 1024, then 8 slots per power of two
+	 * up to 1 MiB. Bin upper bounds are exactly the bucket sizes the generator may pick, so expected waste is exact for
+	 * generated tables thanks to the per-bin sum of requested bytes. Values are the bytes a bucket must hold: the
+	 * request itself in the slab range, plus the NotAlignHeader above it.
+	 */
+	struct SizeHistogram
+	{
+		static constexpr std::size_t LINEAR_STEP_BYTES = 8;
+		static constexpr std::size_t LINEAR_BIN_COUNT = SLAB_BUCKET_LIMIT_BYTES / LINEAR_STEP_BYTES;
+		static constexpr std::size_t SUB_BITS = 3;
+		static constexpr std::size_t SUB_COUNT = std::size_t( 1 ) << SUB_BITS;
+		static constexpr std::size_t FIRST_EXPONENT = std::bit_width( SLAB_BUCKET_LIMIT_BYTES ) - 1;
+		static constexpr std::size_t END_EXPONENT = std::bit_width( SIZE_CLASS_MAXIMUM_SMALL_BYTES ) - 1;
+		static constexpr std::size_t BIN_COUNT = LINEAR_BIN_COUNT + ( END_EXPONENT - FIRST_EXPONENT ) * SUB_COUNT;
+		static constexpr std::size_t HEADERED_EXTRA_BYTES = 16;	 //!< slab 范围之上每块的 NotAlignHeader / NotAlignHeader per block above the slab range
+
+		std::array<std::uint64_t, BIN_COUNT> counts {};	//!< 每箱请求数 / Requests per bin
+		std::array<std::uint64_t, BIN_COUNT> bytes {};	//!< 每箱请求字节总和 / Sum of requested bytes per bin
+
+		/// @brief 请求字节 → 桶需要容纳的字节 / Requested bytes → bytes the bucket has to hold
+		static constexpr std::size_t bucket_request_bytes( std::size_t requested_bytes ) noexcept
+		{
+			return requested_bytes <= SLAB_BUCKET_LIMIT_BYTES ? requested_bytes : requested_bytes + HEADERED_EXTRA_BYTES;
+		}
+
+		/// @return 箱号，超出 Small 层返回 BIN_COUNT / bin index, BIN_COUNT beyond the Small tier
+		static constexpr std::size_t bin_of( std::size_t bucket_bytes ) noexcept
+		{
+			if ( bucket_bytes <= SLAB_BUCKET_LIMIT_BYTES )
+				return bucket_bytes == 0 ? 0 : ( bucket_bytes - 1 ) / LINEAR_STEP_BYTES;
+			if ( bucket_bytes > SIZE_CLASS_MAXIMUM_SMALL_BYTES )
+				return BIN_COUNT;
+			const std::size_t value = bucket_bytes - 1;
+			const std::size_t exponent = static_cast<std::size_t>( std::bit_width( value ) ) - 1;
+			const std::size_t sub = ( value >> ( exponent - SUB_BITS ) ) & ( SUB_COUNT - 1 );
+			return LINEAR_BIN_COUNT + ( exponent - FIRST_EXPONENT ) * SUB_COUNT + sub;
+		}
+
+		/// @brief 箱的上界（含）/ Inclusive upper bound of a bin
+		static constexpr std::size_t bin_upper_bytes( std::size_t bin ) noexcept
+		{
+			if ( bin < LINEAR_BIN_COUNT )
+				return ( bin + 1 ) * LINEAR_STEP_BYTES;
+			const std::size_t exponent = FIRST_EXPONENT + ( bin - LINEAR_BIN_COUNT ) / SUB_COUNT;
+			const std::size_t sub = ( bin - LINEAR_BIN_COUNT ) % SUB_COUNT;
+			return ( std::size_t( 1 ) << exponent ) + ( ( sub + 1 ) << ( exponent - SUB_BITS ) );
+		}
+
+		/// @brief 按请求字节计入 / Count requests by their requested bytes
+		void add( std::size_t requested_bytes, std::uint64_t count = 1 )
+		{
+			const std::size_t bucket_bytes = bucket_request_bytes( requested_bytes );
+			const std::size_t bin = bin_of( bucket_bytes );
+			if ( bin == BIN_COUNT )
+				return;
+			counts[ bin ] += count;
+			bytes[ bin ] += count * bucket_bytes;
+		}
+
+		std::uint64_t total_count() const
+		{
+			std::uint64_t total = 0;
+			for ( std::uint64_t count : counts )
+				total += count;
+			return total;
+		}
+
+		/// @brief 写出 "上界 请求数 字节总和" 文本行，省略空箱 / Write "upper_bytes count bytes" text lines, empty bins omitted
+		void write( std::ostream& output ) const
+		{
+			for ( std::size_t bin = 0; bin < BIN_COUNT; ++bin )
+			{
+				if ( counts[ bin ] != 0 )
+					output << bin_upper_bytes( bin ) << " " << counts[ bin ] << " " << bytes[ bin ] << "\n";
+			}
+		}
+
+		/// @brief 读回 write 的输出，上界不在分箱边界上的行被跳过 / Read back what write produced; lines whose bound is not a bin edge are skipped
+		static SizeHistogram read( std::istream& input )
+		{
+			SizeHistogram histogram;
+			std::size_t	  upper_bytes = 0;
+			std::uint64_t count = 0;
+			std::uint64_t bytes = 0;
+			while ( input >> upper_bytes >> count >> bytes )
+			{
+				const std::size_t bin = bin_of( upper_bytes );
+				if ( bin == BIN_COUNT || bin_upper_bytes( bin ) != upper_bytes )
+					continue;
+				histogram.counts[ bin ] += count;
+				histogram.bytes[ bin ] += bytes;
+			}
+			return histogram;
+		}
+	};
+
+	static_assert( SizeHistogram::bin_upper_bytes( SizeHistogram::BIN_COUNT - 1 ) == SIZE_CLASS_MAXIMUM_SMALL_BYTES );
+	static_assert( SizeHistogram::bin_of( 1025 ) == SizeHistogram::LINEAR_BIN_COUNT && SizeHistogram::bin_of( 1152 ) == SizeHistogram::LINEAR_BIN_COUNT );
+
+	/**
+	 * @brief 进程内的尺寸直方图记录器 / In-process size histogram recorder
+	 * @note 运行时每次分配一次 relaxed fetch_add；只用于采集期，不宜常开 / One relaxed fetch_add per allocation while running; meant for a collection window, not for always-on use
+	 */
+	class SizeHistogramRecorder
+	{
+	public:
+		static SizeHistogramRecorder& instance()
+		{
+			static SizeHistogramRecorder recorder_instance;
+			return recorder_instance;
+		}
+
+		void start()
+		{
+			running.store( true, std::memory_order_release );
+		}
+
+		void stop()
+		{
+			running.store( false, std::memory_order_release );
+		}
+
+		bool is_running() const
+		{
+			return running.load( std::memory_order_relaxed );
+		}
+
+		void reset()
+		{
+			for ( std::size_t bin = 0; bin < SizeHistogram::BIN_COUNT; ++bin )
+			{
+				counts[ bin ].store( 0, std::memory_order_relaxed );
+				bytes[ bin ].store( 0, std::memory_order_relaxed );
+			}
+		}
+
+		/// @brief 分配完成后调用；未运行时只有一次原子读 / Call after an allocation; a single atomic load while stopped
+		void record( std::size_t requested_bytes, std::size_t count = 1 )
+		{
+			if ( !running.load( std::memory_order_relaxed ) )
+				return;
+			const std::size_t bucket_bytes = SizeHistogram::bucket_request_bytes( requested_bytes );
+			const std::size_t bin = SizeHistogram::bin_of( bucket_bytes );
+			if ( bin == SizeHistogram::BIN_COUNT )
+				return;
+			counts[ bin ].fetch_add( count, std::memory_order_relaxed );
+			bytes[ bin ].fetch_add( static_cast<std::uint64_t>( count ) * bucket_bytes, std::memory_order_relaxed );
+		}
+
+		SizeHistogram snapshot() const
+		{
+			SizeHistogram histogram;
+			for ( std::size_t bin = 0; bin < SizeHistogram::BIN_COUNT; ++bin )
+			{
+				histogram.counts[ bin ] = counts[ bin ].load( std::memory_order_relaxed );
+				histogram.bytes[ bin ] = bytes[ bin ].load( std::memory_order_relaxed );
+			}
+			return histogram;
+		}
+
+	private:
+		SizeHistogramRecorder() = default;
+
+		std::atomic<bool>											running { false };
+		std::array<std::atomic<std::uint64_t>, SizeHistogram::BIN_COUNT> counts {};
+		std::array<std::atomic<std::uint64_t>, SizeHistogram::BIN_COUNT> bytes {};
+	};
+
+	/* ============================================================
+	 *  桶表生成 / Bucket table generation
+	 * ============================================================ */
+
+	struct SizeClassGeneratorOptions
+	{
+		std::size_t bucket_count = 64;		//!< 桶数上限（≤ 256）/ Upper bound on buckets (≤ 256)
+		double		worst_case_waste = 0.25;  //!< 任意尺寸（含未出现的）最多浪费桶的比例 / Largest share of a bucket any size, seen or not, may waste
+		double		target_waste = 0.0;		//!< > 0 时取期望浪费不超过它的最少桶数 / When > 0, take the fewest buckets whose expected waste stays below it
+	};
+
+	/**
+	 * @brief 期望内部碎片：直方图落入表后未被请求的字节比例 / Expected internal fragmentation: share of carried bytes nobody asked for
+	 * @note 跨越桶边界的箱整体计入上方的桶，对生成的表是精确值 / A bin straddling a bucket boundary is charged to the bucket above; exact for generated tables
+	 */
+	template <typename BucketSizes>
+	double expected_waste( const SizeHistogram& histogram, const BucketSizes& bucket_sizes )
+	{
+		double wasted_bytes = 0.0;
+		double requested_bytes = 0.0;
+		for ( std::size_t bin = 0; bin < SizeHistogram::BIN_COUNT; ++bin )
+		{
+			if ( histogram.counts[ bin ] == 0 )
+				continue;
+			const auto bucket = std::lower_bound( std::begin( bucket_sizes ), std::end( bucket_sizes ), SizeHistogram::bin_upper_bytes( bin ) );
+			if ( bucket == std::end( bucket_sizes ) )
+				continue;
+			wasted_bytes += static_cast<double>( *bucket ) * static_cast<double>( histogram.counts[ bin ] ) - static_cast<double>( histogram.bytes[ bin ] );
+			requested_bytes += static_cast<double>( histogram.bytes[ bin ] );
+		}
+		const double carried_bytes = wasted_bytes + requested_bytes;
+		return carried_bytes > 0.0 ? wasted_bytes / carried_bytes : 0.0;
+	}
+
+	/**
+	 * @brief 由直方图求最优桶表 / Derive the optimal bucket table from a histogram
+	 * @return 严格递增的桶尺寸，含 SLAB_BUCKET_LIMIT_BYTES 与 1 MiB / strictly ascending bucket sizes, SLAB_BUCKET_LIMIT_BYTES and 1 MiB included
+	 * @throw std::invalid_argument 桶数不足以满足 worst_case_waste / when bucket_count cannot satisfy worst_case_waste
+	 *
+	 * @details
+	 * 候选尺寸即各箱上界，因此结果天然满足 BucketIndexLookup 的约束（线性区 8 的倍数、每个查表段至多一个边界）。
+	 * SLAB_BUCKET_LIMIT_BYTES 必选，使 slab 范围与记录时的假设一致。动态规划 dp[k][j] 为 k 个桶、末桶取候选 j 时的
+	 * 最小浪费字节；相邻桶的间隔不超过 max(16, worst_case_waste × 桶尺寸)。同等浪费时取更少的桶。
+	 *
+	 * Candidates are the bin upper bounds, so the result satisfies BucketIndexLookup by construction (multiples of 8 in
+	 * the linear range, at most one boundary per lookup slot). SLAB_BUCKET_LIMIT_BYTES is mandatory so the slab range
+	 * matches what the recorder assumed. The dynamic programme dp[k][j] is the least wasted bytes with k buckets and the
+	 * last one at candidate j; neighbouring buckets are at most max(16, worst_case_waste × bucket size) apart. Ties go to
+	 * fewer buckets.
+	 */
+	inline std::vector<std::size_t> generate_size_classes( const SizeHistogram& histogram, const SizeClassGeneratorOptions& options = {} )
+	{
+		constexpr std::size_t CANDIDATE_COUNT = SizeHistogram::BIN_COUNT;
+		constexpr std::size_t SLAB_LIMIT_CANDIDATE = SizeHistogram::LINEAR_BIN_COUNT - 1;
+		constexpr std::size_t LAST_CANDIDATE = CANDIDATE_COUNT - 1;
+		constexpr std::size_t NONE = CANDIDATE_COUNT;  // 虚拟起点，尺寸 0 / Virtual start at size 0
+		constexpr std::size_t MINIMUM_GAP_BYTES = 16;
+		constexpr double	  INFINITE_WASTE = std::numeric_limits<double>::infinity();
+
+		const std::size_t maximum_buckets = std::clamp<std::size_t>( options.bucket_count, 1, 256 );
+
+		// 前缀和：prefix[j] 为前 j 个箱之和 / Prefix sums: prefix[j] covers the first j bins
+		std::array<double, CANDIDATE_COUNT + 1> prefix_counts {};
+		std::array<double, CANDIDATE_COUNT + 1> prefix_bytes {};
+		for ( std::size_t bin = 0; bin < CANDIDATE_COUNT; ++bin )
+		{
+			prefix_counts[ bin + 1 ] = prefix_counts[ bin ] + static_cast<double>( histogram.counts[ bin ] );
+			prefix_bytes[ bin + 1 ] = prefix_bytes[ bin ] + static_cast<double>( histogram.bytes[ bin ] );
+		}
+
+		auto first_bin_after = [ & ]( std::size_t previous ) {
+			return previous == NONE ? 0 : previous + 1;
+		};
+		auto allowed = [ & ]( std::size_t previous, std::size_t candidate ) {
+			const std::size_t first_bin = first_bin_after( previous );
+			if ( first_bin <= SLAB_LIMIT_CANDIDATE && SLAB_LIMIT_CANDIDATE < candidate )
+				return false;  // 不得越过必选桶 / Never skip the mandatory bucket
+			const double bucket_bytes = static_cast<double>( SizeHistogram::bin_upper_bytes( candidate ) );
+			const double previous_bytes = previous == NONE ? 0.0 : static_cast<double>( SizeHistogram::bin_upper_bytes( previous ) );
+			return bucket_bytes - previous_bytes <= std::max( static_cast<double>( MINIMUM_GAP_BYTES ), options.worst_case_waste * bucket_bytes );
+		};
+		auto waste = [ & ]( std::size_t previous, std::size_t candidate ) {
+			const std::size_t first_bin = first_bin_after( previous );
+			const double	  bucket_bytes = static_cast<double>( SizeHistogram::bin_upper_bytes( candidate ) );
+			return bucket_bytes * ( prefix_counts[ candidate + 1 ] - prefix_counts[ first_bin ] ) - ( prefix_bytes[ candidate + 1 ] - prefix_bytes[ first_bin ] );
+		};
+
+		std::vector<std::array<double, CANDIDATE_COUNT>>	  least_waste( maximum_buckets + 1 );
+		std::vector<std::array<std::size_t, CANDIDATE_COUNT>> parent( maximum_buckets + 1 );
+		for ( std::size_t candidate = 0; candidate < CANDIDATE_COUNT; ++candidate )
+		{
+			least_waste[ 1 ][ candidate ] = allowed( NONE, candidate ) ? waste( NONE, candidate ) : INFINITE_WASTE;
+			parent[ 1 ][ candidate ] = NONE;
+		}
+		for ( std::size_t buckets = 2; buckets <= maximum_buckets; ++buckets )
+		{
+			for ( std::size_t candidate = 0; candidate < CANDIDATE_COUNT; ++candidate )
+			{
+				double		best = INFINITE_WASTE;
+				std::size_t best_previous = NONE;
+				for ( std::size_t previous = 0; previous < candidate; ++previous )
+				{
+					if ( least_waste[ buckets - 1 ][ previous ] == INFINITE_WASTE || !allowed( previous, candidate ) )
+						continue;
+					const double total = least_waste[ buckets - 1 ][ previous ] + waste( previous, candidate );
+					if ( total < best )
+					{
+						best = total;
+						best_previous = previous;
+					}
+				}
+				least_waste[ buckets ][ candidate ] = best;
+				parent[ buckets ][ candidate ] = best_previous;
+			}
+		}
+
+		/* 选桶数 / Pick the bucket count */
+		const double requested_bytes = prefix_bytes[ CANDIDATE_COUNT ];
+		std::size_t	 chosen_buckets = 0;
+		for ( std::size_t buckets = 1; buckets <= maximum_buckets; ++buckets )
+		{
+			const double total = least_waste[ buckets ][ LAST_CANDIDATE ];
+			if ( total == INFINITE_WASTE )
+				continue;
+			if ( options.target_waste > 0.0 && total <= options.target_waste * ( total + requested_bytes ) )
+			{
+				chosen_buckets = buckets;
+				break;
+			}
+			if ( chosen_buckets == 0 || total < least_waste[ chosen_buckets ][ LAST_CANDIDATE ] )
+				chosen_buckets = buckets;
+		}
+		if ( chosen_buckets == 0 )
+			throw std::invalid_argument( "generate_size_classes: bucket_count is too small for worst_case_waste" );
+
+		std::vector<std::size_t> bucket_sizes( chosen_buckets );
+		for ( std::size_t candidate = LAST_CANDIDATE, buckets = chosen_buckets; buckets > 0; candidate = parent[ buckets ][ candidate ], --buckets )
+			bucket_sizes[ buckets - 1 ] = SizeHistogram::bin_upper_bytes( candidate );
+		return bucket_sizes;
+	}
+
+	/**
+	 * @brief 写出 constexpr 策略头文件 / Write a constexpr policy header
+	 * @param policy_name  生成的结构体名 / name of the generated struct
+	 * @note 以 MEMORY_POOL_SIZE_CLASS_POLICY_HEADER 指向该文件重新构建即可生效；层级阈值沿用默认值
+	 *       Rebuild with MEMORY_POOL_SIZE_CLASS_POLICY_HEADER pointing at the file to use it; tier thresholds keep the defaults
+	 */
+	inline void write_size_class_policy( std::ostream& output, const std::vector<std::size_t>& bucket_sizes, std::string_view policy_name = "TunedSizeClassPolicy" )
+	{
+		output << "// 由 write_size_class_policy 依据记录的尺寸直方图生成 / Generated by write_size_class_policy from a recorded size histogram\n"
+			   << "#pragma once\n\n#include <array>\n#include <cstddef>\n\n"
+			   << "struct " << policy_name << "\n{\n"
+			   << "\tstatic constexpr std::array<std::size_t, " << bucket_sizes.size() << "> BUCKET_SIZES = { ";
+		for ( std::size_t index = 0; index < bucket_sizes.size(); ++index )
+			output << ( index ? ", " : "" ) << bucket_sizes[ index ];
+		output << " };\n\n"
+			   << "\tstatic constexpr std::size_t SMALL_BLOCK_MAX_SIZE = " << ( bucket_sizes.empty() ? 0 : bucket_sizes.back() ) << ";\n"
+			   << "\tstatic constexpr std::size_t MEDIUM_BLOCK_MAX_SIZE = " << DefaultSizeClassPolicy::MEDIUM_BLOCK_MAX_SIZE << ";\n"
+			   << "\tstatic constexpr std::size_t HUGE_BLOCK_THRESHOLD = " << DefaultSizeClassPolicy::HUGE_BLOCK_THRESHOLD << ";\n"
+			   << "};\n\n"
+			   << "#define MEMORY_POOL_SIZE_CLASS_POLICY " << policy_name << "\n";
+	}
+}  // namespace os_memory::memory_pool
+
+/* ============================================================
+ *  构建时选择策略 / Build-time policy selection
+ * ============================================================ */
+#if defined( MEMORY_POOL_SIZE_CLASS_POLICY_HEADER )
+#include MEMORY_POOL_SIZE_CLASS_POLICY_HEADER
+#endif
+
+#if !defined( MEMORY_POOL_SIZE_CLASS_POLICY )
+#define MEMORY_POOL_SIZE_CLASS_POLICY os_memory::memory_pool::DefaultSizeClassPolicy
+#endif
+
+namespace os_memory::memory_pool
+{
+	using ActiveSizeClassPolicy = MEMORY_POOL_SIZE_CLASS_POLICY;  //!< 本次构建使用的策略 / Policy this build uses
+
+	static_assert( is_valid_size_class_policy<ActiveSizeClassPolicy>(), "size-class policy violates the tier constraints" );
+}  // namespace os_memory::memory_pool
+
+#endif	// SIZE_CLASS_POLICY_HPP
@@ -3,9 +3,11 @@
  * @brief STL 兼容分配器实现 / STL-compatible allocator implementation
  *
  * @details
- * 1. 基于线程本地的 PoolAllocator 实现 / Implemented using thread-local PoolAllocator
- * 2. 提供可选的不抛出异常接口 / Optional nothrow allocation interface
- * 3. 满足 C++11 及以上 std::allocator 要求 / Compliant with C++11 and above std::allocator requirements
+ * 1. STL_Allocator 使用进程共享的 GlobalAllocator，容器可以跨线程移动 / STL_Allocator uses the process-wide GlobalAllocator, so containers may move between threads
+ * 2. PoolBoundAllocator 携带指定分配器的引用，供各子系统使用各自的池 / PoolBoundAllocator carries a reference to a chosen allocator, so each subsystem can own a pool
+ * 3. PoolMemoryResource 把任意 InterfaceAllocator 适配为 std::pmr::memory_resource / PoolMemoryResource adapts any InterfaceAllocator to std::pmr::memory_resource
+ * 4. 提供可选的不抛出异常接口 / Optional nothrow allocation interface
+ * 5. 满足 C++11 及以上 std::allocator 要求 / Compliant with C++11 and above std::allocator requirements
  *
  * 代码风格 / Style Notes:
  * 1. 完全避免缩写：All identifiers use full words.
@@ -19,9 +21,11 @@
 #ifndef STL_ALLOCATOR_HPP
 #define STL_ALLOCATOR_HPP
 
-#include "memory_allocators.hpp"  // 包含 PoolAllocator 定义 / Include PoolAllocator definition
+#include "global_allocator_api.hpp"  // GlobalAllocator 与 InterfaceAllocator / GlobalAllocator and InterfaceAllocator
+#include <algorithm>                // std::max
 #include <cstddef>                  // std::size_t, std::ptrdiff_t
 #include <limits>                   // std::numeric_limits
+#include <memory_resource>          // std::pmr::memory_resource
 #include <new>                      // std::bad_alloc, std::nothrow
 #include <type_traits>              // std::true_type
 
@@ -62,7 +66,7 @@ namespace os_memory::allocator
 
 		/// @brief 在移动赋值时传播分配器 / Propagate on container move assignment
 		using propagate_on_container_move_assignment = std::true_type;
-		/// @brief 所有实例总是相等 / Always equal
+		/// @brief 所有实例共用 GlobalAllocator，总是相等 / Every instance shares GlobalAllocator, so all compare equal
 		using is_always_equal                     = std::true_type;
 
 		/// @brief 默认构造函数 / Default constructor
@@ -79,23 +83,19 @@ namespace os_memory::allocator
 			if (count == 0)
 				return nullptr;
 
-			if (this->requested_alignment == 0 || (this->requested_alignment & 1) == 1 || !os_memory::memory_pool::is_power_of_two(this->requested_alignment))
-			{
-				this->requested_alignment = alignof(Type) * alignof(void*);
-			}
-
-			void* raw_pointer = get_pool().allocate(count * sizeof(Type), this->requested_alignment, __FILE__, __LINE__, is_nothrow);
+			void* raw_pointer = get_pool().allocate(count * sizeof(Type), effective_alignment(), __FILE__, __LINE__, is_nothrow);
 			return static_cast<pointer>(raw_pointer);
 		}
 
 		/// @brief 释放内存 / Deallocate memory
 		/// @param allocated_pointer 已分配的指针 / Pointer to deallocate
 		/// @param count 原始分配的元素个数 / Original number of elements allocated
-		void deallocate(pointer allocated_pointer, size_type /*count*/) noexcept
+		void deallocate(pointer allocated_pointer, size_type count) noexcept
 		{
 			if (!allocated_pointer)
 				return;
-			get_pool().deallocate(static_cast<void*>(allocated_pointer));
+			// 尺寸与对齐与 allocate 相同，池可直接定位层级 / Same size and alignment as allocate, so the pool locates the tier directly
+			get_pool().deallocate(static_cast<void*>(allocated_pointer), count * sizeof(Type), effective_alignment());
 		}
 
 		/// @brief 返回可分配的最大元素数 / Maximum number of elements that can be allocated
@@ -134,13 +134,118 @@ namespace os_memory::allocator
 		/// @brief 用户请求的对齐 / User requested alignment; 0 表示使用默认对齐 / 0 means use default alignment
 		size_type requested_alignment = 0;
 
-		/// @brief 获取线程本地 PoolAllocator 实例 / Get thread-local PoolAllocator instance
-		/// @return PoolAllocator 实例 / PoolAllocator instance
-		static PoolAllocator& get_pool()
+		/// @brief 实际使用的对齐：非法或未设置时取默认值 / Alignment actually used: the default when unset or invalid
+		/// @note allocate 与 deallocate 必须得到相同结果，带尺寸释放依赖它 / allocate and deallocate must agree, sized deallocation relies on it
+		size_type effective_alignment() const noexcept
+		{
+			if (this->requested_alignment == 0 || (this->requested_alignment & 1) == 1 || !os_memory::memory_pool::is_power_of_two(this->requested_alignment))
+				return alignof(Type) * alignof(void*);
+			return this->requested_alignment;
+		}
+
+		/// @brief 获取进程共享的分配器 / Get the process-wide allocator
+		/// @note 不再按线程各建一个池：跨线程释放回到同一个池 / No longer one pool per thread: frees from any thread return to the same pool
+		static InterfaceAllocator& get_pool()
+		{
+			return *os_memory::api::GlobalAllocator::get();
+		}
+	};
+
+	/// @brief 绑定到指定分配器的有状态 STL 分配器 / Stateful STL allocator bound to a chosen allocator
+	/// @tparam Type 要分配的元素类型 / Type of elements to allocate
+	/// @note 分配器的生命期须长于使用它的容器 / The allocator must outlive every container using it
+	template <typename Type>
+	class PoolBoundAllocator
+	{
+	public:
+		using value_type          = Type;
+		using size_type           = std::size_t;
+		using difference_type     = std::ptrdiff_t;
+
+		template <typename U>
+		struct rebind { using other = PoolBoundAllocator<U>; };
+
+		/// @brief 容器随移动赋值与交换带走自己的池 / Containers take their pool along on move assignment and swap
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap         = std::true_type;
+		/// @brief 绑定不同池的实例不相等 / Instances bound to different pools are not equal
+		using is_always_equal                     = std::false_type;
+
+		/// @brief 绑定到 allocator / Bind to allocator
+		explicit PoolBoundAllocator(InterfaceAllocator& allocator) noexcept : allocator_(&allocator) {}
+		/// @brief 拷贝构造函数 / Copy constructor
+		template <typename U>
+		PoolBoundAllocator(const PoolBoundAllocator<U>& other) noexcept : allocator_(other.allocator_) {}
+
+		/// @brief 分配内存 / Allocate memory
+		Type* allocate(size_type count)
 		{
-			static thread_local PoolAllocator instance;
-			return instance;
+			if (count > max_size())
+				throw std::bad_alloc();
+			return static_cast<Type*>(allocator_->allocate(std::max<size_type>(count * sizeof(Type), 1), ALIGNMENT, __FILE__, __LINE__));
 		}
+
+		/// @brief 带尺寸释放 / Sized deallocation
+		void deallocate(Type* allocated_pointer, size_type count) noexcept
+		{
+			if (allocated_pointer)
+				allocator_->deallocate(static_cast<void*>(allocated_pointer), std::max<size_type>(count * sizeof(Type), 1), ALIGNMENT);
+		}
+
+		size_type max_size() const noexcept
+		{
+			return std::numeric_limits<size_type>::max() / sizeof(Type);
+		}
+
+		/// @brief 绑定的分配器 / The bound allocator
+		InterfaceAllocator& allocator() const noexcept { return *allocator_; }
+
+		template <typename U>
+		bool operator==(const PoolBoundAllocator<U>& other) const noexcept { return allocator_ == other.allocator_; }
+		template <typename U>
+		bool operator!=(const PoolBoundAllocator<U>& other) const noexcept { return allocator_ != other.allocator_; }
+
+	private:
+		template <typename U>
+		friend class PoolBoundAllocator;
+
+		static constexpr size_type ALIGNMENT = alignof(Type) > alignof(void*) ? alignof(Type) : alignof(void*);
+
+		InterfaceAllocator* allocator_;
+	};
+
+	/**
+	 * @brief 基于 InterfaceAllocator 的 std::pmr::memory_resource / std::pmr::memory_resource over an InterfaceAllocator
+	 * @note 同一分配器上的两个资源相等，可以互相释放 / Two resources over the same allocator compare equal and may free each other's memory
+	 */
+	class PoolMemoryResource : public std::pmr::memory_resource
+	{
+	public:
+		/// @brief 默认使用 GlobalAllocator / GlobalAllocator by default
+		PoolMemoryResource() noexcept : allocator_(*os_memory::api::GlobalAllocator::get()) {}
+		explicit PoolMemoryResource(InterfaceAllocator& allocator) noexcept : allocator_(allocator) {}
+
+		InterfaceAllocator& allocator() const noexcept { return allocator_; }
+
+	private:
+		// 0 字节请求按 1 字节处理：memory_resource 须返回非空指针 / A zero-byte request is served as one byte: memory_resource must return non-null
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			return allocator_.allocate(std::max<std::size_t>(bytes, 1), std::max(alignment, alignof(void*)), __FILE__, __LINE__);
+		}
+
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+		{
+			allocator_.deallocate(pointer, std::max<std::size_t>(bytes, 1), std::max(alignment, alignof(void*)));
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			const auto* pool_resource = dynamic_cast<const PoolMemoryResource*>(&other);
+			return pool_resource && &pool_resource->allocator_ == &allocator_;
+		}
+
+		InterfaceAllocator& allocator_;
 	};
 
 }  // namespace os_memory::allocator